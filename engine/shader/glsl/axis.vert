@@ -4,14 +4,6 @@
 
 #include "constants.h"
 
-struct PointLight
-{
-	vec3 position;
-	float radius;
-	vec3 intensity;
-	float _padding_intensity;
-};
-
 layout(set = 0, binding = 0) readonly buffer _unused_name_perframe
 {
     mat4 proj_view_matrix;
@@ -19,11 +11,6 @@ layout(set = 0, binding = 0) readonly buffer _unused_name_perframe
     float _padding_camera_position;
     vec3 ambient_light;
     float _padding_ambient_light;
-    uint point_light_num;
-    uint _padding_point_light_num_1;
-	uint _padding_point_light_num_2;
-	uint _padding_point_light_num_3;
-    PointLight scene_point_lights[m_max_point_light_count];
 };
 
 layout(set = 0, binding = 1) readonly buffer _unused_name_axis
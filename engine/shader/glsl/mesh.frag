@@ -27,13 +27,12 @@ layout(set = 0, binding = 0) readonly buffer _unused_name_perframe
     lowp float       _padding_camera_position;
     highp vec3       ambient_light;
     lowp float       _padding_ambient_light;
-    highp uint       point_light_num;
-    uint             _padding_point_light_num_1;
-    uint             _padding_point_light_num_2;
-    uint             _padding_point_light_num_3;
-    PointLight       scene_point_lights[m_max_point_light_count];
     DirectionalLight scene_directional_light;
-    highp mat4       directional_light_proj_view;
+    highp uint       directional_light_cascade_count;
+    uint             _padding_directional_light_cascade_count_1;
+    uint             _padding_directional_light_cascade_count_2;
+    uint             _padding_directional_light_cascade_count_3;
+    highp mat4       directional_light_proj_views[m_max_directional_light_cascade_count];
 };
 
 layout(set = 0, binding = 3) uniform sampler2D brdfLUT_sampler;
@@ -41,6 +40,16 @@ layout(set = 0, binding = 4) uniform samplerCube irradiance_sampler;
 layout(set = 0, binding = 5) uniform samplerCube specular_sampler;
 layout(set = 0, binding = 6) uniform highp sampler2DArray point_lights_shadow;
 layout(set = 0, binding = 7) uniform highp sampler2D directional_light_shadow;
+layout(set = 0, binding = 8) readonly buffer _unused_name_point_light_clusters
+{
+    highp uint  cluster_point_light_num;
+    highp uint  cluster_light_index_num;
+    highp float cluster_depth_slice_scale;
+    highp float cluster_depth_slice_bias;
+    PointLight  cluster_point_lights[m_max_clustered_point_light_count];
+    highp uvec2 cluster_light_ranges[m_point_light_cluster_count];
+    highp uint  cluster_light_indices[m_max_point_light_cluster_index_count];
+};
 
 layout(set = 2, binding = 0) uniform _unused_name_permaterial
 {
@@ -13,14 +13,6 @@ struct DirectionalLight
     float _padding_color;
 };
 
-struct PointLight
-{
-    vec3  position;
-    float radius;
-    vec3  intensity;
-    float _padding_intensity;
-};
-
 layout(set = 0, binding = 0) readonly buffer _unused_name_perframe
 {
     mat4             proj_view_matrix;
@@ -28,13 +20,12 @@ layout(set = 0, binding = 0) readonly buffer _unused_name_perframe
     float            _padding_camera_position;
     vec3             ambient_light;
     float            _padding_ambient_light;
-    uint             point_light_num;
-    uint             _padding_point_light_num_1;
-    uint             _padding_point_light_num_2;
-    uint             _padding_point_light_num_3;
-    PointLight       scene_point_lights[m_max_point_light_count];
     DirectionalLight scene_directional_light;
-    highp mat4       directional_light_proj_view;
+    highp uint       directional_light_cascade_count;
+    uint             _padding_directional_light_cascade_count_1;
+    uint             _padding_directional_light_cascade_count_2;
+    uint             _padding_directional_light_cascade_count_3;
+    highp mat4       directional_light_proj_views[m_max_directional_light_cascade_count];
 };
 
 layout(set = 0, binding = 1) readonly buffer _unused_name_per_drawcall
@@ -42,9 +33,10 @@ layout(set = 0, binding = 1) readonly buffer _unused_name_per_drawcall
     VulkanMeshInstance mesh_instances[m_mesh_per_drawcall_max_instance_count];
 };
 
-layout(set = 0, binding = 2) readonly buffer _unused_name_per_drawcall_vertex_blending
+// the joints of every skinned instance of the frame, an instance starts at its joint_palette_offset
+layout(set = 0, binding = 2) readonly buffer _unused_name_joint_palette
 {
-    highp mat4 joint_matrices[m_mesh_vertex_blending_max_joint_count * m_mesh_per_drawcall_max_instance_count];
+    VulkanJointMatrix joint_palette[];
 };
 layout(set = 1, binding = 0) readonly buffer _unused_name_per_mesh_joint_binding
 {
@@ -65,6 +57,7 @@ void main()
 {
     highp mat4  model_matrix           = mesh_instances[gl_InstanceIndex].model_matrix;
     highp float enable_vertex_blending = mesh_instances[gl_InstanceIndex].enable_vertex_blending;
+    highp uint  joint_palette_offset   = mesh_instances[gl_InstanceIndex].joint_palette_offset;
 
     highp vec3 model_position;
     highp vec3 model_normal;
@@ -80,25 +73,25 @@ void main()
         if (in_weights.x > 0.0 && in_indices.x > 0)
         {
             vertex_blending_matrix +=
-                joint_matrices[m_mesh_vertex_blending_max_joint_count * gl_InstanceIndex + in_indices.x] * in_weights.x;
+                joint_matrix_to_mat4(joint_palette[joint_palette_offset + uint(in_indices.x)]) * in_weights.x;
         }
 
         if (in_weights.y > 0.0 && in_indices.y > 0)
         {
             vertex_blending_matrix +=
-                joint_matrices[m_mesh_vertex_blending_max_joint_count * gl_InstanceIndex + in_indices.y] * in_weights.y;
+                joint_matrix_to_mat4(joint_palette[joint_palette_offset + uint(in_indices.y)]) * in_weights.y;
         }
 
         if (in_weights.z > 0.0 && in_indices.z > 0)
         {
             vertex_blending_matrix +=
-                joint_matrices[m_mesh_vertex_blending_max_joint_count * gl_InstanceIndex + in_indices.z] * in_weights.z;
+                joint_matrix_to_mat4(joint_palette[joint_palette_offset + uint(in_indices.z)]) * in_weights.z;
         }
 
         if (in_weights.w > 0.0 && in_indices.w > 0)
         {
             vertex_blending_matrix +=
-                joint_matrices[m_mesh_vertex_blending_max_joint_count * gl_InstanceIndex + in_indices.w] * in_weights.w;
+                joint_matrix_to_mat4(joint_palette[joint_palette_offset + uint(in_indices.w)]) * in_weights.w;
         }
 
         model_position = (vertex_blending_matrix * vec4(in_position, 1.0)).xyz;
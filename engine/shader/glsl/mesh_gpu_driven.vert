@@ -0,0 +1,48 @@
+#version 310 es
+
+#extension GL_GOOGLE_include_directive : enable
+
+#include "constants.h"
+#include "structures.h"
+
+layout(set = 0, binding = 0) readonly buffer _unused_name_perframe
+{
+    mat4 proj_view_matrix;
+};
+
+// filled by mesh_cull.comp, the instance index includes the first instance of the indirect draw
+layout(set = 0, binding = 1) readonly buffer _unused_name_instances
+{
+    VulkanMeshCullInstance mesh_cull_instances[];
+};
+
+layout(set = 0, binding = 2) readonly buffer _unused_name_visible_instances
+{
+    highp uint visible_instance_indices[];
+};
+
+layout(location = 0) in vec3 in_position; // for some types as dvec3 takes 2 locations
+layout(location = 1) in vec3 in_normal;
+layout(location = 2) in vec3 in_tangent;
+layout(location = 3) in vec2 in_texcoord;
+
+layout(location = 0) out vec3 out_world_position; // output in framebuffer 0 for fragment shader
+layout(location = 1) out vec3 out_normal;
+layout(location = 2) out vec3 out_tangent;
+layout(location = 3) out vec2 out_texcoord;
+
+void main()
+{
+    highp mat4 model_matrix = mesh_cull_instances[visible_instance_indices[gl_InstanceIndex]].model_matrix;
+
+    out_world_position = (model_matrix * vec4(in_position, 1.0)).xyz;
+
+    gl_Position = proj_view_matrix * vec4(out_world_position, 1.0f);
+
+    // TODO: normal matrix
+    mat3x3 tangent_matrix = mat3x3(model_matrix[0].xyz, model_matrix[1].xyz, model_matrix[2].xyz);
+    out_normal            = normalize(tangent_matrix * in_normal);
+    out_tangent           = normalize(tangent_matrix * in_tangent);
+
+    out_texcoord = in_texcoord;
+}
@@ -17,11 +17,13 @@ layout(set = 0, binding = 1) readonly buffer _unused_name_perdrawcall
     mat4 model_matrices[m_mesh_per_drawcall_max_instance_count];
     uint node_ids[m_mesh_per_drawcall_max_instance_count];
     float enable_vertex_blendings[m_mesh_per_drawcall_max_instance_count];
+    uint joint_palette_offsets[m_mesh_per_drawcall_max_instance_count];
 };
 
-layout(set = 0, binding = 2) readonly buffer _unused_name_per_drawcall_vertex_blending
+// the joints of every skinned instance of the frame, an instance starts at its joint_palette_offset
+layout(set = 0, binding = 2) readonly buffer _unused_name_joint_palette
 {
-    mat4 joint_matrices[m_mesh_vertex_blending_max_joint_count * m_mesh_per_drawcall_max_instance_count];
+    VulkanJointMatrix joint_palette[];
 };
 
 layout(set = 1, binding = 0) readonly buffer _unused_name_per_mesh_joint_binding
@@ -37,6 +39,7 @@ void main()
 {
     highp mat4 model_matrix = model_matrices[gl_InstanceIndex];
     highp float enable_vertex_blending = enable_vertex_blendings[gl_InstanceIndex];
+    highp uint joint_palette_offset = joint_palette_offsets[gl_InstanceIndex];
 
     highp vec3 model_position;
     if (enable_vertex_blending > 0.0)
@@ -52,22 +55,22 @@ void main()
 
         if (in_weights.x > 0.0 && in_indices.x > 0)
         {
-            vertex_blending_matrix += joint_matrices[m_mesh_vertex_blending_max_joint_count * gl_InstanceIndex + in_indices.x] * in_weights.x;
+            vertex_blending_matrix += joint_matrix_to_mat4(joint_palette[joint_palette_offset + uint(in_indices.x)]) * in_weights.x;
         }
 
         if (in_weights.y > 0.0 && in_indices.y > 0)
         {
-            vertex_blending_matrix += joint_matrices[m_mesh_vertex_blending_max_joint_count * gl_InstanceIndex + in_indices.y] * in_weights.y;
+            vertex_blending_matrix += joint_matrix_to_mat4(joint_palette[joint_palette_offset + uint(in_indices.y)]) * in_weights.y;
         }
 
         if (in_weights.z > 0.0 && in_indices.z > 0)
         {
-            vertex_blending_matrix += joint_matrices[m_mesh_vertex_blending_max_joint_count * gl_InstanceIndex + in_indices.z] * in_weights.z;
+            vertex_blending_matrix += joint_matrix_to_mat4(joint_palette[joint_palette_offset + uint(in_indices.z)]) * in_weights.z;
         }
 
         if (in_weights.w > 0.0 && in_indices.w > 0)
         {
-            vertex_blending_matrix += joint_matrices[m_mesh_vertex_blending_max_joint_count * gl_InstanceIndex + in_indices.w] * in_weights.w;
+            vertex_blending_matrix += joint_matrix_to_mat4(joint_palette[joint_palette_offset + uint(in_indices.w)]) * in_weights.w;
         }
 
         model_position = (vertex_blending_matrix * vec4(in_position, 1.0)).xyz;
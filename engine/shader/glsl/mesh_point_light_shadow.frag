@@ -10,7 +10,7 @@
 layout(set = 0, binding = 0) readonly buffer _unused_name_global_set_per_frame_binding_buffer
 {
     uint point_light_count;
-    uint _padding_point_light_count_0;
+    uint first_point_light_index;
     uint _padding_point_light_count_1;
     uint _padding_point_light_count_2;
     highp vec4 point_lights_position_and_radius[m_max_point_light_count];
@@ -0,0 +1,16 @@
+#version 310 es
+
+#extension GL_GOOGLE_include_directive : enable
+
+#include "constants.h"
+
+layout(set = 0, binding = 0) uniform sampler2D in_particle_color;
+
+layout(location = 0) out highp vec4 out_color;
+
+// the premultiplied half resolution particles, upsampled over the scene
+void main()
+{
+    highp vec2 uv = gl_FragCoord.xy * 0.5 / vec2(textureSize(in_particle_color, 0));
+    out_color     = texture(in_particle_color, uv);
+}
@@ -0,0 +1,28 @@
+#version 310 es
+
+#extension GL_GOOGLE_include_directive : enable
+
+#include "constants.h"
+
+layout(location = 0) in highp vec4 in_color;
+layout(location = 1) in highp vec2 in_uv;
+
+layout(set = 0, binding = 2) uniform sampler2D sparktexture;
+layout(set = 0, binding = 6) uniform sampler2D in_scene_depth;
+
+layout(location = 0) out highp vec4 out_scene_color;
+
+// the half resolution target has no depth attachment, the particles are tested against the scene depth copied at
+// the end of the previous frame
+void main()
+{
+    highp float scene_depth = texelFetch(in_scene_depth, ivec2(gl_FragCoord.xy * 2.0), 0).r;
+    if (gl_FragCoord.z >= scene_depth)
+    {
+        discard;
+    }
+
+    highp float spark     = texture(sparktexture, in_uv).r;
+    out_scene_color.xyz = 4.0f * spark * in_color.xyz;
+    out_scene_color.w   = spark;
+}
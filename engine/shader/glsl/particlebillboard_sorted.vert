@@ -0,0 +1,72 @@
+#version 310 es
+
+#extension GL_GOOGLE_include_directive : enable
+
+#include "constants.h"
+#define PARTICLE_SORT_STATE_QUALIFIER readonly
+#include "particle_sort.h"
+
+layout(std430, set = 0, binding = 1) readonly buffer _unused_name_particles { Particle particles[]; };
+
+layout(set = 0, binding = 3) uniform _unused_name_perframe
+{
+    mat4 proj_view_matrix;
+    vec3 right_diection;
+    vec3 up_direction;
+    vec3 forward_diection;
+};
+
+layout(std430, set = 0, binding = 4) readonly buffer _unused_name_sorted_values { highp uint sorted_values[]; };
+
+layout(std430, set = 0, binding = 5) readonly buffer _unused_name_visibility { highp uint visibility[]; };
+
+layout(location = 0) out vec4 out_color;
+layout(location = 1) out vec2 out_uv;
+
+// particlebillboard.vert over the particles of all the emitters, instanced in the sorted order
+void main()
+{
+    const vec2 vertex_buffer[4] = vec2[4](vec2(-0.5, 0.5), vec2(0.5, 0.5), vec2(-0.5, -0.5), vec2(0.5, -0.5));
+    const vec2 uv_buffer[4]     = vec2[4](vec2(0, 1), vec2(1, 1), vec2(0, 0), vec2(1, 0));
+    vec2       model_position   = vertex_buffer[gl_VertexIndex];
+
+    highp uint particle_index = sorted_values[gl_InstanceIndex];
+    if (tile_grid.w != 0u && visibility[particle_index] == 0u)
+    {
+        // binned out, the strip is clipped
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+        out_color   = vec4(0.0);
+        out_uv      = vec2(0.0);
+        return;
+    }
+
+    Particle particle        = particles[particle_index];
+    vec3     anchor_location = particle.pos;
+
+    // viewport-oriented
+    vec3  vel_dir      = particle.vel;
+    float projectvel_x = dot(vel_dir, right_diection);
+    float projectvel_y = dot(vel_dir, up_direction);
+    float size_x       = particle.size_x;
+    float size_y       = particle.size_y;
+
+    vec3 world_position;
+    if (abs(projectvel_x) < size_x || abs(projectvel_y) < size_y)
+    {
+        world_position =
+            size_x * right_diection * model_position.x + size_y * up_direction * model_position.y + anchor_location;
+    }
+    else
+    {
+        vec3 project_dir = normalize(projectvel_x * right_diection + projectvel_y * up_direction);
+        vec3 side_dir    = normalize(cross(forward_diection, project_dir));
+        world_position =
+            size_x * side_dir * model_position.x + size_y * project_dir * model_position.y + anchor_location;
+    }
+
+    // world to NDC
+    gl_Position = proj_view_matrix * vec4(world_position, 1.0);
+
+    out_color = particle.color;
+    out_uv    = uv_buffer[gl_VertexIndex];
+}
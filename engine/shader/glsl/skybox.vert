@@ -12,14 +12,6 @@ struct DirectionalLight
     lowp float _padding_color;
 };
 
-struct PointLight
-{
-    highp vec3  position;
-    highp float radius;
-    highp vec3  intensity;
-    lowp float  _padding_intensity;
-};
-
 layout(set = 0, binding = 0) readonly buffer _skybox_per_frame
 {
     highp mat4       proj_view_matrix;
@@ -27,13 +19,12 @@ layout(set = 0, binding = 0) readonly buffer _skybox_per_frame
     lowp float       _padding_camera_position;
     highp vec3       ambient_light;
     lowp float       _padding_ambient_light;
-    highp uint       point_light_num;
-    uint             _padding_point_light_num_1;
-    uint             _padding_point_light_num_2;
-    uint             _padding_point_light_num_3;
-    PointLight       scene_point_lights[m_max_point_light_count];
     DirectionalLight scene_directional_light;
-    highp mat4       directional_light_proj_view;
+    highp uint       directional_light_cascade_count;
+    uint             _padding_directional_light_cascade_count_1;
+    uint             _padding_directional_light_cascade_count_2;
+    uint             _padding_directional_light_cascade_count_3;
+    highp mat4       directional_light_proj_views[m_max_directional_light_cascade_count];
 };
 
 layout(location = 0) out vec3 out_UVW;
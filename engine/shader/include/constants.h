@@ -1,7 +1,18 @@
 #define m_max_point_light_count 15
 #define m_max_point_light_geom_vertices 90 // 90 = 2 * 3 * m_max_point_light_count
+#define m_max_directional_light_cascade_count 4
+#define m_max_clustered_point_light_count 512
+#define m_point_light_cluster_dimension_x 16
+#define m_point_light_cluster_dimension_y 9
+#define m_point_light_cluster_dimension_z 24
+#define m_point_light_cluster_count 3456 // 3456 = 16 * 9 * 24
+#define m_max_point_light_cluster_index_count 65536
 #define m_mesh_per_drawcall_max_instance_count 64
 #define m_mesh_vertex_blending_max_joint_count 1024
+#define m_mesh_cull_group_size 64
+#define m_mesh_skinning_group_size 64
+#define m_particle_sort_group_size 256 // one thread per radix digit
+#define m_particle_sort_block_size 1024
 #define CHAOS_LAYOUT_MAJOR row_major
 layout(CHAOS_LAYOUT_MAJOR) buffer;
 layout(CHAOS_LAYOUT_MAJOR) uniform;
\ No newline at end of file
@@ -8,11 +8,30 @@ highp vec3 F0 = mix(vec3(dielectric_specular, dielectric_specular, dielectric_sp
 
 // direct light specular and diffuse BRDF contribution
 highp vec3 Lo = vec3(0.0, 0.0, 0.0);
-for (highp int light_index = 0; light_index < int(point_light_num) && light_index < m_max_point_light_count;
-     ++light_index)
+
+// only the point lights touching the froxel of the main camera around the position are shaded
+highp vec4 cluster_position_clip = proj_view_matrix * vec4(in_world_position, 1.0);
+highp vec2 cluster_uv            = ndcxy_to_uv(cluster_position_clip.xy / cluster_position_clip.w);
+highp uint cluster_x = uint(clamp(cluster_uv.x * float(m_point_light_cluster_dimension_x),
+                                  0.0,
+                                  float(m_point_light_cluster_dimension_x - 1)));
+highp uint cluster_y = uint(clamp(cluster_uv.y * float(m_point_light_cluster_dimension_y),
+                                  0.0,
+                                  float(m_point_light_cluster_dimension_y - 1)));
+highp uint cluster_z =
+    uint(clamp(log(max(cluster_position_clip.w, 0.0001)) * cluster_depth_slice_scale + cluster_depth_slice_bias,
+               0.0,
+               float(m_point_light_cluster_dimension_z - 1)));
+highp uvec2 cluster_light_range =
+    cluster_light_ranges[cluster_x + uint(m_point_light_cluster_dimension_x) *
+                                         (cluster_y + uint(m_point_light_cluster_dimension_y) * cluster_z)];
+
+for (highp uint cluster_light = 0u; cluster_light < cluster_light_range.y; ++cluster_light)
 {
-    highp vec3  point_light_position = scene_point_lights[light_index].position;
-    highp float point_light_radius   = scene_point_lights[light_index].radius;
+    highp int light_index = int(cluster_light_indices[cluster_light_range.x + cluster_light]);
+
+    highp vec3  point_light_position = cluster_point_lights[light_index].position;
+    highp float point_light_radius   = cluster_point_lights[light_index].radius;
 
     highp vec3  L   = normalize(point_light_position - in_world_position);
     highp float NoL = min(dot(N, L), 1.0);
@@ -25,7 +44,9 @@ for (highp int light_index = 0; light_index < int(point_light_num) && light_inde
     highp float light_attenuation = radius_attenuation * distance_attenuation * NoL;
     if (light_attenuation > 0.0)
     {
-        highp float shadow;
+        // only the first m_max_point_light_count lights have a shadow map
+        highp float shadow = 1.0f;
+        if (light_index < m_max_point_light_count)
         {
             // world space to light view space
             // identity rotation
@@ -63,7 +84,7 @@ for (highp int light_index = 0; light_index < int(point_light_num) && light_inde
 
         if (shadow > 0.0f)
         {
-            highp vec3 En = scene_point_lights[light_index].intensity * light_attenuation;
+            highp vec3 En = cluster_point_lights[light_index].intensity * light_attenuation;
             Lo += BRDF(L, V, N, F0, basecolor, metallic, roughness) * En;
         }
     }
@@ -95,17 +116,31 @@ highp vec3 Libl = (kD * diffuse + specular);
 
     if (NoL > 0.0)
     {
-        highp float shadow;
+        highp float shadow = 1.0f;
         {
-            highp vec4 position_clip = directional_light_proj_view * vec4(in_world_position, 1.0);
-            highp vec3 position_ndc  = position_clip.xyz / position_clip.w;
-
-            highp vec2 uv = ndcxy_to_uv(position_ndc.xy);
-
-            highp float closest_depth = texture(directional_light_shadow, uv).r + 0.000075;
-            highp float current_depth = position_ndc.z;
-
-            shadow = (closest_depth >= current_depth) ? 1.0f : -1.0f;
+            // the cascades go from near to far and share the shadow map, split into a 2x2 grid of tiles as soon as
+            // there is more than one, the first cascade covering the position is the sharpest
+            highp uint tile_grid = (directional_light_cascade_count > 1u) ? 2u : 1u;
+            for (highp uint cascade_index = 0u; cascade_index < directional_light_cascade_count; ++cascade_index)
+            {
+                highp vec4 position_clip = directional_light_proj_views[cascade_index] * vec4(in_world_position, 1.0);
+                highp vec3 position_ndc  = position_clip.xyz / position_clip.w;
+
+                highp vec2 uv = ndcxy_to_uv(position_ndc.xy);
+                if (any(lessThan(uv, vec2(0.0))) || any(greaterThan(uv, vec2(1.0))) || position_ndc.z > 1.0)
+                {
+                    continue;
+                }
+
+                highp vec2 tile = vec2(float(cascade_index % tile_grid), float(cascade_index / tile_grid));
+                highp vec2 tile_uv = (uv + tile) / float(tile_grid);
+
+                highp float closest_depth = texture(directional_light_shadow, tile_uv).r + 0.000075;
+                highp float current_depth = position_ndc.z;
+
+                shadow = (closest_depth >= current_depth) ? 1.0f : -1.0f;
+                break;
+            }
         }
 
         if (shadow > 0.0f)
@@ -0,0 +1,29 @@
+struct Particle
+{
+    highp vec3  pos;
+    highp float life;
+    highp vec3  vel;
+    highp float size_x;
+    highp vec3  acc;
+    highp float size_y;
+    highp vec4  color;
+};
+
+// the shaders which only read the state define the qualifier as readonly
+#ifndef PARTICLE_SORT_STATE_QUALIFIER
+#define PARTICLE_SORT_STATE_QUALIFIER
+#endif
+
+// ParticlePass::ParticleSortState, followed by the alive count of every emitter
+layout(std430, set = 0, binding = 0) PARTICLE_SORT_STATE_QUALIFIER buffer _unused_name_particle_sort_state
+{
+    highp mat4  view_projection_matrix;
+    highp vec4  depth_range;       // near, far, depth key scale
+    highp uvec4 tile_grid;         // tile count x, tile count y, tile size, max particles per tile
+    highp vec4  viewport_size;     // width, height
+    highp uvec4 sort_counts;       // sorted particles, sort blocks, particles per emitter
+    highp uvec4 sort_dispatch;     // one group per sort block
+    highp uvec4 particle_dispatch; // one thread per sorted particle
+    highp uvec4 draw_argument;     // the billboard strip instanced by the sorted particles
+    highp uint  emitter_alive_counts[];
+};
@@ -1,14 +1,43 @@
 struct VulkanMeshInstance
 {
     highp float enable_vertex_blending;
-    highp float _padding_enable_vertex_blending_1;
+    highp uint  joint_palette_offset;
     highp float _padding_enable_vertex_blending_2;
     highp float _padding_enable_vertex_blending_3;
     highp mat4  model_matrix;
 };
 
+// rows of an affine joint transform, the last row is (0, 0, 0, 1)
+struct VulkanJointMatrix
+{
+    highp vec4 rows[3];
+};
+
+highp mat4 joint_matrix_to_mat4(VulkanJointMatrix joint_matrix)
+{
+    return transpose(mat4(joint_matrix.rows[0], joint_matrix.rows[1], joint_matrix.rows[2], vec4(0.0, 0.0, 0.0, 1.0)));
+}
+
 struct VulkanMeshVertexJointBinding
 {
     highp ivec4 indices;
     highp vec4  weights;
 };
+
+struct VulkanMeshCullInstance
+{
+    highp mat4  model_matrix;
+    highp vec3  bounding_box_min;
+    highp uint  draw_index;
+    highp vec3  bounding_box_max;
+    highp float _padding_bounding_box_max;
+};
+
+struct VulkanDrawIndexedIndirectCommand
+{
+    highp uint index_count;
+    highp uint instance_count;
+    highp uint first_index;
+    highp int  vertex_offset;
+    highp uint first_instance;
+};
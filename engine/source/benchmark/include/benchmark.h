@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace Piccolo
+{
+    // runs body once to warm up and then iteration_count times, prints and returns the average nanoseconds of a run
+    double runBenchmark(const std::string& name, uint32_t iteration_count, const std::function<void()>& body);
+
+    // keeps the optimizer from dropping the work whose result is otherwise unused
+    void consumeBenchmarkValue(uint64_t value);
+
+    // prints the failed check, the benchmark tool then exits with an error
+    void reportBenchmarkFailure(const std::string& message);
+    bool hasBenchmarkFailure();
+
+    // radix sorted draw list against the nested material and mesh maps it replaced, for 20k visible nodes
+    void benchmarkDrawList();
+
+    // LOG_INFO calls dropped by the runtime level against the message string the old macros built for each of them
+    void benchmarkSuppressedLog();
+
+    // the bundled json assets read through the streaming reader and through a json11 dom
+    void benchmarkJsonLoading();
+
+    // meta lookup, field walk and field lookup by name over a few registered types
+    void benchmarkReflection();
+
+    // skinMeshVertices checked against a scalar reference on a small mesh, then both timed on 20k vertices
+    void benchmarkSkinning();
+
+    // the cpu particle sort checked against the particle_sort_*.comp passes run invocation by invocation, then timed
+    void benchmarkParticleSort();
+
+    // mesh_cull.comp run invocation by invocation against the cpu frustum culling it replaces, then the cpu path timed
+    void benchmarkMeshCull();
+} // namespace Piccolo
@@ -0,0 +1,42 @@
+#include "benchmark/include/benchmark.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+namespace Piccolo
+{
+    namespace
+    {
+        volatile uint64_t s_benchmark_sink {0};
+        bool              s_has_benchmark_failure {false};
+    } // namespace
+
+    double runBenchmark(const std::string& name, uint32_t iteration_count, const std::function<void()>& body)
+    {
+        body();
+
+        auto start_time = std::chrono::steady_clock::now();
+        for (uint32_t iteration = 0; iteration < iteration_count; ++iteration)
+        {
+            body();
+        }
+        auto elapsed_time = std::chrono::steady_clock::now() - start_time;
+
+        uint32_t const run_count  = iteration_count > 0 ? iteration_count : 1;
+        double const   average_ns = std::chrono::duration<double, std::nano>(elapsed_time).count() / run_count;
+        std::cout << "  " << name << ": " << std::fixed << std::setprecision(1) << average_ns << " ns"
+                  << " (" << iteration_count << " runs)" << std::endl;
+        return average_ns;
+    }
+
+    void consumeBenchmarkValue(uint64_t value) { s_benchmark_sink = s_benchmark_sink + value; }
+
+    void reportBenchmarkFailure(const std::string& message)
+    {
+        std::cerr << "  failed: " << message << std::endl;
+        s_has_benchmark_failure = true;
+    }
+
+    bool hasBenchmarkFailure() { return s_has_benchmark_failure; }
+} // namespace Piccolo
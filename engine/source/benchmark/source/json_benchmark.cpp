@@ -0,0 +1,157 @@
+#include "benchmark/include/benchmark.h"
+
+#include "runtime/resource/asset_manager/asset_manager.h"
+#include "runtime/resource/config_manager/config_manager.h"
+#include "runtime/resource/res_type/common/level.h"
+#include "runtime/resource/res_type/common/object.h"
+#include "runtime/resource/res_type/common/world.h"
+#include "runtime/resource/res_type/data/animation_clip.h"
+#include "runtime/resource/res_type/data/animation_skeleton_node_map.h"
+#include "runtime/resource/res_type/data/material.h"
+#include "runtime/resource/res_type/data/skeleton_data.h"
+#include "runtime/resource/res_type/data/skeleton_mask.h"
+#include "runtime/resource/res_type/global/global_particle.h"
+#include "runtime/resource/res_type/global/global_rendering.h"
+
+#include "runtime/function/global/global_context.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace Piccolo
+{
+    namespace
+    {
+        // a bundled json asset read into memory once, so that only the parsing and the deserialization are timed
+        struct JsonAssetFile
+        {
+            std::string text;
+            bool (*read_dom)(const std::string& text) {nullptr};
+            bool (*read_streaming)(const std::string& text) {nullptr};
+        };
+
+        template<typename AssetType>
+        bool readDom(const std::string& text)
+        {
+            std::string error;
+            Json        asset_json = Json::parse(text, error);
+            if (!error.empty())
+            {
+                return false;
+            }
+
+            AssetType asset;
+            Serializer::read(asset_json, asset);
+            return true;
+        }
+
+        template<typename AssetType>
+        bool readStreaming(const std::string& text)
+        {
+            AssetType  asset;
+            JsonReader reader(text.data(), text.data() + text.size());
+            Serializer::read(reader, asset);
+            return !reader.hasError();
+        }
+
+        struct JsonAssetType
+        {
+            const char* suffix;
+            bool (*read_dom)(const std::string& text);
+            bool (*read_streaming)(const std::string& text);
+        };
+
+        // the reflected json assets the asset cooker knows about
+        const JsonAssetType s_json_asset_types[] = {
+            {".object.json", readDom<ObjectDefinitionRes>, readStreaming<ObjectDefinitionRes>},
+            {".level.json", readDom<LevelRes>, readStreaming<LevelRes>},
+            {".world.json", readDom<WorldRes>, readStreaming<WorldRes>},
+            {".material.json", readDom<MaterialRes>, readStreaming<MaterialRes>},
+            {".animation_clip.json", readDom<AnimationAsset>, readStreaming<AnimationAsset>},
+            {".skeleton.json", readDom<SkeletonData>, readStreaming<SkeletonData>},
+            {".skeleton_map.json", readDom<AnimSkelMap>, readStreaming<AnimSkelMap>},
+            {".skeleton_mask.json", readDom<BoneBlendMask>, readStreaming<BoneBlendMask>},
+            {"rendering.global.json", readDom<GlobalRenderingRes>, readStreaming<GlobalRenderingRes>},
+            {"particle.global.json", readDom<GlobalParticleRes>, readStreaming<GlobalParticleRes>},
+        };
+
+        bool hasSuffix(const std::string& text, const std::string& suffix)
+        {
+            return text.size() >= suffix.size() &&
+                   text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+        }
+    } // namespace
+
+    void benchmarkJsonLoading()
+    {
+        const uint32_t run_count = 20;
+
+        std::vector<JsonAssetFile> asset_files;
+        size_t                     total_size = 0;
+
+        const std::filesystem::path& asset_folder = g_runtime_global_context.m_config_manager->getAssetFolder();
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(asset_folder))
+        {
+            if (!entry.is_regular_file())
+            {
+                continue;
+            }
+
+            std::string const file_name = entry.path().filename().generic_string();
+            for (const JsonAssetType& asset_type : s_json_asset_types)
+            {
+                if (!hasSuffix(file_name, asset_type.suffix))
+                {
+                    continue;
+                }
+
+                std::ifstream     asset_json_file(entry.path(), std::ios::binary);
+                std::stringstream buffer;
+                buffer << asset_json_file.rdbuf();
+
+                JsonAssetFile asset_file;
+                asset_file.text           = buffer.str();
+                asset_file.read_dom       = asset_type.read_dom;
+                asset_file.read_streaming = asset_type.read_streaming;
+
+                // both paths have to read the file, otherwise the one failing early would look faster
+                if (!asset_file.read_dom(asset_file.text) || !asset_file.read_streaming(asset_file.text))
+                {
+                    std::cout << "  skipped " << entry.path().generic_string() << ", it does not parse" << std::endl;
+                    break;
+                }
+
+                total_size += asset_file.text.size();
+                asset_files.push_back(std::move(asset_file));
+                break;
+            }
+        }
+
+        if (asset_files.empty())
+        {
+            std::cout << "  no json assets under " << asset_folder.generic_string() << std::endl;
+            return;
+        }
+
+        double dom_ns = runBenchmark("json11 dom", run_count, [&]() {
+            for (const JsonAssetFile& asset_file : asset_files)
+            {
+                consumeBenchmarkValue(asset_file.read_dom(asset_file.text));
+            }
+        });
+
+        double streaming_ns = runBenchmark("streaming reader", run_count, [&]() {
+            for (const JsonAssetFile& asset_file : asset_files)
+            {
+                consumeBenchmarkValue(asset_file.read_streaming(asset_file.text));
+            }
+        });
+
+        std::cout << "  " << asset_files.size() << " files, " << total_size / 1024 << " KiB, streaming "
+                  << dom_ns / streaming_ns << "x faster than the dom" << std::endl;
+    }
+} // namespace Piccolo
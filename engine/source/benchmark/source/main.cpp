@@ -0,0 +1,81 @@
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <vector>
+
+#include "runtime/core/meta/reflection/reflection_register.h"
+#include "runtime/function/global/global_context.h"
+
+#include "benchmark/include/benchmark.h"
+
+namespace
+{
+    struct BenchmarkEntry
+    {
+        const char* name;
+        void (*run)();
+    };
+
+    const BenchmarkEntry s_benchmarks[] = {
+        {"draw_list", Piccolo::benchmarkDrawList},
+        {"suppressed_log", Piccolo::benchmarkSuppressedLog},
+        {"json_loading", Piccolo::benchmarkJsonLoading},
+        {"reflection", Piccolo::benchmarkReflection},
+        {"skinning", Piccolo::benchmarkSkinning},
+        {"particle_sort", Piccolo::benchmarkParticleSort},
+        {"mesh_cull", Piccolo::benchmarkMeshCull},
+    };
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::filesystem::path executable_path(argv[0]);
+    std::filesystem::path config_file_path = executable_path.parent_path() / "PiccoloEditor.ini";
+
+    // the benchmarks named on the command line, all of them when none is named
+    std::vector<const BenchmarkEntry*> selected_benchmarks;
+    for (int i = 1; i < argc; ++i)
+    {
+        bool is_found = false;
+        for (const BenchmarkEntry& benchmark : s_benchmarks)
+        {
+            if (std::strcmp(argv[i], benchmark.name) == 0)
+            {
+                selected_benchmarks.push_back(&benchmark);
+                is_found = true;
+            }
+        }
+        if (!is_found)
+        {
+            std::cerr << "usage: " << executable_path.filename().generic_string() << " [benchmark...], one of:";
+            for (const BenchmarkEntry& benchmark : s_benchmarks)
+            {
+                std::cerr << " " << benchmark.name;
+            }
+            std::cerr << std::endl;
+            return 2;
+        }
+    }
+    if (selected_benchmarks.empty())
+    {
+        for (const BenchmarkEntry& benchmark : s_benchmarks)
+        {
+            selected_benchmarks.push_back(&benchmark);
+        }
+    }
+
+    // the systems a command line tool gets, the benchmarks which load assets find the asset folder through them
+    Piccolo::Reflection::TypeMetaRegister::metaRegister();
+    Piccolo::g_runtime_global_context.startHeadlessSystems(config_file_path.generic_string());
+
+    for (const BenchmarkEntry* benchmark : selected_benchmarks)
+    {
+        std::cout << benchmark->name << std::endl;
+        benchmark->run();
+    }
+
+    Piccolo::g_runtime_global_context.shutdownSystems();
+    Piccolo::Reflection::TypeMetaRegister::metaUnregister();
+
+    return Piccolo::hasBenchmarkFailure() ? 1 : 0;
+}
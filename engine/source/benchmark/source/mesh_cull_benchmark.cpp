@@ -0,0 +1,223 @@
+#include "benchmark/include/benchmark.h"
+
+#include "runtime/core/math/math_headers.h"
+#include "runtime/function/render/render_common.h"
+#include "runtime/function/render/render_helper.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Piccolo
+{
+    namespace
+    {
+        // mesh_cull.comp for one instance, the margin is how far the box is from changing sides of the nearest plane
+        bool cullInstance(const Vector4 frustum_planes[6], const VulkanMeshCullInstance& instance, float& margin)
+        {
+            const Matrix4x4& model_matrix = instance.model_matrix;
+
+            Vector3 local_center  = (instance.bounding_box_max + instance.bounding_box_min) * 0.5f;
+            Vector3 local_extents = (instance.bounding_box_max - instance.bounding_box_min) * 0.5f;
+            Vector3 box_center    = model_matrix.transformAffine(local_center);
+            Vector3 box_extents;
+            for (size_t row = 0; row < 3; ++row)
+            {
+                box_extents[row] = std::fabs(model_matrix[row][0]) * local_extents.x +
+                                   std::fabs(model_matrix[row][1]) * local_extents.y +
+                                   std::fabs(model_matrix[row][2]) * local_extents.z;
+            }
+
+            margin = std::numeric_limits<float>::max();
+            for (int plane_index = 0; plane_index < 6; ++plane_index)
+            {
+                const Vector4& plane                = frustum_planes[plane_index];
+                float          signed_distance      = plane.dotProduct(Vector4(box_center, 1.0f));
+                float          radius_project_plane = std::fabs(plane.x) * box_extents.x +
+                                             std::fabs(plane.y) * box_extents.y + std::fabs(plane.z) * box_extents.z;
+                margin = std::min(margin, std::fabs(signed_distance - radius_project_plane));
+                if (signed_distance >= radius_project_plane)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+    } // namespace
+
+    void benchmarkMeshCull()
+    {
+        const uint32_t instance_count = 20000;
+        const uint32_t material_count = 16;
+        const uint32_t mesh_count     = 64;
+        const uint32_t run_count      = 100;
+
+        Matrix4x4 proj_view_matrix =
+            Math::makePerspectiveMatrix(Radian(Math_PI / 3.0f), 16.0f / 9.0f, 0.1f, 1000.0f) *
+            Math::makeLookAtMatrix(Vector3(0.0f, 0.0f, 0.0f), Vector3(1.0f, 0.0f, 0.0f), Vector3(0.0f, 0.0f, 1.0f));
+
+        // MeshCullPass::preparePassData
+        ClusterFrustum frustum = CreateClusterFrustumFromMatrix(proj_view_matrix, -1.0, 1.0, -1.0, 1.0, 0.0, 1.0);
+        Vector4        frustum_planes[6] = {frustum.m_plane_right,
+                                            frustum.m_plane_left,
+                                            frustum.m_plane_top,
+                                            frustum.m_plane_bottom,
+                                            frustum.m_plane_near,
+                                            frustum.m_plane_far};
+
+        // rotated and scaled boxes all around the camera, some crossing the planes
+        std::mt19937                          random_engine(30);
+        std::uniform_real_distribution<float> position_distribution(-600.0f, 600.0f);
+        std::uniform_real_distribution<float> size_distribution(0.5f, 20.0f);
+        std::uniform_real_distribution<float> unit_distribution(-1.0f, 1.0f);
+
+        std::vector<VulkanMeshCullInstance> instances(instance_count);
+        std::vector<BoundingBox>            world_bounding_boxes(instance_count);
+        std::vector<uint64_t>               draw_keys(instance_count);
+        for (uint32_t i = 0; i < instance_count; ++i)
+        {
+            Vector3 axis(unit_distribution(random_engine),
+                         unit_distribution(random_engine),
+                         unit_distribution(random_engine));
+            axis.normalise();
+            Quaternion rotation(Radian(unit_distribution(random_engine) * Math_PI), axis);
+            Vector3    scale(size_distribution(random_engine) * 0.1f,
+                          size_distribution(random_engine) * 0.1f,
+                          size_distribution(random_engine) * 0.1f);
+            Vector3    position(position_distribution(random_engine),
+                             position_distribution(random_engine),
+                             position_distribution(random_engine));
+
+            VulkanMeshCullInstance& instance = instances[i];
+            instance                         = {};
+            instance.model_matrix.makeTransform(position, scale, rotation);
+            instance.bounding_box_max = Vector3(size_distribution(random_engine),
+                                                size_distribution(random_engine),
+                                                size_distribution(random_engine));
+            instance.bounding_box_min = -instance.bounding_box_max * 0.5f;
+
+            // the cpu path culls the cached world box, see RenderScene::updateVisibleObjectsMainCamera
+            world_bounding_boxes[i] = BoundingBoxTransform(
+                BoundingBox(instance.bounding_box_min, instance.bounding_box_max), instance.model_matrix);
+
+            draw_keys[i] = (static_cast<uint64_t>(random_engine() % material_count) << 32) |
+                           (random_engine() % mesh_count);
+        }
+
+        // the draw table, in the order the entities first use a material and mesh pair
+        std::unordered_map<uint64_t, uint32_t> draw_indices;
+        std::vector<uint32_t>                  draw_instance_counts;
+        for (uint32_t i = 0; i < instance_count; ++i)
+        {
+            auto inserted = draw_indices.emplace(draw_keys[i], static_cast<uint32_t>(draw_instance_counts.size()));
+            if (inserted.second)
+            {
+                draw_instance_counts.push_back(0);
+            }
+            instances[i].draw_index = inserted.first->second;
+            ++draw_instance_counts[instances[i].draw_index];
+        }
+        std::vector<VulkanDrawIndexedIndirectCommand> draw_commands(draw_instance_counts.size());
+        uint32_t                                      first_instance = 0;
+        for (size_t draw_index = 0; draw_index < draw_commands.size(); ++draw_index)
+        {
+            draw_commands[draw_index]                = {};
+            draw_commands[draw_index].first_instance = first_instance;
+            first_instance += draw_instance_counts[draw_index];
+        }
+
+        // mesh_cull.comp, the invocations run in any order and append through the instance count of their draw
+        std::vector<uint32_t> invocation_order(instance_count);
+        for (uint32_t i = 0; i < instance_count; ++i)
+        {
+            invocation_order[i] = i;
+        }
+        std::shuffle(invocation_order.begin(), invocation_order.end(), random_engine);
+
+        std::vector<uint32_t> visible_instance_indices(instance_count, UINT32_MAX);
+        std::vector<float>    margins(instance_count, 0.0f);
+        for (uint32_t instance_index : invocation_order)
+        {
+            if (!cullInstance(frustum_planes, instances[instance_index], margins[instance_index]))
+            {
+                continue;
+            }
+
+            VulkanDrawIndexedIndirectCommand& draw_command = draw_commands[instances[instance_index].draw_index];
+            uint32_t                          slot         = draw_command.instance_count++;
+            visible_instance_indices[draw_command.first_instance + slot] = instance_index;
+        }
+
+        // what the main camera pass draws from the indirect commands against the cpu path
+        std::vector<uint8_t> is_drawn(instance_count, 0);
+        uint32_t             range_error_count = 0;
+        for (size_t draw_index = 0; draw_index < draw_commands.size(); ++draw_index)
+        {
+            const VulkanDrawIndexedIndirectCommand& draw_command = draw_commands[draw_index];
+            if (draw_command.instance_count > draw_instance_counts[draw_index])
+            {
+                ++range_error_count;
+                continue;
+            }
+            for (uint32_t slot = 0; slot < draw_command.instance_count; ++slot)
+            {
+                uint32_t instance_index = visible_instance_indices[draw_command.first_instance + slot];
+                if (instance_index >= instance_count || instances[instance_index].draw_index != draw_index ||
+                    is_drawn[instance_index])
+                {
+                    ++range_error_count;
+                    continue;
+                }
+                is_drawn[instance_index] = 1;
+            }
+        }
+
+        uint32_t mismatch_count = 0;
+        uint32_t boundary_count = 0;
+        uint32_t visible_count  = 0;
+        for (uint32_t i = 0; i < instance_count; ++i)
+        {
+            bool is_visible = TiledFrustumIntersectBox(frustum, world_bounding_boxes[i]);
+            visible_count += is_visible ? 1 : 0;
+            if (is_visible != (is_drawn[i] != 0))
+            {
+                // the two paths round differently, only a box touching a plane may end up on either side
+                if (margins[i] <= 1e-3f * (1.0f + world_bounding_boxes[i].max_bound.length()))
+                {
+                    ++boundary_count;
+                }
+                else
+                {
+                    ++mismatch_count;
+                }
+            }
+        }
+
+        if (range_error_count > 0 || mismatch_count > 0)
+        {
+            reportBenchmarkFailure("mesh_cull.comp differs from the cpu culling on " + std::to_string(mismatch_count) +
+                                   " instances, " + std::to_string(range_error_count) +
+                                   " visible instances out of the range of their draw");
+            return;
+        }
+        std::cout << "  mesh_cull.comp matches the cpu culling on " << instance_count << " instances, "
+                  << visible_count << " visible in " << draw_commands.size() << " draws, " << boundary_count
+                  << " on a plane" << std::endl;
+
+        double cull_ns = runBenchmark("cpu frustum culling", run_count, [&]() {
+            uint32_t visible = 0;
+            for (const BoundingBox& world_bounding_box : world_bounding_boxes)
+            {
+                visible += TiledFrustumIntersectBox(frustum, world_bounding_box) ? 1 : 0;
+            }
+            consumeBenchmarkValue(visible);
+        });
+
+        std::cout << "  per instance: " << cull_ns / instance_count << " ns on the cpu path" << std::endl;
+    }
+} // namespace Piccolo
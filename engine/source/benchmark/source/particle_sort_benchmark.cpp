@@ -0,0 +1,319 @@
+#include "benchmark/include/benchmark.h"
+
+#include "runtime/core/math/math_headers.h"
+#include "runtime/function/particle/particle_sort.h"
+#include "runtime/function/render/render_common.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace Piccolo
+{
+    namespace
+    {
+        // the particle_sort_*.comp shaders run one invocation after the other, with the state ParticlePass fills in,
+        // so that the block histograms, the scan and the chunked scatter are checked against the cpu reference
+
+        struct ParticleSortDispatch
+        {
+            Matrix4x4 view_projection_matrix;
+            float     depth_key_scale {0.0f};
+            float     znear {0.0f};
+            uint32_t  tile_count_x {0};
+            uint32_t  tile_count_y {0};
+            uint32_t  tile_size {0};
+            uint32_t  max_particles_per_tile {0};
+            float     viewport_width {0.0f};
+            float     viewport_height {0.0f};
+        };
+
+        // particle_sort_keys.comp, the slots are handed out in the order the invocations happen to run
+        void dispatchSortKeys(const ParticleSortDispatch&  dispatch,
+                              const std::vector<Vector3>&  positions,
+                              const std::vector<uint32_t>& invocation_order,
+                              std::vector<uint32_t>&       keys_out,
+                              std::vector<uint32_t>&       values_out)
+        {
+            keys_out.clear();
+            values_out.clear();
+            for (uint32_t particle : invocation_order)
+            {
+                Vector4 clip_position = dispatch.view_projection_matrix * Vector4(positions[particle], 1.0f);
+                if (clip_position.w <= 0.0f)
+                {
+                    continue;
+                }
+
+                float screen_x = (clip_position.x / clip_position.w * 0.5f + 0.5f) * dispatch.viewport_width;
+                float screen_y = (clip_position.y / clip_position.w * 0.5f + 0.5f) * dispatch.viewport_height;
+                uint32_t tile_x = static_cast<uint32_t>(Math::clamp(screen_x / static_cast<float>(dispatch.tile_size),
+                                                                    0.0f,
+                                                                    static_cast<float>(dispatch.tile_count_x) - 1.0f));
+                uint32_t tile_y = static_cast<uint32_t>(Math::clamp(screen_y / static_cast<float>(dispatch.tile_size),
+                                                                    0.0f,
+                                                                    static_cast<float>(dispatch.tile_count_y) - 1.0f));
+                uint32_t tile_index = tile_y * dispatch.tile_count_x + tile_x;
+
+                uint32_t depth = static_cast<uint32_t>(
+                    Math::clamp((clip_position.w - dispatch.znear) * dispatch.depth_key_scale, 0.0f, 65535.0f));
+
+                keys_out.push_back((tile_index << 16) | (65535u - depth));
+                values_out.push_back(particle);
+            }
+        }
+
+        // particle_sort_histogram.comp, particle_sort_scan.comp and particle_sort_scatter.comp for one digit
+        void dispatchRadixSortPass(uint32_t                     digit_shift,
+                                   const std::vector<uint32_t>& keys_in,
+                                   const std::vector<uint32_t>& values_in,
+                                   std::vector<uint32_t>&       keys_out,
+                                   std::vector<uint32_t>&       values_out)
+        {
+            uint32_t const key_count   = static_cast<uint32_t>(keys_in.size());
+            uint32_t const block_count = (key_count + s_particle_sort_block_size - 1) / s_particle_sort_block_size;
+
+            // digit major, like the histogram buffer
+            std::vector<uint32_t> histogram(s_particle_sort_group_size * block_count, 0);
+            for (uint32_t block = 0; block < block_count; ++block)
+            {
+                uint32_t first_key = block * s_particle_sort_block_size;
+                uint32_t last_key  = std::min(first_key + s_particle_sort_block_size, key_count);
+                for (uint32_t i = first_key; i < last_key; ++i)
+                {
+                    ++histogram[((keys_in[i] >> digit_shift) & 255u) * block_count + block];
+                }
+            }
+
+            uint32_t offset = 0;
+            for (uint32_t digit = 0; digit < s_particle_sort_group_size; ++digit)
+            {
+                for (uint32_t block = 0; block < block_count; ++block)
+                {
+                    uint32_t count                         = histogram[digit * block_count + block];
+                    histogram[digit * block_count + block] = offset;
+                    offset += count;
+                }
+            }
+
+            keys_out.resize(key_count);
+            values_out.resize(key_count);
+            for (uint32_t block = 0; block < block_count; ++block)
+            {
+                uint32_t digit_offsets[s_particle_sort_group_size];
+                for (uint32_t digit = 0; digit < s_particle_sort_group_size; ++digit)
+                {
+                    digit_offsets[digit] = histogram[digit * block_count + block];
+                }
+
+                uint32_t first_key = block * s_particle_sort_block_size;
+                for (uint32_t chunk = 0; chunk < s_particle_sort_block_size; chunk += s_particle_sort_group_size)
+                {
+                    uint32_t chunk_digits[s_particle_sort_group_size];
+                    uint32_t chunk_digit_counts[s_particle_sort_group_size] = {};
+                    for (uint32_t thread = 0; thread < s_particle_sort_group_size; ++thread)
+                    {
+                        uint32_t key_index   = first_key + chunk + thread;
+                        chunk_digits[thread] = key_index < key_count ? ((keys_in[key_index] >> digit_shift) & 255u) :
+                                                                       s_particle_sort_group_size;
+                    }
+
+                    for (uint32_t thread = 0; thread < s_particle_sort_group_size; ++thread)
+                    {
+                        uint32_t key_index = first_key + chunk + thread;
+                        if (key_index >= key_count)
+                        {
+                            continue;
+                        }
+
+                        uint32_t digit = chunk_digits[thread];
+                        uint32_t rank  = 0;
+                        for (uint32_t i = 0; i < thread; ++i)
+                        {
+                            rank += chunk_digits[i] == digit ? 1 : 0;
+                        }
+
+                        uint32_t slot    = digit_offsets[digit] + rank;
+                        keys_out[slot]   = keys_in[key_index];
+                        values_out[slot] = values_in[key_index];
+                        ++chunk_digit_counts[digit];
+                    }
+
+                    for (uint32_t digit = 0; digit < s_particle_sort_group_size; ++digit)
+                    {
+                        digit_offsets[digit] += chunk_digit_counts[digit];
+                    }
+                }
+            }
+        }
+
+        // particle_sort_bin.comp
+        void dispatchBin(const std::vector<uint32_t>& sorted_keys,
+                         const std::vector<uint32_t>& sorted_values,
+                         uint32_t                     max_particles_per_tile,
+                         std::vector<uint8_t>&        visibility)
+        {
+            uint32_t const key_count = static_cast<uint32_t>(sorted_keys.size());
+            for (uint32_t key_index = 0; key_index < key_count; ++key_index)
+            {
+                uint32_t tile = sorted_keys[key_index] >> 16;
+
+                // the end of the tile
+                uint32_t first = key_index + 1;
+                uint32_t last  = key_count;
+                while (first < last)
+                {
+                    uint32_t middle = (first + last) / 2;
+                    if ((sorted_keys[middle] >> 16) == tile)
+                    {
+                        first = middle + 1;
+                    }
+                    else
+                    {
+                        last = middle;
+                    }
+                }
+
+                visibility[sorted_values[key_index]] = (first - key_index <= max_particles_per_tile) ? 1 : 0;
+            }
+        }
+    } // namespace
+
+    void benchmarkParticleSort()
+    {
+        const uint32_t particle_count = 20000;
+        const uint32_t run_count      = 100;
+
+        ParticleSortView view;
+        view.znear           = 0.1f;
+        view.zfar            = 1000.0f;
+        view.viewport_width  = 1280.0f;
+        view.viewport_height = 720.0f;
+        view.tile_size       = s_particle_sort_tile_size;
+        view.view_projection_matrix =
+            Math::makePerspectiveMatrix(
+                Radian(Math_PI / 3.0f), view.viewport_width / view.viewport_height, view.znear, view.zfar) *
+            Math::makeLookAtMatrix(Vector3(0.0f, 0.0f, 0.0f), Vector3(1.0f, 0.0f, 0.0f), Vector3(0.0f, 0.0f, 1.0f));
+
+        // ParticlePass::sortParticles
+        ParticleSortDispatch dispatch;
+        dispatch.view_projection_matrix = view.view_projection_matrix;
+        dispatch.depth_key_scale        = 65535.0f / (view.zfar - view.znear);
+        dispatch.znear                  = view.znear;
+        dispatch.tile_count_x           = static_cast<uint32_t>(std::ceil(view.viewport_width / view.tile_size));
+        dispatch.tile_count_y           = static_cast<uint32_t>(std::ceil(view.viewport_height / view.tile_size));
+        dispatch.tile_size              = view.tile_size;
+        dispatch.max_particles_per_tile = 8;
+        dispatch.viewport_width         = view.viewport_width;
+        dispatch.viewport_height        = view.viewport_height;
+
+        // a cloud around the camera, some behind it and some off screen, every 16th particle on top of another one
+        // so that equal keys have to keep their order
+        std::mt19937                          random_engine(49);
+        std::uniform_real_distribution<float> forward_distribution(-50.0f, 400.0f);
+        std::uniform_real_distribution<float> side_distribution(-300.0f, 300.0f);
+        std::vector<Vector3>                  positions(particle_count);
+        for (uint32_t particle = 0; particle < particle_count; ++particle)
+        {
+            positions[particle] = (particle % 16 == 15) ?
+                                      positions[random_engine() % particle] :
+                                      Vector3(forward_distribution(random_engine),
+                                              side_distribution(random_engine),
+                                              side_distribution(random_engine));
+        }
+
+        std::vector<uint32_t> invocation_order(particle_count);
+        for (uint32_t particle = 0; particle < particle_count; ++particle)
+        {
+            invocation_order[particle] = particle;
+        }
+        std::shuffle(invocation_order.begin(), invocation_order.end(), random_engine);
+
+        std::vector<uint32_t> keys;
+        std::vector<uint32_t> values;
+        dispatchSortKeys(dispatch, positions, invocation_order, keys, values);
+
+        // the keys, whatever slot they landed in
+        uint32_t mismatch_count = 0;
+        uint32_t sorted_count   = 0;
+        for (uint32_t particle = 0; particle < particle_count; ++particle)
+        {
+            uint32_t key = 0;
+            sorted_count += makeParticleSortKey(view, positions[particle], key) ? 1 : 0;
+        }
+        for (size_t slot = 0; slot < keys.size(); ++slot)
+        {
+            uint32_t key = 0;
+            if (!makeParticleSortKey(view, positions[values[slot]], key) || key != keys[slot])
+            {
+                ++mismatch_count;
+            }
+        }
+        if (mismatch_count > 0 || sorted_count != keys.size())
+        {
+            reportBenchmarkFailure("makeParticleSortKey differs from particle_sort_keys.comp on " +
+                                   std::to_string(mismatch_count) + " keys, " + std::to_string(sorted_count) +
+                                   " particles in front of the camera against " + std::to_string(keys.size()));
+            return;
+        }
+
+        // the order, by tile and from far to near, equal keys in the order they were written
+        std::vector<uint32_t> reference_keys   = keys;
+        std::vector<uint32_t> reference_values = values;
+        std::vector<uint32_t> scratch_keys;
+        std::vector<uint32_t> scratch_values;
+        radixSortParticles(reference_keys, reference_values, scratch_keys, scratch_values, 0, 32);
+
+        std::vector<uint32_t> dispatch_keys   = keys;
+        std::vector<uint32_t> dispatch_values = values;
+        for (uint32_t digit_shift = 0; digit_shift < 32; digit_shift += 8)
+        {
+            dispatchRadixSortPass(digit_shift, dispatch_keys, dispatch_values, scratch_keys, scratch_values);
+            dispatch_keys.swap(scratch_keys);
+            dispatch_values.swap(scratch_values);
+        }
+        if (dispatch_keys != reference_keys || dispatch_values != reference_values)
+        {
+            reportBenchmarkFailure("radixSortParticles differs from the particle_sort_*.comp passes");
+            return;
+        }
+
+        // the visible particles of the crowded tiles
+        std::vector<uint8_t> reference_visibility(particle_count, 0);
+        std::vector<uint8_t> dispatch_visibility(particle_count, 0);
+        binParticles(reference_keys, reference_values, dispatch.max_particles_per_tile, reference_visibility);
+        dispatchBin(dispatch_keys, dispatch_values, dispatch.max_particles_per_tile, dispatch_visibility);
+        if (dispatch_visibility != reference_visibility)
+        {
+            reportBenchmarkFailure("binParticles differs from particle_sort_bin.comp");
+            return;
+        }
+
+        uint32_t visible_count =
+            static_cast<uint32_t>(std::count(reference_visibility.begin(), reference_visibility.end(), 1));
+        std::cout << "  the reference matches the particle_sort_*.comp passes on " << keys.size() << " particles, "
+                  << visible_count << " visible" << std::endl;
+
+        double sort_ns = runBenchmark("keys, radix sort and binning", run_count, [&]() {
+            reference_keys.clear();
+            reference_values.clear();
+            for (uint32_t particle = 0; particle < particle_count; ++particle)
+            {
+                uint32_t key = 0;
+                if (makeParticleSortKey(view, positions[particle], key))
+                {
+                    reference_keys.push_back(key);
+                    reference_values.push_back(particle);
+                }
+            }
+            radixSortParticles(reference_keys, reference_values, scratch_keys, scratch_values, 0, 32);
+            binParticles(reference_keys, reference_values, dispatch.max_particles_per_tile, reference_visibility);
+            consumeBenchmarkValue(reference_visibility[reference_values.back()]);
+        });
+
+        std::cout << "  per particle: " << sort_ns / particle_count << " ns" << std::endl;
+    }
+} // namespace Piccolo
@@ -0,0 +1,96 @@
+#include "benchmark/include/benchmark.h"
+
+#include "runtime/core/meta/reflection/reflection.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace Piccolo
+{
+    void benchmarkReflection()
+    {
+        const uint32_t run_count = 100000;
+
+        // what the editor inspector and the lua bindings look up, from small math types to a whole resource
+        const char* const type_names[] = {"Vector3",
+                                          "Quaternion",
+                                          "Transform",
+                                          "TransformComponent",
+                                          "CameraComponentRes",
+                                          "ObjectDefinitionRes"};
+
+        struct FieldLookup
+        {
+            std::string type_name;
+            std::string field_name;
+        };
+        std::vector<FieldLookup> lookups;
+        for (const char* type_name : type_names)
+        {
+            const Reflection::TypeMeta& meta = Reflection::TypeMeta::newMetaFromName(type_name);
+            if (!meta.isValid() || meta.getFields().empty())
+            {
+                std::cout << "  skipped " << type_name << ", it is not registered" << std::endl;
+                continue;
+            }
+
+            // the last field, so that a linear search by name would have to walk all of them
+            lookups.push_back({type_name, meta.getFields().back().getFieldName()});
+        }
+
+        if (lookups.empty())
+        {
+            std::cout << "  no reflected types are registered" << std::endl;
+            return;
+        }
+
+        double meta_lookup_ns = runBenchmark("meta lookup", run_count, [&]() {
+            for (const FieldLookup& lookup : lookups)
+            {
+                consumeBenchmarkValue(Reflection::TypeMeta::newMetaFromName(lookup.type_name).getTypeId());
+            }
+        });
+
+        double field_walk_ns = runBenchmark("field walk", run_count, [&]() {
+            for (const FieldLookup& lookup : lookups)
+            {
+                const Reflection::TypeMeta& meta = Reflection::TypeMeta::newMetaFromName(lookup.type_name);
+                for (const Reflection::FieldAccessor& field : meta.getFields())
+                {
+                    Reflection::TypeMeta field_type;
+                    consumeBenchmarkValue(field.getTypeMeta(field_type) ? field_type.getTypeId() : 0);
+                }
+            }
+        });
+
+        // the copying accessor list the callers used before getFields, still kept for them
+        double field_list_walk_ns = runBenchmark("field walk through getFieldsList", run_count, [&]() {
+            for (const FieldLookup& lookup : lookups)
+            {
+                Reflection::TypeMeta       meta = Reflection::TypeMeta::newMetaFromName(lookup.type_name);
+                Reflection::FieldAccessor* fields;
+                int const                  field_count = meta.getFieldsList(fields);
+                for (int i = 0; i < field_count; ++i)
+                {
+                    Reflection::TypeMeta field_type;
+                    consumeBenchmarkValue(fields[i].getTypeMeta(field_type) ? field_type.getTypeId() : 0);
+                }
+                delete[] fields;
+            }
+        });
+
+        double name_lookup_ns = runBenchmark("field lookup by name", run_count, [&]() {
+            for (const FieldLookup& lookup : lookups)
+            {
+                const Reflection::TypeMeta& meta = Reflection::TypeMeta::newMetaFromName(lookup.type_name);
+                consumeBenchmarkValue(meta.getFieldByName(lookup.field_name).isValid());
+            }
+        });
+
+        std::cout << "  " << lookups.size() << " types, per type: meta lookup " << meta_lookup_ns / lookups.size()
+                  << " ns, field walk " << field_walk_ns / lookups.size() << " ns ("
+                  << field_list_walk_ns / lookups.size() << " ns copying), name lookup "
+                  << name_lookup_ns / lookups.size() << " ns" << std::endl;
+    }
+} // namespace Piccolo
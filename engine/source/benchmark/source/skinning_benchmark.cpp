@@ -0,0 +1,249 @@
+#include "benchmark/include/benchmark.h"
+
+#include "runtime/core/math/math_headers.h"
+#include "runtime/function/render/render_skinning.h"
+
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace Piccolo
+{
+    namespace
+    {
+        // mesh_skinning.comp written out plainly, a joint row at a time, to check skinMeshVertices against
+        void skinMeshVerticesReference(uint32_t                                                 vertex_count,
+                                       const MeshVertex::VulkanMeshVertexPostition*             positions,
+                                       const MeshVertex::VulkanMeshVertexVaryingEnableBlending* varyings,
+                                       const MeshVertex::VulkanMeshVertexJointBinding*          joint_bindings,
+                                       const VulkanJointMatrix*                                 joints,
+                                       uint32_t                                                 joint_count,
+                                       MeshVertex::VulkanMeshVertexPostition*                   skinned_positions,
+                                       MeshVertex::VulkanMeshVertexVaryingEnableBlending*       skinned_varyings)
+        {
+            for (uint32_t vertex_index = 0; vertex_index < vertex_count; ++vertex_index)
+            {
+                const MeshVertex::VulkanMeshVertexJointBinding& joint_binding = joint_bindings[vertex_index];
+                const float*                                    weights       = &joint_binding.weights.x;
+
+                double rows[3][4] = {};
+                for (uint32_t influence = 0; influence < 4; ++influence)
+                {
+                    int joint_index = joint_binding.indices[influence];
+                    if (weights[influence] <= 0.0f || joint_index <= 0 ||
+                        static_cast<uint32_t>(joint_index) >= joint_count)
+                    {
+                        continue;
+                    }
+
+                    for (uint32_t row = 0; row < 3; ++row)
+                    {
+                        const Vector4& joint_row = joints[joint_index].rows[row];
+                        rows[row][0] += double(joint_row.x) * weights[influence];
+                        rows[row][1] += double(joint_row.y) * weights[influence];
+                        rows[row][2] += double(joint_row.z) * weights[influence];
+                        rows[row][3] += double(joint_row.w) * weights[influence];
+                    }
+                }
+
+                auto transform = [&rows](const Vector3& vector, double w) {
+                    double components[3];
+                    for (uint32_t row = 0; row < 3; ++row)
+                    {
+                        components[row] = rows[row][0] * vector.x + rows[row][1] * vector.y +
+                                          rows[row][2] * vector.z + rows[row][3] * w;
+                    }
+                    return Vector3(float(components[0]), float(components[1]), float(components[2]));
+                };
+
+                skinned_positions[vertex_index].position = transform(positions[vertex_index].position, 1.0);
+
+                Vector3 normal  = transform(varyings[vertex_index].normal, 0.0);
+                Vector3 tangent = transform(varyings[vertex_index].tangent, 0.0);
+                normal.normalise();
+                tangent.normalise();
+                skinned_varyings[vertex_index].normal  = normal;
+                skinned_varyings[vertex_index].tangent = tangent;
+            }
+        }
+
+        bool isNear(const Vector3& value, const Vector3& expected)
+        {
+            // relative to the magnitude, the positions go up to a few hundred units
+            float tolerance = 1e-5f * std::fmax(1.0f, expected.length());
+            return std::fabs(value.x - expected.x) <= tolerance && std::fabs(value.y - expected.y) <= tolerance &&
+                   std::fabs(value.z - expected.z) <= tolerance;
+        }
+
+        struct SkinningMesh
+        {
+            std::vector<MeshVertex::VulkanMeshVertexPostition>             positions;
+            std::vector<MeshVertex::VulkanMeshVertexVaryingEnableBlending> varyings;
+            std::vector<MeshVertex::VulkanMeshVertexJointBinding>          joint_bindings;
+            std::vector<VulkanJointMatrix>                                 joints;
+        };
+
+        // random rigid joints and vertices bound to up to four of them, joint_count - 1 is the last valid index
+        SkinningMesh createSkinningMesh(uint32_t vertex_count, uint32_t joint_count, uint32_t seed)
+        {
+            std::mt19937                          random_engine(seed);
+            std::uniform_real_distribution<float> unit_distribution(-1.0f, 1.0f);
+            std::uniform_real_distribution<float> position_distribution(-200.0f, 200.0f);
+            std::uniform_real_distribution<float> angle_distribution(0.0f, Math_TWO_PI);
+
+            SkinningMesh mesh;
+            mesh.joints.resize(joint_count);
+            for (VulkanJointMatrix& joint : mesh.joints)
+            {
+                Vector3 axis(unit_distribution(random_engine),
+                             unit_distribution(random_engine),
+                             unit_distribution(random_engine));
+                axis.normalise();
+
+                Matrix3x3 rotation;
+                Quaternion(Radian(angle_distribution(random_engine)), axis).toRotationMatrix(rotation);
+                for (uint32_t row = 0; row < 3; ++row)
+                {
+                    joint.rows[row] = Vector4(rotation[row][0],
+                                              rotation[row][1],
+                                              rotation[row][2],
+                                              position_distribution(random_engine));
+                }
+            }
+
+            mesh.positions.resize(vertex_count);
+            mesh.varyings.resize(vertex_count);
+            mesh.joint_bindings.resize(vertex_count);
+            for (uint32_t vertex_index = 0; vertex_index < vertex_count; ++vertex_index)
+            {
+                mesh.positions[vertex_index].position = Vector3(position_distribution(random_engine),
+                                                                position_distribution(random_engine),
+                                                                position_distribution(random_engine));
+                mesh.varyings[vertex_index].normal    = Vector3(unit_distribution(random_engine),
+                                                             unit_distribution(random_engine),
+                                                             unit_distribution(random_engine));
+                mesh.varyings[vertex_index].tangent   = Vector3(unit_distribution(random_engine),
+                                                              unit_distribution(random_engine),
+                                                              unit_distribution(random_engine));
+
+                MeshVertex::VulkanMeshVertexJointBinding& joint_binding = mesh.joint_bindings[vertex_index];
+                float*                                    weights       = &joint_binding.weights.x;
+                float                                     weight_sum    = 0.0f;
+                for (uint32_t influence = 0; influence < 4; ++influence)
+                {
+                    joint_binding.indices[influence] = 1 + random_engine() % (joint_count - 1);
+                    weights[influence]               = std::fabs(unit_distribution(random_engine));
+                    weight_sum += weights[influence];
+                }
+                for (uint32_t influence = 0; influence < 4; ++influence)
+                {
+                    weights[influence] /= weight_sum;
+                }
+            }
+
+            // the influences both paths have to skip: the root joint, an index past the palette, a zero weight
+            if (vertex_count >= 4)
+            {
+                mesh.joint_bindings[0].indices[1] = 0;
+                mesh.joint_bindings[1].indices[2] = joint_count;
+                mesh.joint_bindings[2].weights.w  = 0.0f;
+                mesh.joint_bindings[3].indices[0] = 0;
+                mesh.joint_bindings[3].indices[1] = 0;
+                mesh.joint_bindings[3].indices[2] = 0;
+                mesh.joint_bindings[3].indices[3] = 0;
+            }
+            return mesh;
+        }
+    } // namespace
+
+    void benchmarkSkinning()
+    {
+        // the check: a small mesh through skinMeshVertices, the sse path where it is compiled in, and the reference
+        {
+            const uint32_t vertex_count = 64;
+            const uint32_t joint_count  = 8;
+
+            SkinningMesh mesh = createSkinningMesh(vertex_count, joint_count, 46);
+
+            std::vector<MeshVertex::VulkanMeshVertexPostition>             skinned_positions(vertex_count);
+            std::vector<MeshVertex::VulkanMeshVertexVaryingEnableBlending> skinned_varyings(vertex_count);
+            skinMeshVertices(vertex_count,
+                             mesh.positions.data(),
+                             mesh.varyings.data(),
+                             mesh.joint_bindings.data(),
+                             mesh.joints.data(),
+                             joint_count,
+                             skinned_positions.data(),
+                             skinned_varyings.data());
+
+            std::vector<MeshVertex::VulkanMeshVertexPostition>             expected_positions(vertex_count);
+            std::vector<MeshVertex::VulkanMeshVertexVaryingEnableBlending> expected_varyings(vertex_count);
+            skinMeshVerticesReference(vertex_count,
+                                      mesh.positions.data(),
+                                      mesh.varyings.data(),
+                                      mesh.joint_bindings.data(),
+                                      mesh.joints.data(),
+                                      joint_count,
+                                      expected_positions.data(),
+                                      expected_varyings.data());
+
+            uint32_t mismatch_count = 0;
+            for (uint32_t vertex_index = 0; vertex_index < vertex_count; ++vertex_index)
+            {
+                if (!isNear(skinned_positions[vertex_index].position, expected_positions[vertex_index].position) ||
+                    !isNear(skinned_varyings[vertex_index].normal, expected_varyings[vertex_index].normal) ||
+                    !isNear(skinned_varyings[vertex_index].tangent, expected_varyings[vertex_index].tangent))
+                {
+                    ++mismatch_count;
+                }
+            }
+
+            if (mismatch_count > 0)
+            {
+                reportBenchmarkFailure("skinMeshVertices differs from the reference on " +
+                                       std::to_string(mismatch_count) + " of " + std::to_string(vertex_count) +
+                                       " vertices");
+                return;
+            }
+            std::cout << "  skinMeshVertices matches the reference on " << vertex_count << " vertices" << std::endl;
+        }
+
+        const uint32_t vertex_count = 20000;
+        const uint32_t joint_count  = 64;
+        const uint32_t run_count    = 100;
+
+        SkinningMesh mesh = createSkinningMesh(vertex_count, joint_count, 46);
+
+        std::vector<MeshVertex::VulkanMeshVertexPostition>             skinned_positions(vertex_count);
+        std::vector<MeshVertex::VulkanMeshVertexVaryingEnableBlending> skinned_varyings(vertex_count);
+
+        double reference_ns = runBenchmark("reference", run_count, [&]() {
+            skinMeshVerticesReference(vertex_count,
+                                      mesh.positions.data(),
+                                      mesh.varyings.data(),
+                                      mesh.joint_bindings.data(),
+                                      mesh.joints.data(),
+                                      joint_count,
+                                      skinned_positions.data(),
+                                      skinned_varyings.data());
+            consumeBenchmarkValue(skinned_positions.back().position.x > 0.0f);
+        });
+
+        double skinning_ns = runBenchmark("skinMeshVertices", run_count, [&]() {
+            skinMeshVertices(vertex_count,
+                             mesh.positions.data(),
+                             mesh.varyings.data(),
+                             mesh.joint_bindings.data(),
+                             mesh.joints.data(),
+                             joint_count,
+                             skinned_positions.data(),
+                             skinned_varyings.data());
+            consumeBenchmarkValue(skinned_positions.back().position.x > 0.0f);
+        });
+
+        std::cout << "  per vertex: " << reference_ns / vertex_count << " ns reference, "
+                  << skinning_ns / vertex_count << " ns skinMeshVertices" << std::endl;
+    }
+} // namespace Piccolo
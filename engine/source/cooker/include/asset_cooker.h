@@ -0,0 +1,67 @@
+#pragma once
+
+#include "runtime/resource/res_type/common/cooked_manifest.h"
+
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Piccolo
+{
+    struct AssetCookerOptions
+    {
+        // cook every asset even when the manifest says it is up to date
+        bool force_rebuild {false};
+    };
+
+    // walks the asset folder, writes the binary form of every asset it knows next to the source file and records
+    // the content hash and the dependencies of each one in the manifest read by AssetManager
+    class AssetCooker
+    {
+    public:
+        // bump when a cooker changes its output without changing its format hash
+        static constexpr int s_cooker_version = 1;
+
+        explicit AssetCooker(const AssetCookerOptions& options);
+
+        // false when an asset failed to cook, the manifest is written anyway without the failed assets
+        bool cook();
+
+    private:
+        struct Cooker
+        {
+            std::string name;
+            std::string format_hash;
+            // cooks source_url to AssetManager::getCookedPath(source_url)
+            std::function<bool(const std::string& source_url)> cook;
+        };
+
+        struct CookJob
+        {
+            std::string    source_url;
+            const Cooker*  cooker {nullptr};
+            CookedAssetRes result;
+            bool           is_rebuilt {false};
+            bool           is_succeeded {false};
+        };
+
+        template<typename AssetType>
+        void registerReflectedCooker(const std::string& suffix, const std::string& name);
+        void registerCookers();
+
+        const Cooker* findCooker(const std::string& source_url) const;
+        bool          isUpToDate(const CookJob& job, const CookedAssetRes* previous) const;
+        void          runJob(CookJob& job, const CookedAssetRes* previous) const;
+
+        static std::string              hashFile(const std::filesystem::path& path);
+        static std::vector<std::string> findDependencies(const std::filesystem::path& path);
+
+    private:
+        AssetCookerOptions m_options;
+
+        // file name suffix to cooker, the longest matching suffix wins
+        std::vector<std::pair<std::string, Cooker>> m_cookers;
+    };
+} // namespace Piccolo
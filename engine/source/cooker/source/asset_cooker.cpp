@@ -0,0 +1,375 @@
+#include "cooker/include/asset_cooker.h"
+
+#include "runtime/core/base/macro.h"
+#include "runtime/core/job/job_system.h"
+
+#include "runtime/platform/file_service/file_service.h"
+
+#include "runtime/resource/asset_manager/asset_manager.h"
+#include "runtime/resource/config_manager/config_manager.h"
+#include "runtime/resource/res_type/common/level.h"
+#include "runtime/resource/res_type/common/object.h"
+#include "runtime/resource/res_type/common/world.h"
+#include "runtime/resource/res_type/data/animation_clip.h"
+#include "runtime/resource/res_type/data/animation_skeleton_node_map.h"
+#include "runtime/resource/res_type/data/material.h"
+#include "runtime/resource/res_type/data/mesh_data.h"
+#include "runtime/resource/res_type/data/skeleton_data.h"
+#include "runtime/resource/res_type/data/skeleton_mask.h"
+#include "runtime/resource/res_type/global/global_particle.h"
+#include "runtime/resource/res_type/global/global_rendering.h"
+
+#include "runtime/function/global/global_context.h"
+#include "runtime/function/render/render_cooked_asset.h"
+#include "runtime/function/render/render_resource_base.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+
+namespace Piccolo
+{
+    namespace
+    {
+        std::string toHexString(uint64_t value)
+        {
+            char text[17];
+            std::snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(value));
+            return text;
+        }
+
+        bool endsWith(const std::string& text, const std::string& suffix)
+        {
+            return text.size() >= suffix.size() &&
+                   text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+        }
+
+        bool cookTexture(const std::string& source_url, bool is_hdr)
+        {
+            std::shared_ptr<AssetManager> asset_manager = g_runtime_global_context.m_asset_manager;
+
+            // the same pixel layouts as RenderResourceBase::loadTexture and loadTextureHDR
+            std::shared_ptr<TextureData> texture =
+                RenderResourceBase::decodeTexture(asset_manager->getFullPath(source_url).generic_string(), 4, is_hdr);
+            if (!texture)
+            {
+                LOG_ERROR("decode texture {} failed!", source_url);
+                return false;
+            }
+
+            return CookedRenderAsset::saveTexture(
+                asset_manager->getCookedPath(source_url), *texture, 4, is_hdr ? sizeof(float) : sizeof(uint8_t));
+        }
+
+        bool cookObjMesh(const std::string& source_url)
+        {
+            std::shared_ptr<AssetManager> asset_manager = g_runtime_global_context.m_asset_manager;
+
+            AxisAlignedBox bounding_box;
+            StaticMeshData mesh_data =
+                RenderResourceBase::loadStaticMesh(asset_manager->getFullPath(source_url).generic_string(), bounding_box);
+            if (!mesh_data.m_vertex_buffer || !mesh_data.m_index_buffer)
+            {
+                LOG_ERROR("load mesh {} failed!", source_url);
+                return false;
+            }
+
+            return CookedRenderAsset::saveStaticMesh(asset_manager->getCookedPath(source_url), mesh_data, bounding_box);
+        }
+
+        void collectDependencies(const Json& json, std::vector<std::string>& dependencies)
+        {
+            static const char* const s_asset_extensions[] = {".json", ".obj", ".png", ".jpg", ".tga", ".hdr", ".HDR"};
+
+            if (json.is_string())
+            {
+                const std::string& text = json.string_value();
+                for (const char* extension : s_asset_extensions)
+                {
+                    if (endsWith(text, extension))
+                    {
+                        dependencies.push_back(text);
+                        break;
+                    }
+                }
+            }
+            else if (json.is_array())
+            {
+                for (const Json& element : json.array_items())
+                {
+                    collectDependencies(element, dependencies);
+                }
+            }
+            else if (json.is_object())
+            {
+                for (const auto& item : json.object_items())
+                {
+                    collectDependencies(item.second, dependencies);
+                }
+            }
+        }
+    } // namespace
+
+    AssetCooker::AssetCooker(const AssetCookerOptions& options) : m_options(options) { registerCookers(); }
+
+    template<typename AssetType>
+    void AssetCooker::registerReflectedCooker(const std::string& suffix, const std::string& name)
+    {
+        Cooker cooker;
+        cooker.name        = name;
+        // the polymorphic pointees are not part of the schema hash of the asset, any registered class may be one
+        cooker.format_hash = toHexString(Serializer::combineBinarySchemaHash(
+            Serializer::getBinarySchemaHash<AssetType>(), Reflection::TypeMeta::getRegisteredBinarySchemaHash()));
+        cooker.cook        = [](const std::string& source_url) {
+            std::shared_ptr<AssetManager> asset_manager = g_runtime_global_context.m_asset_manager;
+
+            // the json dom path leaves the asset untouched on a malformed file instead of cooking half of it
+            AssetType asset;
+            return asset_manager->loadAsset(source_url, asset, AssetLoadMode::json_dom) &&
+                   asset_manager->saveCookedAsset(asset, source_url);
+        };
+        m_cookers.emplace_back(suffix, std::move(cooker));
+    }
+
+    void AssetCooker::registerCookers()
+    {
+        registerReflectedCooker<ObjectDefinitionRes>(".object.json", "object");
+        registerReflectedCooker<LevelRes>(".level.json", "level");
+        registerReflectedCooker<WorldRes>(".world.json", "world");
+        registerReflectedCooker<MaterialRes>(".material.json", "material");
+        registerReflectedCooker<MeshData>(".mesh.json", "skinned_mesh");
+        registerReflectedCooker<AnimationAsset>(".animation_clip.json", "animation_clip");
+        registerReflectedCooker<SkeletonData>(".skeleton.json", "skeleton");
+        registerReflectedCooker<AnimSkelMap>(".skeleton_map.json", "skeleton_map");
+        registerReflectedCooker<BoneBlendMask>(".skeleton_mask.json", "skeleton_mask");
+        registerReflectedCooker<GlobalRenderingRes>("rendering.global.json", "global_rendering");
+        registerReflectedCooker<GlobalParticleRes>("particle.global.json", "global_particle");
+
+        const std::string texture_format     = toHexString(CookedRenderAsset::s_texture_format);
+        const std::string static_mesh_format = toHexString(CookedRenderAsset::s_static_mesh_format);
+
+        for (const char* suffix : {".png", ".jpg", ".tga"})
+        {
+            m_cookers.emplace_back(suffix, Cooker {"texture", texture_format, [](const std::string& source_url) {
+                                                       return cookTexture(source_url, false);
+                                                   }});
+        }
+        for (const char* suffix : {".hdr", ".HDR"})
+        {
+            m_cookers.emplace_back(suffix, Cooker {"texture_hdr", texture_format, [](const std::string& source_url) {
+                                                       return cookTexture(source_url, true);
+                                                   }});
+        }
+        m_cookers.emplace_back(".obj", Cooker {"static_mesh", static_mesh_format, cookObjMesh});
+
+        std::sort(m_cookers.begin(), m_cookers.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.first.size() > rhs.first.size();
+        });
+    }
+
+    const AssetCooker::Cooker* AssetCooker::findCooker(const std::string& source_url) const
+    {
+        for (const auto& cooker : m_cookers)
+        {
+            if (endsWith(source_url, cooker.first))
+            {
+                return &cooker.second;
+            }
+        }
+        return nullptr;
+    }
+
+    std::string AssetCooker::hashFile(const std::filesystem::path& path)
+    {
+        MappedFile file;
+        if (!file.open(path))
+        {
+            return std::string();
+        }
+
+        // FNV-1a, enough to tell an edited file from an untouched one
+        uint64_t    hash = 0xcbf29ce484222325ULL;
+        const char* data = file.data();
+        for (size_t i = 0; i < file.size(); ++i)
+        {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= 0x100000001b3ULL;
+        }
+        return toHexString(hash) + "-" + std::to_string(file.size());
+    }
+
+    std::vector<std::string> AssetCooker::findDependencies(const std::filesystem::path& path)
+    {
+        std::vector<std::string> dependencies;
+        if (path.extension() != ".json")
+        {
+            return dependencies;
+        }
+
+        MappedFile file;
+        if (!file.open(path))
+        {
+            return dependencies;
+        }
+
+        std::string error;
+        Json        json = Json::parse(std::string(file.data(), file.size()), error);
+        if (!error.empty())
+        {
+            return dependencies;
+        }
+
+        collectDependencies(json, dependencies);
+        std::sort(dependencies.begin(), dependencies.end());
+        dependencies.erase(std::unique(dependencies.begin(), dependencies.end()), dependencies.end());
+        return dependencies;
+    }
+
+    bool AssetCooker::isUpToDate(const CookJob& job, const CookedAssetRes* previous) const
+    {
+        if (m_options.force_rebuild || !previous)
+        {
+            return false;
+        }
+
+        return previous->m_content_hash == job.result.m_content_hash && previous->m_cooker == job.result.m_cooker &&
+               previous->m_format_hash == job.result.m_format_hash &&
+               previous->m_cooked_url == job.result.m_cooked_url &&
+               std::filesystem::exists(g_runtime_global_context.m_asset_manager->getFullPath(job.result.m_cooked_url));
+    }
+
+    void AssetCooker::runJob(CookJob& job, const CookedAssetRes* previous) const
+    {
+        std::shared_ptr<AssetManager> asset_manager = g_runtime_global_context.m_asset_manager;
+        std::filesystem::path         source_path   = asset_manager->getFullPath(job.source_url);
+
+        job.result.m_source_url   = job.source_url;
+        job.result.m_cooked_url   = asset_manager->getCookedPath(job.source_url)
+                                      .lexically_relative(g_runtime_global_context.m_config_manager->getRootFolder())
+                                      .generic_string();
+        job.result.m_cooker       = job.cooker->name;
+        job.result.m_format_hash  = job.cooker->format_hash;
+        job.result.m_content_hash = hashFile(source_path);
+
+        if (isUpToDate(job, previous))
+        {
+            job.result.m_dependencies = previous->m_dependencies;
+            job.is_succeeded          = true;
+            return;
+        }
+
+        job.result.m_dependencies = findDependencies(source_path);
+        job.is_rebuilt            = true;
+        job.is_succeeded          = !job.result.m_content_hash.empty() && job.cooker->cook(job.source_url);
+        if (!job.is_succeeded)
+        {
+            LOG_ERROR("cook asset {} failed!", job.source_url);
+        }
+    }
+
+    bool AssetCooker::cook()
+    {
+        std::shared_ptr<AssetManager>  asset_manager  = g_runtime_global_context.m_asset_manager;
+        std::shared_ptr<ConfigManager> config_manager = g_runtime_global_context.m_config_manager;
+
+        const std::string& manifest_url = config_manager->getCookedManifestUrl();
+        if (manifest_url.empty())
+        {
+            LOG_ERROR("no CookedManifest in the config file, nothing to cook");
+            return false;
+        }
+
+        auto start_time = std::chrono::steady_clock::now();
+
+        // the previous manifest tells which assets are unchanged since they were cooked
+        CookedManifestRes previous_manifest;
+        if (std::filesystem::exists(asset_manager->getFullPath(manifest_url)))
+        {
+            asset_manager->loadAsset(manifest_url, previous_manifest, AssetLoadMode::json_dom);
+        }
+        std::unordered_map<std::string, const CookedAssetRes*> previous_assets;
+        if (previous_manifest.m_cooker_version == s_cooker_version)
+        {
+            for (const CookedAssetRes& previous_asset : previous_manifest.m_assets)
+            {
+                previous_assets[previous_asset.m_source_url] = &previous_asset;
+            }
+        }
+
+        std::vector<CookJob> jobs;
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(config_manager->getAssetFolder()))
+        {
+            if (!entry.is_regular_file())
+            {
+                continue;
+            }
+
+            std::string source_url =
+                entry.path().lexically_relative(config_manager->getRootFolder()).generic_string();
+            const Cooker* cooker = findCooker(source_url);
+            if (!cooker || source_url == manifest_url)
+            {
+                continue;
+            }
+
+            CookJob job;
+            job.source_url = source_url;
+            job.cooker     = cooker;
+            jobs.push_back(std::move(job));
+        }
+        std::sort(jobs.begin(), jobs.end(), [](const CookJob& lhs, const CookJob& rhs) {
+            return lhs.source_url < rhs.source_url;
+        });
+
+        std::vector<std::function<void()>> job_functions;
+        job_functions.reserve(jobs.size());
+        for (CookJob& job : jobs)
+        {
+            auto                  iter     = previous_assets.find(job.source_url);
+            const CookedAssetRes* previous = iter != previous_assets.end() ? iter->second : nullptr;
+            job_functions.emplace_back([this, &job, previous]() { runJob(job, previous); });
+        }
+        g_runtime_global_context.m_job_system->parallelRun(job_functions);
+
+        CookedManifestRes manifest;
+        manifest.m_cooker_version = s_cooker_version;
+
+        size_t rebuilt_count = 0;
+        size_t failed_count  = 0;
+        for (CookJob& job : jobs)
+        {
+            if (!job.is_succeeded)
+            {
+                ++failed_count;
+                continue;
+            }
+            rebuilt_count += job.is_rebuilt ? 1 : 0;
+            manifest.m_assets.push_back(std::move(job.result));
+        }
+
+        // dependencies are only recorded, a missing one is reported because the runtime would fail to load it
+        for (const CookedAssetRes& cooked_asset : manifest.m_assets)
+        {
+            for (const std::string& dependency : cooked_asset.m_dependencies)
+            {
+                if (!std::filesystem::exists(asset_manager->getFullPath(dependency)))
+                {
+                    LOG_WARN("{} references {} which does not exist", cooked_asset.m_source_url, dependency);
+                }
+            }
+        }
+
+        bool is_manifest_saved = asset_manager->saveAsset(manifest, manifest_url);
+
+        auto elapsed_ms =
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count();
+        LOG_INFO("cooked {} assets, {} up to date, {} failed, {} ms",
+                 rebuilt_count,
+                 manifest.m_assets.size() - rebuilt_count,
+                 failed_count,
+                 elapsed_ms);
+
+        return is_manifest_saved && failed_count == 0;
+    }
+} // namespace Piccolo
@@ -0,0 +1,48 @@
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+#include "runtime/core/meta/reflection/reflection_register.h"
+#include "runtime/function/global/global_context.h"
+
+#include "cooker/include/asset_cooker.h"
+
+int main(int argc, char** argv)
+{
+    std::filesystem::path executable_path(argv[0]);
+    std::filesystem::path config_file_path = executable_path.parent_path() / "PiccoloEditor.ini";
+
+    Piccolo::AssetCookerOptions options;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--force") == 0)
+        {
+            options.force_rebuild = true;
+        }
+        else if (std::strcmp(argv[i], "--config") == 0 && i + 1 < argc)
+        {
+            config_file_path = argv[++i];
+        }
+        else
+        {
+            std::cerr << "usage: " << executable_path.filename().generic_string()
+                      << " [--force] [--config <PiccoloEditor.ini>]" << std::endl;
+            return 2;
+        }
+    }
+
+    Piccolo::Reflection::TypeMetaRegister::metaRegister();
+    Piccolo::g_runtime_global_context.startHeadlessSystems(config_file_path.generic_string());
+
+    bool is_succeeded = false;
+    {
+        Piccolo::AssetCooker cooker(options);
+        is_succeeded = cooker.cook();
+    }
+
+    Piccolo::g_runtime_global_context.shutdownSystems();
+    Piccolo::Reflection::TypeMetaRegister::metaUnregister();
+
+    return is_succeeded ? 0 : 1;
+}
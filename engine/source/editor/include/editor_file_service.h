@@ -1,7 +1,10 @@
 #pragma once
 
+#include <cstdint>
+#include <filesystem>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace Piccolo
@@ -9,6 +12,8 @@ namespace Piccolo
     class EditorFileNode;
     using EditorFileNodeArray = std::vector<std::shared_ptr<EditorFileNode>>;
 
+    struct FileChangeEvent;
+
     struct EditorFileNode
     {
         std::string         m_file_name;
@@ -22,18 +27,27 @@ namespace Piccolo
         {}
     };
 
+    // the tree of the asset folder, built once and then patched with the changes the file watcher reports
     class EditorFileService
     {
-        EditorFileNodeArray m_file_node_array;
-        EditorFileNode      m_root_node{ "asset", "Folder", "asset", -1 };
+        // keyed by the path relative to the asset folder, the root node is keyed by an empty path
+        std::unordered_map<std::string, std::shared_ptr<EditorFileNode>> m_file_node_map;
+        EditorFileNode                                                   m_root_node{ "asset", "Folder", "asset", -1 };
+        std::filesystem::path                                            m_asset_folder;
+        uint32_t                                                         m_file_listener_id {0};
 
     private:
-        EditorFileNode* getParentNodePtr(EditorFileNode* file_node);
-        bool            checkFileArray(EditorFileNode* file_node);
+        void addFileNode(const std::filesystem::path& file_path);
+        void removeFileNode(const std::string& relative_path);
+        void eraseSubtree(const std::string& relative_path, const std::shared_ptr<EditorFileNode>& file_node);
+        void onFilesChanged(const std::vector<FileChangeEvent>& events);
 
     public:
-        EditorFileNode* getEditorRootNode() { return m_file_node_array.empty() ? nullptr : m_file_node_array[0].get(); }
+        ~EditorFileService();
+
+        EditorFileNode* getEditorRootNode();
 
+        void initialize();
         void buildEngineFileTree();
     };
 } // namespace Piccolo
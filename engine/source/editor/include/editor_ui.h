@@ -49,7 +49,6 @@ namespace Piccolo
         std::unordered_map<std::string, std::function<void(std::string, void*)>> m_editor_ui_creator;
         std::unordered_map<std::string, unsigned int>                            m_new_object_index_map;
         EditorFileService                                                        m_editor_file_service;
-        std::chrono::time_point<std::chrono::steady_clock>                       m_last_file_tree_update;
 
         bool m_editor_menu_window_open       = true;
         bool m_asset_window_open             = true;
@@ -1,6 +1,7 @@
 #include "editor/include/editor_file_service.h"
 
 #include "runtime/platform/file_service/file_service.h"
+#include "runtime/platform/file_watcher/file_watcher.h"
 #include "runtime/platform/path/path.h"
 
 #include "runtime/resource/asset_manager/asset_manager.h"
@@ -8,6 +9,8 @@
 
 #include "runtime/function/global/global_context.h"
 
+#include <algorithm>
+
 namespace Piccolo
 {
     /// helper function: split the input string with separator, and filter the substring
@@ -43,100 +46,188 @@ namespace Piccolo
         return output_string;
     }
 
-    void EditorFileService::buildEngineFileTree()
+    EditorFileService::~EditorFileService()
     {
-        std::string                              asset_folder = g_runtime_global_context.m_config_manager->getAssetFolder().generic_string();
-        const std::vector<std::filesystem::path> file_paths = g_runtime_global_context.m_file_system->getFiles(asset_folder);
-        std::vector<std::vector<std::string>>    all_file_segments;
-        for (const auto& path : file_paths)
+        if (m_file_listener_id != 0 && g_runtime_global_context.m_file_watcher)
         {
-            const std::filesystem::path& relative_path = Path::getRelativePath(asset_folder, path);
-            all_file_segments.emplace_back(Path::getPathSegments(relative_path));
+            g_runtime_global_context.m_file_watcher->removeListener(m_file_listener_id);
         }
+    }
+
+    EditorFileNode* EditorFileService::getEditorRootNode()
+    {
+        auto iter = m_file_node_map.find(std::string());
+        return iter == m_file_node_map.end() ? nullptr : iter->second.get();
+    }
+
+    void EditorFileService::initialize()
+    {
+        m_asset_folder = g_runtime_global_context.m_config_manager->getAssetFolder();
+        buildEngineFileTree();
 
-        std::vector<std::shared_ptr<EditorFileNode>> node_array;
+        m_file_listener_id = g_runtime_global_context.m_file_watcher->addListener(
+            [this](const std::vector<FileChangeEvent>& events) { onFilesChanged(events); });
+    }
 
-        m_file_node_array.clear();
+    void EditorFileService::buildEngineFileTree()
+    {
+        m_file_node_map.clear();
         auto root_node = std::make_shared<EditorFileNode>();
         *root_node     = m_root_node;
-        m_file_node_array.push_back(root_node);
+        m_file_node_map.emplace(std::string(), root_node);
 
-        int all_file_segments_count = all_file_segments.size();
-        for (int file_index = 0; file_index < all_file_segments_count; file_index++)
+        const std::vector<std::filesystem::path> file_paths =
+            g_runtime_global_context.m_file_system->getFiles(m_asset_folder);
+        for (const auto& path : file_paths)
         {
-            int depth = 0;
-            node_array.clear();
-            node_array.push_back(root_node);
-            int file_segment_count = all_file_segments[file_index].size();
-            for (int file_segment_index = 0; file_segment_index < file_segment_count; file_segment_index++)
+            addFileNode(path);
+        }
+    }
+
+    void EditorFileService::onFilesChanged(const std::vector<FileChangeEvent>& events)
+    {
+        const std::filesystem::path asset_folder = std::filesystem::absolute(m_asset_folder).lexically_normal();
+        for (const FileChangeEvent& event : events)
+        {
+            if (event.type == FileChangeType::rescan)
             {
-                auto file_node         = std::make_shared<EditorFileNode>();
-                file_node->m_file_name = all_file_segments[file_index][file_segment_index];
-                if (depth < file_segment_count - 1)
-                {
-                    file_node->m_file_type = "Folder";
-                }
-                else
-                {
-                    const auto& extensions = Path::getFileExtensions(file_paths[file_index]);
-                    file_node->m_file_type = std::get<0>(extensions);
-                    if (file_node->m_file_type.size() == 0)
-                        continue;
-
-                    if (file_node->m_file_type.compare(".json") == 0)
-                    {
-                        file_node->m_file_type = std::get<1>(extensions);
-                        if (file_node->m_file_type.compare(".component") == 0)
-                        {
-                            file_node->m_file_type = std::get<2>(extensions) + std::get<1>(extensions);
-                        }
-                    }
-                    file_node->m_file_type = file_node->m_file_type.substr(1);
-                    file_node->m_file_path = file_paths[file_index].generic_string();
-                }
-                file_node->m_node_depth = depth;
-                node_array.push_back(file_node);
+                buildEngineFileTree();
+                return;
+            }
 
-                bool node_exists = checkFileArray(file_node.get());
-                if (node_exists == false)
-                {
-                    m_file_node_array.push_back(file_node);
-                }
-                EditorFileNode* parent_node_ptr = getParentNodePtr(node_array[depth].get());
-                if (parent_node_ptr != nullptr && node_exists == false)
-                {
-                    parent_node_ptr->m_child_nodes.push_back(file_node);
-                }
-                depth++;
+            // folders show up with their first file and go away with their last one
+            const std::filesystem::path relative_path =
+                Path::getRelativePath(asset_folder, event.path.lexically_normal());
+            if (relative_path.empty() || *relative_path.begin() == "..")
+            {
+                continue;
+            }
+
+            if (event.type == FileChangeType::removed)
+            {
+                removeFileNode(relative_path.generic_string());
+            }
+            else if (!event.is_directory &&
+                     m_file_node_map.find(relative_path.generic_string()) == m_file_node_map.end())
+            {
+                addFileNode(m_asset_folder / relative_path);
             }
         }
     }
 
-    bool EditorFileService::checkFileArray(EditorFileNode* file_node)
+    void EditorFileService::addFileNode(const std::filesystem::path& file_path)
     {
-        int editor_node_count = m_file_node_array.size();
-        for (int file_node_index = 0; file_node_index < editor_node_count; file_node_index++)
+        const std::vector<std::string> file_segments =
+            Path::getPathSegments(Path::getRelativePath(m_asset_folder, file_path));
+        if (file_segments.empty())
+        {
+            return;
+        }
+
+        const auto& extensions = Path::getFileExtensions(file_path);
+        std::string file_type  = std::get<0>(extensions);
+        if (file_type.size() == 0)
+            return;
+
+        // a plain .json file keeps its extension as type
+        if (file_type.compare(".json") == 0 && !std::get<1>(extensions).empty())
         {
-            if (m_file_node_array[file_node_index]->m_file_name == file_node->m_file_name &&
-                m_file_node_array[file_node_index]->m_node_depth == file_node->m_node_depth)
+            file_type = std::get<1>(extensions);
+            if (file_type.compare(".component") == 0)
             {
-                return true;
+                file_type = std::get<2>(extensions) + std::get<1>(extensions);
             }
         }
-        return false;
+        file_type = file_type.substr(1);
+
+        std::shared_ptr<EditorFileNode> parent_node = m_file_node_map[std::string()];
+        std::string                     relative_path;
+        int                             file_segment_count = file_segments.size();
+        for (int depth = 0; depth < file_segment_count; depth++)
+        {
+            if (depth > 0)
+            {
+                relative_path += "/";
+            }
+            relative_path += file_segments[depth];
+
+            auto iter = m_file_node_map.find(relative_path);
+            if (iter != m_file_node_map.end())
+            {
+                parent_node = iter->second;
+                continue;
+            }
+
+            auto file_node          = std::make_shared<EditorFileNode>();
+            file_node->m_file_name  = file_segments[depth];
+            file_node->m_node_depth = depth;
+            if (depth < file_segment_count - 1)
+            {
+                file_node->m_file_type = "Folder";
+            }
+            else
+            {
+                file_node->m_file_type = file_type;
+                file_node->m_file_path = file_path.generic_string();
+            }
+
+            // children are kept sorted by name, so that the order does not depend on when a file showed up
+            EditorFileNodeArray& child_nodes = parent_node->m_child_nodes;
+            child_nodes.insert(std::upper_bound(child_nodes.begin(),
+                                                child_nodes.end(),
+                                                file_node,
+                                                [](const std::shared_ptr<EditorFileNode>& lhs,
+                                                   const std::shared_ptr<EditorFileNode>& rhs) {
+                                                    return lhs->m_file_name < rhs->m_file_name;
+                                                }),
+                               file_node);
+            m_file_node_map.emplace(relative_path, file_node);
+            parent_node = file_node;
+        }
     }
 
-    EditorFileNode* EditorFileService::getParentNodePtr(EditorFileNode* file_node)
+    void EditorFileService::removeFileNode(const std::string& relative_path)
     {
-        int editor_node_count = m_file_node_array.size();
-        for (int file_node_index = 0; file_node_index < editor_node_count; file_node_index++)
+        auto iter = m_file_node_map.find(relative_path);
+        if (iter == m_file_node_map.end())
+        {
+            return;
+        }
+        std::shared_ptr<EditorFileNode> file_node = iter->second;
+        eraseSubtree(relative_path, file_node);
+
+        // drop the node from its parent and every folder which is left empty
+        std::string child_path = relative_path;
+        while (!child_path.empty())
         {
-            if (m_file_node_array[file_node_index]->m_file_name == file_node->m_file_name &&
-                m_file_node_array[file_node_index]->m_node_depth == file_node->m_node_depth)
+            size_t      separator   = child_path.find_last_of('/');
+            std::string parent_path = separator == std::string::npos ? std::string() : child_path.substr(0, separator);
+            std::string child_name  = separator == std::string::npos ? child_path : child_path.substr(separator + 1);
+
+            EditorFileNodeArray& child_nodes = m_file_node_map[parent_path]->m_child_nodes;
+            child_nodes.erase(std::remove_if(child_nodes.begin(),
+                                             child_nodes.end(),
+                                             [&child_name](const std::shared_ptr<EditorFileNode>& child_node) {
+                                                 return child_node->m_file_name == child_name;
+                                             }),
+                              child_nodes.end());
+            if (!child_nodes.empty() || parent_path.empty())
             {
-                return m_file_node_array[file_node_index].get();
+                break;
             }
+
+            m_file_node_map.erase(parent_path);
+            child_path = parent_path;
+        }
+    }
+
+    void EditorFileService::eraseSubtree(const std::string&                     relative_path,
+                                         const std::shared_ptr<EditorFileNode>& file_node)
+    {
+        for (const auto& child_node : file_node->m_child_nodes)
+        {
+            eraseSubtree(relative_path + "/" + child_node->m_file_name, child_node);
         }
-        return nullptr;
+        m_file_node_map.erase(relative_path);
     }
 } // namespace Piccolo
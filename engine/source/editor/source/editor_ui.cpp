@@ -452,12 +452,8 @@ namespace Piccolo
 
     void EditorUI::createLeafNodeUI(Reflection::ReflectionInstance& instance)
     {
-        Reflection::FieldAccessor* fields;
-        int                        fields_count = instance.m_meta.getFieldsList(fields);
-
-        for (size_t index = 0; index < fields_count; index++)
+        for (const Reflection::FieldAccessor& field : instance.m_meta.getFields())
         {
-            auto field = fields[index];
             if (field.isArrayType())
             {
                 Reflection::ArrayAccessor array_accessor;
@@ -523,7 +519,6 @@ namespace Piccolo
                                                                      field.get(instance.m_instance));
             }
         }
-        delete[] fields;
     }
 
     void EditorUI::showEditorDetailWindow(bool* p_open)
@@ -596,16 +591,12 @@ namespace Piccolo
             ImGui::TableSetupColumn("Type", ImGuiTableColumnFlags_WidthFixed);
             ImGui::TableHeadersRow();
 
-            auto current_time = std::chrono::steady_clock::now();
-            if (current_time - m_last_file_tree_update > std::chrono::seconds(1))
+            // the tree follows the file watcher, it is not rebuilt here
+            EditorFileNode* editor_root_node = m_editor_file_service.getEditorRootNode();
+            if (editor_root_node != nullptr)
             {
-                m_editor_file_service.buildEngineFileTree();
-                m_last_file_tree_update = current_time;
+                buildEditorFileAssetsUITree(editor_root_node);
             }
-            m_last_file_tree_update = current_time;
-
-            EditorFileNode* editor_root_node = m_editor_file_service.getEditorRootNode();
-            buildEditorFileAssetsUITree(editor_root_node);
             ImGui::EndTable();
         }
 
@@ -911,6 +902,8 @@ namespace Piccolo
 
         // initialize imgui vulkan render backend
         init_info.render_system->initializeUIRenderBackend(this);
+
+        m_editor_file_service.initialize();
     }
 
     void EditorUI::setUIColorStyle()
@@ -0,0 +1,102 @@
+#include "common/thread_pool.h"
+
+ThreadPool::ThreadPool(unsigned int thread_count)
+{
+    if (thread_count == 0)
+    {
+        thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    for (unsigned int index = 1; index < thread_count; ++index)
+    {
+        m_workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_work_condition.notify_all();
+
+    for (auto& worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+void ThreadPool::parallelFor(size_t job_count, const std::function<void(size_t)>& job)
+{
+    if (job_count == 0)
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_job       = &job;
+        m_job_count = job_count;
+        m_next_job.store(0);
+        m_exception        = nullptr;
+        m_finished_workers = 0;
+        ++m_generation;
+    }
+    m_work_condition.notify_all();
+
+    runJobs();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done_condition.wait(lock, [this]() { return m_finished_workers == m_workers.size(); });
+    m_job = nullptr;
+
+    if (m_exception)
+    {
+        std::rethrow_exception(m_exception);
+    }
+}
+
+void ThreadPool::workerLoop()
+{
+    uint64_t generation = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_work_condition.wait(lock, [this, generation]() { return m_stop || m_generation != generation; });
+            if (m_stop)
+            {
+                return;
+            }
+            generation = m_generation;
+        }
+
+        runJobs();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_finished_workers;
+        }
+        m_done_condition.notify_all();
+    }
+}
+
+void ThreadPool::runJobs()
+{
+    for (size_t index = m_next_job.fetch_add(1); index < m_job_count; index = m_next_job.fetch_add(1))
+    {
+        try
+        {
+            (*m_job)(index);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_exception)
+            {
+                m_exception = std::current_exception();
+            }
+        }
+    }
+}
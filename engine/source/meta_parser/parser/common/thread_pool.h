@@ -0,0 +1,49 @@
+#pragma once
+
+#include "precompiled.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// fixed set of worker threads, the calling thread works on the jobs as well and returns when all of them are done
+class ThreadPool
+{
+public:
+    // thread_count 0 picks the number of hardware threads
+    explicit ThreadPool(unsigned int thread_count);
+    ~ThreadPool();
+
+    // runs job(0) ... job(job_count - 1), the first exception thrown by a job is rethrown once all of them are done
+    void parallelFor(size_t job_count, const std::function<void(size_t)>& job);
+
+    unsigned int getThreadCount() const { return static_cast<unsigned int>(m_workers.size()) + 1; }
+
+private:
+    ThreadPool(const ThreadPool&);
+    ThreadPool& operator=(const ThreadPool&);
+
+    void workerLoop();
+    void runJobs();
+
+private:
+    std::vector<std::thread> m_workers;
+
+    std::mutex              m_mutex;
+    std::condition_variable m_work_condition;
+    std::condition_variable m_done_condition;
+
+    // the batch the workers are on, a new generation wakes them up
+    // every worker reports back before parallelFor returns, so none of them is left behind on an old batch
+    const std::function<void(size_t)>* m_job {nullptr};
+    size_t                             m_job_count {0};
+    std::atomic<size_t>                m_next_job {0};
+    uint64_t                           m_generation {0};
+    size_t                             m_finished_workers {0};
+    bool                               m_stop {false};
+
+    std::exception_ptr m_exception;
+};
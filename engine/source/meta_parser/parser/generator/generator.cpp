@@ -12,6 +12,17 @@ namespace Generator
             fs::create_directories(path);
         }
     }
+    std::vector<std::string> GeneratorInterface::getOutputFiles(std::string path) { return {processFileName(path)}; }
+
+    void GeneratorInterface::clean(std::string path)
+    {
+        for (auto& output_file : getOutputFiles(path))
+        {
+            std::error_code error;
+            fs::remove(output_file, error);
+        }
+    }
+
     void GeneratorInterface::genClassRenderData(std::shared_ptr<Class> class_temp, Mustache::data& class_def)
     {
         class_def.set("class_name", class_temp->getClassName());
@@ -3,6 +3,7 @@
 
 #include <functional>
 #include <string>
+#include <vector>
 namespace Generator
 {
     class GeneratorInterface
@@ -15,7 +16,13 @@ namespace Generator
             m_root_path(root_path), m_get_include_func(get_include_func)
         {}
         virtual int  generate(std::string path, SchemaMoudle schema) = 0;
-        virtual void finish() {};
+        // module_paths are all headers with reflected classes, including those left untouched by this run
+        virtual void finish(const std::vector<std::string>& /*module_paths*/) {}
+
+        // the files generate() writes for the header at path
+        virtual std::vector<std::string> getOutputFiles(std::string path);
+        // removes the files of a header which is gone or has no reflected classes anymore
+        void clean(std::string path);
 
         virtual ~GeneratorInterface() {};
 
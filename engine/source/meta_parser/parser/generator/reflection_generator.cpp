@@ -110,25 +110,21 @@ namespace Generator
         std::string render_string =
             TemplateManager::getInstance()->renderByTemplate("commonReflectionFile", mustache_data);
         Utils::saveFile(render_string, file_path);
-
-        m_sourcefile_list.emplace_back(tmp);
-
-        m_head_file_list.emplace_back(Utils::makeRelativePath(m_root_path, file_path).string());
         return 0;
     }
-    void ReflectionGenerator::finish()
+    void ReflectionGenerator::finish(const std::vector<std::string>& module_paths)
     {
         Mustache::data mustache_data;
         Mustache::data include_headfiles = Mustache::data::type::list;
         Mustache::data sourefile_names    = Mustache::data::type::list;
 
-        for (auto& head_file : m_head_file_list)
-        {
-            include_headfiles.push_back(Mustache::data("headfile_name", head_file));
-        }
-        for (auto& sourefile_name_upper_camel_case : m_sourcefile_list)
+        for (auto& module_path : module_paths)
         {
-            sourefile_names.push_back(Mustache::data("sourefile_name_upper_camel_case", sourefile_name_upper_camel_case));
+            include_headfiles.push_back(Mustache::data(
+                "headfile_name", Utils::makeRelativePath(m_root_path, processFileName(module_path)).string()));
+            sourefile_names.push_back(Mustache::data(
+                "sourefile_name_upper_camel_case",
+                Utils::convertNameToUpperCamelCase(fs::path(module_path).stem().string(), "_")));
         }
         mustache_data.set("include_headfiles", include_headfiles);
         mustache_data.set("sourefile_names", sourefile_names);
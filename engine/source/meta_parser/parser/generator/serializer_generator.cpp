@@ -17,6 +17,7 @@ namespace Generator
         TemplateManager::getInstance()->loadTemplates(m_root_path, "allSerializer.h");
         TemplateManager::getInstance()->loadTemplates(m_root_path, "allSerializer.ipp");
         TemplateManager::getInstance()->loadTemplates(m_root_path, "commonSerializerGenFile");
+        TemplateManager::getInstance()->loadTemplates(m_root_path, "commonSerializerImplFile");
         return;
     }
 
@@ -25,6 +26,44 @@ namespace Generator
         auto relativeDir = fs::path(path).filename().replace_extension("serializer.gen.h").string();
         return m_out_path + "/" + relativeDir;
     }
+
+    std::string SerializerGenerator::processImplFileName(std::string path)
+    {
+        auto relativeDir = fs::path(path).filename().replace_extension("serializer.gen.ipp").string();
+        return m_out_path + "/" + relativeDir;
+    }
+
+    std::vector<std::string> SerializerGenerator::getOutputFiles(std::string path)
+    {
+        return {processFileName(path), processImplFileName(path)};
+    }
+    std::string SerializerGenerator::genSchemaHash(std::shared_ptr<Class> class_temp)
+    {
+        std::string schema = class_temp->getClassName();
+        for (auto& base_class : class_temp->m_base_classes)
+        {
+            schema += ":" + base_class->name;
+        }
+        for (auto& field : class_temp->m_fields)
+        {
+            if (!field->shouldCompile())
+                continue;
+            schema += ";" + field->m_type + " " + field->m_display_name;
+        }
+
+        // fnv-1a, stable across compilers unlike std::hash
+        uint64_t hash = 14695981039346656037ULL;
+        for (unsigned char c : schema)
+        {
+            hash ^= c;
+            hash *= 1099511628211ULL;
+        }
+
+        std::stringstream hash_string;
+        hash_string << "0x" << std::hex << hash;
+        return hash_string.str();
+    }
+
     int SerializerGenerator::generate(std::string path, SchemaMoudle schema)
     {
         std::string file_path = processFileName(path);
@@ -42,6 +81,7 @@ namespace Generator
 
             Mustache::data class_def;
             genClassRenderData(class_temp, class_def);
+            class_def.set("class_schema_hash", genSchemaHash(class_temp));
 
             // deal base class
             for (int index = 0; index < class_temp->m_base_classes.size(); ++index)
@@ -78,7 +118,6 @@ namespace Generator
                 // deal normal
             }
             class_defines.push_back(class_def);
-            m_class_defines.push_back(class_def);
         }
 
         muatache_data.set("class_defines", class_defines);
@@ -87,19 +126,33 @@ namespace Generator
             TemplateManager::getInstance()->renderByTemplate("commonSerializerGenFile", muatache_data);
         Utils::saveFile(render_string, file_path);
 
-        m_include_headfiles.push_back(
+        Mustache::data impl_include_headfiles(Mustache::data::type::list);
+        impl_include_headfiles.push_back(
             Mustache::data("headfile_name", Utils::makeRelativePath(m_root_path, file_path).string()));
+        muatache_data.set("include_headfiles", impl_include_headfiles);
+        render_string = TemplateManager::getInstance()->renderByTemplate("commonSerializerImplFile", muatache_data);
+        Utils::saveFile(render_string, processImplFileName(path));
         return 0;
     }
 
-    void SerializerGenerator::finish()
+    void SerializerGenerator::finish(const std::vector<std::string>& module_paths)
     {
+        Mustache::data include_headfiles(Mustache::data::type::list);
+        Mustache::data include_implfiles(Mustache::data::type::list);
+        for (auto& module_path : module_paths)
+        {
+            include_headfiles.push_back(Mustache::data(
+                "headfile_name", Utils::makeRelativePath(m_root_path, processFileName(module_path)).string()));
+            include_implfiles.push_back(Mustache::data(
+                "headfile_name", Utils::makeRelativePath(m_root_path, processImplFileName(module_path)).string()));
+        }
+
         Mustache::data mustache_data;
-        mustache_data.set("class_defines", m_class_defines);
-        mustache_data.set("include_headfiles", m_include_headfiles);
+        mustache_data.set("include_headfiles", include_headfiles);
 
         std::string render_string = TemplateManager::getInstance()->renderByTemplate("allSerializer.h", mustache_data);
         Utils::saveFile(render_string, m_out_path + "/all_serializer.h");
+        mustache_data.set("include_headfiles", include_implfiles);
         render_string = TemplateManager::getInstance()->renderByTemplate("allSerializer.ipp", mustache_data);
         Utils::saveFile(render_string, m_out_path + "/all_serializer.ipp");
     }
@@ -10,7 +10,9 @@ namespace Generator
 
         virtual int generate(std::string path, SchemaMoudle schema) override;
 
-        virtual void finish() override;
+        virtual void finish(const std::vector<std::string>& module_paths) override;
+
+        virtual std::vector<std::string> getOutputFiles(std::string path) override;
 
         virtual ~SerializerGenerator() override;
 
@@ -18,9 +20,10 @@ namespace Generator
         virtual void prepareStatus(std::string path) override;
 
         virtual std::string processFileName(std::string path) override;
+        // the definitions of a header go to their own file, only all_serializer.ipp includes them
+        std::string processImplFileName(std::string path);
 
-    private:
-        Mustache::data m_class_defines {Mustache::data::type::list};
-        Mustache::data m_include_headfiles {Mustache::data::type::list};
+        // hash of the names and the types of the fields, part of the schema hash of the binary form
+        std::string genSchemaHash(std::shared_ptr<Class> class_temp);
     };
 } // namespace Generator
@@ -1,12 +1,13 @@
 #include "common/precompiled.h"
 #include "parser/parser.h"
 
-int parse(std::string project_file_name,
-          std::string source_include_file_name,
-          std::string include_path,
-          std::string sys_include,
-          std::string module_name,
-          std::string show_errors);
+int parse(std::string  project_file_name,
+          std::string  source_include_file_name,
+          std::string  include_path,
+          std::string  sys_include,
+          std::string  module_name,
+          std::string  show_errors,
+          unsigned int job_count);
 
 int main(int argc, char* argv[])
 {
@@ -16,9 +17,24 @@ int main(int argc, char* argv[])
     if (argv[1] != nullptr && argv[2] != nullptr && argv[3] != nullptr && argv[4] != nullptr && argv[5] != nullptr &&
         argv[6] != nullptr)
     {
+        // optional: --jobs <count>, 0 or none uses every hardware thread
+        unsigned int job_count = 0;
+        for (int index = 7; index < argc; ++index)
+        {
+            if (std::string(argv[index]) == "--jobs" && index + 1 < argc)
+            {
+                job_count = static_cast<unsigned int>(std::max(std::atoi(argv[++index]), 0));
+            }
+            else
+            {
+                std::cerr << "Unknown argument: " << argv[index] << std::endl;
+                return -1;
+            }
+        }
+
         MetaParser::prepare();
 
-        result = parse(argv[1], argv[2], argv[3], argv[4], argv[5], argv[6]);
+        result = parse(argv[1], argv[2], argv[3], argv[4], argv[5], argv[6], job_count);
 
         auto duration_time = std::chrono::system_clock::now() - start_time;
         std::cout << "Completed in " << std::chrono::duration_cast<std::chrono::milliseconds>(duration_time).count()
@@ -30,7 +46,7 @@ int main(int argc, char* argv[])
         std::cerr << "Arguments parse error!" << std::endl
                   << "Please call the tool like this:" << std::endl
                   << "meta_parser  project_file_name  include_file_name_to_generate  project_base_directory "
-                     "sys_include_directory module_name showErrors(0 or 1)"
+                     "sys_include_directory module_name showErrors(0 or 1) [--jobs count]"
                   << std::endl
                   << std::endl;
         return -1;
@@ -39,12 +55,13 @@ int main(int argc, char* argv[])
     return 0;
 }
 
-int parse(std::string project_input_file_name,
-          std::string source_include_file_name,
-          std::string include_path,
-          std::string sys_include,
-          std::string module_name,
-          std::string show_errors)
+int parse(std::string  project_input_file_name,
+          std::string  source_include_file_name,
+          std::string  include_path,
+          std::string  sys_include,
+          std::string  module_name,
+          std::string  show_errors,
+          unsigned int job_count)
 {
     std::cout << std::endl;
     std::cout << "Parsing meta data for target \"" << module_name << "\"" << std::endl;
@@ -52,8 +69,13 @@ int parse(std::string project_input_file_name,
 
     bool is_show_errors = "0" != show_errors;
 
-    MetaParser parser(
-        project_input_file_name, source_include_file_name, include_path, sys_include, module_name, is_show_errors);
+    MetaParser parser(project_input_file_name,
+                      source_include_file_name,
+                      include_path,
+                      sys_include,
+                      module_name,
+                      is_show_errors,
+                      job_count);
 
     std::cout << "Parsing in " << include_path << std::endl;
     int result = parser.parse();
@@ -271,6 +271,18 @@ namespace Utils
         {
             fs::create_directories(out_path.parent_path());
         }
+        // an untouched file keeps its timestamp, so nothing which includes it is rebuilt
+        {
+            std::ifstream     existing_file_stream(output_file);
+            std::stringstream existing_content;
+            existing_content << existing_file_stream.rdbuf();
+            if (existing_file_stream.is_open() && existing_content.str().size() == outpu_string.size() + 1 &&
+                existing_content.str().compare(0, outpu_string.size(), outpu_string) == 0)
+            {
+                return;
+            }
+        }
+
         std::fstream output_file_stream(output_file, std::ios_base::out);
 
         output_file_stream << outpu_string << std::endl;
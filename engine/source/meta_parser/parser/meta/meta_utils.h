@@ -47,6 +47,7 @@ namespace Utils
 
     std::string loadFile(std::string path);
 
+    // the file is only written when its content differs
     void saveFile(const std::string& outpu_string, const std::string& output_file);
 
     void replaceAll(std::string& resource_str, std::string sub_str, std::string new_str);
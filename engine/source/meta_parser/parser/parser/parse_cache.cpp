@@ -0,0 +1,139 @@
+#include "common/precompiled.h"
+
+#include "parser/parse_cache.h"
+
+namespace
+{
+    const char* const k_cache_version = "meta_parser_cache 1";
+}
+
+void ParseCache::load(const std::string& cache_file, const std::string& key)
+{
+    m_cache_file = cache_file;
+    m_key        = key;
+    m_entries.clear();
+
+    std::ifstream cache_stream(m_cache_file);
+    if (!cache_stream.is_open())
+    {
+        return;
+    }
+
+    std::string line;
+    if (!std::getline(cache_stream, line) || line != k_cache_version)
+    {
+        return;
+    }
+    if (!std::getline(cache_stream, line) || line != key)
+    {
+        std::cout << "Templates or arguments changed, every header is parsed again" << std::endl;
+        return;
+    }
+
+    // <content hash> <class count> <header path>, followed by one class name per line
+    while (std::getline(cache_stream, line))
+    {
+        std::istringstream line_stream(line);
+        ParseCacheEntry    entry;
+        size_t             class_count = 0;
+        std::string        header;
+        line_stream >> entry.content_hash >> class_count;
+        std::getline(line_stream >> std::ws, header);
+        if (line_stream.fail() || header.empty())
+        {
+            std::cout << "Broken cache file " << m_cache_file << ", every header is parsed again" << std::endl;
+            m_entries.clear();
+            return;
+        }
+
+        for (size_t index = 0; index < class_count && std::getline(cache_stream, line); ++index)
+        {
+            entry.class_names.emplace_back(line);
+        }
+        m_entries.insert_or_assign(header, std::move(entry));
+    }
+}
+
+void ParseCache::save() const
+{
+    std::ofstream cache_file(m_cache_file, std::ios_base::out | std::ios_base::trunc);
+    if (!cache_file.is_open())
+    {
+        std::cerr << "Could not write the cache file: " << m_cache_file << std::endl;
+        return;
+    }
+
+    cache_file << k_cache_version << std::endl << m_key << std::endl;
+    for (auto& entry : m_entries)
+    {
+        cache_file << entry.second.content_hash << " " << entry.second.class_names.size() << " " << entry.first
+                   << std::endl;
+        for (auto& class_name : entry.second.class_names)
+        {
+            cache_file << class_name << std::endl;
+        }
+    }
+}
+
+const ParseCacheEntry* ParseCache::find(const std::string& header) const
+{
+    auto iter = m_entries.find(header);
+    return iter == m_entries.end() ? nullptr : &iter->second;
+}
+
+void ParseCache::update(const std::string& header, ParseCacheEntry entry)
+{
+    m_entries.insert_or_assign(header, std::move(entry));
+}
+
+std::vector<std::string> ParseCache::retain(const std::unordered_set<std::string>& headers)
+{
+    std::vector<std::string> removed_headers;
+    for (auto iter = m_entries.begin(); iter != m_entries.end();)
+    {
+        if (headers.find(iter->first) == headers.end())
+        {
+            removed_headers.emplace_back(iter->first);
+            iter = m_entries.erase(iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+    return removed_headers;
+}
+
+std::string ParseCache::normalizePath(const std::string& path)
+{
+    // symbolic links are kept, the generated include paths are made relative to the unresolved source directory
+    return fs::absolute(fs::path(path)).lexically_normal().generic_string();
+}
+
+std::string ParseCache::hashString(const std::string& content)
+{
+    // fnv-1a, stable across runs and compilers unlike std::hash
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : content)
+    {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+
+    std::stringstream hash_string;
+    hash_string << std::hex << hash << "-" << std::dec << content.size();
+    return hash_string.str();
+}
+
+std::string ParseCache::hashFile(const std::string& path)
+{
+    std::ifstream file(path, std::ios_base::in | std::ios_base::binary);
+    if (!file.is_open())
+    {
+        return "missing";
+    }
+
+    std::stringstream content;
+    content << file.rdbuf();
+    return hashString(content.str());
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "common/precompiled.h"
+
+// what a previous run found in each header, so that unchanged headers are neither parsed nor generated again
+struct ParseCacheEntry
+{
+    std::string content_hash;
+    // display names of the reflected classes declared in the header, empty when nothing is generated for it
+    std::vector<std::string> class_names;
+};
+
+class ParseCache
+{
+public:
+    // entries written under another key are dropped, the key covers everything besides the header content
+    // which changes the generated code: the templates and the parser arguments
+    void load(const std::string& cache_file, const std::string& key);
+    void save() const;
+
+    const ParseCacheEntry* find(const std::string& header) const;
+    void                   update(const std::string& header, ParseCacheEntry entry);
+    // drops the headers which are no longer part of the project and returns them
+    std::vector<std::string> retain(const std::unordered_set<std::string>& headers);
+
+    const std::map<std::string, ParseCacheEntry>& getEntries() const { return m_entries; }
+
+    // paths as the project file and libclang spell them differ, both are normalized before they are compared
+    static std::string normalizePath(const std::string& path);
+    static std::string hashString(const std::string& content);
+    // hash of the file content, "missing" for a file which does not exist
+    static std::string hashFile(const std::string& path);
+
+private:
+    std::string m_cache_file;
+    std::string m_key;
+
+    std::map<std::string, ParseCacheEntry> m_entries;
+};
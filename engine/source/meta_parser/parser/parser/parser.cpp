@@ -25,12 +25,24 @@
     { \
         if (handle->shouldCompile()) \
         { \
-            auto file = handle->getSourceFile(); \
+            auto file = ParseCache::normalizePath(handle->getSourceFile()); \
             m_schema_modules[file].container.emplace_back(handle); \
             m_type_table[handle->m_display_name] = file; \
         } \
     }
 
+namespace
+{
+    using StageClock = std::chrono::steady_clock;
+
+    void printStageTime(const char* stage, StageClock::time_point start_time)
+    {
+        auto duration_time = StageClock::now() - start_time;
+        std::cout << "  " << stage << ": "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(duration_time).count() << "ms" << std::endl;
+    }
+} // namespace
+
 void MetaParser::prepare(void) {}
 
 std::string MetaParser::getIncludeFile(std::string name)
@@ -44,10 +56,12 @@ MetaParser::MetaParser(const std::string project_input_file,
                        const std::string include_path,
                        const std::string sys_include,
                        const std::string module_name,
-                       bool              is_show_errors) :
+                       bool              is_show_errors,
+                       unsigned int      job_count) :
     m_project_input_file(project_input_file),
     m_source_include_file_name(include_file_path), m_index(nullptr), m_translation_unit(nullptr),
-    m_sys_include(sys_include), m_module_name(module_name), m_is_show_errors(is_show_errors)
+    m_sys_include(sys_include), m_module_name(module_name), m_is_show_errors(is_show_errors),
+    m_thread_pool(job_count)
 {
     m_work_paths = Utils::split(include_path, ";");
 
@@ -73,11 +87,67 @@ MetaParser::~MetaParser(void)
 }
 
 void MetaParser::finish(void)
+{
+    std::vector<std::string> module_paths;
+    for (auto& entry : m_parse_cache.getEntries())
+    {
+        if (!entry.second.class_names.empty())
+        {
+            module_paths.emplace_back(entry.first);
+        }
+    }
+
+    // every generator writes its own summary files
+    m_thread_pool.parallelFor(m_generators.size(),
+                              [this, &module_paths](size_t index) { m_generators[index]->finish(module_paths); });
+}
+
+std::string MetaParser::getCacheKey(void)
+{
+    // the generated code also depends on the templates and on how clang is invoked
+    std::stringstream key;
+
+    std::vector<std::string> template_files;
+    fs::path                 template_path = m_work_paths[0] + "/../template";
+    if (fs::exists(template_path))
+    {
+        for (auto& template_file : fs::directory_iterator(template_path))
+        {
+            template_files.emplace_back(template_file.path().generic_string());
+        }
+    }
+    std::sort(template_files.begin(), template_files.end());
+    for (auto& template_file : template_files)
+    {
+        key << fs::path(template_file).filename().string() << ParseCache::hashFile(template_file);
+    }
+
+    for (auto argument : arguments)
+    {
+        key << argument;
+    }
+    key << m_sys_include;
+    for (auto& work_path : m_work_paths)
+    {
+        key << work_path;
+    }
+
+    return ParseCache::hashString(key.str());
+}
+
+bool MetaParser::hasOutputFiles(const std::string& header)
 {
     for (auto generator_iter : m_generators)
     {
-        generator_iter->finish();
+        for (auto& output_file : generator_iter->getOutputFiles(header))
+        {
+            if (!fs::exists(output_file))
+            {
+                return false;
+            }
+        }
     }
+    return true;
 }
 
 bool MetaParser::parseProject()
@@ -101,6 +171,43 @@ bool MetaParser::parseProject()
     auto         inlcude_files = Utils::split(context, ";");
     std::fstream include_file;
 
+    m_parse_cache.load(m_work_paths[0] + "/_generated/meta_parser.cache", getCacheKey());
+
+    m_headers.clear();
+    m_header_hashes.clear();
+    m_changed_headers.clear();
+    for (auto include_item : inlcude_files)
+    {
+        std::string header = ParseCache::normalizePath(include_item);
+        if (m_header_hashes.emplace(header, std::string()).second)
+        {
+            m_headers.emplace_back(header);
+        }
+    }
+
+    std::vector<std::string> content_hashes(m_headers.size());
+    std::vector<char>        has_output_files(m_headers.size(), 1);
+    m_thread_pool.parallelFor(m_headers.size(), [this, &content_hashes, &has_output_files](size_t index) {
+        content_hashes[index]   = ParseCache::hashFile(m_headers[index]);
+        has_output_files[index] = hasOutputFiles(m_headers[index]) ? 1 : 0;
+    });
+
+    for (size_t index = 0; index < m_headers.size(); ++index)
+    {
+        const std::string& header       = m_headers[index];
+        const std::string& content_hash = content_hashes[index];
+        m_header_hashes[header]         = content_hash;
+
+        auto entry = m_parse_cache.find(header);
+        if (entry == nullptr || entry->content_hash != content_hash ||
+            (!entry->class_names.empty() && !has_output_files[index]))
+        {
+            m_changed_headers.emplace_back(header);
+        }
+    }
+    std::cout << m_changed_headers.size() << " of " << m_headers.size() << " headers changed since the last run"
+              << std::endl;
+
     include_file.open(m_source_include_file_name, std::ios::out);
     if (!include_file.is_open())
     {
@@ -125,11 +232,9 @@ bool MetaParser::parseProject()
     include_file << "#ifndef __" << output_filename << "__" << std::endl;
     include_file << "#define __" << output_filename << "__" << std::endl;
 
-    for (auto include_item : inlcude_files)
+    for (auto& include_item : m_changed_headers)
     {
-        std::string temp_string(include_item);
-        Utils::replace(temp_string, '\\', '/');
-        include_file << "#include  \"" << temp_string << "\"" << std::endl;
+        include_file << "#include  \"" << include_item << "\"" << std::endl;
     }
 
     include_file << "#endif" << std::endl;
@@ -139,12 +244,35 @@ bool MetaParser::parseProject()
 
 int MetaParser::parse(void)
 {
-    bool parse_include_ = parseProject();
+    auto stage_start_time = StageClock::now();
+    bool parse_include_   = parseProject();
     if (!parse_include_)
     {
         std::cerr << "Parsing project file error! " << std::endl;
         return -1;
     }
+    printStageTime("project file and header hashes", stage_start_time);
+
+    // the types of the unchanged headers are still needed to resolve the includes of the generated files
+    std::unordered_set<std::string> changed_headers(m_changed_headers.begin(), m_changed_headers.end());
+    for (auto& header : m_headers)
+    {
+        auto entry = m_parse_cache.find(header);
+        if (entry == nullptr || changed_headers.find(header) != changed_headers.end())
+        {
+            continue;
+        }
+        for (auto& class_name : entry->class_names)
+        {
+            m_type_table[class_name] = header;
+        }
+    }
+
+    if (m_changed_headers.empty())
+    {
+        std::cerr << "Nothing changed, skip parsing" << std::endl;
+        return 0;
+    }
 
     std::cerr << "Parsing the whole project..." << std::endl;
     int is_show_errors      = m_is_show_errors ? 1 : 0;
@@ -172,31 +300,90 @@ int MetaParser::parse(void)
         return -2;
     }
 
-    m_translation_unit = clang_createTranslationUnitFromSourceFile(
-        m_index, m_source_include_file_name.c_str(), static_cast<int>(arguments.size()), arguments.data(), 0, nullptr);
-    auto cursor = clang_getTranslationUnitCursor(m_translation_unit);
+    // only declarations are reflected, the function bodies are not even looked at
+    stage_start_time   = StageClock::now();
+    m_translation_unit = clang_parseTranslationUnit(m_index,
+                                                    m_source_include_file_name.c_str(),
+                                                    arguments.data(),
+                                                    static_cast<int>(arguments.size()),
+                                                    nullptr,
+                                                    0,
+                                                    CXTranslationUnit_SkipFunctionBodies);
+    printStageTime("clang parsing", stage_start_time);
+
+    stage_start_time = StageClock::now();
+    auto cursor      = clang_getTranslationUnitCursor(m_translation_unit);
 
     Namespace temp_namespace;
 
     buildClassAST(cursor, temp_namespace);
 
     temp_namespace.clear();
+    printStageTime("class AST", stage_start_time);
 
     return 0;
 }
 
 void MetaParser::generateFiles(void)
 {
-    std::cerr << "Start generate runtime schemas(" << m_schema_modules.size() << ")..." << std::endl;
+    std::cerr << "Start generate runtime schemas(" << m_schema_modules.size() << ") on "
+              << m_thread_pool.getThreadCount() << " threads..." << std::endl;
+
+    // the modules only read the parsed classes and the type table, and each of them writes its own files
+    auto stage_start_time = StageClock::now();
+
+    std::vector<std::pair<const std::string*, const SchemaMoudle*>> schemas;
     for (auto& schema : m_schema_modules)
+    {
+        schemas.emplace_back(&schema.first, &schema.second);
+    }
+    m_thread_pool.parallelFor(schemas.size() * m_generators.size(), [this, &schemas](size_t index) {
+        auto& schema = schemas[index / m_generators.size()];
+        m_generators[index % m_generators.size()]->generate(*schema.first, *schema.second);
+    });
+    printStageTime("schema modules", stage_start_time);
+
+    for (auto& header : m_changed_headers)
+    {
+        auto old_entry = m_parse_cache.find(header);
+        bool had_classes = old_entry != nullptr && !old_entry->class_names.empty();
+
+        ParseCacheEntry entry;
+        entry.content_hash = m_header_hashes[header];
+        auto schema        = m_schema_modules.find(header);
+        if (schema != m_schema_modules.end())
+        {
+            for (auto& class_temp : schema->second.classes)
+            {
+                entry.class_names.emplace_back(class_temp->m_display_name);
+            }
+        }
+
+        if (had_classes && entry.class_names.empty())
+        {
+            for (auto& generator_iter : m_generators)
+            {
+                generator_iter->clean(header);
+            }
+        }
+        m_parse_cache.update(header, std::move(entry));
+    }
+
+    // headers removed from the project take their generated files with them
+    std::unordered_set<std::string> headers(m_headers.begin(), m_headers.end());
+    for (auto& header : m_parse_cache.retain(headers))
     {
         for (auto& generator_iter : m_generators)
         {
-            generator_iter->generate(schema.first, schema.second);
+            generator_iter->clean(header);
         }
     }
 
+    stage_start_time = StageClock::now();
     finish();
+
+    m_parse_cache.save();
+    printStageTime("summary files and cache", stage_start_time);
 }
 
 void MetaParser::buildClassAST(const Cursor& cursor, Namespace& current_namespace)
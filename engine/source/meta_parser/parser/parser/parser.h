@@ -4,10 +4,12 @@
 
 #include "common/namespace.h"
 #include "common/schema_module.h"
+#include "common/thread_pool.h"
 
 #include "cursor/cursor.h"
 
 #include "generator/generator.h"
+#include "parser/parse_cache.h"
 #include "template_manager/template_manager.h"
 
 class Class;
@@ -22,7 +24,8 @@ public:
                const std::string include_path,
                const std::string include_sys,
                const std::string module_name,
-               bool              is_show_errors);
+               bool              is_show_errors,
+               unsigned int      job_count);
     ~MetaParser(void);
     void finish(void);
     int  parse(void);
@@ -57,8 +60,20 @@ private:
 
     bool m_is_show_errors;
 
+    // hashing the headers, generating and writing the files of the schema modules are spread over it
+    ThreadPool m_thread_pool;
+
+    // normalized paths of all headers of the project and their content hashes
+    std::vector<std::string>                     m_headers;
+    std::unordered_map<std::string, std::string> m_header_hashes;
+    // only these are parsed and generated again, the others keep what the cache says about them
+    std::vector<std::string> m_changed_headers;
+    ParseCache               m_parse_cache;
+
 private:
     bool        parseProject(void);
+    std::string getCacheKey(void);
+    bool        hasOutputFiles(const std::string& header);
     void        buildClassAST(const Cursor& cursor, Namespace& current_namespace);
     std::string getIncludeFile(std::string name);
 };
@@ -9,10 +9,12 @@ void TemplateManager::loadTemplates(std::string path, std::string template_name)
 
 std::string TemplateManager::renderByTemplate(std::string template_name, Mustache::data& template_data)
 {
-    if (m_template_pool.end() == m_template_pool.find(template_name))
+    // called from several generator threads at once, the pool is only read here
+    auto template_iter = m_template_pool.find(template_name);
+    if (m_template_pool.end() == template_iter)
     {
         return "";
     }
-    Mustache::mustache tmpl(m_template_pool[template_name]);
+    Mustache::mustache tmpl(template_iter->second);
     return tmpl.render(template_data);
 }
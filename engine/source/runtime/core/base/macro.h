@@ -6,19 +6,58 @@
 
 #include <chrono>
 #include <thread>
+#include <type_traits>
 
+// log calls below this level are compiled out, it is set by the PICCOLO_LOG_ACTIVE_LEVEL cmake cache variable
+#define PICCOLO_LOG_LEVEL_DEBUG 0
+#define PICCOLO_LOG_LEVEL_INFO 1
+#define PICCOLO_LOG_LEVEL_WARN 2
+#define PICCOLO_LOG_LEVEL_ERROR 3
+
+#ifndef PICCOLO_LOG_ACTIVE_LEVEL
+#define PICCOLO_LOG_ACTIVE_LEVEL PICCOLO_LOG_LEVEL_DEBUG
+#endif
+
+#define PICCOLO_LOG_MODULE \
+    std::integral_constant<Piccolo::LogSystem::LogModule, Piccolo::LogSystem::getModule(__FILE__)>::value
+
+// the runtime level is checked before any argument is evaluated, the arguments are passed to spdlog unformatted
 #define LOG_HELPER(LOG_LEVEL, ...) \
-    g_runtime_global_context.m_logger_system->log(LOG_LEVEL, "[" + std::string(__FUNCTION__) + "] " + __VA_ARGS__);
+    do \
+    { \
+        if (g_runtime_global_context.m_logger_system->shouldLog(LOG_LEVEL, PICCOLO_LOG_MODULE)) \
+        { \
+            g_runtime_global_context.m_logger_system->log( \
+                LOG_LEVEL, spdlog::source_loc {__FILE__, __LINE__, __FUNCTION__}, __VA_ARGS__); \
+        } \
+    } while (0)
 
-#define LOG_DEBUG(...) LOG_HELPER(LogSystem::LogLevel::debug, __VA_ARGS__);
+#if PICCOLO_LOG_ACTIVE_LEVEL <= PICCOLO_LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) LOG_HELPER(Piccolo::LogSystem::LogLevel::debug, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) (void)0
+#endif
 
-#define LOG_INFO(...) LOG_HELPER(LogSystem::LogLevel::info, __VA_ARGS__);
+#if PICCOLO_LOG_ACTIVE_LEVEL <= PICCOLO_LOG_LEVEL_INFO
+#define LOG_INFO(...) LOG_HELPER(Piccolo::LogSystem::LogLevel::info, __VA_ARGS__)
+#else
+#define LOG_INFO(...) (void)0
+#endif
 
-#define LOG_WARN(...) LOG_HELPER(LogSystem::LogLevel::warn, __VA_ARGS__);
+#if PICCOLO_LOG_ACTIVE_LEVEL <= PICCOLO_LOG_LEVEL_WARN
+#define LOG_WARN(...) LOG_HELPER(Piccolo::LogSystem::LogLevel::warn, __VA_ARGS__)
+#else
+#define LOG_WARN(...) (void)0
+#endif
 
-#define LOG_ERROR(...) LOG_HELPER(LogSystem::LogLevel::error, __VA_ARGS__);
+#if PICCOLO_LOG_ACTIVE_LEVEL <= PICCOLO_LOG_LEVEL_ERROR
+#define LOG_ERROR(...) LOG_HELPER(Piccolo::LogSystem::LogLevel::error, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) (void)0
+#endif
 
-#define LOG_FATAL(...) LOG_HELPER(LogSystem::LogLevel::fatal, __VA_ARGS__);
+// never compiled out, a fatal log throws
+#define LOG_FATAL(...) LOG_HELPER(Piccolo::LogSystem::LogLevel::fatal, __VA_ARGS__)
 
 #define PolitSleep(_ms) std::this_thread::sleep_for(std::chrono::milliseconds(_ms));
 
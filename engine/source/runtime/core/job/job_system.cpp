@@ -0,0 +1,136 @@
+#include "runtime/core/job/job_system.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+namespace Piccolo
+{
+    namespace
+    {
+        struct JobBatch
+        {
+            const std::vector<std::function<void()>>* jobs {nullptr};
+            size_t                                    job_count {0};
+            std::atomic<size_t>                       next_job {0};
+            std::atomic<size_t>                       finished_job_count {0};
+            std::exception_ptr                        first_exception;
+            std::mutex                                mutex;
+            std::condition_variable                   finished_condition;
+
+            // claims and runs jobs until the batch is drained, the job list is only touched while a job is left
+            void drain()
+            {
+                size_t job_index;
+                while ((job_index = next_job.fetch_add(1)) < job_count)
+                {
+                    try
+                    {
+                        (*jobs)[job_index]();
+                    }
+                    catch (...)
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if (!first_exception)
+                        {
+                            first_exception = std::current_exception();
+                        }
+                    }
+
+                    if (finished_job_count.fetch_add(1) + 1 == job_count)
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        finished_condition.notify_all();
+                    }
+                }
+            }
+        };
+    } // namespace
+
+    JobSystem::JobSystem(uint32_t worker_count)
+    {
+        if (worker_count == 0)
+        {
+            uint32_t hardware_thread_count = std::thread::hardware_concurrency();
+            worker_count                   = hardware_thread_count > 1 ? hardware_thread_count - 1 : 1;
+        }
+
+        m_workers.reserve(worker_count);
+        for (uint32_t i = 0; i < worker_count; ++i)
+        {
+            m_workers.emplace_back(&JobSystem::workerLoop, this);
+        }
+    }
+
+    JobSystem::~JobSystem()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_queue_mutex);
+            m_is_stopping = true;
+        }
+        m_queue_condition.notify_all();
+
+        for (std::thread& worker : m_workers)
+        {
+            worker.join();
+        }
+    }
+
+    void JobSystem::parallelRun(const std::vector<std::function<void()>>& jobs)
+    {
+        if (jobs.empty())
+        {
+            return;
+        }
+
+        // the batch is shared with the queued helpers, which may still be dequeued after this call returns
+        std::shared_ptr<JobBatch> batch = std::make_shared<JobBatch>();
+        batch->jobs                     = &jobs;
+        batch->job_count                = jobs.size();
+
+        size_t helper_count = std::min(jobs.size() - 1, m_workers.size());
+        if (helper_count > 0)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_queue_mutex);
+                for (size_t i = 0; i < helper_count; ++i)
+                {
+                    m_queue.emplace_back([batch]() { batch->drain(); });
+                }
+            }
+            m_queue_condition.notify_all();
+        }
+
+        batch->drain();
+
+        {
+            std::unique_lock<std::mutex> lock(batch->mutex);
+            batch->finished_condition.wait(lock, [&batch]() { return batch->finished_job_count == batch->job_count; });
+        }
+
+        if (batch->first_exception)
+        {
+            std::rethrow_exception(batch->first_exception);
+        }
+    }
+
+    void JobSystem::workerLoop()
+    {
+        while (true)
+        {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(m_queue_mutex);
+                m_queue_condition.wait(lock, [this]() { return m_is_stopping || !m_queue.empty(); });
+                if (m_is_stopping && m_queue.empty())
+                {
+                    return;
+                }
+                job = std::move(m_queue.front());
+                m_queue.pop_front();
+            }
+            job();
+        }
+    }
+} // namespace Piccolo
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Piccolo
+{
+    class JobSystem final
+    {
+    public:
+        // worker_count 0 means one worker per hardware thread except the calling one
+        explicit JobSystem(uint32_t worker_count = 0);
+        ~JobSystem();
+
+        // runs the jobs on the workers and the calling thread and returns once all of them are finished,
+        // the first exception thrown by a job is rethrown on the calling thread
+        void parallelRun(const std::vector<std::function<void()>>& jobs);
+
+        uint32_t getWorkerCount() const { return static_cast<uint32_t>(m_workers.size()); }
+
+    private:
+        void workerLoop();
+
+    private:
+        std::vector<std::thread>          m_workers;
+        std::deque<std::function<void()>> m_queue;
+        std::mutex                        m_queue_mutex;
+        std::condition_variable           m_queue_condition;
+        bool                              m_is_stopping {false};
+    };
+} // namespace Piccolo
@@ -1,36 +1,356 @@
 #include "runtime/core/log/log_system.h"
 
-#include <spdlog/async.h>
-#include <spdlog/sinks/basic_file_sink.h>
+#include <spdlog/details/os.h>
+#include <spdlog/pattern_formatter.h>
+#include <spdlog/sinks/rotating_file_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
+#include <chrono>
+
 namespace Piccolo
 {
-    LogSystem::LogSystem()
+    namespace
+    {
+        // the message of the structured file sink, escaped to stay a valid json string
+        class JsonMessageFormatter final : public spdlog::custom_flag_formatter
+        {
+        public:
+            void format(const spdlog::details::log_msg& msg, const std::tm&, spdlog::memory_buf_t& dest) override
+            {
+                for (char c : msg.payload)
+                {
+                    switch (c)
+                    {
+                        case '"':
+                            dest.append(spdlog::string_view_t("\\\""));
+                            break;
+                        case '\\':
+                            dest.append(spdlog::string_view_t("\\\\"));
+                            break;
+                        case '\n':
+                            dest.append(spdlog::string_view_t("\\n"));
+                            break;
+                        case '\r':
+                            dest.append(spdlog::string_view_t("\\r"));
+                            break;
+                        case '\t':
+                            dest.append(spdlog::string_view_t("\\t"));
+                            break;
+                        default:
+                            if (static_cast<unsigned char>(c) < 0x20)
+                            {
+                                fmt::format_to(std::back_inserter(dest), "\\u{:04x}", static_cast<unsigned>(c));
+                            }
+                            else
+                            {
+                                dest.push_back(c);
+                            }
+                            break;
+                    }
+                }
+            }
+
+            std::unique_ptr<spdlog::custom_flag_formatter> clone() const override
+            {
+                return spdlog::details::make_unique<JsonMessageFormatter>();
+            }
+        };
+
+        std::atomic<uint64_t> g_log_system_instance_count {0};
+    } // namespace
+
+    struct LogSystem::ThreadLogBuffer
+    {
+        struct Record
+        {
+            spdlog::log_clock::time_point time;
+            spdlog::source_loc            location;
+            spdlog::level::level_enum     level {spdlog::level::info};
+            size_t                        thread_id {0};
+            std::string                   message;
+        };
+
+        explicit ThreadLogBuffer(uint32_t capacity) : records(capacity), mask(capacity - 1) {}
+
+        std::vector<Record> records;
+        size_t              mask;
+
+        // head is only written by the owning thread, tail only by the drain thread
+        alignas(64) std::atomic<size_t> head {0};
+        alignas(64) std::atomic<size_t> tail {0};
+    };
+
+    LogSystem::LogSystem(const LogSystemInitInfo& init_info)
     {
         auto console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
         console_sink->set_level(spdlog::level::trace);
-        console_sink->set_pattern("[%^%l%$] %v");
+        // %! is the function name passed by the LOG_* macros
+        console_sink->set_pattern("[%^%l%$] [%!] %v");
+
+        std::vector<spdlog::sink_ptr> sinks = {console_sink};
 
-        const spdlog::sinks_init_list sink_list = {console_sink};
+        if (!init_info.file_path.empty())
+        {
+            try
+            {
+                auto file_sink = std::make_shared<spdlog::sinks::rotating_file_sink_mt>(
+                    init_info.file_path.generic_string(), init_info.max_file_size, init_info.max_file_count);
+                file_sink->set_level(spdlog::level::trace);
 
-        spdlog::init_thread_pool(8192, 1);
+                auto file_formatter = std::make_unique<spdlog::pattern_formatter>();
+                file_formatter->add_flag<JsonMessageFormatter>('*').set_pattern(
+                    "{\"time\":\"%Y-%m-%dT%H:%M:%S.%f\",\"level\":\"%l\",\"thread\":%t,\"source\":\"%s:%#\","
+                    "\"function\":\"%!\",\"message\":\"%*\"}");
+                file_sink->set_formatter(std::move(file_formatter));
 
-        m_logger = std::make_shared<spdlog::async_logger>("muggle_logger",
-                                                          sink_list.begin(),
-                                                          sink_list.end(),
-                                                          spdlog::thread_pool(),
-                                                          spdlog::async_overflow_policy::block);
+                sinks.push_back(file_sink);
+            }
+            catch (const spdlog::spdlog_ex& exception)
+            {
+                console_sink->log(spdlog::details::log_msg(
+                    "muggle_logger", spdlog::level::warn, std::string("log file disabled, ") + exception.what()));
+            }
+        }
+
+        m_logger = std::make_shared<spdlog::logger>("muggle_logger", sinks.begin(), sinks.end());
         m_logger->set_level(spdlog::level::trace);
 
         spdlog::register_logger(m_logger);
+
+        setLevel(LogLevel::debug);
+
+        m_enable_async = init_info.enable_async;
+        if (m_enable_async)
+        {
+            uint32_t capacity = 1;
+            while (capacity < std::max(init_info.thread_buffer_capacity, 2u))
+            {
+                capacity <<= 1;
+            }
+            m_thread_buffer_capacity = capacity;
+            m_instance_id            = ++g_log_system_instance_count;
+
+            m_drain_thread = std::thread(&LogSystem::drainLoop, this);
+        }
     }
 
     LogSystem::~LogSystem()
     {
+        if (m_enable_async)
+        {
+            // the drain thread writes what is left before it exits
+            m_stop_draining.store(true);
+            m_drain_thread.join();
+        }
+
         m_logger->flush();
         spdlog::drop_all();
     }
 
+    void LogSystem::setLevel(LogLevel level)
+    {
+        for (std::atomic<uint8_t>& module_level : m_module_levels)
+        {
+            module_level.store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+        }
+    }
+
+    void LogSystem::setModuleLevel(LogModule module, LogLevel level)
+    {
+        m_module_levels[static_cast<uint8_t>(module)].store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+    }
+
+    LogSystem::LogLevel LogSystem::getModuleLevel(LogModule module) const
+    {
+        return static_cast<LogLevel>(m_module_levels[static_cast<uint8_t>(module)].load(std::memory_order_relaxed));
+    }
+
+    void LogSystem::flush()
+    {
+        if (m_enable_async && std::this_thread::get_id() != m_drain_thread.get_id())
+        {
+            // wait for a full drain which started after this call
+            std::unique_lock<std::mutex> lock(m_flush_mutex);
+            uint64_t                     request = m_flush_request.fetch_add(1) + 1;
+            m_flush_condition.wait(lock, [this, request]() { return m_flush_done.load() >= request; });
+        }
+
+        m_logger->flush();
+    }
+
+    LogStatistics LogSystem::getStatistics() const
+    {
+        LogStatistics statistics;
+        statistics.queued_count  = m_queued_count.load(std::memory_order_relaxed);
+        statistics.dropped_count = m_dropped_count.load(std::memory_order_relaxed);
+        statistics.written_count = m_written_count.load(std::memory_order_relaxed);
+        statistics.pending_count =
+            statistics.queued_count > statistics.written_count ? statistics.queued_count - statistics.written_count : 0;
+        return statistics;
+    }
+
+    spdlog::level::level_enum LogSystem::toSpdlogLevel(LogLevel level)
+    {
+        switch (level)
+        {
+            case LogLevel::debug:
+                return spdlog::level::debug;
+            case LogLevel::info:
+                return spdlog::level::info;
+            case LogLevel::warn:
+                return spdlog::level::warn;
+            case LogLevel::error:
+                return spdlog::level::err;
+            case LogLevel::fatal:
+                return spdlog::level::critical;
+            default:
+                return spdlog::level::info;
+        }
+    }
+
+    LogSystem::ThreadLogBuffer* LogSystem::getThreadBuffer()
+    {
+        // the instance id guards against a buffer registered to a log system which has been destroyed
+        // the thread shares the ownership, so the drain thread can tell when the thread has exited
+        thread_local uint64_t                         t_instance_id {0};
+        thread_local std::shared_ptr<ThreadLogBuffer> t_buffer;
+
+        if (t_instance_id != m_instance_id)
+        {
+            t_buffer      = std::make_shared<ThreadLogBuffer>(m_thread_buffer_capacity);
+            t_instance_id = m_instance_id;
+
+            std::lock_guard<std::mutex> lock(m_thread_buffers_mutex);
+            m_thread_buffers.push_back(t_buffer);
+        }
+        return t_buffer.get();
+    }
+
+    void LogSystem::enqueue(LogLevel level, const spdlog::source_loc& location, std::string&& message)
+    {
+        thread_local size_t t_thread_id = spdlog::details::os::thread_id();
+
+        ThreadLogBuffer* buffer = getThreadBuffer();
+
+        size_t head = buffer->head.load(std::memory_order_relaxed);
+        if (head - buffer->tail.load(std::memory_order_acquire) >= buffer->records.size())
+        {
+            // never block the caller, the drain thread reports the dropped messages
+            m_dropped_count.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        ThreadLogBuffer::Record& record = buffer->records[head & buffer->mask];
+        record.time                     = spdlog::log_clock::now();
+        record.location                 = location;
+        record.level                    = toSpdlogLevel(level);
+        record.thread_id                = t_thread_id;
+        record.message                  = std::move(message);
+
+        buffer->head.store(head + 1, std::memory_order_release);
+        m_queued_count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    size_t LogSystem::drainThreadBuffers()
+    {
+        std::vector<std::shared_ptr<ThreadLogBuffer>> thread_buffers;
+        {
+            std::lock_guard<std::mutex> lock(m_thread_buffers_mutex);
+
+            // the buffers of exited threads are released once they have been drained
+            m_thread_buffers.erase(std::remove_if(m_thread_buffers.begin(),
+                                                  m_thread_buffers.end(),
+                                                  [](const std::shared_ptr<ThreadLogBuffer>& buffer) {
+                                                      return buffer.use_count() == 1 &&
+                                                             buffer->head.load() == buffer->tail.load();
+                                                  }),
+                                   m_thread_buffers.end());
+
+            thread_buffers = m_thread_buffers;
+        }
+
+        // collect first so that the messages of different threads are written in time order
+        thread_local std::vector<ThreadLogBuffer::Record> t_records;
+        t_records.clear();
+
+        for (const std::shared_ptr<ThreadLogBuffer>& buffer : thread_buffers)
+        {
+            size_t tail = buffer->tail.load(std::memory_order_relaxed);
+            size_t head = buffer->head.load(std::memory_order_acquire);
+            for (; tail != head; ++tail)
+            {
+                t_records.push_back(std::move(buffer->records[tail & buffer->mask]));
+            }
+            buffer->tail.store(tail, std::memory_order_release);
+        }
+
+        std::stable_sort(t_records.begin(),
+                         t_records.end(),
+                         [](const ThreadLogBuffer::Record& lhs, const ThreadLogBuffer::Record& rhs) {
+                             return lhs.time < rhs.time;
+                         });
+
+        for (const ThreadLogBuffer::Record& record : t_records)
+        {
+            spdlog::details::log_msg msg(
+                record.time, record.location, m_logger->name(), record.level, record.message);
+            msg.thread_id = record.thread_id;
+            for (const spdlog::sink_ptr& sink : m_logger->sinks())
+            {
+                if (sink->should_log(record.level))
+                {
+                    sink->log(msg);
+                }
+            }
+        }
+        m_written_count.fetch_add(t_records.size(), std::memory_order_relaxed);
+
+        return t_records.size();
+    }
+
+    void LogSystem::drainLoop()
+    {
+        uint64_t reported_dropped_count = 0;
+
+        while (true)
+        {
+            bool     stopping      = m_stop_draining.load();
+            uint64_t flush_request = m_flush_request.load();
+
+            size_t written_count = drainThreadBuffers();
+
+            if (flush_request != m_flush_done.load())
+            {
+                m_logger->flush();
+                {
+                    std::lock_guard<std::mutex> lock(m_flush_mutex);
+                    m_flush_done.store(flush_request);
+                }
+                m_flush_condition.notify_all();
+            }
+
+            uint64_t dropped_count = m_dropped_count.load(std::memory_order_relaxed);
+            if (dropped_count != reported_dropped_count)
+            {
+                m_logger->log(spdlog::source_loc {__FILE__, __LINE__, __FUNCTION__},
+                              spdlog::level::warn,
+                              "{} log messages dropped, the thread buffers are full",
+                              dropped_count - reported_dropped_count);
+                reported_dropped_count = dropped_count;
+            }
+
+            if (stopping)
+            {
+                break;
+            }
+
+            if (written_count == 0)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+    }
+
 } // namespace Piccolo
@@ -2,11 +2,39 @@
 
 #include <spdlog/spdlog.h>
 
+#include <atomic>
+#include <condition_variable>
 #include <cstdint>
+#include <filesystem>
+#include <mutex>
 #include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
 namespace Piccolo
 {
+    struct LogSystemInitInfo
+    {
+        // messages are staged in per thread buffers and written by a background thread, otherwise they are
+        // written by the calling thread
+        bool     enable_async {true};
+        uint32_t thread_buffer_capacity {1024}; // messages, rounded up to a power of two
+
+        // structured log file, one json object per line, disabled when empty
+        std::filesystem::path file_path;
+        size_t                max_file_size {5 * 1024 * 1024};
+        size_t                max_file_count {3};
+    };
+
+    struct LogStatistics
+    {
+        uint64_t queued_count {0};  // accepted into a thread buffer since startup
+        uint64_t dropped_count {0}; // rejected because the buffer of the thread was full
+        uint64_t written_count {0}; // handed to the sinks since startup
+        uint64_t pending_count {0}; // queued but not written yet
+    };
 
     class LogSystem final
     {
@@ -20,45 +48,167 @@ namespace Piccolo
             fatal
         };
 
+        // every log call belongs to the module of the file it is written in, see getModule
+        enum class LogModule : uint8_t
+        {
+            general,
+            core,
+            resource,
+            render,
+            physics,
+            animation,
+            particle,
+            script,
+            input,
+            editor,
+            count
+        };
+
     public:
-        LogSystem();
+        explicit LogSystem(const LogSystemInitInfo& init_info = LogSystemInitInfo {});
         ~LogSystem();
 
+        // checked by the LOG_* macros before the arguments are evaluated
+        bool shouldLog(LogLevel level, LogModule module) const
+        {
+            return static_cast<uint8_t>(level) >=
+                   m_module_levels[static_cast<uint8_t>(module)].load(std::memory_order_relaxed);
+        }
+
+        void     setLevel(LogLevel level);
+        void     setModuleLevel(LogModule module, LogLevel level);
+        LogLevel getModuleLevel(LogModule module) const;
+
+        void          flush();
+        LogStatistics getStatistics() const;
+
         template<typename... TARGS>
-        void log(LogLevel level, TARGS&&... args)
+        void log(LogLevel level, const spdlog::source_loc& location, TARGS&&... args)
         {
-            switch (level)
+            // a fatal log throws right after, so it is written synchronously behind the pending messages
+            if (m_enable_async && level == LogLevel::fatal)
+            {
+                flush();
+            }
+
+            if (!m_enable_async || level == LogLevel::fatal)
+            {
+                m_logger->log(location, toSpdlogLevel(level), std::forward<TARGS>(args)...);
+            }
+            else
+            {
+                enqueue(level, location, formatMessage(std::forward<TARGS>(args)...));
+            }
+
+            if (level == LogLevel::fatal)
             {
-                case LogLevel::debug:
-                    m_logger->debug(std::forward<TARGS>(args)...);
-                    break;
-                case LogLevel::info:
-                    m_logger->info(std::forward<TARGS>(args)...);
-                    break;
-                case LogLevel::warn:
-                    m_logger->warn(std::forward<TARGS>(args)...);
-                    break;
-                case LogLevel::error:
-                    m_logger->error(std::forward<TARGS>(args)...);
-                    break;
-                case LogLevel::fatal:
-                    m_logger->critical(std::forward<TARGS>(args)...);
-                    fatalCallback(std::forward<TARGS>(args)...);
-                    break;
-                default:
-                    break;
+                fatalCallback(std::forward<TARGS>(args)...);
             }
         }
 
         template<typename... TARGS>
         void fatalCallback(TARGS&&... args)
         {
-            const std::string format_str = fmt::format(std::forward<TARGS>(args)...);
+            const std::string format_str = formatMessage(std::forward<TARGS>(args)...);
             throw std::runtime_error(format_str);
         }
 
+        // resolved at compile time from __FILE__, the first matching directory wins
+        static constexpr LogModule getModule(const char* file)
+        {
+            if (containsPath(file, "function/render/"))
+                return LogModule::render;
+            if (containsPath(file, "function/physics/"))
+                return LogModule::physics;
+            if (containsPath(file, "function/animation/"))
+                return LogModule::animation;
+            if (containsPath(file, "function/particle/"))
+                return LogModule::particle;
+            if (containsPath(file, "component/lua/"))
+                return LogModule::script;
+            if (containsPath(file, "function/input/"))
+                return LogModule::input;
+            if (containsPath(file, "runtime/resource/"))
+                return LogModule::resource;
+            if (containsPath(file, "runtime/core/"))
+                return LogModule::core;
+            if (containsPath(file, "source/editor/"))
+                return LogModule::editor;
+            return LogModule::general;
+        }
+
+    private:
+        // substring search which treats '\' as '/' so that the module of msvc paths is found as well
+        static constexpr bool containsPath(const char* path, const char* pattern)
+        {
+            for (const char* start = path; *start != '\0'; ++start)
+            {
+                const char* p = start;
+                const char* q = pattern;
+                while (*q != '\0' && *p != '\0' && ((*p == '\\' ? '/' : *p) == *q))
+                {
+                    ++p;
+                    ++q;
+                }
+                if (*q == '\0')
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        static spdlog::level::level_enum toSpdlogLevel(LogLevel level);
+
+        // a single argument is the message itself, like in spdlog it is not used as a format string
+        template<typename T>
+        static std::string formatMessage(const T& message)
+        {
+            if constexpr (std::is_convertible_v<const T&, spdlog::string_view_t>)
+            {
+                spdlog::string_view_t message_view = message;
+                return std::string(message_view.data(), message_view.size());
+            }
+            else
+            {
+                return fmt::format("{}", message);
+            }
+        }
+
+        template<typename TFORMAT, typename TARG, typename... TARGS>
+        static std::string formatMessage(const TFORMAT& format, TARG&& arg, TARGS&&... args)
+        {
+            return fmt::format(format, std::forward<TARG>(arg), std::forward<TARGS>(args)...);
+        }
+
+        struct ThreadLogBuffer;
+
+        ThreadLogBuffer* getThreadBuffer();
+        void             enqueue(LogLevel level, const spdlog::source_loc& location, std::string&& message);
+        void             drainLoop();
+        size_t           drainThreadBuffers();
+
     private:
         std::shared_ptr<spdlog::logger> m_logger;
+
+        std::atomic<uint8_t> m_module_levels[static_cast<uint8_t>(LogModule::count)];
+
+        // async backend, every thread owns a single producer single consumer ring drained by m_drain_thread
+        bool                                          m_enable_async {false};
+        uint32_t                                      m_thread_buffer_capacity {0};
+        uint64_t                                      m_instance_id {0};
+        std::mutex                                    m_thread_buffers_mutex;
+        std::vector<std::shared_ptr<ThreadLogBuffer>> m_thread_buffers;
+        std::thread                                   m_drain_thread;
+        std::atomic<bool>                             m_stop_draining {false};
+        std::atomic<uint64_t>                         m_flush_request {0};
+        std::atomic<uint64_t>                         m_flush_done {0};
+        std::mutex                                    m_flush_mutex;
+        std::condition_variable                       m_flush_condition;
+
+        std::atomic<uint64_t> m_queued_count {0};
+        std::atomic<uint64_t> m_dropped_count {0};
+        std::atomic<uint64_t> m_written_count {0};
     };
 
-} // namespace Piccolo
\ No newline at end of file
+} // namespace Piccolo
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Piccolo
+{
+    // the binary form written by the generated Serializer::write(BinaryWriter&, const T&) specializations
+    // values are stored in the byte order of the host, cooked files are not meant to be moved across platforms
+    class BinaryWriter
+    {
+    public:
+        void writeBytes(const void* data, size_t size)
+        {
+            const char* bytes = static_cast<const char*>(data);
+            m_buffer.insert(m_buffer.end(), bytes, bytes + size);
+        }
+
+        template<typename T>
+        void writeValue(const T& value)
+        {
+            static_assert(std::is_arithmetic<T>::value, "BinaryWriter::writeValue only takes arithmetic types");
+            writeBytes(&value, sizeof(T));
+        }
+
+        void writeSize(size_t size) { writeValue(static_cast<uint32_t>(size)); }
+
+        void writeString(const std::string& value)
+        {
+            writeSize(value.size());
+            writeBytes(value.data(), value.size());
+        }
+
+        void reserve(size_t size) { m_buffer.reserve(size); }
+
+        const std::vector<char>& getBuffer() const { return m_buffer; }
+
+    private:
+        std::vector<char> m_buffer;
+    };
+
+    // reads the binary form from a buffer which is not copied
+    // the first error stops the reading, every following read fails and leaves its output untouched
+    class BinaryReader
+    {
+    public:
+        BinaryReader(const char* begin, const char* end) : m_begin(begin), m_cursor(begin), m_end(end) {}
+
+        bool readBytes(void* data, size_t size)
+        {
+            if (size > getRemainingSize())
+            {
+                return fail("unexpected end of data");
+            }
+            if (size != 0)
+            {
+                std::memcpy(data, m_cursor, size);
+            }
+            m_cursor += size;
+            return true;
+        }
+
+        template<typename T>
+        bool readValue(T& value)
+        {
+            static_assert(std::is_arithmetic<T>::value, "BinaryReader::readValue only takes arithmetic types");
+            return readBytes(&value, sizeof(T));
+        }
+
+        bool readSize(uint32_t& size) { return readValue(size); }
+
+        bool readString(std::string& value)
+        {
+            uint32_t size = 0;
+            if (!readSize(size))
+            {
+                return false;
+            }
+            if (size > getRemainingSize())
+            {
+                return fail("string longer than the data");
+            }
+            value.assign(m_cursor, size);
+            m_cursor += size;
+            return true;
+        }
+
+        size_t getRemainingSize() const { return static_cast<size_t>(m_end - m_cursor); }
+
+        bool fail(const char* error)
+        {
+            if (m_error.empty())
+            {
+                m_error        = error;
+                m_error_offset = static_cast<size_t>(m_cursor - m_begin);
+                m_cursor       = m_end;
+            }
+            return false;
+        }
+
+        bool               hasError() const { return !m_error.empty(); }
+        const std::string& getError() const { return m_error; }
+        size_t             getErrorOffset() const { return m_error_offset; }
+
+    private:
+        const char* m_begin {nullptr};
+        const char* m_cursor {nullptr};
+        const char* m_end {nullptr};
+
+        std::string m_error;
+        size_t      m_error_offset {0};
+    };
+} // namespace Piccolo
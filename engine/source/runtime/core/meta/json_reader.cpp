@@ -0,0 +1,432 @@
+#include "runtime/core/meta/json_reader.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+namespace Piccolo
+{
+    namespace
+    {
+        void appendUtf8(std::string& out, unsigned long code_point)
+        {
+            if (code_point < 0x80)
+            {
+                out += static_cast<char>(code_point);
+            }
+            else if (code_point < 0x800)
+            {
+                out += static_cast<char>((code_point >> 6) | 0xC0);
+                out += static_cast<char>((code_point & 0x3F) | 0x80);
+            }
+            else if (code_point < 0x10000)
+            {
+                out += static_cast<char>((code_point >> 12) | 0xE0);
+                out += static_cast<char>(((code_point >> 6) & 0x3F) | 0x80);
+                out += static_cast<char>((code_point & 0x3F) | 0x80);
+            }
+            else
+            {
+                out += static_cast<char>((code_point >> 18) | 0xF0);
+                out += static_cast<char>(((code_point >> 12) & 0x3F) | 0x80);
+                out += static_cast<char>(((code_point >> 6) & 0x3F) | 0x80);
+                out += static_cast<char>((code_point & 0x3F) | 0x80);
+            }
+        }
+
+        bool isNumberCharacter(char c)
+        {
+            return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+        }
+    } // namespace
+
+    JsonReader::JsonReader(const char* begin, const char* end) : m_begin(begin), m_cursor(begin), m_end(end) {}
+
+    JsonReader::JsonReader(std::string_view text) : JsonReader(text.data(), text.data() + text.size()) {}
+
+    void JsonReader::skipWhitespace()
+    {
+        while (m_cursor != m_end && (*m_cursor == ' ' || *m_cursor == '\t' || *m_cursor == '\n' || *m_cursor == '\r'))
+        {
+            ++m_cursor;
+        }
+    }
+
+    char JsonReader::peek()
+    {
+        skipWhitespace();
+        return (m_cursor != m_end && !hasError()) ? *m_cursor : '\0';
+    }
+
+    bool JsonReader::consume(char c)
+    {
+        if (peek() != c)
+        {
+            return false;
+        }
+        ++m_cursor;
+        return true;
+    }
+
+    bool JsonReader::fail(const char* error)
+    {
+        if (!hasError())
+        {
+            m_error        = error;
+            m_error_offset = static_cast<size_t>(m_cursor - m_begin);
+            m_cursor       = m_end;
+        }
+        return false;
+    }
+
+    bool JsonReader::beginObject()
+    {
+        if (!consume('{'))
+        {
+            return fail("expected object");
+        }
+        m_scope_state = ScopeState::first;
+        return true;
+    }
+
+    bool JsonReader::nextKey(std::string_view& key)
+    {
+        if (consume('}'))
+        {
+            m_scope_state = ScopeState::next;
+            return false;
+        }
+        if (m_scope_state == ScopeState::next && !consume(','))
+        {
+            return fail("expected ',' or '}' in object");
+        }
+        if (peek() != '"' || !parseStringView(key))
+        {
+            return fail("expected object key");
+        }
+        if (!consume(':'))
+        {
+            return fail("expected ':' after object key");
+        }
+        m_scope_state = ScopeState::next;
+        return true;
+    }
+
+    bool JsonReader::beginArray()
+    {
+        if (!consume('['))
+        {
+            return fail("expected array");
+        }
+        m_scope_state = ScopeState::first;
+        return true;
+    }
+
+    bool JsonReader::nextElement()
+    {
+        if (consume(']'))
+        {
+            m_scope_state = ScopeState::next;
+            return false;
+        }
+        if (m_scope_state == ScopeState::next && !consume(','))
+        {
+            return fail("expected ',' or ']' in array");
+        }
+        if (peek() == '\0')
+        {
+            return fail("unexpected end in array");
+        }
+        m_scope_state = ScopeState::next;
+        return true;
+    }
+
+    size_t JsonReader::copyNumberToken(char* token, size_t capacity)
+    {
+        skipWhitespace();
+
+        size_t length = 0;
+        while (m_cursor + length != m_end && isNumberCharacter(m_cursor[length]) && length < capacity - 1)
+        {
+            token[length] = m_cursor[length];
+            ++length;
+        }
+        token[length] = '\0';
+        return length;
+    }
+
+    bool JsonReader::readNumber(double& value)
+    {
+        char   token[64];
+        size_t length = copyNumberToken(token, sizeof(token));
+
+        char*  token_end = nullptr;
+        double number    = std::strtod(token, &token_end);
+        if (length == 0 || token_end != token + length)
+        {
+            return fail("expected number");
+        }
+
+        m_cursor += length;
+        value = number;
+        return true;
+    }
+
+    bool JsonReader::readInteger(long long& value)
+    {
+        char   token[64];
+        size_t length = copyNumberToken(token, sizeof(token));
+
+        // a fraction or an exponent is truncated like json11 does, strtod would round the 64 bit integers
+        if (std::strpbrk(token, ".eE") != nullptr)
+        {
+            double number = 0.0;
+            if (!readNumber(number))
+            {
+                return false;
+            }
+            value = static_cast<long long>(number);
+            return true;
+        }
+
+        errno = 0;
+
+        char*     token_end = nullptr;
+        long long number    = std::strtoll(token, &token_end, 10);
+        if (length == 0 || token_end != token + length)
+        {
+            return fail("expected integer");
+        }
+        if (errno == ERANGE)
+        {
+            return fail("integer out of range");
+        }
+
+        m_cursor += length;
+        value = number;
+        return true;
+    }
+
+    bool JsonReader::readBool(bool& value)
+    {
+        skipWhitespace();
+        if (m_end - m_cursor >= 4 && std::memcmp(m_cursor, "true", 4) == 0)
+        {
+            m_cursor += 4;
+            value = true;
+            return true;
+        }
+        if (m_end - m_cursor >= 5 && std::memcmp(m_cursor, "false", 5) == 0)
+        {
+            m_cursor += 5;
+            value = false;
+            return true;
+        }
+        return fail("expected bool");
+    }
+
+    bool JsonReader::readString(std::string& value)
+    {
+        if (peek() != '"')
+        {
+            return fail("expected string");
+        }
+        value.clear();
+        return parseString(value);
+    }
+
+    bool JsonReader::readNull()
+    {
+        skipWhitespace();
+        if (m_end - m_cursor >= 4 && std::memcmp(m_cursor, "null", 4) == 0)
+        {
+            m_cursor += 4;
+            return true;
+        }
+        return false;
+    }
+
+    bool JsonReader::isObject() { return peek() == '{'; }
+
+    bool JsonReader::isArray() { return peek() == '['; }
+
+    std::string_view JsonReader::skipValue()
+    {
+        char        c     = peek();
+        const char* begin = m_cursor;
+        switch (c)
+        {
+            case '{':
+                skipContainer('{', '}');
+                break;
+            case '[':
+                skipContainer('[', ']');
+                break;
+            case '"':
+            {
+                std::string_view ignored;
+                parseStringView(ignored);
+                break;
+            }
+            case 't':
+            case 'f':
+            {
+                bool ignored;
+                readBool(ignored);
+                break;
+            }
+            case 'n':
+                if (!readNull())
+                {
+                    fail("expected null");
+                }
+                break;
+            default:
+            {
+                double ignored;
+                readNumber(ignored);
+                break;
+            }
+        }
+        return hasError() ? std::string_view() : std::string_view(begin, static_cast<size_t>(m_cursor - begin));
+    }
+
+    bool JsonReader::skipContainer(char open, char close)
+    {
+        // the content is only scanned for strings and the nesting, it is validated by whoever reads it later
+        size_t depth = 0;
+        while (m_cursor != m_end)
+        {
+            char c = *m_cursor;
+            if (c == '"')
+            {
+                std::string_view ignored;
+                if (!parseStringView(ignored))
+                {
+                    return false;
+                }
+                continue;
+            }
+
+            ++m_cursor;
+            if (c == open)
+            {
+                ++depth;
+            }
+            else if (c == close && --depth == 0)
+            {
+                return true;
+            }
+        }
+        return fail("unexpected end in container");
+    }
+
+    bool JsonReader::parseStringView(std::string_view& value)
+    {
+        // the common case without escapes is returned in place
+        const char* begin = m_cursor + 1;
+        const char* it    = begin;
+        while (it != m_end && *it != '"' && *it != '\\')
+        {
+            ++it;
+        }
+        if (it != m_end && *it == '"')
+        {
+            value    = std::string_view(begin, static_cast<size_t>(it - begin));
+            m_cursor = it + 1;
+            return true;
+        }
+
+        m_key_buffer.clear();
+        if (!parseString(m_key_buffer))
+        {
+            return false;
+        }
+        value = m_key_buffer;
+        return true;
+    }
+
+    bool JsonReader::parseString(std::string& value)
+    {
+        ++m_cursor; // opening quote
+        while (true)
+        {
+            const char* run = m_cursor;
+            while (m_cursor != m_end && *m_cursor != '"' && *m_cursor != '\\')
+            {
+                ++m_cursor;
+            }
+            value.append(run, m_cursor);
+
+            if (m_cursor == m_end)
+            {
+                return fail("unexpected end in string");
+            }
+            if (*m_cursor++ == '"')
+            {
+                return true;
+            }
+
+            if (m_cursor == m_end)
+            {
+                return fail("unexpected end in string");
+            }
+            char escape = *m_cursor++;
+            switch (escape)
+            {
+                case '"':
+                case '\\':
+                case '/':
+                    value += escape;
+                    break;
+                case 'b':
+                    value += '\b';
+                    break;
+                case 'f':
+                    value += '\f';
+                    break;
+                case 'n':
+                    value += '\n';
+                    break;
+                case 'r':
+                    value += '\r';
+                    break;
+                case 't':
+                    value += '\t';
+                    break;
+                case 'u':
+                {
+                    if (m_end - m_cursor < 4)
+                    {
+                        return fail("unexpected end in string");
+                    }
+                    char          hex[5]     = {m_cursor[0], m_cursor[1], m_cursor[2], m_cursor[3], '\0'};
+                    char*         hex_end    = nullptr;
+                    unsigned long code_point = std::strtoul(hex, &hex_end, 16);
+                    if (hex_end != hex + 4)
+                    {
+                        return fail("bad \\u escape in string");
+                    }
+                    m_cursor += 4;
+
+                    // surrogate pair
+                    if (code_point >= 0xD800 && code_point <= 0xDBFF && m_end - m_cursor >= 6 && m_cursor[0] == '\\' &&
+                        m_cursor[1] == 'u')
+                    {
+                        char          low_hex[5] = {m_cursor[2], m_cursor[3], m_cursor[4], m_cursor[5], '\0'};
+                        unsigned long low        = std::strtoul(low_hex, &hex_end, 16);
+                        if (hex_end == low_hex + 4 && low >= 0xDC00 && low <= 0xDFFF)
+                        {
+                            code_point = (((code_point - 0xD800) << 10) | (low - 0xDC00)) + 0x10000;
+                            m_cursor += 6;
+                        }
+                    }
+                    appendUtf8(value, code_point);
+                    break;
+                }
+                default:
+                    return fail("bad escape in string");
+            }
+        }
+    }
+} // namespace Piccolo
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace Piccolo
+{
+    // pull parser over a json text which is not copied, the generated Serializer::read(JsonReader&, T&)
+    // specializations deserialize straight from it without building a json11 dom
+    // the first error stops the parsing, every following read fails and leaves its output untouched
+    class JsonReader
+    {
+    public:
+        JsonReader(const char* begin, const char* end);
+        explicit JsonReader(std::string_view text);
+
+        // object: for (reader.beginObject(); reader.nextKey(key);) { read or skip the value of key }
+        bool beginObject();
+        bool nextKey(std::string_view& key);
+
+        // array: for (reader.beginArray(); reader.nextElement();) { read the element }
+        bool beginArray();
+        bool nextElement();
+
+        bool readNumber(double& value);
+        bool readInteger(long long& value);
+        bool readBool(bool& value);
+        bool readString(std::string& value);
+        // consumes the value only when it is null
+        bool readNull();
+
+        // skips the next value and returns its text, the text can be read again by another reader
+        std::string_view skipValue();
+
+        bool isObject();
+        bool isArray();
+
+        bool               hasError() const { return !m_error.empty(); }
+        const std::string& getError() const { return m_error; }
+        size_t             getErrorOffset() const { return m_error_offset; }
+
+    private:
+        enum class ScopeState : unsigned char
+        {
+            first,
+            next
+        };
+
+        void skipWhitespace();
+        char peek();
+        bool consume(char c);
+        bool fail(const char* error);
+        // copies the number token at the cursor, the text is not null terminated
+        size_t copyNumberToken(char* token, size_t capacity);
+        bool parseString(std::string& value);
+        bool parseStringView(std::string_view& value);
+        bool skipContainer(char open, char close);
+
+    private:
+        const char* m_begin {nullptr};
+        const char* m_cursor {nullptr};
+        const char* m_end {nullptr};
+
+        // whether the next nextKey/nextElement is the first of its scope, enough for a single level because
+        // beginObject/beginArray reset it and the caller always handles a value before it moves on
+        ScopeState m_scope_state {ScopeState::first};
+
+        // keys with escapes are decoded here, the others point into the text
+        std::string m_key_buffer;
+
+        std::string m_error;
+        size_t      m_error_offset {0};
+    };
+} // namespace Piccolo
@@ -1,6 +1,7 @@
 #include "reflection.h"
+#include <algorithm>
 #include <cstring>
-#include <map>
+#include <memory>
 
 namespace Piccolo
 {
@@ -9,24 +10,89 @@ namespace Piccolo
         const char* k_unknown_type = "UnknownType";
         const char* k_unknown      = "Unknown";
 
-        static std::map<std::string, ClassFunctionTuple*>       m_class_map;
-        static std::multimap<std::string, FieldFunctionTuple*>  m_field_map;
-        static std::multimap<std::string, MethodFunctionTuple*> m_method_map;
-        static std::map<std::string, ArrayFunctionTuple*>       m_array_map;
+        // everything registered under one type name, built by metaRegister and only read afterwards
+        class TypeDescriptor
+        {
+        public:
+            TypeDescriptor(std::string_view type_name, uint32_t type_id) :
+                m_type_name(type_name), m_type_id(type_id), m_meta(this)
+            {}
+
+            std::string         m_type_name;
+            uint32_t            m_type_id {0};
+            ClassFunctionTuple* m_class_functions {nullptr};
+
+            std::vector<FieldAccessor>                   m_fields;
+            std::vector<MethodAccessor>                  m_methods;
+            std::unordered_map<std::string_view, size_t> m_field_indices;
+            std::unordered_map<std::string_view, size_t> m_method_indices;
+
+            // handed out by reference, every TypeMeta of this type points back here
+            TypeMeta m_meta;
+        };
+
+        // a type gets its id the first time its name is registered, as a class or as the type of a field or element
+        // so every name the accessors hand out resolves without a lookup, ids start at 1
+        static std::vector<std::unique_ptr<TypeDescriptor>>          m_type_descriptors;
+        static std::unordered_map<std::string_view, TypeDescriptor*> m_type_descriptor_map;
+        static std::unordered_map<std::string_view, ArrayFunctionTuple*> m_array_map;
+
+        // owned here, the accessors only point to them
+        static std::vector<FieldFunctionTuple*>  m_field_tuples;
+        static std::vector<MethodFunctionTuple*> m_method_tuples;
+
+        static const TypeMeta                   k_unknown_meta;
+        static const std::vector<FieldAccessor>  k_no_fields;
+        static const std::vector<MethodAccessor> k_no_methods;
+
+        static TypeDescriptor* findTypeDescriptor(std::string_view type_name)
+        {
+            auto iter = m_type_descriptor_map.find(type_name);
+            return iter != m_type_descriptor_map.end() ? iter->second : nullptr;
+        }
+
+        static TypeDescriptor* internTypeDescriptor(std::string_view type_name)
+        {
+            TypeDescriptor* descriptor = findTypeDescriptor(type_name);
+            if (descriptor == nullptr)
+            {
+                uint32_t type_id = static_cast<uint32_t>(m_type_descriptors.size()) + 1;
+                m_type_descriptors.emplace_back(std::make_unique<TypeDescriptor>(type_name, type_id));
+
+                descriptor = m_type_descriptors.back().get();
+                m_type_descriptor_map.emplace(descriptor->m_type_name, descriptor);
+            }
+            return descriptor;
+        }
 
         void TypeMetaRegisterinterface::registerToFieldMap(const char* name, FieldFunctionTuple* value)
         {
-            m_field_map.insert(std::make_pair(name, value));
+            TypeDescriptor* descriptor = internTypeDescriptor(name);
+
+            FieldAccessor field(value);
+            field.m_owner_type = descriptor;
+            field.m_field_type = internTypeDescriptor(field.m_field_type_name);
+
+            descriptor->m_field_indices.emplace(field.m_field_name, descriptor->m_fields.size());
+            descriptor->m_fields.emplace_back(field);
+            m_field_tuples.push_back(value);
         }
         void TypeMetaRegisterinterface::registerToMethodMap(const char* name, MethodFunctionTuple* value)
         {
-            m_method_map.insert(std::make_pair(name, value));
+            TypeDescriptor* descriptor = internTypeDescriptor(name);
+
+            MethodAccessor method(value);
+            descriptor->m_method_indices.emplace(method.m_method_name, descriptor->m_methods.size());
+            descriptor->m_methods.emplace_back(method);
+            m_method_tuples.push_back(value);
         }
         void TypeMetaRegisterinterface::registerToArrayMap(const char* name, ArrayFunctionTuple* value)
         {
             if (m_array_map.find(name) == m_array_map.end())
             {
+                // the generated names are string literals, they outlive the map
                 m_array_map.insert(std::make_pair(name, value));
+                internTypeDescriptor(std::get<4>(*value)());
             }
             else
             {
@@ -36,10 +102,10 @@ namespace Piccolo
 
         void TypeMetaRegisterinterface::registerToClassMap(const char* name, ClassFunctionTuple* value)
         {
-            // m_class_mapûҵעĶӦ򴴽һpairmap
-            if (m_class_map.find(name) == m_class_map.end())
+            TypeDescriptor* descriptor = internTypeDescriptor(name);
+            if (descriptor->m_class_functions == nullptr)
             {
-                m_class_map.insert(std::make_pair(name, value));
+                descriptor->m_class_functions = value;
             }
             else
             {
@@ -49,16 +115,22 @@ namespace Piccolo
 
         void TypeMetaRegisterinterface::unregisterAll()
         {
-            for (const auto& itr : m_field_map)
+            for (FieldFunctionTuple* field_tuple : m_field_tuples)
             {
-                delete itr.second;
+                delete field_tuple;
             }
-            m_field_map.clear();
-            for (const auto& itr : m_class_map)
+            m_field_tuples.clear();
+            for (MethodFunctionTuple* method_tuple : m_method_tuples)
             {
-                delete itr.second;
+                delete method_tuple;
+            }
+            m_method_tuples.clear();
+            for (const auto& descriptor : m_type_descriptors)
+            {
+                delete descriptor->m_class_functions;
             }
-            m_class_map.clear();
+            m_type_descriptor_map.clear();
+            m_type_descriptors.clear();
             for (const auto& itr : m_array_map)
             {
                 delete itr.second;
@@ -66,44 +138,17 @@ namespace Piccolo
             m_array_map.clear();
         }
 
-        TypeMeta::TypeMeta(std::string type_name) : m_type_name(type_name)
-        {
-            m_is_valid = false;
-            m_fields.clear();
-            m_methods.clear();
-
-            // equal_range()ҪmultimapжٸظԪ
-            // equal_rangeֵMap͵ĵ(pair)ֱָԪصʼλú͸ԪؽλõһԪصλ
-            auto fields_iter = m_field_map.equal_range(type_name);
-            while (fields_iter.first != fields_iter.second)
-            {
-                FieldAccessor f_field(fields_iter.first->second); // AccessorĹ캯TypeMetaFieldAccessorԪ࣬Կֱӵprivateĺι캯
-                m_fields.emplace_back(f_field); // ͨemplace_backȡf_fieldһֱԭعӵvector
-                m_is_valid = true;
+        TypeMeta::TypeMeta(const TypeDescriptor* descriptor) : m_descriptor(descriptor) {}
 
-                ++fields_iter.first;
-            }
+        TypeMeta::TypeMeta() : m_descriptor(nullptr) {}
 
-            auto methods_iter = m_method_map.equal_range(type_name);
-            while (methods_iter.first != methods_iter.second)
-            {
-                MethodAccessor f_method(methods_iter.first->second);
-                m_methods.emplace_back(f_method); 
-                m_is_valid = true;
-
-                ++methods_iter.first;
-            }
-        }
-
-        TypeMeta::TypeMeta() : m_type_name(k_unknown_type), m_is_valid(false) { m_fields.clear(); m_methods.clear(); }
-
-        TypeMeta TypeMeta::newMetaFromName(std::string type_name)
+        const TypeMeta& TypeMeta::newMetaFromName(std::string_view type_name)
         {
-            TypeMeta f_type(type_name);
-            return f_type;
+            const TypeDescriptor* descriptor = findTypeDescriptor(type_name);
+            return descriptor ? descriptor->m_meta : k_unknown_meta;
         }
 
-        bool TypeMeta::newArrayAccessorFromName(std::string array_type_name, ArrayAccessor& accessor)
+        bool TypeMeta::newArrayAccessorFromName(std::string_view array_type_name, ArrayAccessor& accessor)
         {
             auto iter = m_array_map.find(array_type_name);
 
@@ -117,102 +162,184 @@ namespace Piccolo
             return false;
         }
 
-        ReflectionInstance TypeMeta::newFromNameAndJson(std::string type_name, const Json& json_context)
+        ReflectionInstance TypeMeta::newFromNameAndJson(std::string_view type_name, const Json& json_context)
         {
-            auto iter = m_class_map.find(type_name);
+            const TypeDescriptor* descriptor = findTypeDescriptor(type_name);
 
-            if (iter != m_class_map.end())
+            if (descriptor && descriptor->m_class_functions)
             {
-                return ReflectionInstance(TypeMeta(type_name), (std::get<1>(*iter->second)(json_context)));
+                return ReflectionInstance(descriptor->m_meta,
+                                          (std::get<1>(*descriptor->m_class_functions)(json_context)));
             }
             return ReflectionInstance();
         }
 
-        Json TypeMeta::writeByName(std::string type_name, void* instance)
+        ReflectionInstance TypeMeta::newFromNameAndJsonReader(std::string_view type_name, JsonReader& reader)
         {
-            auto iter = m_class_map.find(type_name);
+            const TypeDescriptor* descriptor = findTypeDescriptor(type_name);
 
-            if (iter != m_class_map.end())
+            if (descriptor && descriptor->m_class_functions)
             {
-                return std::get<2>(*iter->second)(instance);
+                return ReflectionInstance(descriptor->m_meta, (std::get<3>(*descriptor->m_class_functions)(reader)));
+            }
+            reader.skipValue();
+            return ReflectionInstance();
+        }
+
+        ReflectionInstance TypeMeta::newFromNameAndBinary(std::string_view type_name, BinaryReader& reader)
+        {
+            const TypeDescriptor* descriptor = findTypeDescriptor(type_name);
+
+            if (descriptor && descriptor->m_class_functions)
+            {
+                return ReflectionInstance(descriptor->m_meta, (std::get<4>(*descriptor->m_class_functions)(reader)));
+            }
+            // the size of an unknown type is unknown as well, nothing after it can be read
+            reader.fail("unknown type in binary data");
+            return ReflectionInstance();
+        }
+
+        Json TypeMeta::writeByName(std::string_view type_name, void* instance)
+        {
+            const TypeDescriptor* descriptor = findTypeDescriptor(type_name);
+
+            if (descriptor && descriptor->m_class_functions)
+            {
+                return std::get<2>(*descriptor->m_class_functions)(instance);
             }
             return Json();
         }
 
-        std::string TypeMeta::getTypeName() { return m_type_name; }
+        void TypeMeta::writeBinaryByName(std::string_view type_name, BinaryWriter& writer, void* instance)
+        {
+            const TypeDescriptor* descriptor = findTypeDescriptor(type_name);
+
+            if (descriptor && descriptor->m_class_functions)
+            {
+                std::get<5>(*descriptor->m_class_functions)(writer, instance);
+            }
+        }
+
+        uint64_t TypeMeta::getBinarySchemaHashByName(std::string_view type_name)
+        {
+            const TypeDescriptor* descriptor = findTypeDescriptor(type_name);
+
+            if (descriptor && descriptor->m_class_functions)
+            {
+                return std::get<6>(*descriptor->m_class_functions)();
+            }
+            return 0;
+        }
+
+        uint64_t TypeMeta::getRegisteredBinarySchemaHash()
+        {
+            // by name, the ids depend on the registration order
+            std::vector<const TypeDescriptor*> descriptors;
+            for (const auto& descriptor : m_type_descriptors)
+            {
+                if (descriptor->m_class_functions)
+                {
+                    descriptors.push_back(descriptor.get());
+                }
+            }
+            std::sort(descriptors.begin(), descriptors.end(), [](const TypeDescriptor* lhs, const TypeDescriptor* rhs) {
+                return lhs->m_type_name < rhs->m_type_name;
+            });
+
+            // fnv-1a over the names and the hashes
+            uint64_t hash    = 0xcbf29ce484222325ULL;
+            auto     combine = [&hash](const void* data, size_t size) {
+                for (size_t i = 0; i < size; ++i)
+                {
+                    hash = (hash ^ static_cast<const unsigned char*>(data)[i]) * 0x100000001b3ULL;
+                }
+            };
+            for (const TypeDescriptor* descriptor : descriptors)
+            {
+                uint64_t schema_hash = std::get<6>(*descriptor->m_class_functions)();
+                combine(descriptor->m_type_name.data(), descriptor->m_type_name.size() + 1);
+                combine(&schema_hash, sizeof(schema_hash));
+            }
+            return hash;
+        }
+
+        std::string TypeMeta::getTypeName() const { return m_descriptor ? m_descriptor->m_type_name : k_unknown_type; }
+
+        uint32_t TypeMeta::getTypeId() const { return m_descriptor ? m_descriptor->m_type_id : 0; }
+
+        bool TypeMeta::isValid() const
+        {
+            return m_descriptor && (!m_descriptor->m_fields.empty() || !m_descriptor->m_methods.empty());
+        }
+
+        const std::vector<FieldAccessor>& TypeMeta::getFields() const
+        {
+            return m_descriptor ? m_descriptor->m_fields : k_no_fields;
+        }
+
+        const std::vector<MethodAccessor>& TypeMeta::getMethods() const
+        {
+            return m_descriptor ? m_descriptor->m_methods : k_no_methods;
+        }
 
         int TypeMeta::getFieldsList(FieldAccessor*& out_list)
         {
-            int count = m_fields.size();
+            const std::vector<FieldAccessor>& fields = getFields();
+
+            int count = static_cast<int>(fields.size());
             out_list  = new FieldAccessor[count];
             for (int i = 0; i < count; ++i)
             {
-                out_list[i] = m_fields[i];
+                out_list[i] = fields[i];
             }
             return count;
         }
 
         int TypeMeta::getMethodsList(MethodAccessor*& out_list)
         {
-            int count = m_methods.size();
+            const std::vector<MethodAccessor>& methods = getMethods();
+
+            int count = static_cast<int>(methods.size());
             out_list  = new MethodAccessor[count];
             for (int i = 0; i < count; ++i)
             {
-                out_list[i] = m_methods[i];
+                out_list[i] = methods[i];
             }
             return count;
         }
 
         int TypeMeta::getBaseClassReflectionInstanceList(ReflectionInstance*& out_list, void* instance)
         {
-            auto iter = m_class_map.find(m_type_name);
-
-            if (iter != m_class_map.end())
+            if (m_descriptor && m_descriptor->m_class_functions)
             {
-                return (std::get<0>(*iter->second))(out_list, instance);
+                return (std::get<0>(*m_descriptor->m_class_functions))(out_list, instance);
             }
 
             return 0;
         }
 
-        FieldAccessor TypeMeta::getFieldByName(const char* name)
+        FieldAccessor TypeMeta::getFieldByName(std::string_view name) const
         {
-            const auto it = std::find_if(m_fields.begin(), m_fields.end(), [&](const auto& i) {
-                return std::strcmp(i.getFieldName(), name) == 0;
-            });
-            if (it != m_fields.end())
-                return *it;
+            if (m_descriptor)
+            {
+                auto iter = m_descriptor->m_field_indices.find(name);
+                if (iter != m_descriptor->m_field_indices.end())
+                    return m_descriptor->m_fields[iter->second];
+            }
             return FieldAccessor(nullptr);
         }
 
-        MethodAccessor TypeMeta::getMethodByName(const char* name)
+        MethodAccessor TypeMeta::getMethodByName(std::string_view name) const
         {
-            const auto it = std::find_if(m_methods.begin(), m_methods.end(), [&](const auto& i) {
-                return std::strcmp(i.getMethodName(), name) == 0;
-            });
-            if (it != m_methods.end())
-                return *it;
-            return MethodAccessor(nullptr);
-        }
-
-        TypeMeta& TypeMeta::operator=(const TypeMeta& dest)
-        {
-            if (this == &dest)
+            if (m_descriptor)
             {
-                return *this;
+                auto iter = m_descriptor->m_method_indices.find(name);
+                if (iter != m_descriptor->m_method_indices.end())
+                    return m_descriptor->m_methods[iter->second];
             }
-            m_fields.clear();
-            m_fields = dest.m_fields;
-
-            
-            m_methods.clear();
-            m_methods = dest.m_methods;
-
-            m_type_name = dest.m_type_name;
-            m_is_valid  = dest.m_is_valid;
-
-            return *this;
+            return MethodAccessor(nullptr);
         }
+
         FieldAccessor::FieldAccessor()
         {
             m_field_type_name = k_unknown_type;
@@ -231,56 +358,38 @@ namespace Piccolo
 
             m_field_name      = (std::get<3>(*m_functions))(); // ɵreflectionļлȡԱ
             m_field_type_name = (std::get<4>(*m_functions))(); // ȡԱ
+            m_is_array        = (std::get<5>(*m_functions))();
         }
 
         // setget
-        void* FieldAccessor::get(void* instance)
+        void* FieldAccessor::get(void* instance) const
         {
             // todo: should check validation
             return static_cast<void*>((std::get<1>(*m_functions))(instance));
         }
 
-        void FieldAccessor::set(void* instance, void* value)
+        void FieldAccessor::set(void* instance, void* value) const
         {
             // todo: should check validation
             (std::get<0>(*m_functions))(instance, value);
         }
 
         // ȡ
-        TypeMeta FieldAccessor::getOwnerTypeMeta()
+        TypeMeta FieldAccessor::getOwnerTypeMeta() const
         {
-            // todo: should check validation
-            TypeMeta f_type((std::get<2>(*m_functions))());
-            return f_type;
+            return m_owner_type ? m_owner_type->m_meta : k_unknown_meta;
         }
 
-        bool FieldAccessor::getTypeMeta(TypeMeta& field_type)
+        bool FieldAccessor::getTypeMeta(TypeMeta& field_type) const
         {
-            TypeMeta f_type(m_field_type_name);
-            field_type = f_type;
-            return f_type.m_is_valid;
+            field_type = m_field_type ? m_field_type->m_meta : k_unknown_meta;
+            return field_type.isValid();
         }
 
         const char* FieldAccessor::getFieldName() const { return m_field_name; }
-        const char* FieldAccessor::getFieldTypeName() { return m_field_type_name; }
+        const char* FieldAccessor::getFieldTypeName() const { return m_field_type_name; }
 
-        bool FieldAccessor::isArrayType()
-        {
-            // todo: should check validation
-            return (std::get<5>(*m_functions))();
-        }
-
-        FieldAccessor& FieldAccessor::operator=(const FieldAccessor& dest)
-        {
-            if (this == &dest)
-            {
-                return *this;
-            }
-            m_functions       = dest.m_functions;
-            m_field_name      = dest.m_field_name;
-            m_field_type_name = dest.m_field_type_name;
-            return *this;
-        }
+        bool FieldAccessor::isArrayType() const { return m_is_array; }
 
         MethodAccessor::MethodAccessor()
         {
@@ -298,20 +407,8 @@ namespace Piccolo
 
             m_method_name      = (std::get<0>(*m_functions))();
         }
-        const char* MethodAccessor::getMethodName() const{
-            return (std::get<0>(*m_functions))();
-        }
-        MethodAccessor& MethodAccessor::operator=(const MethodAccessor& dest)
-        {
-            if (this == &dest)
-            {
-                return *this;
-            }
-            m_functions       = dest.m_functions;
-            m_method_name      = dest.m_method_name;
-            return *this;
-        }
-        void MethodAccessor::invoke(void* instance) { (std::get<1>(*m_functions))(instance); }
+        const char* MethodAccessor::getMethodName() const { return m_method_name; }
+        void MethodAccessor::invoke(void* instance) const { (std::get<1>(*m_functions))(instance); }
         ArrayAccessor::ArrayAccessor() :
             m_func(nullptr), m_array_type_name("UnKnownType"), m_element_type_name("UnKnownType")
         {}
@@ -1,10 +1,15 @@
 // Learn more about refletion: https://zhuanlan.zhihu.com/p/586485554
 
 #pragma once
+#include "runtime/core/meta/binary_stream.h"
 #include "runtime/core/meta/json.h"
+#include "runtime/core/meta/json_reader.h"
 
+#include <cstdint>
 #include <functional>
 #include <string>
+#include <string_view>
+#include <tuple>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -84,24 +89,37 @@ namespace Piccolo
         class MethodAccessor;
         class ArrayAccessor;
         class ReflectionInstance;
+        class TypeDescriptor;
     } // namespace Reflection
-    typedef std::function<void(void*, void*)>      SetFuncion;
-    typedef std::function<void*(void*)>            GetFuncion;
-    typedef std::function<const char*()>           GetNameFuncion;
-    typedef std::function<void(int, void*, void*)> SetArrayFunc;
-    typedef std::function<void*(int, void*)>       GetArrayFunc;
-    typedef std::function<int(void*)>              GetSizeFunc;
-    typedef std::function<bool()>                  GetBoolFunc;
-    typedef std::function<void(void*)>             InvokeFunction;
-
-    typedef std::function<void*(const Json&)>                           ConstructorWithJson;
-    typedef std::function<Json(void*)>                                  WriteJsonByName;
-    typedef std::function<int(Reflection::ReflectionInstance*&, void*)> GetBaseClassReflectionInstanceListFunc; // ȡʵбָ
+    // the generated operators only register static functions, plain function pointers save the std::function call
+    typedef void (*SetFuncion)(void*, void*);
+    typedef void* (*GetFuncion)(void*);
+    typedef const char* (*GetNameFuncion)();
+    typedef void (*SetArrayFunc)(int, void*, void*);
+    typedef void* (*GetArrayFunc)(int, void*);
+    typedef int (*GetSizeFunc)(void*);
+    typedef bool (*GetBoolFunc)();
+    typedef void (*InvokeFunction)(void*);
+
+    typedef void* (*ConstructorWithJson)(const Json&);
+    typedef void* (*ConstructorWithJsonReader)(JsonReader&);
+    typedef void* (*ConstructorWithBinary)(BinaryReader&);
+    typedef void (*WriteBinaryByName)(BinaryWriter&, void*);
+    typedef uint64_t (*GetBinarySchemaHashFunc)();
+    typedef Json (*WriteJsonByName)(void*);
+    typedef int (*GetBaseClassReflectionInstanceListFunc)(Reflection::ReflectionInstance*&, void*); // ȡʵбָ
 
     typedef std::tuple<SetFuncion, GetFuncion, GetNameFuncion, GetNameFuncion, GetNameFuncion, GetBoolFunc>
                                                        FieldFunctionTuple;
     typedef std::tuple<GetNameFuncion, InvokeFunction> MethodFunctionTuple;
-    typedef std::tuple<GetBaseClassReflectionInstanceListFunc, ConstructorWithJson, WriteJsonByName> ClassFunctionTuple; // кĺָ
+    typedef std::tuple<GetBaseClassReflectionInstanceListFunc,
+                       ConstructorWithJson,
+                       WriteJsonByName,
+                       ConstructorWithJsonReader,
+                       ConstructorWithBinary,
+                       WriteBinaryByName,
+                       GetBinarySchemaHashFunc>
+        ClassFunctionTuple; // кĺָ
     typedef std::tuple<SetArrayFunc, GetArrayFunc, GetSizeFunc, GetNameFuncion, GetNameFuncion>      ArrayFunctionTuple; // 麯ָ
 
     namespace Reflection
@@ -119,10 +137,13 @@ namespace Piccolo
             static void unregisterAll();
         };
         // һֶεԪϢ
+        // a handle to the registry entry of the type, the entries are built once by metaRegister and looked up by
+        // hash, copying a TypeMeta copies one pointer
         class TypeMeta
         {
             friend class FieldAccessor;
             friend class ArrayAccessor;
+            friend class TypeDescriptor;
             friend class TypeMetaRegisterinterface;
 
         public:
@@ -130,48 +151,61 @@ namespace Piccolo
 
             // static void Register();
 
-            static TypeMeta newMetaFromName(std::string type_name);
-
-            static bool               newArrayAccessorFromName(std::string array_type_name, ArrayAccessor& accessor);
-            static ReflectionInstance newFromNameAndJson(std::string type_name, const Json& json_context);
-            static Json               writeByName(std::string type_name, void* instance);
-
-            std::string getTypeName();
-
+            // the cached meta of the type, an invalid one for a name which has never been registered
+            static const TypeMeta& newMetaFromName(std::string_view type_name);
+
+            static bool newArrayAccessorFromName(std::string_view array_type_name, ArrayAccessor& accessor);
+            static ReflectionInstance newFromNameAndJson(std::string_view type_name, const Json& json_context);
+            static ReflectionInstance newFromNameAndJsonReader(std::string_view type_name, JsonReader& reader);
+            static ReflectionInstance newFromNameAndBinary(std::string_view type_name, BinaryReader& reader);
+            static void writeBinaryByName(std::string_view type_name, BinaryWriter& writer, void* instance);
+            // Serializer::getBinarySchemaHash of the registered class, 0 for an unknown type
+            static uint64_t getBinarySchemaHashByName(std::string_view type_name);
+            // the schema hashes of every registered class, for the binary data whose pointees are only known by name
+            static uint64_t getRegisteredBinarySchemaHash();
+            static Json writeByName(std::string_view type_name, void* instance);
+
+            std::string getTypeName() const;
+            // interned when the type is registered, 0 for an unknown type
+            uint32_t getTypeId() const;
+
+            // the registered accessors in declaration order, nothing is copied
+            const std::vector<FieldAccessor>&  getFields() const;
+            const std::vector<MethodAccessor>& getMethods() const;
+
+            // copies of getFields/getMethods in a new[] array the caller deletes
             int getFieldsList(FieldAccessor*& out_list);
             int getMethodsList(MethodAccessor*& out_list);
 
             int getBaseClassReflectionInstanceList(ReflectionInstance*& out_list, void* instance);
 
-            FieldAccessor getFieldByName(const char* name);
-            MethodAccessor getMethodByName(const char* name);
+            FieldAccessor  getFieldByName(std::string_view name) const;
+            MethodAccessor getMethodByName(std::string_view name) const;
 
-            bool isValid() { return m_is_valid; }
+            bool isValid() const;
 
-            TypeMeta& operator=(const TypeMeta& dest);
+            bool operator==(const TypeMeta& rhs) const { return m_descriptor == rhs.m_descriptor; }
+            bool operator!=(const TypeMeta& rhs) const { return m_descriptor != rhs.m_descriptor; }
 
         private:
-            TypeMeta(std::string type_name);
+            explicit TypeMeta(const TypeDescriptor* descriptor);
 
         private:
-            std::vector<FieldAccessor>   m_fields;
-            std::vector<MethodAccessor>  m_methods;
-            std::string                  m_type_name;
-
-            bool m_is_valid;
+            const TypeDescriptor* m_descriptor;
         };
 
         class FieldAccessor
         {
             friend class TypeMeta;
+            friend class TypeMetaRegisterinterface;
 
         public:
             FieldAccessor();
 
-            void* get(void* instance);
-            void  set(void* instance, void* value);
+            void* get(void* instance) const;
+            void  set(void* instance, void* value) const;
 
-            TypeMeta getOwnerTypeMeta();
+            TypeMeta getOwnerTypeMeta() const;
 
             /**
              * param: TypeMeta out_type
@@ -181,33 +215,39 @@ namespace Piccolo
              *        true: it's a reflection type
              *        false: it's not a reflection type
              */
-            bool        getTypeMeta(TypeMeta& field_type);
+            bool        getTypeMeta(TypeMeta& field_type) const;
             const char* getFieldName() const;
-            const char* getFieldTypeName();
-            bool        isArrayType();
+            const char* getFieldTypeName() const;
+            bool        isArrayType() const;
 
-            FieldAccessor& operator=(const FieldAccessor& dest);
+            // false for the accessor returned when getFieldByName finds nothing
+            bool isValid() const { return m_functions != nullptr; }
 
         private:
             FieldAccessor(FieldFunctionTuple* functions);
 
         private:
-            FieldFunctionTuple* m_functions;
-            const char*         m_field_name;
-            const char*         m_field_type_name;
+            FieldFunctionTuple*   m_functions;
+            const char*           m_field_name;
+            const char*           m_field_type_name;
+            bool                  m_is_array {false};
+            const TypeDescriptor* m_owner_type {nullptr};
+            const TypeDescriptor* m_field_type {nullptr};
         };
         class MethodAccessor
         {
             friend class TypeMeta;
+            friend class TypeMetaRegisterinterface;
 
         public:
             MethodAccessor();
 
-            void invoke(void* instance);
+            void invoke(void* instance) const;
 
             const char* getMethodName() const;
 
-            MethodAccessor& operator=(const MethodAccessor& dest);
+            // false for the accessor returned when getMethodByName finds nothing
+            bool isValid() const { return m_functions != nullptr; }
 
         private:
             MethodAccessor(MethodFunctionTuple* functions);
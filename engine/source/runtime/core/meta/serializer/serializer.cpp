@@ -14,6 +14,27 @@ namespace Piccolo
         assert(json_context.is_number());
         return instance = json_context.number_value();
     }
+    template<>
+    char& Serializer::read(JsonReader& reader, char& instance)
+    {
+        double value = 0.0;
+        if (reader.readNumber(value))
+        {
+            instance = static_cast<char>(value);
+        }
+        return instance;
+    }
+    template<>
+    void Serializer::write(BinaryWriter& writer, const char& instance)
+    {
+        writer.writeValue(instance);
+    }
+    template<>
+    char& Serializer::read(BinaryReader& reader, char& instance)
+    {
+        reader.readValue(instance);
+        return instance;
+    }
 
     template<>
     Json Serializer::write(const int& instance)
@@ -26,6 +47,27 @@ namespace Piccolo
         assert(json_context.is_number());
         return instance = static_cast<int>(json_context.number_value());
     }
+    template<>
+    int& Serializer::read(JsonReader& reader, int& instance)
+    {
+        long long value = 0;
+        if (reader.readInteger(value))
+        {
+            instance = static_cast<int>(value);
+        }
+        return instance;
+    }
+    template<>
+    void Serializer::write(BinaryWriter& writer, const int& instance)
+    {
+        writer.writeValue(instance);
+    }
+    template<>
+    int& Serializer::read(BinaryReader& reader, int& instance)
+    {
+        reader.readValue(instance);
+        return instance;
+    }
 
     template<>
     Json Serializer::write(const unsigned int& instance)
@@ -38,6 +80,27 @@ namespace Piccolo
         assert(json_context.is_number());
         return instance = static_cast<unsigned int>(json_context.number_value());
     }
+    template<>
+    unsigned int& Serializer::read(JsonReader& reader, unsigned int& instance)
+    {
+        long long value = 0;
+        if (reader.readInteger(value))
+        {
+            instance = static_cast<unsigned int>(value);
+        }
+        return instance;
+    }
+    template<>
+    void Serializer::write(BinaryWriter& writer, const unsigned int& instance)
+    {
+        writer.writeValue(instance);
+    }
+    template<>
+    unsigned int& Serializer::read(BinaryReader& reader, unsigned int& instance)
+    {
+        reader.readValue(instance);
+        return instance;
+    }
 
     template<>
     Json Serializer::write(const float& instance)
@@ -50,6 +113,27 @@ namespace Piccolo
         assert(json_context.is_number());
         return instance = static_cast<float>(json_context.number_value());
     }
+    template<>
+    float& Serializer::read(JsonReader& reader, float& instance)
+    {
+        double value = 0.0;
+        if (reader.readNumber(value))
+        {
+            instance = static_cast<float>(value);
+        }
+        return instance;
+    }
+    template<>
+    void Serializer::write(BinaryWriter& writer, const float& instance)
+    {
+        writer.writeValue(instance);
+    }
+    template<>
+    float& Serializer::read(BinaryReader& reader, float& instance)
+    {
+        reader.readValue(instance);
+        return instance;
+    }
 
     template<>
     Json Serializer::write(const double& instance)
@@ -62,6 +146,23 @@ namespace Piccolo
         assert(json_context.is_number());
         return instance = static_cast<float>(json_context.number_value());
     }
+    template<>
+    double& Serializer::read(JsonReader& reader, double& instance)
+    {
+        reader.readNumber(instance);
+        return instance;
+    }
+    template<>
+    void Serializer::write(BinaryWriter& writer, const double& instance)
+    {
+        writer.writeValue(instance);
+    }
+    template<>
+    double& Serializer::read(BinaryReader& reader, double& instance)
+    {
+        reader.readValue(instance);
+        return instance;
+    }
 
     template<>
     Json Serializer::write(const bool& instance)
@@ -74,6 +175,23 @@ namespace Piccolo
         assert(json_context.is_bool());
         return instance = json_context.bool_value();
     }
+    template<>
+    bool& Serializer::read(JsonReader& reader, bool& instance)
+    {
+        reader.readBool(instance);
+        return instance;
+    }
+    template<>
+    void Serializer::write(BinaryWriter& writer, const bool& instance)
+    {
+        writer.writeValue(instance);
+    }
+    template<>
+    bool& Serializer::read(BinaryReader& reader, bool& instance)
+    {
+        reader.readValue(instance);
+        return instance;
+    }
 
     template<>
     Json Serializer::write(const std::string& instance)
@@ -86,6 +204,23 @@ namespace Piccolo
         assert(json_context.is_string());
         return instance = json_context.string_value();
     }
+    template<>
+    std::string& Serializer::read(JsonReader& reader, std::string& instance)
+    {
+        reader.readString(instance);
+        return instance;
+    }
+    template<>
+    void Serializer::write(BinaryWriter& writer, const std::string& instance)
+    {
+        writer.writeString(instance);
+    }
+    template<>
+    std::string& Serializer::read(BinaryReader& reader, std::string& instance)
+    {
+        reader.readString(instance);
+        return instance;
+    }
 
     // template<>
     // Json Serializer::write(const Reflection::object& instance)
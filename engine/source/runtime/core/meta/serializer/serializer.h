@@ -1,14 +1,34 @@
 #pragma once
+#include "runtime/core/meta/binary_stream.h"
 #include "runtime/core/meta/json.h"
+#include "runtime/core/meta/json_reader.h"
 #include "runtime/core/meta/reflection/reflection.h"
 
+#include <algorithm>
 #include <cassert>
+#include <string_view>
 
 namespace Piccolo
 {
     template<typename...>
     inline constexpr bool always_false = false;
 
+    template<typename T>
+    struct is_std_vector : std::false_type
+    {};
+
+    template<typename T, typename Allocator>
+    struct is_std_vector<std::vector<T, Allocator>> : std::true_type
+    {};
+
+    template<typename T>
+    struct is_reflection_ptr : std::false_type
+    {};
+
+    template<typename T>
+    struct is_reflection_ptr<Reflection::ReflectionPtr<T>> : std::true_type
+    {};
+
     class Serializer
     {
     public:
@@ -37,6 +57,53 @@ namespace Piccolo
             return instance;
         }
 
+        template<typename T>
+        static T*& readPointer(JsonReader& reader, T*& instance, std::string* out_type_name = nullptr)
+        {
+            assert(instance == nullptr);
+            std::string      type_name;
+            std::string_view context_text;
+            std::string_view key;
+            for (reader.beginObject(); reader.nextKey(key);)
+            {
+                if (key == "$typeName")
+                {
+                    reader.readString(type_name);
+                }
+                else if (key == "$context")
+                {
+                    // json11 dumps the keys sorted, so the context comes before the type name it depends on
+                    context_text = reader.skipValue();
+                }
+                else
+                {
+                    reader.skipValue();
+                }
+            }
+            if (out_type_name)
+            {
+                *out_type_name = type_name;
+            }
+            if (reader.hasError())
+            {
+                return instance;
+            }
+
+            assert(!type_name.empty());
+            JsonReader context_reader(context_text);
+            if ('*' == type_name[0])
+            {
+                instance = new T;
+                read(context_reader, *instance);
+            }
+            else
+            {
+                instance = static_cast<T*>(
+                    Reflection::TypeMeta::newFromNameAndJsonReader(type_name, context_reader).m_instance);
+            }
+            return instance;
+        }
+
         template<typename T>
         static Json write(const Reflection::ReflectionPtr<T>& instance)
         {
@@ -54,6 +121,15 @@ namespace Piccolo
             return readPointer(json_context, instance.getPtrReference());
         }
 
+        template<typename T>
+        static T*& read(JsonReader& reader, Reflection::ReflectionPtr<T>& instance)
+        {
+            std::string type_name;
+            readPointer(reader, instance.getPtrReference(), &type_name);
+            instance.setTypeName(type_name);
+            return instance.getPtrReference();
+        }
+
         template<typename T>
         static Json write(const T& instance)
         {
@@ -82,6 +158,206 @@ namespace Piccolo
                 return instance;
             }
         }
+
+        // streaming counterpart of read(const Json&, T&), the generated specializations read the fields straight
+        // from the text, errors are kept by the reader
+        template<typename T>
+        static T& read(JsonReader& reader, T& instance)
+        {
+            if constexpr (std::is_pointer<T>::value)
+            {
+                return readPointer(reader, instance);
+            }
+            else
+            {
+                static_assert(always_false<T>, "Serializer::read<T> has not been implemented yet!");
+                return instance;
+            }
+        }
+
+        // reads the value of the field named field_name, including the fields of the base classes,
+        // returns false when the type has no such field
+        template<typename T>
+        static bool readField(JsonReader& reader, std::string_view field_name, T& instance)
+        {
+            static_assert(always_false<T>, "Serializer::readField<T> has not been implemented yet!");
+            return false;
+        }
+
+        // binary form: the fields in declaration order after the ones of the base classes, without names,
+        // a change of the layout is caught by comparing getBinarySchemaHash of the root type
+        template<typename T>
+        static void writePointer(BinaryWriter& writer, T* instance)
+        {
+            writer.writeValue(static_cast<uint8_t>(instance != nullptr));
+            if (instance)
+            {
+                write(writer, *instance);
+            }
+        }
+
+        template<typename T>
+        static T*& readPointer(BinaryReader& reader, T*& instance)
+        {
+            assert(instance == nullptr);
+            uint8_t has_instance = 0;
+            if (reader.readValue(has_instance) && has_instance)
+            {
+                instance = new T;
+                read(reader, *instance);
+            }
+            return instance;
+        }
+
+        // the pointee is only known by name, its schema hash follows the name so that a pointee whose layout
+        // changed fails the read instead of being read with the wrong layout
+        template<typename T>
+        static void write(BinaryWriter& writer, const Reflection::ReflectionPtr<T>& instance)
+        {
+            std::string type_name = instance.getTypeName();
+            writer.writeString(type_name);
+            writer.writeValue(Reflection::TypeMeta::getBinarySchemaHashByName(type_name));
+            Reflection::TypeMeta::writeBinaryByName(type_name, writer, instance.operator->());
+        }
+
+        template<typename T>
+        static T*& read(BinaryReader& reader, Reflection::ReflectionPtr<T>& instance)
+        {
+            std::string type_name;
+            uint64_t    schema_hash = 0;
+            if (reader.readString(type_name) && reader.readValue(schema_hash))
+            {
+                if (schema_hash != Reflection::TypeMeta::getBinarySchemaHashByName(type_name))
+                {
+                    reader.fail("the layout of a polymorphic pointee changed");
+                    return instance.getPtrReference();
+                }
+                instance.setTypeName(type_name);
+                instance.getPtrReference() =
+                    static_cast<T*>(Reflection::TypeMeta::newFromNameAndBinary(type_name, reader).m_instance);
+            }
+            return instance.getPtrReference();
+        }
+
+        template<typename T>
+        static void write(BinaryWriter& writer, const std::vector<T>& instance)
+        {
+            writer.writeSize(instance.size());
+            if constexpr (std::is_trivially_copyable<T>::value)
+            {
+                if (isBinaryBlittable<T>())
+                {
+                    writer.writeBytes(instance.data(), instance.size() * sizeof(T));
+                    return;
+                }
+            }
+            for (const T& item : instance)
+            {
+                write(writer, item);
+            }
+        }
+
+        template<typename T>
+        static std::vector<T>& read(BinaryReader& reader, std::vector<T>& instance)
+        {
+            uint32_t size = 0;
+            if (!reader.readSize(size))
+            {
+                return instance;
+            }
+            if constexpr (std::is_trivially_copyable<T>::value)
+            {
+                if (isBinaryBlittable<T>())
+                {
+                    if (static_cast<size_t>(size) * sizeof(T) > reader.getRemainingSize())
+                    {
+                        reader.fail("array longer than the data");
+                        return instance;
+                    }
+                    instance.resize(size);
+                    reader.readBytes(instance.data(), instance.size() * sizeof(T));
+                    return instance;
+                }
+            }
+            instance.clear();
+            instance.reserve(std::min(static_cast<size_t>(size), reader.getRemainingSize()));
+            for (uint32_t index = 0; index < size && !reader.hasError(); ++index)
+            {
+                read(reader, instance.emplace_back());
+            }
+            return instance;
+        }
+
+        template<typename T>
+        static void write(BinaryWriter& writer, const T& instance)
+        {
+            if constexpr (std::is_pointer<T>::value)
+            {
+                writePointer(writer, (T)instance);
+            }
+            else
+            {
+                static_assert(always_false<T>, "Serializer::write<T> has not been implemented yet!");
+            }
+        }
+
+        template<typename T>
+        static T& read(BinaryReader& reader, T& instance)
+        {
+            if constexpr (std::is_pointer<T>::value)
+            {
+                return readPointer(reader, instance);
+            }
+            else
+            {
+                static_assert(always_false<T>, "Serializer::read<T> has not been implemented yet!");
+                return instance;
+            }
+        }
+
+        // whether an array of T can be copied as raw memory, the generated specializations accept the reflected
+        // classes made of such fields only, without padding or members hidden from the reflection
+        template<typename T>
+        static bool isBinaryBlittable()
+        {
+            return std::is_arithmetic<T>::value;
+        }
+
+        template<typename T>
+        static uint64_t getBinarySchemaHash()
+        {
+            if constexpr (std::is_arithmetic<T>::value)
+            {
+                return combineBinarySchemaHash(std::is_floating_point<T>::value ? 0x66 : 0x69, sizeof(T));
+            }
+            else if constexpr (std::is_same<T, std::string>::value)
+            {
+                return 0x73;
+            }
+            else if constexpr (is_std_vector<T>::value)
+            {
+                return combineBinarySchemaHash(0x5b, getBinarySchemaHash<typename T::value_type>());
+            }
+            else if constexpr (std::is_pointer<T>::value)
+            {
+                return combineBinarySchemaHash(0x2a, getBinarySchemaHash<std::remove_cv_t<std::remove_pointer_t<T>>>());
+            }
+            else if constexpr (is_reflection_ptr<T>::value)
+            {
+                // the pointee type is only known when reading, its record carries its own schema hash
+                return 0x25;
+            }
+            else
+            {
+                static_assert(always_false<T>, "Serializer::getBinarySchemaHash<T> has not been implemented yet!");
+                return 0;
+            }
+        }
+
+        static uint64_t combineBinarySchemaHash(uint64_t seed, uint64_t value)
+        {
+            return seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+        }
     };
 
     // implementation of base types
@@ -89,36 +365,78 @@ namespace Piccolo
     Json Serializer::write(const char& instance);
     template<>
     char& Serializer::read(const Json& json_context, char& instance);
+    template<>
+    char& Serializer::read(JsonReader& reader, char& instance);
+    template<>
+    void Serializer::write(BinaryWriter& writer, const char& instance);
+    template<>
+    char& Serializer::read(BinaryReader& reader, char& instance);
 
     template<>
     Json Serializer::write(const int& instance);
     template<>
     int& Serializer::read(const Json& json_context, int& instance);
+    template<>
+    int& Serializer::read(JsonReader& reader, int& instance);
+    template<>
+    void Serializer::write(BinaryWriter& writer, const int& instance);
+    template<>
+    int& Serializer::read(BinaryReader& reader, int& instance);
 
     template<>
     Json Serializer::write(const unsigned int& instance);
     template<>
     unsigned int& Serializer::read(const Json& json_context, unsigned int& instance);
+    template<>
+    unsigned int& Serializer::read(JsonReader& reader, unsigned int& instance);
+    template<>
+    void Serializer::write(BinaryWriter& writer, const unsigned int& instance);
+    template<>
+    unsigned int& Serializer::read(BinaryReader& reader, unsigned int& instance);
 
     template<>
     Json Serializer::write(const float& instance);
     template<>
     float& Serializer::read(const Json& json_context, float& instance);
+    template<>
+    float& Serializer::read(JsonReader& reader, float& instance);
+    template<>
+    void Serializer::write(BinaryWriter& writer, const float& instance);
+    template<>
+    float& Serializer::read(BinaryReader& reader, float& instance);
 
     template<>
     Json Serializer::write(const double& instance);
     template<>
     double& Serializer::read(const Json& json_context, double& instance);
+    template<>
+    double& Serializer::read(JsonReader& reader, double& instance);
+    template<>
+    void Serializer::write(BinaryWriter& writer, const double& instance);
+    template<>
+    double& Serializer::read(BinaryReader& reader, double& instance);
 
     template<>
     Json Serializer::write(const bool& instance);
     template<>
     bool& Serializer::read(const Json& json_context, bool& instance);
+    template<>
+    bool& Serializer::read(JsonReader& reader, bool& instance);
+    template<>
+    void Serializer::write(BinaryWriter& writer, const bool& instance);
+    template<>
+    bool& Serializer::read(BinaryReader& reader, bool& instance);
 
     template<>
     Json Serializer::write(const std::string& instance);
     template<>
     std::string& Serializer::read(const Json& json_context, std::string& instance);
+    template<>
+    std::string& Serializer::read(JsonReader& reader, std::string& instance);
+    template<>
+    void Serializer::write(BinaryWriter& writer, const std::string& instance);
+    template<>
+    std::string& Serializer::read(BinaryReader& reader, std::string& instance);
 
     // template<>
     // Json Serializer::write(const Reflection::object& instance);
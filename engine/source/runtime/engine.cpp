@@ -11,6 +11,7 @@
 #include "runtime/function/render/render_system.h"
 #include "runtime/function/render/window_system.h"
 #include "runtime/function/render/debugdraw/debug_draw_manager.h"
+#include "runtime/platform/file_watcher/file_watcher.h"
 
 namespace Piccolo
 {
@@ -92,7 +93,11 @@ namespace Piccolo
 
     void PiccoloEngine::logicalTick(float delta_time)
     {
+        // the listeners of the file changes run before the world sees the frame
+        g_runtime_global_context.m_file_watcher->tick();
         g_runtime_global_context.m_world_manager->tick(delta_time);
+        // the emitters ticked by the world are simulated before the swap, the render tick uploads them
+        g_runtime_global_context.m_particle_manager->tick(delta_time);
         g_runtime_global_context.m_input_system->tick();
     }
 
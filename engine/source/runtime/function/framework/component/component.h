@@ -1,6 +1,9 @@
 #pragma once
 #include "runtime/core/meta/reflection/reflection.h"
 
+#include <string>
+#include <vector>
+
 namespace Piccolo
 {
     class GObject;
@@ -21,6 +24,10 @@ namespace Piccolo
         // Instantiating the component after definition loaded
         virtual void postLoadResource(std::weak_ptr<GObject> parent_object) { m_parent_object = parent_object; }
 
+        // the assets postLoadResource reads besides the component itself, the component is loaded again when one of
+        // them changes
+        virtual void getAssetDependencies(std::vector<std::string>& out_asset_urls) const {}
+
         virtual void tick(float delta_time) {};
 
         bool isDirty() const { return m_is_dirty; }
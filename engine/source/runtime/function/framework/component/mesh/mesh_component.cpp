@@ -56,6 +56,18 @@ namespace Piccolo
         }
     }
 
+    void MeshComponent::getAssetDependencies(std::vector<std::string>& out_asset_urls) const
+    {
+        // the mesh files and the textures are reloaded by the render system, only the materials map to other files
+        for (const SubMeshRes& sub_mesh : m_mesh_res.m_sub_meshes)
+        {
+            if (!sub_mesh.m_material.empty())
+            {
+                out_asset_urls.push_back(sub_mesh.m_material);
+            }
+        }
+    }
+
     void MeshComponent::tick(float delta_time)
     {
         if (!m_parent_object.lock())
@@ -20,6 +20,7 @@ namespace Piccolo
         MeshComponent() {};
 
         void postLoadResource(std::weak_ptr<GObject> parent_object) override;
+        void getAssetDependencies(std::vector<std::string>& out_asset_urls) const override;
 
         const std::vector<GameObjectPartDesc>& getRawMeshes() const { return m_raw_meshes; }
 
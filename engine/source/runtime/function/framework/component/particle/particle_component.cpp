@@ -49,12 +49,16 @@ namespace Piccolo
 
         logic_swap_data.addTickParticleEmitter(m_transform_desc.m_id);
 
+        std::shared_ptr<ParticleManager> particle_manager = g_runtime_global_context.m_particle_manager;
+        particle_manager->tickEmitter(m_transform_desc.m_id);
+
         TransformComponent* transform_component = m_parent_object.lock()->tryGetComponent(TransformComponent);
         if (transform_component->isDirty())
         {
             computeGlobalTransform();
 
             logic_swap_data.updateParticleTransform(m_transform_desc);
+            particle_manager->updateEmitterTransform(m_transform_desc);
         }
     }
 }; // namespace Piccolo
\ No newline at end of file
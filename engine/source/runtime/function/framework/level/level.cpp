@@ -12,6 +12,7 @@
 #include "runtime/function/physics/physics_manager.h"
 #include "runtime/function/physics/physics_scene.h"
 #include <limits>
+#include <unordered_set>
 
 namespace Piccolo
 {
@@ -68,6 +69,7 @@ namespace Piccolo
         ASSERT(g_runtime_global_context.m_physics_manager);
         m_physics_scene = g_runtime_global_context.m_physics_manager->createPhysicsScene(level_res.m_gravity);
         ParticleEmitterIDAllocator::reset();
+        g_runtime_global_context.m_particle_manager->clear();
 
         for (const ObjectInstanceRes& object_instance_res : level_res.m_objects)
         {
@@ -101,6 +103,30 @@ namespace Piccolo
         LOG_INFO("unload level: {}", m_level_res_url);
     }
 
+    void Level::reloadAssets(const std::vector<std::string>& asset_urls)
+    {
+        if (!m_is_loaded)
+        {
+            return;
+        }
+
+        const std::unordered_set<std::string> asset_url_set(asset_urls.begin(), asset_urls.end());
+
+        size_t reloaded_object_count = 0;
+        for (const auto& id_object_pair : m_gobjects)
+        {
+            if (id_object_pair.second && id_object_pair.second->reloadAssets(asset_url_set))
+            {
+                ++reloaded_object_count;
+            }
+        }
+
+        if (reloaded_object_count > 0)
+        {
+            LOG_INFO("reloaded {} objects of level {}", reloaded_object_count, m_level_res_url);
+        }
+    }
+
     bool Level::save()
     {
         LOG_INFO("saving level: {}", m_level_res_url);
@@ -5,6 +5,7 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace Piccolo
 {
@@ -40,6 +41,9 @@ namespace Piccolo
 
         std::weak_ptr<PhysicsScene> getPhysicsScene() const { return m_physics_scene; }
 
+        // reloads the objects depending on the changed assets, asset_urls are relative to the root folder
+        void reloadAssets(const std::vector<std::string>& asset_urls);
+
     protected:
         void clear();
 
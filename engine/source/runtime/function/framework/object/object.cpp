@@ -76,6 +76,7 @@ namespace Piccolo
                 component->postLoadResource(weak_from_this());
             }
         }
+        m_instanced_component_count = m_components.size();
 
         // load object definition components
         m_definition_url = object_instance_res.m_definition;
@@ -86,19 +87,84 @@ namespace Piccolo
         if (!is_loaded_success)
             return false;
 
+        addDefinitionComponents(definition_res);
+
+        return true;
+    }
+
+    void GObject::addDefinitionComponents(ObjectDefinitionRes& definition_res)
+    {
         for (auto loaded_component : definition_res.m_components)
         {
             const std::string type_name = loaded_component.getTypeName();
             // don't create component if it has been instanced
             if (hasComponent(type_name))
+            {
+                PICCOLO_REFLECTION_DELETE(loaded_component);
                 continue;
+            }
 
             loaded_component->postLoadResource(weak_from_this());
 
             m_components.push_back(loaded_component);
         }
+    }
 
-        return true;
+    bool GObject::reloadAssets(const std::unordered_set<std::string>& asset_urls)
+    {
+        std::shared_ptr<AssetManager> asset_manager = g_runtime_global_context.m_asset_manager;
+        ASSERT(asset_manager);
+
+        bool is_reloaded = false;
+
+        if (asset_urls.find(asset_manager->getAssetUrl(m_definition_url)) != asset_urls.end())
+        {
+            // a malformed definition keeps the current components
+            ObjectDefinitionRes definition_res;
+            if (asset_manager->loadAsset(m_definition_url, definition_res))
+            {
+                for (size_t i = m_instanced_component_count; i < m_components.size(); ++i)
+                {
+                    PICCOLO_REFLECTION_DELETE(m_components[i]);
+                }
+                m_components.resize(m_instanced_component_count);
+
+                addDefinitionComponents(definition_res);
+                is_reloaded = true;
+            }
+        }
+
+        std::vector<std::string> dependencies;
+        for (auto& component : m_components)
+        {
+            if (!component)
+            {
+                continue;
+            }
+
+            dependencies.clear();
+            component->getAssetDependencies(dependencies);
+            for (const std::string& dependency : dependencies)
+            {
+                if (asset_urls.find(asset_manager->getAssetUrl(dependency)) != asset_urls.end())
+                {
+                    component->postLoadResource(weak_from_this());
+                    is_reloaded = true;
+                    break;
+                }
+            }
+        }
+
+        if (is_reloaded)
+        {
+            // sends the reloaded meshes to the render system, as a moved object would
+            TransformComponent* transform_component = tryGetComponent(TransformComponent);
+            if (transform_component)
+            {
+                transform_component->setDirtyFlag(true);
+            }
+        }
+        return is_reloaded;
     }
 
     void GObject::save(ObjectInstanceRes& out_object_instance_res)
@@ -26,6 +26,10 @@ namespace Piccolo
         bool load(const ObjectInstanceRes& object_instance_res);
         void save(ObjectInstanceRes& out_object_instance_res);
 
+        // loads the components again when the definition or an asset they read is among asset_urls, which are
+        // relative to the root folder, returns whether anything was reloaded
+        bool reloadAssets(const std::unordered_set<std::string>& asset_urls);
+
         GObjectID getID() const { return m_id; }
 
         void               setName(std::string name) { m_name = name; }
@@ -66,10 +70,15 @@ namespace Piccolo
 #define tryGetComponentConst(COMPONENT_TYPE) tryGetComponentConst<const COMPONENT_TYPE>(#COMPONENT_TYPE)
 
     protected:
+        void addDefinitionComponents(ObjectDefinitionRes& definition_res);
+
         GObjectID   m_id {k_invalid_gobject_id};
         std::string m_name;
         std::string m_definition_url;
 
+        // the components instanced by the level come first, the ones added from the definition follow them
+        size_t m_instanced_component_count {0};
+
         // we have to use the ReflectionPtr due to that the components need to be reflected 
         // in editor, and it's polymorphism
         std::vector<Reflection::ReflectionPtr<Component>> m_components;
@@ -147,6 +147,17 @@ namespace Piccolo
         LOG_INFO("reload current evel succeed");
     }
 
+    void WorldManager::reloadAssets(const std::vector<std::string>& asset_urls)
+    {
+        auto active_level = m_current_active_level.lock();
+        if (active_level == nullptr)
+        {
+            return;
+        }
+
+        active_level->reloadAssets(asset_urls);
+    }
+
     void WorldManager::saveCurrentLevel()
     {
         auto active_level = m_current_active_level.lock();
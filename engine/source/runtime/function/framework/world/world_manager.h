@@ -4,6 +4,7 @@
 
 #include <filesystem>
 #include <string>
+#include <vector>
 
 namespace Piccolo
 {
@@ -23,6 +24,8 @@ namespace Piccolo
 
         void reloadCurrentLevel();
         void saveCurrentLevel();
+        // reloads what the active level uses from the changed assets instead of the whole level
+        void reloadAssets(const std::vector<std::string>& asset_urls);
 
         void                 tick(float delta_time);
         std::weak_ptr<Level> getCurrentActiveLevel() const { return m_current_active_level; }
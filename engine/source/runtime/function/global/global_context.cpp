@@ -1,10 +1,12 @@
 #include "runtime/function/global/global_context.h"
 
+#include "core/job/job_system.h"
 #include "core/log/log_system.h"
 
 #include "runtime/engine.h"
 
 #include "runtime/platform/file_service/file_service.h"
+#include "runtime/platform/file_watcher/file_watcher.h"
 
 #include "runtime/resource/asset_manager/asset_manager.h"
 #include "runtime/resource/config_manager/config_manager.h"
@@ -25,14 +27,24 @@ namespace Piccolo
 
     void RuntimeGlobalContext::startSystems(const std::string& config_file_path)
     {
-        m_config_manager = std::make_shared<ConfigManager>();
-        m_config_manager->initialize(config_file_path);
-
-        m_file_system = std::make_shared<FileSystem>();
-
-        m_logger_system = std::make_shared<LogSystem>();
-
-        m_asset_manager = std::make_shared<AssetManager>();
+        startHeadlessSystems(config_file_path);
+
+        m_file_watcher = std::make_shared<FileWatcher>();
+        FileWatcherInitInfo file_watcher_init_info;
+        file_watcher_init_info.directory = m_config_manager->getAssetFolder();
+        m_file_watcher->initialize(file_watcher_init_info);
+        m_file_watcher->addListener([this](const std::vector<FileChangeEvent>& events) {
+            m_asset_manager->onFilesChanged(events);
+
+            // hot reload, the objects send their new descs through the swap data, the cached meshes and materials
+            // are rebuilt in place
+            std::vector<std::string> asset_urls = m_asset_manager->getChangedAssetUrls(events);
+            if (!asset_urls.empty())
+            {
+                m_world_manager->reloadAssets(asset_urls);
+                m_render_system->reloadAssets(asset_urls);
+            }
+        });
 
         m_physics_manager = std::make_shared<PhysicsManager>();
         m_physics_manager->initialize();
@@ -61,25 +73,61 @@ namespace Piccolo
         m_render_debug_config = std::make_shared<RenderDebugConfig>();
     }
 
+    void RuntimeGlobalContext::startHeadlessSystems(const std::string& config_file_path)
+    {
+        m_config_manager = std::make_shared<ConfigManager>();
+        m_config_manager->initialize(config_file_path);
+
+        m_file_system = std::make_shared<FileSystem>();
+
+        LogSystemInitInfo log_init_info;
+        log_init_info.enable_async = m_config_manager->isAsyncLogEnabled();
+        log_init_info.file_path    = m_config_manager->getLogFilePath();
+        m_logger_system            = std::make_shared<LogSystem>(log_init_info);
+
+        m_job_system = std::make_shared<JobSystem>();
+
+        m_asset_manager = std::make_shared<AssetManager>();
+        m_asset_manager->initialize();
+    }
+
     void RuntimeGlobalContext::shutdownSystems()
     {
         m_render_debug_config.reset();
 
+        // no change is reported to a system which is being destroyed
+        m_file_watcher.reset();
+
         m_debugdraw_manager.reset();
 
-        m_render_system->clear();
-        m_render_system.reset();
+        // only the headless systems exist when started by startHeadlessSystems
+        if (m_render_system)
+        {
+            m_render_system->clear();
+            m_render_system.reset();
+        }
 
-        m_window_system.reset();
+        m_job_system.reset();
 
-        m_world_manager->clear();
-        m_world_manager.reset();
-
-        m_physics_manager->clear();
-        m_physics_manager.reset();
+        m_window_system.reset();
 
-        m_input_system->clear();
-        m_input_system.reset();
+        if (m_world_manager)
+        {
+            m_world_manager->clear();
+            m_world_manager.reset();
+        }
+
+        if (m_physics_manager)
+        {
+            m_physics_manager->clear();
+            m_physics_manager.reset();
+        }
+
+        if (m_input_system)
+        {
+            m_input_system->clear();
+            m_input_system.reset();
+        }
 
         m_asset_manager.reset();
 
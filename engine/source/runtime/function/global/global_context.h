@@ -6,9 +6,11 @@
 namespace Piccolo
 {
     class LogSystem;
+    class JobSystem;
     class InputSystem;
     class PhysicsManager;
     class FileSystem;
+    class FileWatcher;
     class AssetManager;
     class ConfigManager;
     class WorldManager;
@@ -26,13 +28,17 @@ namespace Piccolo
     public:
         // create all global systems and initialize these systems
         void startSystems(const std::string& config_file_path);
+        // create the systems which need neither a window nor a gpu, enough for command line tools
+        void startHeadlessSystems(const std::string& config_file_path);
         // destroy all global systems
         void shutdownSystems();
 
     public:
         std::shared_ptr<LogSystem>         m_logger_system;
+        std::shared_ptr<JobSystem>         m_job_system;
         std::shared_ptr<InputSystem>       m_input_system;
         std::shared_ptr<FileSystem>        m_file_system;
+        std::shared_ptr<FileWatcher>       m_file_watcher;
         std::shared_ptr<AssetManager>      m_asset_manager;
         std::shared_ptr<ConfigManager>     m_config_manager;
         std::shared_ptr<WorldManager>      m_world_manager;
@@ -0,0 +1,454 @@
+#include "runtime/function/particle/particle_cpu_simulator.h"
+
+#include "runtime/function/particle/particle_common.h"
+#include "runtime/function/particle/particle_sort.h"
+
+#include "runtime/core/job/job_system.h"
+#include "runtime/function/global/global_context.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <random>
+
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define PICCOLO_PARTICLE_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace Piccolo
+{
+    namespace
+    {
+        // particles emitted, integrated and compacted by one job
+        constexpr uint32_t s_simulation_chunk_size {16384};
+
+        // marks the particles which died in this tick until their chunk is compacted
+        constexpr float s_dead_particle_life {-std::numeric_limits<float>::max()};
+
+        constexpr float s_golden_ratio {1.61803398874989484820459f};
+        constexpr float s_pi {3.1415926535897932384626433832795f};
+
+        // the gold noise of particle_emit.comp
+        float goldNoise(float x, float y, float seed)
+        {
+            float distance = std::sqrt((x * s_golden_ratio - x) * (x * s_golden_ratio - x) +
+                                       (y * s_golden_ratio - y) * (y * s_golden_ratio - y));
+            float noise    = std::tan(distance * seed) * x;
+            return noise - std::floor(noise);
+        }
+
+        // the shader reads the row major matrix as column major, so it multiplies by the transposed rotation
+        Vector3 rotateLikeShader(const Matrix4x4& rotation, float x, float y, float z, float w)
+        {
+            return Vector3(rotation[0][0] * x + rotation[1][0] * y + rotation[2][0] * z + rotation[3][0] * w,
+                           rotation[0][1] * x + rotation[1][1] * y + rotation[2][1] * z + rotation[3][1] * w,
+                           rotation[0][2] * x + rotation[1][2] * y + rotation[2][2] * z + rotation[3][2] * w);
+        }
+    } // namespace
+
+    void ParticleCpuSimulator::initialize(const GlobalParticleRes& global_particle_res)
+    {
+        m_global_particle_res = global_particle_res;
+
+        std::random_device r;
+        std::seed_seq      seed {r()};
+        m_random_engine.seed(seed);
+    }
+
+    void ParticleCpuSimulator::clear()
+    {
+        m_emitters.clear();
+        m_ticked_emitters.clear();
+    }
+
+    void ParticleCpuSimulator::createEmitter(ParticleEmitterID id, const ParticleEmitterDesc& desc)
+    {
+        if (id >= m_emitters.size())
+        {
+            m_emitters.resize(id + 1);
+        }
+
+        // the attribute arrays keep their storage for the next particles of the emitter
+        EmitterState& emitter    = m_emitters[id];
+        emitter.desc             = desc;
+        emitter.emit_accumulator = 0.0f;
+        emitter.alive_count      = 0;
+        emitter.emit_count       = 0;
+        emitter.draw_order.clear();
+    }
+
+    void ParticleCpuSimulator::updateEmitterTransform(const ParticleEmitterTransformDesc& transform_desc)
+    {
+        if (transform_desc.m_id < m_emitters.size())
+        {
+            m_emitters[transform_desc.m_id].desc.m_position = transform_desc.m_position;
+            m_emitters[transform_desc.m_id].desc.m_rotation = transform_desc.m_rotation;
+        }
+    }
+
+    void ParticleCpuSimulator::tickEmitter(ParticleEmitterID id)
+    {
+        if (id < m_emitters.size() && !m_emitters[id].is_ticked)
+        {
+            m_emitters[id].is_ticked = true;
+            m_ticked_emitters.push_back(id);
+        }
+    }
+
+    void ParticleCpuSimulator::simulate()
+    {
+        if (m_ticked_emitters.empty())
+        {
+            return;
+        }
+
+        // the same seeds as ParticlePass::updateUniformBuffer draws for the compute shaders
+        for (float& random : m_random)
+        {
+            random = m_random_engine.uniformDistribution<float>(0, 1000) * 0.001f;
+        }
+
+        std::vector<SimulationChunk> chunks;
+        for (ParticleEmitterID id : m_ticked_emitters)
+        {
+            if (id >= m_emitters.size() || !m_emitters[id].is_ticked)
+            {
+                continue;
+            }
+
+            EmitterState& emitter = m_emitters[id];
+            emitter.is_ticked     = false;
+            emitter.draw_order.clear();
+
+            // particle_kickoff.comp, the emit gap is counted once per tick instead of once per emit invocation
+            emitter.emit_count = 0;
+            emitter.emit_accumulator += 1.0f;
+            if (emitter.emit_accumulator > m_global_particle_res.m_emit_gap)
+            {
+                int free_count = s_max_particles - static_cast<int>(emitter.alive_count);
+                int emit_count = std::max(0, std::min(free_count, m_global_particle_res.m_emit_count));
+
+                emitter.emit_accumulator = 1.0f;
+                emitter.emit_count       = static_cast<uint32_t>(emit_count);
+            }
+
+            uint32_t particle_count = emitter.alive_count + emitter.emit_count;
+            for (std::vector<float>& attribute : emitter.attributes)
+            {
+                if (attribute.size() < particle_count)
+                {
+                    attribute.resize(particle_count);
+                }
+            }
+
+            for (uint32_t begin = 0; begin < particle_count; begin += s_simulation_chunk_size)
+            {
+                SimulationChunk chunk;
+                chunk.emitter = &emitter;
+                chunk.begin   = begin;
+                chunk.end     = std::min(begin + s_simulation_chunk_size, particle_count);
+                chunks.push_back(chunk);
+            }
+        }
+        m_ticked_emitters.clear();
+
+        std::vector<std::function<void()>> jobs;
+        jobs.reserve(chunks.size());
+        for (SimulationChunk& chunk : chunks)
+        {
+            jobs.emplace_back([this, &chunk]() {
+                // the emitted particles are simulated in the tick of their emission, as on the gpu
+                EmitterState& emitter    = *chunk.emitter;
+                uint32_t      emit_begin = std::max(chunk.begin, emitter.alive_count);
+                if (emit_begin < chunk.end)
+                {
+                    emitParticles(emitter, emit_begin, chunk.end, emit_begin - emitter.alive_count);
+                }
+                integrateParticles(emitter, chunk.begin, chunk.end);
+                compactChunk(chunk);
+            });
+        }
+        g_runtime_global_context.m_job_system->parallelRun(jobs);
+
+        // close the gaps left between the compacted chunks, the chunks of an emitter follow each other
+        EmitterState* emitter     = nullptr;
+        uint32_t      write_index = 0;
+        for (const SimulationChunk& chunk : chunks)
+        {
+            if (chunk.emitter != emitter)
+            {
+                if (emitter)
+                {
+                    emitter->alive_count = write_index;
+                }
+                emitter     = chunk.emitter;
+                write_index = 0;
+            }
+
+            if (write_index != chunk.begin)
+            {
+                for (std::vector<float>& attribute : emitter->attributes)
+                {
+                    std::copy(attribute.begin() + chunk.begin,
+                              attribute.begin() + chunk.begin + chunk.survivor_count,
+                              attribute.begin() + write_index);
+                }
+            }
+            write_index += chunk.survivor_count;
+        }
+        if (emitter)
+        {
+            emitter->alive_count = write_index;
+        }
+    }
+
+    void ParticleCpuSimulator::sortByViewDepth(const Matrix4x4& view_matrix)
+    {
+        std::vector<std::function<void()>> jobs;
+        for (EmitterState& emitter : m_emitters)
+        {
+            if (emitter.alive_count == 0)
+            {
+                continue;
+            }
+
+            jobs.emplace_back([&emitter, &view_matrix]() {
+                uint32_t     count      = emitter.alive_count;
+                const float* position_x = emitter.attributes[_position_x].data();
+                const float* position_y = emitter.attributes[_position_y].data();
+                const float* position_z = emitter.attributes[_position_z].data();
+
+                emitter.view_depths.resize(count);
+                float* view_depths = emitter.view_depths.data();
+
+                uint32_t index = 0;
+#ifdef PICCOLO_PARTICLE_SSE
+                const __m128 row_x = _mm_set1_ps(view_matrix[2][0]);
+                const __m128 row_y = _mm_set1_ps(view_matrix[2][1]);
+                const __m128 row_z = _mm_set1_ps(view_matrix[2][2]);
+                const __m128 row_w = _mm_set1_ps(view_matrix[2][3]);
+                for (; index + 4 <= count; index += 4)
+                {
+                    __m128 depth = _mm_add_ps(_mm_add_ps(_mm_mul_ps(row_x, _mm_loadu_ps(position_x + index)),
+                                                         _mm_mul_ps(row_y, _mm_loadu_ps(position_y + index))),
+                                              _mm_add_ps(_mm_mul_ps(row_z, _mm_loadu_ps(position_z + index)), row_w));
+                    _mm_storeu_ps(view_depths + index, depth);
+                }
+#endif
+                for (; index < count; ++index)
+                {
+                    view_depths[index] = view_matrix[2][0] * position_x[index] + view_matrix[2][1] * position_y[index] +
+                                         view_matrix[2][2] * position_z[index] + view_matrix[2][3];
+                }
+
+                // the camera looks down -z, so the farthest particles have the smallest view z and come first
+                emitter.depth_keys.resize(count);
+                for (index = 0; index < count; ++index)
+                {
+                    emitter.depth_keys[index] = makeFloatSortKey(view_depths[index]);
+                }
+                emitter.draw_order.resize(count);
+                std::iota(emitter.draw_order.begin(), emitter.draw_order.end(), 0);
+                radixSortParticles(emitter.depth_keys,
+                                   emitter.draw_order,
+                                   emitter.scratch_keys,
+                                   emitter.scratch_draw_order,
+                                   0,
+                                   32);
+            });
+        }
+        g_runtime_global_context.m_job_system->parallelRun(jobs);
+    }
+
+    uint32_t ParticleCpuSimulator::getAliveCount(ParticleEmitterID id) const
+    {
+        return id < m_emitters.size() ? m_emitters[id].alive_count : 0;
+    }
+
+    void ParticleCpuSimulator::writeRenderParticles(ParticleEmitterID id, ParticleRenderData* render_particles) const
+    {
+        if (id >= m_emitters.size())
+        {
+            return;
+        }
+
+        const EmitterState& emitter    = m_emitters[id];
+        const auto&         attributes = emitter.attributes;
+        bool                is_sorted  = emitter.draw_order.size() == emitter.alive_count;
+        for (uint32_t draw_index = 0; draw_index < emitter.alive_count; ++draw_index)
+        {
+            uint32_t            index    = is_sorted ? emitter.draw_order[draw_index] : draw_index;
+            ParticleRenderData& particle = render_particles[draw_index];
+
+            particle.pos    = Vector3(attributes[_position_x][index],
+                                   attributes[_position_y][index],
+                                   attributes[_position_z][index]);
+            particle.life   = attributes[_life][index];
+            particle.vel    = Vector3(attributes[_velocity_x][index],
+                                   attributes[_velocity_y][index],
+                                   attributes[_velocity_z][index]);
+            particle.size_x = attributes[_size_x][index];
+            particle.acc    = Vector3(attributes[_acceleration_x][index],
+                                   attributes[_acceleration_y][index],
+                                   attributes[_acceleration_z][index]);
+            particle.size_y = attributes[_size_y][index];
+            particle.color  = Vector4(attributes[_color_r][index],
+                                     attributes[_color_g][index],
+                                     attributes[_color_b][index],
+                                     attributes[_color_a][index]);
+        }
+    }
+
+    void ParticleCpuSimulator::emitParticles(EmitterState& emitter,
+                                             uint32_t      begin,
+                                             uint32_t      end,
+                                             uint32_t      first_emit_index) const
+    {
+        const ParticleEmitterDesc& desc       = emitter.desc;
+        auto&                      attributes = emitter.attributes;
+        const Vector3&             gravity    = m_global_particle_res.m_gravity;
+
+        for (uint32_t index = begin; index < end; ++index)
+        {
+            // the emit invocation index seeds the noise in particle_emit.comp
+            float thread_id = static_cast<float>(first_emit_index + index - begin);
+            float noise_x   = thread_id * m_random[0];
+            float noise_y   = thread_id * m_random[1];
+            float rnd0      = goldNoise(noise_x, noise_y, m_random[2]);
+            float rnd1      = goldNoise(noise_x, noise_y, m_random[2] + 0.2f);
+            float rnd2      = goldNoise(noise_x, noise_y, m_random[2] + 0.4f);
+
+            Vector3 position;
+            Vector3 velocity;
+            Vector4 color;
+            if (desc.m_emitter_type == static_cast<int>(EMITTER_TYPE::MESH))
+            {
+                position = Vector3(desc.m_position.x, desc.m_position.y, desc.m_position.z) +
+                           rotateLikeShader(desc.m_rotation, 0.0f, rnd0, rnd1, 0.0f);
+                velocity = rotateLikeShader(desc.m_rotation,
+                                            (rnd0 * 2 - 1) * desc.m_velocity.w + desc.m_velocity.x,
+                                            (rnd1 * 2 - 1) * desc.m_velocity.w + desc.m_velocity.y,
+                                            (rnd2 * 2 - 1) * desc.m_velocity.w + desc.m_velocity.z,
+                                            1.0f);
+                color    = Vector4(1.0f - rnd0, 1.0f - rnd1, 1.0f - rnd2, 0.0f);
+            }
+            else
+            {
+                float theta = 0.15f * s_pi;
+                float phi   = (2 * rnd0 - 1) * s_pi;
+                float r     = 1 + rnd1;
+
+                position = Vector3(0.1f * (2 * rnd0 - 1) * desc.m_position.w + desc.m_position.x,
+                                   0.1f * (2 * rnd1 - 1) * desc.m_position.w + desc.m_position.y,
+                                   0.1f * (2 * rnd2 - 1) * desc.m_position.w + desc.m_position.z);
+                velocity = Vector3(r * std::sin(theta) * std::cos(phi) * desc.m_velocity.w + desc.m_velocity.x,
+                                   r * std::sin(theta) * std::sin(phi) * desc.m_velocity.w + desc.m_velocity.y,
+                                   r * std::cos(theta) * desc.m_velocity.w + desc.m_velocity.z);
+                color    = desc.m_color;
+            }
+
+            attributes[_position_x][index]     = position.x;
+            attributes[_position_y][index]     = position.y;
+            attributes[_position_z][index]     = position.z;
+            attributes[_velocity_x][index]     = velocity.x;
+            attributes[_velocity_y][index]     = velocity.y;
+            attributes[_velocity_z][index]     = velocity.z;
+            attributes[_acceleration_x][index] = desc.m_acceleration.x + gravity.x;
+            attributes[_acceleration_y][index] = desc.m_acceleration.y + gravity.y;
+            attributes[_acceleration_z][index] = desc.m_acceleration.z + gravity.z;
+            attributes[_life][index]           = rnd0 * desc.m_life.y + desc.m_life.x;
+            attributes[_size_x][index]         = desc.m_size.x;
+            attributes[_size_y][index]         = desc.m_size.y;
+            attributes[_color_r][index]        = color.x;
+            attributes[_color_g][index]        = color.y;
+            attributes[_color_b][index]        = color.z;
+            attributes[_color_a][index]        = color.w;
+        }
+    }
+
+    void ParticleCpuSimulator::integrateParticles(EmitterState& emitter, uint32_t begin, uint32_t end) const
+    {
+        auto&  attributes = emitter.attributes;
+        float* position[3] = {
+            attributes[_position_x].data(), attributes[_position_y].data(), attributes[_position_z].data()};
+        float* velocity[3] = {
+            attributes[_velocity_x].data(), attributes[_velocity_y].data(), attributes[_velocity_z].data()};
+        const float* acceleration[3] = {attributes[_acceleration_x].data(),
+                                        attributes[_acceleration_y].data(),
+                                        attributes[_acceleration_z].data()};
+        float*       life            = attributes[_life].data();
+        const float  time_step       = m_global_particle_res.m_time_step;
+
+        // like particle_simulate.comp, the particles with life left move, the ones below zero die, the others age
+        uint32_t index = begin;
+#ifdef PICCOLO_PARTICLE_SSE
+        const __m128 time_step4 = _mm_set1_ps(time_step);
+        const __m128 zero       = _mm_setzero_ps();
+        const __m128 dead_life  = _mm_set1_ps(s_dead_particle_life);
+        for (; index + 4 <= end; index += 4)
+        {
+            __m128 particle_life = _mm_loadu_ps(life + index);
+            __m128 is_moving     = _mm_cmpgt_ps(particle_life, zero);
+            __m128 is_dead       = _mm_cmplt_ps(particle_life, zero);
+
+            for (uint32_t axis = 0; axis < 3; ++axis)
+            {
+                __m128 particle_velocity = _mm_loadu_ps(velocity[axis] + index);
+                __m128 particle_position = _mm_loadu_ps(position[axis] + index);
+
+                particle_velocity = _mm_add_ps(
+                    particle_velocity,
+                    _mm_and_ps(is_moving, _mm_mul_ps(_mm_loadu_ps(acceleration[axis] + index), time_step4)));
+                particle_position =
+                    _mm_add_ps(particle_position, _mm_and_ps(is_moving, _mm_mul_ps(particle_velocity, time_step4)));
+
+                _mm_storeu_ps(velocity[axis] + index, particle_velocity);
+                _mm_storeu_ps(position[axis] + index, particle_position);
+            }
+
+            particle_life = _mm_or_ps(_mm_and_ps(is_dead, dead_life),
+                                      _mm_andnot_ps(is_dead, _mm_sub_ps(particle_life, time_step4)));
+            _mm_storeu_ps(life + index, particle_life);
+        }
+#endif
+        for (; index < end; ++index)
+        {
+            if (life[index] > 0.0f)
+            {
+                for (uint32_t axis = 0; axis < 3; ++axis)
+                {
+                    velocity[axis][index] += acceleration[axis][index] * time_step;
+                    position[axis][index] += velocity[axis][index] * time_step;
+                }
+            }
+            life[index] = life[index] < 0.0f ? s_dead_particle_life : life[index] - time_step;
+        }
+    }
+
+    void ParticleCpuSimulator::compactChunk(SimulationChunk& chunk) const
+    {
+        auto&        attributes  = chunk.emitter->attributes;
+        const float* life        = attributes[_life].data();
+        uint32_t     write_index = chunk.begin;
+        for (uint32_t index = chunk.begin; index < chunk.end; ++index)
+        {
+            if (life[index] == s_dead_particle_life)
+            {
+                continue;
+            }
+
+            if (write_index != index)
+            {
+                for (std::vector<float>& attribute : attributes)
+                {
+                    attribute[write_index] = attribute[index];
+                }
+            }
+            ++write_index;
+        }
+        chunk.survivor_count = write_index - chunk.begin;
+    }
+} // namespace Piccolo
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "runtime/function/particle/particle_desc.h"
+
+#include "runtime/resource/res_type/global/global_particle.h"
+
+#include "runtime/core/math/matrix4.h"
+#include "runtime/core/math/random.h"
+#include "runtime/core/math/vector3.h"
+#include "runtime/core/math/vector4.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace Piccolo
+{
+    // the particle read by particlebillboard.vert
+    struct ParticleRenderData
+    {
+        Vector3 pos;
+        float   life;
+        Vector3 vel;
+        float   size_x;
+        Vector3 acc;
+        float   size_y;
+        Vector4 color;
+    };
+
+    // the cpu counterpart of particle_kickoff.comp, particle_emit.comp and particle_simulate.comp, the emitters are
+    // ticked with the same fixed time step and emit with the same noise, but do not collide with the scene, which is
+    // only known to the gpu, and the mesh emitters do not sample the logo texture
+    class ParticleCpuSimulator
+    {
+    public:
+        void initialize(const GlobalParticleRes& global_particle_res);
+        void clear();
+
+        // an id which is already used resets the emitter, the ids restart from 0 when a level is loaded
+        void createEmitter(ParticleEmitterID id, const ParticleEmitterDesc& desc);
+        void updateEmitterTransform(const ParticleEmitterTransformDesc& transform_desc);
+        void tickEmitter(ParticleEmitterID id);
+
+        // emits and integrates the emitters ticked since the last call on the job system, then compacts them
+        void simulate();
+
+        // orders the alive particles back to front for blending, the order is dropped by the next simulate
+        void sortByViewDepth(const Matrix4x4& view_matrix);
+
+        uint32_t getEmitterCount() const { return static_cast<uint32_t>(m_emitters.size()); }
+        uint32_t getAliveCount(ParticleEmitterID id) const;
+
+        // writes getAliveCount particles, sorted when sortByViewDepth was called after the last simulate
+        void writeRenderParticles(ParticleEmitterID id, ParticleRenderData* render_particles) const;
+
+    private:
+        enum ParticleAttribute : uint8_t
+        {
+            _position_x = 0,
+            _position_y,
+            _position_z,
+            _velocity_x,
+            _velocity_y,
+            _velocity_z,
+            _acceleration_x,
+            _acceleration_y,
+            _acceleration_z,
+            _life,
+            _size_x,
+            _size_y,
+            _color_r,
+            _color_g,
+            _color_b,
+            _color_a,
+            _particle_attribute_count
+        };
+
+        // the alive particles are packed at the front of every attribute array
+        struct EmitterState
+        {
+            ParticleEmitterDesc desc;
+            float               emit_accumulator {0.0f};
+            uint32_t            alive_count {0};
+            uint32_t            emit_count {0};
+            bool                is_ticked {false};
+
+            std::array<std::vector<float>, _particle_attribute_count> attributes;
+            std::vector<float>                                        view_depths;
+            std::vector<uint32_t>                                     draw_order;
+            std::vector<uint32_t>                                     depth_keys;
+            std::vector<uint32_t>                                     scratch_keys;
+            std::vector<uint32_t>                                     scratch_draw_order;
+        };
+
+        // a range of one emitter which is emitted, integrated and compacted by one job
+        struct SimulationChunk
+        {
+            EmitterState* emitter {nullptr};
+            uint32_t      begin {0};
+            uint32_t      end {0};
+            uint32_t      survivor_count {0};
+        };
+
+        void emitParticles(EmitterState& emitter, uint32_t begin, uint32_t end, uint32_t first_emit_index) const;
+        void integrateParticles(EmitterState& emitter, uint32_t begin, uint32_t end) const;
+        void compactChunk(SimulationChunk& chunk) const;
+
+    private:
+        GlobalParticleRes m_global_particle_res;
+
+        std::vector<EmitterState>      m_emitters;
+        std::vector<ParticleEmitterID> m_ticked_emitters;
+
+        // the noise seeds of the tick, shared by all the emitters like the compute uniform buffer
+        float m_random[3] {0.0f, 0.0f, 0.0f};
+
+        DefaultRNG m_random_engine;
+    };
+} // namespace Piccolo
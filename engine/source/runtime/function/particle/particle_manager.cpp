@@ -49,6 +49,18 @@ namespace Piccolo
             global_particle_res.m_max_life = s_default_particle_life_time * s_default_particle_time_step;
         }
         m_global_particle_res = global_particle_res;
+
+        m_is_cpu_simulation_enabled = global_particle_res.m_enable_cpu_simulation;
+        m_cpu_simulator             = std::make_unique<ParticleCpuSimulator>();
+        m_cpu_simulator->initialize(m_global_particle_res);
+    }
+
+    void ParticleManager::clear()
+    {
+        if (m_cpu_simulator)
+        {
+            m_cpu_simulator->clear();
+        }
     }
 
     void ParticleManager::createParticleEmitter(const ParticleComponentRes&   particle_res,
@@ -61,6 +73,37 @@ namespace Piccolo
         swap_data.addNewParticleEmitter(desc);
 
         transform_desc.m_id = ParticleEmitterIDAllocator::alloc();
+
+        // registered even when disabled, so that the simulation can be switched on at runtime
+        if (m_cpu_simulator)
+        {
+            m_cpu_simulator->createEmitter(transform_desc.m_id, desc);
+        }
+    }
+
+    void ParticleManager::tickEmitter(ParticleEmitterID id)
+    {
+        if (m_is_cpu_simulation_enabled && m_cpu_simulator)
+        {
+            m_cpu_simulator->tickEmitter(id);
+        }
+    }
+
+    void ParticleManager::updateEmitterTransform(const ParticleEmitterTransformDesc& transform_desc)
+    {
+        if (m_cpu_simulator)
+        {
+            m_cpu_simulator->updateEmitterTransform(transform_desc);
+        }
+    }
+
+    void ParticleManager::tick(float delta_time)
+    {
+        // one step of m_time_step per frame like the compute passes, delta_time is not used to stay in step with them
+        if (m_is_cpu_simulation_enabled && m_cpu_simulator)
+        {
+            m_cpu_simulator->simulate();
+        }
     }
 
     const GlobalParticleRes& ParticleManager::getGlobalParticleRes() { return m_global_particle_res; }
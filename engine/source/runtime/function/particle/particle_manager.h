@@ -1,5 +1,6 @@
 #pragma once
 
+#include "runtime/function/particle/particle_cpu_simulator.h"
 #include "runtime/function/particle/particle_desc.h"
 
 #include "runtime/resource/res_type/components/emitter.h"
@@ -30,7 +31,20 @@ namespace Piccolo
         void createParticleEmitter(const ParticleComponentRes&   particle_res,
                                    ParticleEmitterTransformDesc& transform_desc);
 
+        // the cpu simulation follows the emitters of the logic, the compute passes get them by the swap data
+        void tickEmitter(ParticleEmitterID id);
+        void updateEmitterTransform(const ParticleEmitterTransformDesc& transform_desc);
+        void tick(float delta_time);
+
+        void setCpuSimulationEnabled(bool enabled) { m_is_cpu_simulation_enabled = enabled; }
+        bool isCpuSimulationEnabled() const { return m_is_cpu_simulation_enabled; }
+
+        ParticleCpuSimulator* getCpuSimulator() { return m_cpu_simulator.get(); }
+
     private:
         GlobalParticleRes m_global_particle_res;
+
+        bool                                  m_is_cpu_simulation_enabled {false};
+        std::unique_ptr<ParticleCpuSimulator> m_cpu_simulator;
     };
 } // namespace Piccolo
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include "runtime/function/particle/particle_sort.h"
+
+#include "runtime/core/math/math.h"
+#include "runtime/core/math/vector4.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace Piccolo
+{
+    bool makeParticleSortKey(const ParticleSortView& view, const Vector3& position, uint32_t& key)
+    {
+        Vector4 clip_position = view.view_projection_matrix * Vector4(position, 1.0f);
+        if (clip_position.w <= 0.0f)
+        {
+            return false;
+        }
+
+        float screen_x = (clip_position.x / clip_position.w * 0.5f + 0.5f) * view.viewport_width;
+        float screen_y = (clip_position.y / clip_position.w * 0.5f + 0.5f) * view.viewport_height;
+
+        float tile_size    = static_cast<float>(view.tile_size);
+        float tile_count_x = std::ceil(view.viewport_width / tile_size);
+        float tile_count_y = std::ceil(view.viewport_height / tile_size);
+        float tile_x       = Math::clamp(screen_x / tile_size, 0.0f, tile_count_x - 1.0f);
+        float tile_y       = Math::clamp(screen_y / tile_size, 0.0f, tile_count_y - 1.0f);
+        uint32_t tile_index =
+            static_cast<uint32_t>(tile_y) * static_cast<uint32_t>(tile_count_x) + static_cast<uint32_t>(tile_x);
+
+        float depth_scale = 65535.0f / (view.zfar - view.znear);
+        float depth       = Math::clamp((clip_position.w - view.znear) * depth_scale, 0.0f, 65535.0f);
+
+        key = (tile_index << 16) | (65535u - static_cast<uint32_t>(depth));
+        return true;
+    }
+
+    uint32_t makeFloatSortKey(float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+
+        // the negative floats are ordered backwards, flipping all their bits reverses them
+        return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+    }
+
+    void radixSortParticles(std::vector<uint32_t>& keys,
+                            std::vector<uint32_t>& values,
+                            std::vector<uint32_t>& scratch_keys,
+                            std::vector<uint32_t>& scratch_values,
+                            uint32_t               first_bit,
+                            uint32_t               last_bit)
+    {
+        size_t count = keys.size();
+        if (count < 2)
+        {
+            return;
+        }
+
+        scratch_keys.resize(count);
+        scratch_values.resize(count);
+
+        for (uint32_t shift = first_bit; shift < last_bit; shift += 8)
+        {
+            uint32_t histogram[256] = {};
+            for (size_t i = 0; i < count; ++i)
+            {
+                ++histogram[(keys[i] >> shift) & 0xFF];
+            }
+
+            // every key has the same digit, the pass would not move anything
+            if (histogram[(keys[0] >> shift) & 0xFF] == count)
+            {
+                continue;
+            }
+
+            uint32_t offset = 0;
+            for (uint32_t digit = 0; digit < 256; ++digit)
+            {
+                uint32_t digit_count = histogram[digit];
+                histogram[digit]     = offset;
+                offset += digit_count;
+            }
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                uint32_t destination        = histogram[(keys[i] >> shift) & 0xFF]++;
+                scratch_keys[destination]   = keys[i];
+                scratch_values[destination] = values[i];
+            }
+
+            keys.swap(scratch_keys);
+            values.swap(scratch_values);
+        }
+    }
+
+    void binParticles(const std::vector<uint32_t>& sorted_keys,
+                      const std::vector<uint32_t>& sorted_values,
+                      uint32_t                     max_particles_per_tile,
+                      std::vector<uint8_t>&        visibility)
+    {
+        size_t count      = sorted_keys.size();
+        size_t tile_begin = 0;
+        while (tile_begin < count)
+        {
+            uint32_t tile     = sorted_keys[tile_begin] >> 16;
+            size_t   tile_end = tile_begin + 1;
+            while (tile_end < count && (sorted_keys[tile_end] >> 16) == tile)
+            {
+                ++tile_end;
+            }
+
+            for (size_t i = tile_begin; i < tile_end; ++i)
+            {
+                visibility[sorted_values[i]] = (tile_end - i <= max_particles_per_tile) ? 1 : 0;
+            }
+            tile_begin = tile_end;
+        }
+    }
+} // namespace Piccolo
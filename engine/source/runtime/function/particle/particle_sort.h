@@ -0,0 +1,47 @@
+#pragma once
+
+#include "runtime/core/math/matrix4.h"
+#include "runtime/core/math/vector3.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Piccolo
+{
+    // the cpu side of the particle_sort_*.comp shaders, to check them and to order the cpu simulated particles
+
+    // the camera the keys are made for, the screen is split into tiles of tile_size pixels
+    struct ParticleSortView
+    {
+        Matrix4x4 view_projection_matrix;
+        float     znear {0.0f};
+        float     zfar {0.0f};
+        float     viewport_width {0.0f};
+        float     viewport_height {0.0f};
+        uint32_t  tile_size {0};
+    };
+
+    // the screen tile in the high 16 bits and the inverted quantized view depth in the low 16 bits, so that sorting
+    // by the low half orders the particles from far to near and sorting by the high half groups them by tile, false
+    // when the particle is behind the camera and is not sorted
+    bool makeParticleSortKey(const ParticleSortView& view, const Vector3& position, uint32_t& key);
+
+    // a key which orders the floats like operator<
+    uint32_t makeFloatSortKey(float value);
+
+    // stable least significant digit first sort of the bits [first_bit, last_bit) of the keys, 8 bits per pass like
+    // particle_sort_histogram.comp, particle_sort_scan.comp and particle_sort_scatter.comp, the values follow their key
+    void radixSortParticles(std::vector<uint32_t>& keys,
+                            std::vector<uint32_t>& values,
+                            std::vector<uint32_t>& scratch_keys,
+                            std::vector<uint32_t>& scratch_values,
+                            uint32_t               first_bit,
+                            uint32_t               last_bit);
+
+    // particle_sort_bin.comp, the keys are sorted by tile and then from far to near, the max_particles_per_tile
+    // nearest particles of every tile are visible, visibility is indexed by the values and must cover them
+    void binParticles(const std::vector<uint32_t>& sorted_keys,
+                      const std::vector<uint32_t>& sorted_values,
+                      uint32_t                     max_particles_per_tile,
+                      std::vector<uint8_t>&        visibility);
+} // namespace Piccolo
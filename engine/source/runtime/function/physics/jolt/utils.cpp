@@ -148,7 +148,7 @@ namespace Piccolo
         }
         else
         {
-            LOG_ERROR("Unsupported Shape")
+            LOG_ERROR("Unsupported Shape");
         }
 
         return jph_shape;
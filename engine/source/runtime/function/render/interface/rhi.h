@@ -4,6 +4,7 @@
 #include <GLFW/glfw3.h>
 #include <vk_mem_alloc.h>
 
+#include <filesystem>
 #include <memory>
 #include <vector>
 #include <functional>
@@ -16,6 +17,15 @@ namespace Piccolo
     struct RHIInitInfo
     {
         std::shared_ptr<WindowSystem> window_system;
+        std::filesystem::path         pipeline_cache_path;
+    };
+
+    // a host visible slice of staging memory, only valid until the upload commands are flushed
+    struct RHIStagingBufferAllocation
+    {
+        RHIBuffer*    buffer {nullptr};
+        RHIDeviceSize offset {0};
+        void*         mapped_data {nullptr};
     };
     
     class RHI
@@ -27,6 +37,7 @@ namespace Piccolo
         virtual void prepareContext() = 0;
 
         virtual bool isPointLightShadowEnabled() = 0;
+        virtual bool isGpuDrivenRenderingSupported() = 0;
         // allocate and create
         virtual bool allocateCommandBuffers(const RHICommandBufferAllocateInfo* pAllocateInfo, RHICommandBuffer* &pCommandBuffers) = 0;
         virtual bool allocateDescriptorSets(const RHIDescriptorSetAllocateInfo* pAllocateInfo, RHIDescriptorSet* &pDescriptorSets) = 0;
@@ -111,6 +122,9 @@ namespace Piccolo
         virtual void cmdDraw(RHICommandBuffer* commandBuffer, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance) = 0;
         virtual void cmdDispatch(RHICommandBuffer* commandBuffer, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) = 0;
         virtual void cmdDispatchIndirect(RHICommandBuffer* commandBuffer, RHIBuffer* buffer, RHIDeviceSize offset) = 0;
+        virtual void cmdDrawIndexedIndirect(RHICommandBuffer* commandBuffer, RHIBuffer* buffer, RHIDeviceSize offset, uint32_t drawCount, uint32_t stride) = 0;
+        virtual void cmdDrawIndirect(RHICommandBuffer* commandBuffer, RHIBuffer* buffer, RHIDeviceSize offset, uint32_t drawCount, uint32_t stride) = 0;
+
         virtual void cmdPipelineBarrier(RHICommandBuffer* commandBuffer, RHIPipelineStageFlags srcStageMask, RHIPipelineStageFlags dstStageMask, RHIDependencyFlags dependencyFlags, uint32_t memoryBarrierCount, const RHIMemoryBarrier* pMemoryBarriers, uint32_t bufferMemoryBarrierCount, const RHIBufferMemoryBarrier* pBufferMemoryBarriers, uint32_t imageMemoryBarrierCount, const RHIImageMemoryBarrier* pImageMemoryBarriers) = 0;
         virtual bool endCommandBuffer(RHICommandBuffer* commandBuffer) = 0;
         virtual void updateDescriptorSets(uint32_t descriptorWriteCount, const RHIWriteDescriptorSet* pDescriptorWrites, uint32_t descriptorCopyCount, const RHICopyDescriptorSet* pDescriptorCopies) = 0;
@@ -143,6 +157,12 @@ namespace Piccolo
         virtual void pushEvent(RHICommandBuffer* commond_buffer, const char* name, const float* color) = 0;
         virtual void popEvent(RHICommandBuffer* commond_buffer) = 0;
 
+        // staging upload
+        virtual bool allocateStagingBuffer(RHIDeviceSize size, RHIDeviceSize alignment, RHIStagingBufferAllocation& allocation) = 0;
+        virtual void enqueueCopyBuffer(const RHIStagingBufferAllocation& src, RHIBuffer* dstBuffer, RHIDeviceSize srcOffset, RHIDeviceSize dstOffset, RHIDeviceSize size) = 0;
+        virtual void flushUploadCommands() = 0;
+
+
         // destory
         virtual void clear() = 0;
         virtual void clearSwapchain() = 0;
@@ -159,6 +179,8 @@ namespace Piccolo
         virtual void destroyDevice() = 0;
         virtual void destroyCommandPool(RHICommandPool* commandPool) = 0;
         virtual void destroyBuffer(RHIBuffer* &buffer) = 0;
+        virtual void destroyBufferVMA(VmaAllocator allocator, RHIBuffer* &buffer, VmaAllocation allocation) = 0;
+        virtual void destroyImageVMA(VmaAllocator allocator, RHIImage* &image, VmaAllocation allocation) = 0;
         virtual void freeCommandBuffers(RHICommandPool* commandPool, uint32_t commandBufferCount, RHICommandBuffer* pCommandBuffers) = 0;
 
         // memory
@@ -170,6 +192,8 @@ namespace Piccolo
 
         //semaphores
         virtual RHISemaphore* &getTextureCopySemaphore(uint32_t index) = 0;
+        // waited by the next submitRendering, for the work of other queues which its rendering depends on
+        virtual void addRenderingWaitSemaphore(RHISemaphore* semaphore, RHIPipelineStageFlags waitStageMask) = 0;
 
     private:
     };
@@ -68,7 +68,9 @@
 #error Unknown Compiler
 #endif
 
+#include <chrono>
 #include <cstring>
+#include <fstream>
 #include <iostream>
 #include <set>
 #include <stdexcept>
@@ -83,7 +85,8 @@ namespace Piccolo
 
     void VulkanRHI::initialize(RHIInitInfo init_info)
     {
-        m_window = init_info.window_system->getWindow();
+        m_window              = init_info.window_system->getWindow();
+        m_pipeline_cache_path = init_info.pipeline_cache_path;
 
         std::array<int, 2> window_size = init_info.window_system->getWindowSize();
 
@@ -164,6 +167,10 @@ namespace Piccolo
         createFramebufferImageAndView();
 
         createAssetAllocator();
+
+        createStagingRing();
+
+        createPipelineCache();
     }
 
     void VulkanRHI::prepareContext()
@@ -174,6 +181,10 @@ namespace Piccolo
 
     void VulkanRHI::clear()
     {
+        destroyStagingRing();
+
+        destroyPipelineCache();
+
         if (m_enable_validation_Layers)
         {
             destroyDebugUtilsMessengerEXT(m_instance, m_debug_messenger, nullptr);
@@ -378,6 +389,9 @@ namespace Piccolo
 
     bool VulkanRHI::prepareBeforePass(std::function<void()> passUpdateAfterRecreateSwapchain)
     {
+        // resources uploaded since the last frame are submitted ahead of this frame's rendering
+        flushUploadCommands();
+
         VkResult acquire_image_result =
             vkAcquireNextImageKHR(m_device,
                                   m_swapchain,
@@ -477,12 +491,16 @@ namespace Piccolo
         // 統ύ 10 Command Bufferʱʹһύ10Command Buffer VkSubmitInfo
         // ʹ10ÿһCommand Buffer VkSubmitInfo ṹҪЧʵĶ࣬ʹ¶ִֻһvkQueueSubmit
         // ύCommandȫͬӱϽVkSubmitInfoGPUϵһͬ/ȵԪΪԼһFence/Semaphores
-        VkPipelineStageFlags wait_stages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
+        // the swapchain image first, then the semaphores added since the last frame
+        m_rendering_wait_semaphores.insert(m_rendering_wait_semaphores.begin(),
+                                           m_image_available_for_render_semaphores[m_current_frame_index]);
+        m_rendering_wait_stages.insert(m_rendering_wait_stages.begin(), VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+
         VkSubmitInfo         submit_info   = {};
         submit_info.sType                  = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        submit_info.waitSemaphoreCount     = 1;
-        submit_info.pWaitSemaphores        = &m_image_available_for_render_semaphores[m_current_frame_index];
-        submit_info.pWaitDstStageMask      = wait_stages;
+        submit_info.waitSemaphoreCount     = static_cast<uint32_t>(m_rendering_wait_semaphores.size());
+        submit_info.pWaitSemaphores        = m_rendering_wait_semaphores.data();
+        submit_info.pWaitDstStageMask      = m_rendering_wait_stages.data();
         submit_info.commandBufferCount     = 1;
         submit_info.pCommandBuffers        = &m_vk_command_buffers[m_current_frame_index];
         submit_info.signalSemaphoreCount = 2;
@@ -497,7 +515,9 @@ namespace Piccolo
         }
         VkResult res_queue_submit =
             vkQueueSubmit(((VulkanQueue*)m_graphics_queue)->getResource(), 1, &submit_info, m_is_frame_in_flight_fences[m_current_frame_index]);
-        
+        m_rendering_wait_semaphores.clear();
+        m_rendering_wait_stages.clear();
+
         if (VK_SUCCESS != res_queue_submit)
         {
             LOG_ERROR("vkQueueSubmit failed!");
@@ -539,6 +559,9 @@ namespace Piccolo
 
     RHICommandBuffer* VulkanRHI::beginSingleTimeCommands()
     {
+        // keep the pending uploads ordered before any immediate work on the graphics queue
+        flushUploadCommands();
+
         VkCommandBufferAllocateInfo allocInfo {};
         allocInfo.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
         allocInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
@@ -576,6 +599,227 @@ namespace Piccolo
         delete(command_buffer);
     }
 
+    bool VulkanRHI::allocateStagingBuffer(RHIDeviceSize size, RHIDeviceSize alignment, RHIStagingBufferAllocation& allocation)
+    {
+        UploadBatch* batch = &beginUploadBatch();
+
+        VkDeviceSize staging_alignment = alignment > 0 ? alignment : 1;
+        VkDeviceSize offset            = 0;
+        VkDeviceSize consumed          = 0;
+        bool         is_fit            = findStagingRingSpace(size, staging_alignment, offset, consumed);
+        if (!is_fit && size <= k_staging_ring_buffer_size)
+        {
+            // the ring is still read by submitted batches, submit the pending uploads and retire from the oldest
+            flushUploadCommands();
+            for (uint8_t i = 0; i < k_max_frames_in_flight && !is_fit; ++i)
+            {
+                retireUploadBatch((m_current_upload_batch_index + i) % k_max_frames_in_flight);
+                is_fit = findStagingRingSpace(size, staging_alignment, offset, consumed);
+            }
+            batch = &beginUploadBatch();
+        }
+
+        if (is_fit)
+        {
+            m_staging_ring_head = offset + size;
+            m_staging_ring_used += consumed;
+            batch->staging_ring_consumed += consumed;
+
+            allocation.buffer      = m_rhi_staging_ring_buffer;
+            allocation.offset      = offset;
+            allocation.mapped_data = static_cast<uint8_t*>(m_staging_ring_buffer_memory_pointer) + offset;
+            return true;
+        }
+
+        // larger than the whole ring, use a dedicated staging buffer released together with the batch
+        VkBuffer       vk_buffer;
+        VkDeviceMemory vk_buffer_memory;
+        VulkanUtil::createBuffer(m_physical_device,
+                                 m_device,
+                                 size,
+                                 VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                 vk_buffer,
+                                 vk_buffer_memory);
+
+        void* data = nullptr;
+        if (vkMapMemory(m_device, vk_buffer_memory, 0, size, 0, &data) != VK_SUCCESS)
+        {
+            LOG_ERROR("failed to map dedicated staging buffer!");
+            vkDestroyBuffer(m_device, vk_buffer, nullptr);
+            vkFreeMemory(m_device, vk_buffer_memory, nullptr);
+            return false;
+        }
+
+        RHIBuffer* rhi_buffer = new VulkanBuffer();
+        ((VulkanBuffer*)rhi_buffer)->setResource(vk_buffer);
+        batch->dedicated_staging_buffers.push_back(std::make_pair(rhi_buffer, vk_buffer_memory));
+
+        allocation.buffer      = rhi_buffer;
+        allocation.offset      = 0;
+        allocation.mapped_data = data;
+        return true;
+    }
+
+    void VulkanRHI::enqueueCopyBuffer(const RHIStagingBufferAllocation& src, RHIBuffer* dstBuffer, RHIDeviceSize srcOffset, RHIDeviceSize dstOffset, RHIDeviceSize size)
+    {
+        VkCommandBuffer command_buffer = beginUploadCommands();
+
+        VkBufferCopy copy_region = {src.offset + srcOffset, dstOffset, size};
+        vkCmdCopyBuffer(command_buffer,
+                        ((VulkanBuffer*)src.buffer)->getResource(),
+                        ((VulkanBuffer*)dstBuffer)->getResource(),
+                        1,
+                        &copy_region);
+    }
+
+    VkCommandBuffer VulkanRHI::beginUploadCommands()
+    {
+        UploadBatch& batch = beginUploadBatch();
+        ++batch.command_count;
+        return batch.command_buffer;
+    }
+
+    void VulkanRHI::flushUploadCommands()
+    {
+        UploadBatch& batch = m_upload_batches[m_current_upload_batch_index];
+        if (!batch.is_recording || batch.command_count == 0)
+        {
+            return;
+        }
+
+        // make the transferred data visible to all the later work on the graphics queue
+        VkMemoryBarrier memory_barrier {};
+        memory_barrier.sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        memory_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        memory_barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT |
+                                       VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+        vkCmdPipelineBarrier(batch.command_buffer,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                             0,
+                             1,
+                             &memory_barrier,
+                             0,
+                             nullptr,
+                             0,
+                             nullptr);
+
+        if (VK_SUCCESS != _vkEndCommandBuffer(batch.command_buffer))
+        {
+            LOG_ERROR("_vkEndCommandBuffer failed!");
+            return;
+        }
+
+        if (VK_SUCCESS != _vkResetFences(m_device, 1, &batch.fence))
+        {
+            LOG_ERROR("_vkResetFences failed!");
+            return;
+        }
+
+        VkSubmitInfo submit_info {};
+        submit_info.sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submit_info.commandBufferCount = 1;
+        submit_info.pCommandBuffers    = &batch.command_buffer;
+
+        if (VK_SUCCESS != vkQueueSubmit(((VulkanQueue*)m_graphics_queue)->getResource(), 1, &submit_info, batch.fence))
+        {
+            LOG_ERROR("vkQueueSubmit failed!");
+            return;
+        }
+
+        batch.is_recording = false;
+        batch.is_in_flight = true;
+
+        ++m_upload_submit_count;
+        m_upload_command_count += batch.command_count;
+        LOG_DEBUG("submitted {} upload commands in one batch, {} uploads in {} submissions since startup",
+                  batch.command_count,
+                  m_upload_command_count,
+                  m_upload_submit_count);
+
+        m_current_upload_batch_index = (m_current_upload_batch_index + 1) % k_max_frames_in_flight;
+    }
+
+    VulkanRHI::UploadBatch& VulkanRHI::beginUploadBatch()
+    {
+        UploadBatch& batch = m_upload_batches[m_current_upload_batch_index];
+        if (batch.is_recording)
+        {
+            return batch;
+        }
+
+        // the batch slots are reused round robin, so the slot to record is always the oldest one
+        retireUploadBatch(m_current_upload_batch_index);
+
+        vkResetCommandBuffer(batch.command_buffer, 0);
+
+        VkCommandBufferBeginInfo begin_info {};
+        begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+        if (VK_SUCCESS != _vkBeginCommandBuffer(batch.command_buffer, &begin_info))
+        {
+            LOG_ERROR("_vkBeginCommandBuffer failed!");
+        }
+
+        batch.is_recording  = true;
+        batch.command_count = 0;
+        return batch;
+    }
+
+    void VulkanRHI::retireUploadBatch(uint8_t batch_index)
+    {
+        UploadBatch& batch = m_upload_batches[batch_index];
+        if (!batch.is_in_flight)
+        {
+            return;
+        }
+
+        if (VK_SUCCESS != _vkWaitForFences(m_device, 1, &batch.fence, VK_TRUE, UINT64_MAX))
+        {
+            LOG_ERROR("_vkWaitForFences failed!");
+        }
+
+        m_staging_ring_used -= batch.staging_ring_consumed;
+        batch.staging_ring_consumed = 0;
+        if (m_staging_ring_used == 0)
+        {
+            m_staging_ring_head = 0;
+        }
+
+        for (auto& dedicated_staging_buffer : batch.dedicated_staging_buffers)
+        {
+            vkDestroyBuffer(m_device, ((VulkanBuffer*)dedicated_staging_buffer.first)->getResource(), nullptr);
+            vkFreeMemory(m_device, dedicated_staging_buffer.second, nullptr);
+            delete dedicated_staging_buffer.first;
+        }
+        batch.dedicated_staging_buffers.clear();
+
+        batch.is_in_flight = false;
+    }
+
+    bool VulkanRHI::findStagingRingSpace(VkDeviceSize  size,
+                                         VkDeviceSize  alignment,
+                                         VkDeviceSize& offset,
+                                         VkDeviceSize& consumed) const
+    {
+        VkDeviceSize aligned_head = ((m_staging_ring_head + alignment - 1) / alignment) * alignment;
+        if (aligned_head + size <= k_staging_ring_buffer_size)
+        {
+            offset   = aligned_head;
+            consumed = aligned_head - m_staging_ring_head + size;
+        }
+        else
+        {
+            // skip the tail of the ring and restart from the beginning
+            offset   = 0;
+            consumed = k_staging_ring_buffer_size - m_staging_ring_head + size;
+        }
+
+        return m_staging_ring_used + consumed <= k_staging_ring_buffer_size;
+    }
+
     // validation layers
     // пõУ
     bool VulkanRHI::checkValidationLayerSupport()
@@ -858,6 +1102,15 @@ namespace Piccolo
             physical_device_features.geometryShader = VK_TRUE;
         }
 
+        // the gpu driven mesh path reads the culled instance list through the first instance of indirect draws
+        VkPhysicalDeviceFeatures supported_features;
+        vkGetPhysicalDeviceFeatures(m_physical_device, &supported_features);
+        m_enable_gpu_driven_rendering = supported_features.drawIndirectFirstInstance == VK_TRUE;
+        if (m_enable_gpu_driven_rendering)
+        {
+            physical_device_features.drawIndirectFirstInstance = VK_TRUE;
+        }
+
         // device create info
         // VkDeviceCreateInfoṹpQueueCreateInfosָָqueue_create_infosݵĵַ
         // pEnabledFeaturesָָphysical_device_featuresĵַ
@@ -1533,7 +1786,7 @@ namespace Piccolo
         VkPipeline vk_pipelines; // VkPipelineԱ洢Ĺ߶
         // ͨVkPipelineCacheԽߴصݽл棬ڶvkCreateGraphicsPipelinesʹã
         // ԽļڶʹáʹԼ֮Ĺߴ
-        VkPipelineCache vk_pipeline_cache = VK_NULL_HANDLE;
+        VkPipelineCache vk_pipeline_cache = m_pipeline_cache;
         if (pipelineCache != nullptr)
         {
             vk_pipeline_cache = ((VulkanPipelineCache*)pipelineCache)->getResource();
@@ -1589,7 +1842,7 @@ namespace Piccolo
 
         pPipelines = new VulkanPipeline();
         VkPipeline vk_pipelines;
-        VkPipelineCache vk_pipeline_cache = VK_NULL_HANDLE;
+        VkPipelineCache vk_pipeline_cache = m_pipeline_cache;
         if (pipelineCache != nullptr)
         {
             vk_pipeline_cache = ((VulkanPipelineCache*)pipelineCache)->getResource();
@@ -2682,6 +2935,16 @@ namespace Piccolo
         vkCmdDispatchIndirect(((VulkanCommandBuffer*)commandBuffer)->getResource(), ((VulkanBuffer*)buffer)->getResource(), offset);
     }
 
+    void VulkanRHI::cmdDrawIndexedIndirect(RHICommandBuffer* commandBuffer, RHIBuffer* buffer, RHIDeviceSize offset, uint32_t drawCount, uint32_t stride)
+    {
+        vkCmdDrawIndexedIndirect(((VulkanCommandBuffer*)commandBuffer)->getResource(), ((VulkanBuffer*)buffer)->getResource(), offset, drawCount, stride);
+    }
+
+    void VulkanRHI::cmdDrawIndirect(RHICommandBuffer* commandBuffer, RHIBuffer* buffer, RHIDeviceSize offset, uint32_t drawCount, uint32_t stride)
+    {
+        vkCmdDrawIndirect(((VulkanCommandBuffer*)commandBuffer)->getResource(), ((VulkanBuffer*)buffer)->getResource(), offset, drawCount, stride);
+    }
+
     void VulkanRHI::cmdCopyImageToBuffer(
         RHICommandBuffer* commandBuffer,
         RHIImage* srcImage,
@@ -2804,13 +3067,18 @@ namespace Piccolo
 
         VkDescriptorPoolSize pool_sizes[7];
         pool_sizes[0].type            = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
-        pool_sizes[0].descriptorCount = 3 + 2 + 2 + 2 + 1 + 1 + 3 + 3;
+        // + mesh cull + gpu driven mesh global + mesh skinning
+        pool_sizes[0].descriptorCount = 3 + 2 + 2 + 2 + 1 + 1 + 3 + 3 + 3 + 3 + 2;
         pool_sizes[1].type            = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-        pool_sizes[1].descriptorCount = 1 + 1 + 1 * m_max_vertex_blending_mesh_count;
+        // + mesh skinning global and per mesh + particle sort and sorted billboard
+        pool_sizes[1].descriptorCount = 1 + 1 + 1 * m_max_vertex_blending_mesh_count + 1 + 2 +
+                                        3 * m_max_vertex_blending_mesh_count + 5 * 8 + 4;
         pool_sizes[2].type            = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        pool_sizes[2].descriptorCount = 1 * m_max_material_count;
+        // + particle sort and sorted billboard
+        pool_sizes[2].descriptorCount = 1 * m_max_material_count + 5 + 1;
         pool_sizes[3].type            = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        pool_sizes[3].descriptorCount = 3 + 5 * m_max_material_count + 1 + 1; // ImGui_ImplVulkan_CreateDeviceObjects
+        // + particle sorted billboard and half resolution composite
+        pool_sizes[3].descriptorCount = 3 + 5 * m_max_material_count + 1 + 1 + 5 + 2 + 1; // ImGui_ImplVulkan_CreateDeviceObjects
         pool_sizes[4].type            = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
         pool_sizes[4].descriptorCount = 4 + 1 + 1 + 2;
         pool_sizes[5].type            = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
@@ -2822,8 +3090,11 @@ namespace Piccolo
         pool_info.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
         pool_info.poolSizeCount = sizeof(pool_sizes) / sizeof(pool_sizes[0]);
         pool_info.pPoolSizes    = pool_sizes;
-        pool_info.maxSets =
-            1 + 1 + 1 + m_max_material_count + m_max_vertex_blending_mesh_count + 1 + 1; // +skybox + axis descriptor set
+        // +skybox + axis descriptor set + mesh cull + gpu driven mesh global + mesh skinning global and per mesh
+        // + particle sort, sorted billboard and half resolution composite
+        pool_info.maxSets = 1 + 1 + 1 + m_max_material_count + m_max_vertex_blending_mesh_count + 1 + 1 + 2 + 1 +
+                            m_max_vertex_blending_mesh_count + 5 + 1 + 1;
+
         pool_info.flags = 0U;
 
         if (vkCreateDescriptorPool(m_device, &pool_info, nullptr, &m_vk_descriptor_pool) != VK_SUCCESS)
@@ -2893,6 +3164,8 @@ namespace Piccolo
 
     RHISampler* VulkanRHI::getOrCreateDefaultSampler(RHIDefaultSamplerType type)
     {
+        std::lock_guard<std::mutex> lock(m_sampler_mutex);
+
         switch (type)
         {
         case Piccolo::Default_Sampler_Linear:
@@ -2926,6 +3199,9 @@ namespace Piccolo
             LOG_ERROR("width == 0 || height == 0");
             return nullptr;
         }
+
+        std::lock_guard<std::mutex> lock(m_sampler_mutex);
+
         RHISampler* sampler;
         uint32_t  mip_levels = floor(log2(std::max(width, height))) + 1;
         auto      find_sampler = m_mipmap_sampler_map.find(mip_levels);
@@ -3155,6 +3431,180 @@ namespace Piccolo
         }
     }
 
+    void VulkanRHI::createStagingRing()
+    {
+        VulkanUtil::createBuffer(m_physical_device,
+                                 m_device,
+                                 k_staging_ring_buffer_size,
+                                 VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                 m_staging_ring_buffer,
+                                 m_staging_ring_buffer_memory);
+
+        // persistently mapped, unmapped only when the ring is destroyed
+        if (vkMapMemory(m_device,
+                        m_staging_ring_buffer_memory,
+                        0,
+                        VK_WHOLE_SIZE,
+                        0,
+                        &m_staging_ring_buffer_memory_pointer) != VK_SUCCESS)
+        {
+            LOG_ERROR("failed to map staging ring buffer!");
+        }
+
+        m_rhi_staging_ring_buffer = new VulkanBuffer();
+        ((VulkanBuffer*)m_rhi_staging_ring_buffer)->setResource(m_staging_ring_buffer);
+
+        VkCommandPoolCreateInfo command_pool_create_info {};
+        command_pool_create_info.sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        command_pool_create_info.flags            = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        command_pool_create_info.queueFamilyIndex = m_queue_indices.graphics_family.value();
+
+        if (vkCreateCommandPool(m_device, &command_pool_create_info, nullptr, &m_upload_command_pool) != VK_SUCCESS)
+        {
+            LOG_ERROR("vk create upload command pool");
+        }
+
+        VkCommandBufferAllocateInfo command_buffer_allocate_info {};
+        command_buffer_allocate_info.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        command_buffer_allocate_info.commandPool        = m_upload_command_pool;
+        command_buffer_allocate_info.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        command_buffer_allocate_info.commandBufferCount = 1U;
+
+        VkFenceCreateInfo fence_create_info {};
+        fence_create_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+        for (uint32_t i = 0; i < k_max_frames_in_flight; ++i)
+        {
+            if (vkAllocateCommandBuffers(m_device, &command_buffer_allocate_info, &m_upload_batches[i].command_buffer) !=
+                    VK_SUCCESS ||
+                vkCreateFence(m_device, &fence_create_info, nullptr, &m_upload_batches[i].fence) != VK_SUCCESS)
+            {
+                LOG_ERROR("vk create upload command buffer & fence");
+            }
+        }
+    }
+
+    void VulkanRHI::destroyStagingRing()
+    {
+        if (m_upload_command_pool == VK_NULL_HANDLE)
+        {
+            return;
+        }
+
+        flushUploadCommands();
+        for (uint8_t i = 0; i < k_max_frames_in_flight; ++i)
+        {
+            retireUploadBatch((m_current_upload_batch_index + i) % k_max_frames_in_flight);
+        }
+        // retiring waits on the fences, so none is destroyed before all the batches are retired
+        for (uint8_t i = 0; i < k_max_frames_in_flight; ++i)
+        {
+            vkDestroyFence(m_device, m_upload_batches[i].fence, nullptr);
+            m_upload_batches[i].fence = VK_NULL_HANDLE;
+        }
+        vkDestroyCommandPool(m_device, m_upload_command_pool, nullptr);
+        m_upload_command_pool = VK_NULL_HANDLE;
+
+        vkUnmapMemory(m_device, m_staging_ring_buffer_memory);
+        vkDestroyBuffer(m_device, m_staging_ring_buffer, nullptr);
+        vkFreeMemory(m_device, m_staging_ring_buffer_memory, nullptr);
+        delete m_rhi_staging_ring_buffer;
+        m_rhi_staging_ring_buffer = nullptr;
+    }
+
+    void VulkanRHI::createPipelineCache()
+    {
+        auto start_time = std::chrono::steady_clock::now();
+
+        VkPhysicalDeviceProperties physical_device_properties;
+        vkGetPhysicalDeviceProperties(m_physical_device, &physical_device_properties);
+
+        std::vector<char> cache_data;
+        if (!m_pipeline_cache_path.empty())
+        {
+            std::ifstream cache_file(m_pipeline_cache_path, std::ios::binary | std::ios::ate);
+            if (cache_file.is_open())
+            {
+                cache_data.resize(static_cast<size_t>(cache_file.tellg()));
+                cache_file.seekg(0);
+                cache_file.read(cache_data.data(), cache_data.size());
+            }
+        }
+
+        // a cache written by another driver or device is discarded rather than handed to the driver
+        if (!cache_data.empty())
+        {
+            VkPipelineCacheHeaderVersionOne header {};
+            bool is_valid = cache_data.size() >= sizeof(header);
+            if (is_valid)
+            {
+                memcpy(&header, cache_data.data(), sizeof(header));
+                is_valid = header.headerSize >= sizeof(header) &&
+                           header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+                           header.vendorID == physical_device_properties.vendorID &&
+                           header.deviceID == physical_device_properties.deviceID &&
+                           memcmp(header.pipelineCacheUUID,
+                                  physical_device_properties.pipelineCacheUUID,
+                                  VK_UUID_SIZE) == 0;
+            }
+            if (!is_valid)
+            {
+                LOG_WARN("pipeline cache {} does not match the current device, it will be rebuilt",
+                         m_pipeline_cache_path.generic_string());
+                cache_data.clear();
+            }
+        }
+
+        VkPipelineCacheCreateInfo pipeline_cache_create_info {};
+        pipeline_cache_create_info.sType           = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        pipeline_cache_create_info.initialDataSize = cache_data.size();
+        pipeline_cache_create_info.pInitialData    = cache_data.empty() ? nullptr : cache_data.data();
+
+        if (vkCreatePipelineCache(m_device, &pipeline_cache_create_info, nullptr, &m_pipeline_cache) != VK_SUCCESS)
+        {
+            LOG_ERROR("vk create pipeline cache");
+            m_pipeline_cache = VK_NULL_HANDLE;
+            return;
+        }
+
+        auto load_time =
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time);
+        LOG_INFO("pipeline cache loaded {} bytes in {} ms", cache_data.size(), load_time.count() / 1000.0);
+    }
+
+    void VulkanRHI::destroyPipelineCache()
+    {
+        if (m_pipeline_cache == VK_NULL_HANDLE)
+        {
+            return;
+        }
+
+        if (!m_pipeline_cache_path.empty())
+        {
+            size_t cache_data_size = 0;
+            vkGetPipelineCacheData(m_device, m_pipeline_cache, &cache_data_size, nullptr);
+
+            std::vector<char> cache_data(cache_data_size);
+            if (cache_data_size > 0 &&
+                vkGetPipelineCacheData(m_device, m_pipeline_cache, &cache_data_size, cache_data.data()) == VK_SUCCESS)
+            {
+                std::ofstream cache_file(m_pipeline_cache_path, std::ios::binary | std::ios::trunc);
+                if (cache_file.is_open())
+                {
+                    cache_file.write(cache_data.data(), cache_data_size);
+                }
+                else
+                {
+                    LOG_WARN("failed to write pipeline cache {}", m_pipeline_cache_path.generic_string());
+                }
+            }
+        }
+
+        vkDestroyPipelineCache(m_device, m_pipeline_cache, nullptr);
+        m_pipeline_cache = VK_NULL_HANDLE;
+    }
+
     void VulkanRHI::createAssetAllocator()
     {
         VmaVulkanFunctions vulkanFunctions    = {};
@@ -3198,7 +3648,12 @@ namespace Piccolo
 
         VkDescriptorSet vk_descriptor_set;
         pDescriptorSets = new VulkanDescriptorSet;
+
+        // the descriptor pool is shared by all passes, which may be set up on several threads
+        std::unique_lock<std::mutex> lock(m_descriptor_pool_mutex);
         VkResult result = vkAllocateDescriptorSets(m_device, &descriptorset_allocate_info, &vk_descriptor_set);
+        lock.unlock();
+
         ((VulkanDescriptorSet*)pDescriptorSets)->setResource(vk_descriptor_set);
 
         if (result == VK_SUCCESS)
@@ -3417,6 +3872,18 @@ namespace Piccolo
         RHI_DELETE_PTR(buffer);
     }
 
+    void VulkanRHI::destroyBufferVMA(VmaAllocator allocator, RHIBuffer* &buffer, VmaAllocation allocation)
+    {
+        vmaDestroyBuffer(allocator, ((VulkanBuffer*)buffer)->getResource(), allocation);
+        RHI_DELETE_PTR(buffer);
+    }
+
+    void VulkanRHI::destroyImageVMA(VmaAllocator allocator, RHIImage* &image, VmaAllocation allocation)
+    {
+        vmaDestroyImage(allocator, ((VulkanImage*)image)->getResource(), allocation);
+        RHI_DELETE_PTR(image);
+    }
+
     void VulkanRHI::freeCommandBuffers(RHICommandPool* commandPool, uint32_t commandBufferCount, RHICommandBuffer* pCommandBuffers)
     {
         VkCommandBuffer vk_command_buffer = ((VulkanCommandBuffer*)pCommandBuffers)->getResource();
@@ -3474,6 +3941,12 @@ namespace Piccolo
         return m_image_available_for_texturescopy_semaphores[index];
     }
 
+    void VulkanRHI::addRenderingWaitSemaphore(RHISemaphore* semaphore, RHIPipelineStageFlags waitStageMask)
+    {
+        m_rendering_wait_semaphores.push_back(((VulkanSemaphore*)semaphore)->getResource());
+        m_rendering_wait_stages.push_back(static_cast<VkPipelineStageFlags>(waitStageMask));
+    }
+
     // ڴСıᵼ½ʹڲ䣬Ҫ¶Խд
     void VulkanRHI::recreateSwapchain()
     {
@@ -3788,6 +4261,7 @@ namespace Piccolo
         }
     }
     bool VulkanRHI::isPointLightShadowEnabled(){ return m_enable_point_light_shadow; }
+    bool VulkanRHI::isGpuDrivenRenderingSupported(){ return m_enable_gpu_driven_rendering; }
 
     RHICommandBuffer* VulkanRHI::getCurrentCommandBuffer() const
     {
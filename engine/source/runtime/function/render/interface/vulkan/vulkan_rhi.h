@@ -6,8 +6,10 @@
 #include <vk_mem_alloc.h>
 #include <vulkan/vulkan.h>
 
+#include <filesystem>
 #include <functional>
 #include <map>
+#include <mutex>
 #include <vector>
 
 namespace Piccolo
@@ -104,6 +106,8 @@ namespace Piccolo
         void cmdDraw(RHICommandBuffer* commandBuffer, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance) override;
         void cmdDispatch(RHICommandBuffer* commandBuffer, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) override;
         void cmdDispatchIndirect(RHICommandBuffer* commandBuffer, RHIBuffer* buffer, RHIDeviceSize offset) override;
+        void cmdDrawIndexedIndirect(RHICommandBuffer* commandBuffer, RHIBuffer* buffer, RHIDeviceSize offset, uint32_t drawCount, uint32_t stride) override;
+        void cmdDrawIndirect(RHICommandBuffer* commandBuffer, RHIBuffer* buffer, RHIDeviceSize offset, uint32_t drawCount, uint32_t stride) override;
         void cmdPipelineBarrier(RHICommandBuffer* commandBuffer, RHIPipelineStageFlags srcStageMask, RHIPipelineStageFlags dstStageMask, RHIDependencyFlags dependencyFlags, uint32_t memoryBarrierCount, const RHIMemoryBarrier* pMemoryBarriers, uint32_t bufferMemoryBarrierCount, const RHIBufferMemoryBarrier* pBufferMemoryBarriers, uint32_t imageMemoryBarrierCount, const RHIImageMemoryBarrier* pImageMemoryBarriers) override;
         bool endCommandBuffer(RHICommandBuffer* commandBuffer) override;
         void updateDescriptorSets(uint32_t descriptorWriteCount, const RHIWriteDescriptorSet* pDescriptorWrites, uint32_t descriptorCopyCount, const RHICopyDescriptorSet* pDescriptorCopies) override;
@@ -137,6 +141,12 @@ namespace Piccolo
         void pushEvent(RHICommandBuffer* commond_buffer, const char* name, const float* color) override;
         void popEvent(RHICommandBuffer* commond_buffer) override;
 
+        // staging upload
+        bool allocateStagingBuffer(RHIDeviceSize size, RHIDeviceSize alignment, RHIStagingBufferAllocation& allocation) override;
+        void enqueueCopyBuffer(const RHIStagingBufferAllocation& src, RHIBuffer* dstBuffer, RHIDeviceSize srcOffset, RHIDeviceSize dstOffset, RHIDeviceSize size) override;
+        void flushUploadCommands() override;
+        VkCommandBuffer beginUploadCommands();
+
         // destory
         virtual ~VulkanRHI() override final;
         void clear() override;
@@ -154,6 +164,8 @@ namespace Piccolo
         void destroyDevice() override;
         void destroyCommandPool(RHICommandPool* commandPool) override;
         void destroyBuffer(RHIBuffer* &buffer) override;
+        void destroyBufferVMA(VmaAllocator allocator, RHIBuffer* &buffer, VmaAllocation allocation) override;
+        void destroyImageVMA(VmaAllocator allocator, RHIImage* &image, VmaAllocation allocation) override;
         void freeCommandBuffers(RHICommandPool* commandPool, uint32_t commandBufferCount, RHICommandBuffer* pCommandBuffers) override;
 
         // memory
@@ -165,6 +177,7 @@ namespace Piccolo
         
         //semaphores
         RHISemaphore* &getTextureCopySemaphore(uint32_t index) override;
+        void addRenderingWaitSemaphore(RHISemaphore* semaphore, RHIPipelineStageFlags waitStageMask) override;
     public:
         // һͬʱд֡
         static uint8_t const k_max_frames_in_flight {3};
@@ -277,6 +290,50 @@ namespace Piccolo
         RHISampler* m_linear_sampler = nullptr;
         RHISampler* m_nearest_sampler = nullptr;
         std::map<uint32_t, RHISampler*> m_mipmap_sampler_map;
+        std::mutex                      m_sampler_mutex;
+
+        // guards allocations from the shared descriptor pool
+        std::mutex m_descriptor_pool_mutex;
+
+        // uploads are recorded into the current batch and submitted together by flushUploadCommands,
+        // the staging memory of a batch is recycled once its fence is signaled
+        struct UploadBatch
+        {
+            VkCommandBuffer command_buffer {VK_NULL_HANDLE};
+            VkFence         fence {VK_NULL_HANDLE};
+            bool            is_recording {false};
+            bool            is_in_flight {false};
+            uint32_t        command_count {0};
+            VkDeviceSize    staging_ring_consumed {0};
+
+            // uploads larger than the staging ring
+            std::vector<std::pair<RHIBuffer*, VkDeviceMemory>> dedicated_staging_buffers;
+        };
+
+        static VkDeviceSize const k_staging_ring_buffer_size {64 * 1024 * 1024};
+
+        VkBuffer       m_staging_ring_buffer {VK_NULL_HANDLE};
+        RHIBuffer*     m_rhi_staging_ring_buffer {nullptr};
+        VkDeviceMemory m_staging_ring_buffer_memory {VK_NULL_HANDLE};
+        void*          m_staging_ring_buffer_memory_pointer {nullptr};
+        VkDeviceSize   m_staging_ring_head {0};
+        VkDeviceSize   m_staging_ring_used {0};
+
+        VkCommandPool m_upload_command_pool {VK_NULL_HANDLE};
+        UploadBatch   m_upload_batches[k_max_frames_in_flight];
+        uint8_t       m_current_upload_batch_index {0};
+
+        // upload statistics since startup
+        uint64_t m_upload_submit_count {0};
+        uint64_t m_upload_command_count {0};
+
+        // added by the passes which submit to other queues, consumed by the next submitRendering
+        std::vector<VkSemaphore>          m_rendering_wait_semaphores;
+        std::vector<VkPipelineStageFlags> m_rendering_wait_stages;
+
+        // shared by every pipeline created without an explicit cache, persisted across runs
+        VkPipelineCache       m_pipeline_cache {VK_NULL_HANDLE};
+        std::filesystem::path m_pipeline_cache_path;
 
     private:
         void createInstance();
@@ -289,14 +346,24 @@ namespace Piccolo
         void createDescriptorPool();
         void createSyncPrimitives();
         void createAssetAllocator();
+        void createStagingRing();
+        void destroyStagingRing();
+        void createPipelineCache();
+        void destroyPipelineCache();
+
+        UploadBatch& beginUploadBatch();
+        void         retireUploadBatch(uint8_t batch_index);
+        bool         findStagingRingSpace(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& offset, VkDeviceSize& consumed) const;
 
     public:
         bool isPointLightShadowEnabled() override;
+        bool isGpuDrivenRenderingSupported() override;
 
     private:
         bool m_enable_validation_Layers{ true };
         bool m_enable_debug_utils_label{ true };
         bool m_enable_point_light_shadow{ true };
+        bool m_enable_gpu_driven_rendering{ false };
 
         // used in descriptor pool creation
         uint32_t m_max_vertex_blending_mesh_count{ 256 };
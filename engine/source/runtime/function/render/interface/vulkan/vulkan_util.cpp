@@ -344,21 +344,21 @@ namespace Piccolo
 
         // use staging buffer ݴ滺
         // ʹCPUɼĻΪʱ壬ʹԿȡϿĻΪĻ
-        VkBuffer       inefficient_staging_buffer;
-        VkDeviceMemory inefficient_staging_buffer_memory;
-        VulkanUtil::createBuffer(static_cast<VulkanRHI*>(rhi)->m_physical_device,
-                                 static_cast<VulkanRHI*>(rhi)->m_device,
-                                 texture_byte_size,
-                                 VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                                 inefficient_staging_buffer,
-                                 inefficient_staging_buffer_memory);
-
-        void* data;
-        vkMapMemory(
-            static_cast<VulkanRHI*>(rhi)->m_device, inefficient_staging_buffer_memory, 0, texture_byte_size, 0, &data);
-        memcpy(data, texture_image_pixels, static_cast<size_t>(texture_byte_size));
-        vkUnmapMemory(static_cast<VulkanRHI*>(rhi)->m_device, inefficient_staging_buffer_memory);
+        // the buffer offset of a buffer to image copy must be a multiple of both the texel size and 4
+        VkDeviceSize staging_alignment =
+            texture_byte_size / (static_cast<VkDeviceSize>(texture_image_width) * texture_image_height);
+        if (staging_alignment % 4 != 0)
+        {
+            staging_alignment *= 4;
+        }
+
+        RHIStagingBufferAllocation staging_allocation;
+        if (!rhi->allocateStagingBuffer(texture_byte_size, staging_alignment, staging_allocation))
+        {
+            LOG_ERROR("failed to allocate texture staging buffer");
+            return;
+        }
+        memcpy(staging_allocation.mapped_data, texture_image_pixels, static_cast<size_t>(texture_byte_size));
 
         // generate mipmapped image
         uint32_t mip_levels =
@@ -401,7 +401,13 @@ namespace Piccolo
                               1,
                               VK_IMAGE_ASPECT_COLOR_BIT);
         // copy from staging buffer as destination
-        copyBufferToImage(rhi, inefficient_staging_buffer, image, texture_image_width, texture_image_height, 1);
+        copyBufferToImage(rhi,
+                          ((VulkanBuffer*)staging_allocation.buffer)->getResource(),
+                          staging_allocation.offset,
+                          image,
+                          texture_image_width,
+                          texture_image_height,
+                          1);
         // layout transitions -- image layout is set from destination to shader_read
         transitionImageLayout(rhi,
                               image,
@@ -411,9 +417,6 @@ namespace Piccolo
                               1,
                               VK_IMAGE_ASPECT_COLOR_BIT);
 
-        vkDestroyBuffer(static_cast<VulkanRHI*>(rhi)->m_device, inefficient_staging_buffer, nullptr);
-        vkFreeMemory(static_cast<VulkanRHI*>(rhi)->m_device, inefficient_staging_buffer_memory, nullptr);
-
         // generate mipmapped image
         genMipmappedImage(rhi, image, texture_image_width, texture_image_height, mip_levels);
 
@@ -507,26 +510,28 @@ namespace Piccolo
                        &image_allocation,
                        NULL);
 
-        VkBuffer       inefficient_staging_buffer;
-        VkDeviceMemory inefficient_staging_buffer_memory;
-        createBuffer(static_cast<VulkanRHI*>(rhi)->m_physical_device,
-                     static_cast<VulkanRHI*>(rhi)->m_device,
-                     cube_byte_size,
-                     VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                     inefficient_staging_buffer,
-                     inefficient_staging_buffer_memory);
-
-        void* data = NULL;
-        vkMapMemory(
-            static_cast<VulkanRHI*>(rhi)->m_device, inefficient_staging_buffer_memory, 0, cube_byte_size, 0, &data);
+        // the buffer offset of a buffer to image copy must be a multiple of both the texel size and 4
+        VkDeviceSize staging_alignment =
+            texture_layer_byte_size / (static_cast<VkDeviceSize>(texture_image_width) * texture_image_height);
+        if (staging_alignment % 4 != 0)
+        {
+            staging_alignment *= 4;
+        }
+
+        RHIStagingBufferAllocation staging_allocation;
+        if (!rhi->allocateStagingBuffer(cube_byte_size, staging_alignment, staging_allocation))
+        {
+            LOG_ERROR("failed to allocate cubemap staging buffer");
+            return;
+        }
+
+        void* data = staging_allocation.mapped_data;
         for (int i = 0; i < 6; i++)
         {
             memcpy((void*)(static_cast<char*>(data) + texture_layer_byte_size * i),
                    texture_image_pixels[i],
                    static_cast<size_t>(texture_layer_byte_size));
         }
-        vkUnmapMemory(static_cast<VulkanRHI*>(rhi)->m_device, inefficient_staging_buffer_memory);
 
         // layout transitions -- image layout is set from none to destination
         transitionImageLayout(rhi,
@@ -538,15 +543,13 @@ namespace Piccolo
                               VK_IMAGE_ASPECT_COLOR_BIT);
         // copy from staging buffer as destination
         copyBufferToImage(rhi,
-                          inefficient_staging_buffer,
+                          ((VulkanBuffer*)staging_allocation.buffer)->getResource(),
+                          staging_allocation.offset,
                           image,
                           static_cast<uint32_t>(texture_image_width),
                           static_cast<uint32_t>(texture_image_height),
                           6);
 
-        vkDestroyBuffer(static_cast<VulkanRHI*>(rhi)->m_device, inefficient_staging_buffer, nullptr);
-        vkFreeMemory(static_cast<VulkanRHI*>(rhi)->m_device, inefficient_staging_buffer_memory, nullptr);
-
         generateTextureMipMaps(
             rhi, image, vulkan_image_format, texture_image_width, texture_image_height, 6, miplevels);
 
@@ -576,8 +579,7 @@ namespace Piccolo
             return;
         }
 
-        RHICommandBuffer* rhi_command_buffer = static_cast<VulkanRHI*>(rhi)->beginSingleTimeCommands();
-        VkCommandBuffer command_buffer = ((VulkanCommandBuffer*)rhi_command_buffer)->getResource();
+        VkCommandBuffer command_buffer = static_cast<VulkanRHI*>(rhi)->beginUploadCommands();
 
         VkImageMemoryBarrier barrier {};
         barrier.sType                           = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
@@ -673,8 +675,6 @@ namespace Piccolo
                              nullptr,
                              1,
                              &barrier);
-
-        static_cast<VulkanRHI*>(rhi)->endSingleTimeCommands(rhi_command_buffer);
     }
 
     void VulkanUtil::transitionImageLayout(RHI*               rhi,
@@ -691,8 +691,7 @@ namespace Piccolo
             return;
         }
 
-        RHICommandBuffer* rhi_command_buffer = static_cast<VulkanRHI*>(rhi)->beginSingleTimeCommands();
-        VkCommandBuffer command_buffer = ((VulkanCommandBuffer*)rhi_command_buffer)->getResource();
+        VkCommandBuffer command_buffer = static_cast<VulkanRHI*>(rhi)->beginUploadCommands();
 
         VkImageMemoryBarrier barrier {};
         barrier.sType                           = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
@@ -763,16 +762,15 @@ namespace Piccolo
         }
 
         vkCmdPipelineBarrier(command_buffer, sourceStage, destinationStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
-
-        static_cast<VulkanRHI*>(rhi)->endSingleTimeCommands(rhi_command_buffer);
     }
 
-    void VulkanUtil::copyBufferToImage(RHI*     rhi,
-                                       VkBuffer buffer,
-                                       VkImage  image,
-                                       uint32_t width,
-                                       uint32_t height,
-                                       uint32_t layer_count)
+    void VulkanUtil::copyBufferToImage(RHI*         rhi,
+                                       VkBuffer     buffer,
+                                       VkDeviceSize buffer_offset,
+                                       VkImage      image,
+                                       uint32_t     width,
+                                       uint32_t     height,
+                                       uint32_t     layer_count)
     {
         if (rhi == nullptr)
         {
@@ -780,11 +778,10 @@ namespace Piccolo
             return;
         }
 
-        RHICommandBuffer* rhi_command_buffer = static_cast<VulkanRHI*>(rhi)->beginSingleTimeCommands();
-        VkCommandBuffer command_buffer = ((VulkanCommandBuffer*)rhi_command_buffer)->getResource();
+        VkCommandBuffer command_buffer = static_cast<VulkanRHI*>(rhi)->beginUploadCommands();
 
         VkBufferImageCopy region {};
-        region.bufferOffset                    = 0;
+        region.bufferOffset                    = buffer_offset;
         region.bufferRowLength                 = 0;
         region.bufferImageHeight               = 0;
         region.imageSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
@@ -795,8 +792,6 @@ namespace Piccolo
         region.imageExtent                     = {width, height, 1};
 
         vkCmdCopyBufferToImage(command_buffer, buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-
-        static_cast<VulkanRHI*>(rhi)->endSingleTimeCommands(rhi_command_buffer);
     }
 
     void VulkanUtil::genMipmappedImage(RHI* rhi, VkImage image, uint32_t width, uint32_t height, uint32_t mip_levels)
@@ -807,8 +802,7 @@ namespace Piccolo
             return;
         }
 
-        RHICommandBuffer* rhi_command_buffer = static_cast<VulkanRHI*>(rhi)->beginSingleTimeCommands();
-        VkCommandBuffer command_buffer = ((VulkanCommandBuffer*)rhi_command_buffer)->getResource();
+        VkCommandBuffer command_buffer = static_cast<VulkanRHI*>(rhi)->beginUploadCommands();
 
         for (uint32_t i = 1; i < mip_levels; i++)
         {
@@ -908,8 +902,6 @@ namespace Piccolo
                              nullptr,
                              1,
                              &barrier);
-
-        static_cast<VulkanRHI*>(rhi)->endSingleTimeCommands(rhi_command_buffer);
     }
 
     VkSampler VulkanUtil::getOrCreateMipmapSampler(VkPhysicalDevice physical_device,
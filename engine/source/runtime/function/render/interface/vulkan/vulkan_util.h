@@ -91,12 +91,14 @@ namespace Piccolo
                                                     uint32_t           layer_count,
                                                     uint32_t           miplevels,
                                                     VkImageAspectFlags aspect_mask_bits);
-        static void           copyBufferToImage(RHI*     rhi,
-                                                VkBuffer buffer,
-                                                VkImage  image,
-                                                uint32_t width,
-                                                uint32_t height,
-                                                uint32_t layer_count);
+        static void           copyBufferToImage(RHI*         rhi,
+                                                VkBuffer     buffer,
+                                                VkDeviceSize buffer_offset,
+                                                VkImage      image,
+                                                uint32_t     width,
+                                                uint32_t     height,
+                                                uint32_t     layer_count);
+
         static void genMipmappedImage(RHI* rhi, VkImage image, uint32_t width, uint32_t height, uint32_t mip_levels);
 
         static VkSampler
@@ -26,15 +26,6 @@ namespace Piccolo
         setupPipelines();
         setupDescriptorSet();
     }
-    void DirectionalLightShadowPass::preparePassData(std::shared_ptr<RenderResourceBase> render_resource)
-    {
-        const RenderResource* vulkan_resource = static_cast<const RenderResource*>(render_resource.get());
-        if (vulkan_resource)
-        {
-            m_mesh_directional_light_shadow_perframe_storage_buffer_object =
-                vulkan_resource->m_mesh_directional_light_shadow_perframe_storage_buffer_object;
-        }
-    }
     void DirectionalLightShadowPass::draw() { drawModel(); }
     void DirectionalLightShadowPass::setupAttachments()
     {
@@ -150,6 +141,15 @@ namespace Piccolo
         {
             throw std::runtime_error("create directional light shadow render pass");
         }
+
+        // compatible with the framebuffer, the tiles which are not cleared keep the cached cascades
+        directional_light_shadow_color_attachment_description.loadOp        = RHI_ATTACHMENT_LOAD_OP_LOAD;
+        directional_light_shadow_color_attachment_description.initialLayout = RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+        if (RHI_SUCCESS != m_rhi->createRenderPass(&renderpass_create_info, m_cached_tiles_render_pass))
+        {
+            throw std::runtime_error("create directional light shadow cached tiles render pass");
+        }
     }
     void DirectionalLightShadowPass::setupFramebuffer()
     {
@@ -329,10 +329,12 @@ namespace Piccolo
         depth_stencil_create_info.depthBoundsTestEnable = RHI_FALSE;
         depth_stencil_create_info.stencilTestEnable     = RHI_FALSE;
 
+        // each cascade is drawn into its own tile of the shadow map
+        RHIDynamicState                   dynamic_states[] = {RHI_DYNAMIC_STATE_VIEWPORT, RHI_DYNAMIC_STATE_SCISSOR};
         RHIPipelineDynamicStateCreateInfo dynamic_state_create_info {};
         dynamic_state_create_info.sType             = RHI_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-        dynamic_state_create_info.dynamicStateCount = 0;
-        dynamic_state_create_info.pDynamicStates    = NULL;
+        dynamic_state_create_info.dynamicStateCount = (sizeof(dynamic_states) / sizeof(dynamic_states[0]));
+        dynamic_state_create_info.pDynamicStates    = dynamic_states;
 
         RHIGraphicsPipelineCreateInfo pipelineInfo {};
         pipelineInfo.sType               = RHI_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
@@ -396,7 +398,7 @@ namespace Piccolo
         RHIDescriptorBufferInfo mesh_directional_light_shadow_per_drawcall_vertex_blending_storage_buffer_info = {};
         mesh_directional_light_shadow_per_drawcall_vertex_blending_storage_buffer_info.offset                 = 0;
         mesh_directional_light_shadow_per_drawcall_vertex_blending_storage_buffer_info.range =
-            sizeof(MeshDirectionalLightShadowPerdrawcallVertexBlendingStorageBufferObject);
+            sizeof(MeshJointPaletteStorageBufferObject);
         mesh_directional_light_shadow_per_drawcall_vertex_blending_storage_buffer_info.buffer =
             m_global_render_resource->_storage_buffer._global_upload_ringbuffer;
         assert(mesh_directional_light_shadow_per_drawcall_vertex_blending_storage_buffer_info.range <
@@ -454,38 +456,30 @@ namespace Piccolo
     }
     void DirectionalLightShadowPass::drawModel()
     {
-        struct MeshNode
-        {
-            const Matrix4x4* model_matrix {nullptr};
-            const Matrix4x4* joint_matrices {nullptr};
-            uint32_t         joint_count {0};
-        };
+        const std::vector<RenderDirectionalLightCascade>& cascades = *(m_visiable_nodes.p_directional_light_cascades);
 
-        std::map<VulkanPBRMaterial*, std::map<VulkanMesh*, std::vector<MeshNode>>>
-            directional_light_mesh_drawcall_batch;
+        uint32_t const cascade_count = static_cast<uint32_t>(cascades.size());
+        // should sync the tiles in "shader_include/mesh_lighting.inl"
+        uint32_t const tile_grid      = (cascade_count > 1) ? 2 : 1;
+        uint32_t const tile_dimension = s_directional_light_shadow_map_dimension / tile_grid;
 
-        // reorganize mesh
-        for (RenderMeshNode& node : *(m_visiable_nodes.p_directional_light_visible_mesh_nodes))
+        // the cached tiles are only there if the whole shadow map was drawn with the same cascades before
+        bool const is_drawing_meshes = m_rhi->isPointLightShadowEnabled();
+        bool       keep_cached_tiles = false;
+        if (is_drawing_meshes && m_drawn_cascade_count == cascade_count)
         {
-            auto& mesh_instanced = directional_light_mesh_drawcall_batch[node.ref_material];
-            auto& mesh_nodes     = mesh_instanced[node.ref_mesh];
-
-            MeshNode temp;
-            temp.model_matrix = node.model_matrix;
-            if (node.enable_vertex_blending)
+            for (const RenderDirectionalLightCascade& cascade : cascades)
             {
-                temp.joint_matrices = node.joint_matrices;
-                temp.joint_count    = node.joint_count;
+                keep_cached_tiles |= cascade.is_cached;
             }
-
-            mesh_nodes.push_back(temp);
         }
 
         // Directional Light Shadow begin pass
         {
             RHIRenderPassBeginInfo renderpass_begin_info {};
-            renderpass_begin_info.sType             = RHI_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-            renderpass_begin_info.renderPass        = m_framebuffer.render_pass;
+            renderpass_begin_info.sType = RHI_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+            renderpass_begin_info.renderPass =
+                keep_cached_tiles ? m_cached_tiles_render_pass : m_framebuffer.render_pass;
             renderpass_begin_info.framebuffer       = m_framebuffer.framebuffer;
             renderpass_begin_info.renderArea.offset = {0, 0};
             renderpass_begin_info.renderArea.extent = {s_directional_light_shadow_map_dimension,
@@ -504,186 +498,61 @@ namespace Piccolo
         }
 
         // Mesh
-        if (m_rhi->isPointLightShadowEnabled())
+        if (is_drawing_meshes)
         {
             float color[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
             m_rhi->pushEvent(m_rhi->getCurrentCommandBuffer(), "Mesh", color);
 
             m_rhi->cmdBindPipelinePFN(m_rhi->getCurrentCommandBuffer(), RHI_PIPELINE_BIND_POINT_GRAPHICS, m_render_pipelines[0].pipeline);
 
-            // perframe storage buffer
-            uint32_t perframe_dynamic_offset =
-                roundUp(m_global_render_resource->_storage_buffer
-                            ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()],
-                        m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-            m_global_render_resource->_storage_buffer
-                ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] =
-                perframe_dynamic_offset + sizeof(MeshPerframeStorageBufferObject);
-            assert(m_global_render_resource->_storage_buffer
-                       ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] <=
-                   (m_global_render_resource->_storage_buffer
-                        ._global_upload_ringbuffers_begin[m_rhi->getCurrentFrameIndex()] +
-                    m_global_render_resource->_storage_buffer
-                        ._global_upload_ringbuffers_size[m_rhi->getCurrentFrameIndex()]));
-
-            MeshDirectionalLightShadowPerframeStorageBufferObject& perframe_storage_buffer_object =
-                (*reinterpret_cast<MeshDirectionalLightShadowPerframeStorageBufferObject*>(
-                    reinterpret_cast<uintptr_t>(
-                        m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
-                    perframe_dynamic_offset));
-            perframe_storage_buffer_object = m_mesh_directional_light_shadow_perframe_storage_buffer_object;
-
-            for (auto& [material, mesh_instanced] : directional_light_mesh_drawcall_batch)
+            for (uint32_t cascade_index = 0; cascade_index < cascade_count; ++cascade_index)
             {
-                // TODO: render from near to far
+                const RenderDirectionalLightCascade& cascade = cascades[cascade_index];
+                if (keep_cached_tiles && cascade.is_cached)
+                {
+                    continue;
+                }
 
-                for (auto& [mesh, mesh_nodes] : mesh_instanced)
+                RHIRect2D tile_rect = {{static_cast<int32_t>((cascade_index % tile_grid) * tile_dimension),
+                                        static_cast<int32_t>((cascade_index / tile_grid) * tile_dimension)},
+                                       {tile_dimension, tile_dimension}};
+
+                if (keep_cached_tiles)
                 {
-                    uint32_t total_instance_count = static_cast<uint32_t>(mesh_nodes.size());
-                    if (total_instance_count > 0)
-                    {
-                        // bind per mesh
-                        m_rhi->cmdBindDescriptorSetsPFN(m_rhi->getCurrentCommandBuffer(),
-                                                        RHI_PIPELINE_BIND_POINT_GRAPHICS,
-                                                        m_render_pipelines[0].layout,
-                                                        1,
-                                                        1,
-                                                        &mesh->mesh_vertex_blending_descriptor_set,
-                                                        0,
-                                                        NULL);
-
-                        RHIBuffer*     vertex_buffers[] = {mesh->mesh_vertex_position_buffer};
-                        RHIDeviceSize offsets[]        = {0};
-                        m_rhi->cmdBindVertexBuffersPFN(m_rhi->getCurrentCommandBuffer(), 0, 1, vertex_buffers, offsets);
-                        m_rhi->cmdBindIndexBufferPFN(m_rhi->getCurrentCommandBuffer(), mesh->mesh_index_buffer, 0, RHI_INDEX_TYPE_UINT16);
-
-                        uint32_t drawcall_max_instance_count =
-                            (sizeof(MeshDirectionalLightShadowPerdrawcallStorageBufferObject::mesh_instances) /
-                             sizeof(MeshDirectionalLightShadowPerdrawcallStorageBufferObject::mesh_instances[0]));
-                        uint32_t drawcall_count =
-                            roundUp(total_instance_count, drawcall_max_instance_count) / drawcall_max_instance_count;
-
-                        for (uint32_t drawcall_index = 0; drawcall_index < drawcall_count; ++drawcall_index)
-                        {
-                            uint32_t current_instance_count =
-                                ((total_instance_count - drawcall_max_instance_count * drawcall_index) <
-                                 drawcall_max_instance_count) ?
-                                    (total_instance_count - drawcall_max_instance_count * drawcall_index) :
-                                    drawcall_max_instance_count;
-
-                            // perdrawcall storage buffer
-                            uint32_t perdrawcall_dynamic_offset =
-                                roundUp(m_global_render_resource->_storage_buffer
-                                            ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()],
-                                        m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                            m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] =
-                                perdrawcall_dynamic_offset +
-                                sizeof(MeshDirectionalLightShadowPerdrawcallStorageBufferObject);
-                            assert(m_global_render_resource->_storage_buffer
-                                       ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] <=
-                                   (m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_begin[m_rhi->getCurrentFrameIndex()] +
-                                    m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_size[m_rhi->getCurrentFrameIndex()]));
-
-                            MeshDirectionalLightShadowPerdrawcallStorageBufferObject&
-                                perdrawcall_storage_buffer_object =
-                                    (*reinterpret_cast<MeshDirectionalLightShadowPerdrawcallStorageBufferObject*>(
-                                        reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
-                                                                        ._global_upload_ringbuffer_memory_pointer) +
-                                        perdrawcall_dynamic_offset));
-                            for (uint32_t i = 0; i < current_instance_count; ++i)
-                            {
-                                perdrawcall_storage_buffer_object.mesh_instances[i].model_matrix =
-                                    *mesh_nodes[drawcall_max_instance_count * drawcall_index + i].model_matrix;
-                                perdrawcall_storage_buffer_object.mesh_instances[i].enable_vertex_blending =
-                                    mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices ? 1.0 :
-                                                                                                                  -1.0;
-                            }
-
-                            // per drawcall vertex blending storage buffer
-                            uint32_t per_drawcall_vertex_blending_dynamic_offset;
-                            bool     least_one_enable_vertex_blending = true;
-                            for (uint32_t i = 0; i < current_instance_count; ++i)
-                            {
-                                if (!mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices)
-                                {
-                                    least_one_enable_vertex_blending = false;
-                                    break;
-                                }
-                            }
-                            if (least_one_enable_vertex_blending)
-                            {
-                                per_drawcall_vertex_blending_dynamic_offset = roundUp(
-                                    m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()],
-                                    m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                                m_global_render_resource->_storage_buffer
-                                    ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] =
-                                    per_drawcall_vertex_blending_dynamic_offset +
-                                    sizeof(MeshDirectionalLightShadowPerdrawcallVertexBlendingStorageBufferObject);
-                                assert(m_global_render_resource->_storage_buffer
-                                           ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] <=
-                                       (m_global_render_resource->_storage_buffer
-                                            ._global_upload_ringbuffers_begin[m_rhi->getCurrentFrameIndex()] +
-                                        m_global_render_resource->_storage_buffer
-                                            ._global_upload_ringbuffers_size[m_rhi->getCurrentFrameIndex()]));
-
-                                MeshDirectionalLightShadowPerdrawcallVertexBlendingStorageBufferObject&
-                                    per_drawcall_vertex_blending_storage_buffer_object =
-                                        (*reinterpret_cast<
-                                            MeshDirectionalLightShadowPerdrawcallVertexBlendingStorageBufferObject*>(
-                                            reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
-                                                                            ._global_upload_ringbuffer_memory_pointer) +
-                                            per_drawcall_vertex_blending_dynamic_offset));
-                                for (uint32_t i = 0; i < current_instance_count; ++i)
-                                {
-                                    if (mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices)
-                                    {
-                                        for (uint32_t j = 0;
-                                             j <
-                                             mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_count;
-                                             ++j)
-                                        {
-                                            per_drawcall_vertex_blending_storage_buffer_object
-                                                .joint_matrices[s_mesh_vertex_blending_max_joint_count * i + j] =
-                                                mesh_nodes[drawcall_max_instance_count * drawcall_index + i]
-                                                    .joint_matrices[j];
-                                        }
-                                    }
-                                }
-                            }
-                            else
-                            {
-                                per_drawcall_vertex_blending_dynamic_offset = 0;
-                            }
-
-                            // bind perdrawcall
-                            uint32_t dynamic_offsets[3] = {perframe_dynamic_offset,
-                                                           perdrawcall_dynamic_offset,
-                                                           per_drawcall_vertex_blending_dynamic_offset};
-                            m_rhi->cmdBindDescriptorSetsPFN(m_rhi->getCurrentCommandBuffer(),
-                                                            RHI_PIPELINE_BIND_POINT_GRAPHICS,
-                                                            m_render_pipelines[0].layout,
-                                                            0,
-                                                            1,
-                                                            &m_descriptor_infos[0].descriptor_set,
-                                                            (sizeof(dynamic_offsets) / sizeof(dynamic_offsets[0])),
-                                                            dynamic_offsets);
-                            m_rhi->cmdDrawIndexedPFN(m_rhi->getCurrentCommandBuffer(),
-                                                     mesh->mesh_index_count,
-                                                     current_instance_count,
-                                                     0,
-                                                     0,
-                                                     0);
-                        }
-                    }
+                    // the load op kept the color of every tile, the depth is cleared as a whole
+                    RHIClearAttachment clear_attachments[1];
+                    clear_attachments[0].aspectMask                  = RHI_IMAGE_ASPECT_COLOR_BIT;
+                    clear_attachments[0].colorAttachment             = 0;
+                    clear_attachments[0].clearValue.color.float32[0] = 1.0f;
+                    clear_attachments[0].clearValue.color.float32[1] = 0.0f;
+                    clear_attachments[0].clearValue.color.float32[2] = 0.0f;
+                    clear_attachments[0].clearValue.color.float32[3] = 0.0f;
+                    RHIClearRect clear_rects[1];
+                    clear_rects[0].baseArrayLayer = 0;
+                    clear_rects[0].layerCount     = 1;
+                    clear_rects[0].rect           = tile_rect;
+                    m_rhi->cmdClearAttachmentsPFN(m_rhi->getCurrentCommandBuffer(),
+                                                  sizeof(clear_attachments) / sizeof(clear_attachments[0]),
+                                                  clear_attachments,
+                                                  sizeof(clear_rects) / sizeof(clear_rects[0]),
+                                                  clear_rects);
                 }
+
+                RHIViewport viewport = {static_cast<float>(tile_rect.offset.x),
+                                        static_cast<float>(tile_rect.offset.y),
+                                        static_cast<float>(tile_dimension),
+                                        static_cast<float>(tile_dimension),
+                                        0.0f,
+                                        1.0f};
+                m_rhi->cmdSetViewportPFN(m_rhi->getCurrentCommandBuffer(), 0, 1, &viewport);
+                m_rhi->cmdSetScissorPFN(m_rhi->getCurrentCommandBuffer(), 0, 1, &tile_rect);
+
+                drawCascade(cascade);
             }
 
             m_rhi->popEvent(m_rhi->getCurrentCommandBuffer());
         }
+        m_drawn_cascade_count = is_drawing_meshes ? cascade_count : 0;
 
         // Directional Light Shadow end pass
         {
@@ -692,4 +561,133 @@ namespace Piccolo
             m_rhi->cmdEndRenderPassPFN(m_rhi->getCurrentCommandBuffer());
         }
     }
+
+    void DirectionalLightShadowPass::drawCascade(const RenderDirectionalLightCascade& cascade)
+    {
+        m_mesh_draw_list.build(cascade.visible_mesh_nodes, false, nullptr);
+
+        // perframe storage buffer
+        uint32_t perframe_dynamic_offset =
+            roundUp(m_global_render_resource->_storage_buffer
+                        ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()],
+                    m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
+        m_global_render_resource->_storage_buffer._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] =
+            perframe_dynamic_offset + sizeof(MeshDirectionalLightShadowPerframeStorageBufferObject);
+        assert(m_global_render_resource->_storage_buffer
+                   ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] <=
+               (m_global_render_resource->_storage_buffer
+                    ._global_upload_ringbuffers_begin[m_rhi->getCurrentFrameIndex()] +
+                m_global_render_resource->_storage_buffer
+                    ._global_upload_ringbuffers_size[m_rhi->getCurrentFrameIndex()]));
+
+        MeshDirectionalLightShadowPerframeStorageBufferObject& perframe_storage_buffer_object =
+            (*reinterpret_cast<MeshDirectionalLightShadowPerframeStorageBufferObject*>(
+                reinterpret_cast<uintptr_t>(
+                    m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
+                perframe_dynamic_offset));
+        perframe_storage_buffer_object.light_proj_view = cascade.light_proj_view;
+
+        for (const RenderDrawBatch& batch : m_mesh_draw_list.getBatches())
+        {
+            VulkanMesh*               mesh       = batch.mesh;
+            const RenderDrawInstance* mesh_nodes = m_mesh_draw_list.getInstances(batch);
+
+            uint32_t total_instance_count = batch.instance_count;
+            if (total_instance_count > 0)
+            {
+                // bind per mesh
+                m_rhi->cmdBindDescriptorSetsPFN(m_rhi->getCurrentCommandBuffer(),
+                                                RHI_PIPELINE_BIND_POINT_GRAPHICS,
+                                                m_render_pipelines[0].layout,
+                                                1,
+                                                1,
+                                                &mesh->mesh_vertex_blending_descriptor_set,
+                                                0,
+                                                NULL);
+
+                RHIBuffer*     vertex_buffers[] = {mesh->mesh_vertex_position_buffer};
+                RHIDeviceSize offsets[]        = {0};
+
+                // a pre-skinned instance reads the vertices the skinning pass wrote for it
+                if (batch.is_pre_skinned)
+                {
+                    vertex_buffers[0] = m_global_render_resource->_skinned_vertex_buffer._position_buffer;
+                    offsets[0]        = sizeof(MeshVertex::VulkanMeshVertexPostition) * batch.skinned_vertex_offset;
+                }
+
+                m_rhi->cmdBindVertexBuffersPFN(m_rhi->getCurrentCommandBuffer(), 0, 1, vertex_buffers, offsets);
+                m_rhi->cmdBindIndexBufferPFN(m_rhi->getCurrentCommandBuffer(), mesh->mesh_index_buffer, 0, RHI_INDEX_TYPE_UINT16);
+
+                uint32_t drawcall_max_instance_count =
+                    (sizeof(MeshDirectionalLightShadowPerdrawcallStorageBufferObject::mesh_instances) /
+                     sizeof(MeshDirectionalLightShadowPerdrawcallStorageBufferObject::mesh_instances[0]));
+                uint32_t drawcall_count =
+                    roundUp(total_instance_count, drawcall_max_instance_count) / drawcall_max_instance_count;
+
+                for (uint32_t drawcall_index = 0; drawcall_index < drawcall_count; ++drawcall_index)
+                {
+                    uint32_t current_instance_count =
+                        ((total_instance_count - drawcall_max_instance_count * drawcall_index) <
+                         drawcall_max_instance_count) ?
+                            (total_instance_count - drawcall_max_instance_count * drawcall_index) :
+                            drawcall_max_instance_count;
+
+                    // perdrawcall storage buffer
+                    uint32_t perdrawcall_dynamic_offset =
+                        roundUp(m_global_render_resource->_storage_buffer
+                                    ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()],
+                                m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
+                    m_global_render_resource->_storage_buffer
+                        ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] =
+                        perdrawcall_dynamic_offset +
+                        sizeof(MeshDirectionalLightShadowPerdrawcallStorageBufferObject);
+                    assert(m_global_render_resource->_storage_buffer
+                               ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] <=
+                           (m_global_render_resource->_storage_buffer
+                                ._global_upload_ringbuffers_begin[m_rhi->getCurrentFrameIndex()] +
+                            m_global_render_resource->_storage_buffer
+                                ._global_upload_ringbuffers_size[m_rhi->getCurrentFrameIndex()]));
+
+                    MeshDirectionalLightShadowPerdrawcallStorageBufferObject&
+                        perdrawcall_storage_buffer_object =
+                            (*reinterpret_cast<MeshDirectionalLightShadowPerdrawcallStorageBufferObject*>(
+                                reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
+                                                                ._global_upload_ringbuffer_memory_pointer) +
+                                perdrawcall_dynamic_offset));
+                    for (uint32_t i = 0; i < current_instance_count; ++i)
+                    {
+                        perdrawcall_storage_buffer_object.mesh_instances[i].model_matrix =
+                            *mesh_nodes[drawcall_max_instance_count * drawcall_index + i].model_matrix;
+                        perdrawcall_storage_buffer_object.mesh_instances[i].enable_vertex_blending =
+                            mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_count > 0 ? 1.0 : -1.0;
+                        perdrawcall_storage_buffer_object.mesh_instances[i].joint_palette_offset =
+                            mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_palette_offset;
+                    }
+
+                    // the skinned instances read their joints from the palette of the frame
+                    uint32_t per_drawcall_vertex_blending_dynamic_offset =
+                        m_global_render_resource->_storage_buffer._joint_palette_dynamic_offset;
+
+                    // bind perdrawcall
+                    uint32_t dynamic_offsets[3] = {perframe_dynamic_offset,
+                                                   perdrawcall_dynamic_offset,
+                                                   per_drawcall_vertex_blending_dynamic_offset};
+                    m_rhi->cmdBindDescriptorSetsPFN(m_rhi->getCurrentCommandBuffer(),
+                                                    RHI_PIPELINE_BIND_POINT_GRAPHICS,
+                                                    m_render_pipelines[0].layout,
+                                                    0,
+                                                    1,
+                                                    &m_descriptor_infos[0].descriptor_set,
+                                                    (sizeof(dynamic_offsets) / sizeof(dynamic_offsets[0])),
+                                                    dynamic_offsets);
+                    m_rhi->cmdDrawIndexedPFN(m_rhi->getCurrentCommandBuffer(),
+                                             mesh->mesh_index_count,
+                                             current_instance_count,
+                                             0,
+                                             0,
+                                             0);
+                }
+            }
+        }
+    }
 } // namespace Piccolo
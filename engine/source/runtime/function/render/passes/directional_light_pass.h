@@ -1,5 +1,6 @@
 #pragma once
 
+#include "runtime/function/render/render_draw_list.h"
 #include "runtime/function/render/render_pass.h"
 
 namespace Piccolo
@@ -11,7 +12,6 @@ namespace Piccolo
     public:
         void initialize(const RenderPassInitInfo* init_info) override final;
         void postInitialize() override final;
-        void preparePassData(std::shared_ptr<RenderResourceBase> render_resource) override final;
         void draw() override final;
 
         void setPerMeshLayout(RHIDescriptorSetLayout* layout) { m_per_mesh_layout = layout; }
@@ -24,10 +24,16 @@ namespace Piccolo
         void setupPipelines();
         void setupDescriptorSet();
         void drawModel();
+        void drawCascade(const RenderDirectionalLightCascade& cascade);
 
     private:
         RHIDescriptorSetLayout* m_per_mesh_layout;
-        MeshDirectionalLightShadowPerframeStorageBufferObject
-            m_mesh_directional_light_shadow_perframe_storage_buffer_object;
+        RenderDrawList          m_mesh_draw_list;
+
+        // same attachments as the render pass of m_framebuffer, but the color is loaded so that the tiles of the
+        // cached cascades survive
+        RHIRenderPass* m_cached_tiles_render_pass {nullptr};
+        // cascades in the shadow map since the last time all of it was drawn, 0 before the first time
+        uint32_t m_drawn_cascade_count {0};
     };
 } // namespace Piccolo
@@ -6,6 +6,11 @@
 #include "runtime/function/render/interface/vulkan/vulkan_rhi.h"
 #include "runtime/function/render/interface/vulkan/vulkan_util.h"
 
+#include "runtime/core/job/job_system.h"
+#include "runtime/function/global/global_context.h"
+
+#include <cstring>
+#include <functional>
 #include <map>
 #include <stdexcept>
 
@@ -15,6 +20,7 @@
 #include <deferred_lighting_vert.h>
 #include <mesh_frag.h>
 #include <mesh_gbuffer_frag.h>
+#include <mesh_gpu_driven_vert.h>
 #include <mesh_vert.h>
 #include <skybox_frag.h>
 #include <skybox_vert.h>
@@ -46,6 +52,8 @@ namespace Piccolo
         {
             m_mesh_perframe_storage_buffer_object = vulkan_resource->m_mesh_perframe_storage_buffer_object;
             m_axis_storage_buffer_object          = vulkan_resource->m_axis_storage_buffer_object;
+
+            m_point_light_cluster_storage_buffer_object = &vulkan_resource->m_point_light_cluster_storage_buffer_object;
         }
     }
 
@@ -566,7 +574,7 @@ namespace Piccolo
         }
 
         {
-            RHIDescriptorSetLayoutBinding mesh_global_layout_bindings[8];
+            RHIDescriptorSetLayoutBinding mesh_global_layout_bindings[9];
 
             RHIDescriptorSetLayoutBinding& mesh_global_layout_perframe_storage_buffer_binding =
                 mesh_global_layout_bindings[0];
@@ -623,6 +631,15 @@ namespace Piccolo
             mesh_global_layout_directional_light_shadow_texture_binding = mesh_global_layout_brdfLUT_texture_binding;
             mesh_global_layout_directional_light_shadow_texture_binding.binding = 7;
 
+            RHIDescriptorSetLayoutBinding& mesh_global_layout_point_light_cluster_storage_buffer_binding =
+                mesh_global_layout_bindings[8];
+            mesh_global_layout_point_light_cluster_storage_buffer_binding.binding = 8;
+            mesh_global_layout_point_light_cluster_storage_buffer_binding.descriptorType =
+                RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+            mesh_global_layout_point_light_cluster_storage_buffer_binding.descriptorCount = 1;
+            mesh_global_layout_point_light_cluster_storage_buffer_binding.stageFlags = RHI_SHADER_STAGE_FRAGMENT_BIT;
+            mesh_global_layout_point_light_cluster_storage_buffer_binding.pImmutableSamplers = NULL;
+
             RHIDescriptorSetLayoutCreateInfo mesh_global_layout_create_info;
             mesh_global_layout_create_info.sType = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
             mesh_global_layout_create_info.pNext = NULL;
@@ -804,8 +821,11 @@ namespace Piccolo
     {
         m_render_pipelines.resize(_render_pipeline_type_count);
 
+        // the pipelines only read the pass state set up before, so they are created concurrently
+        std::vector<std::function<void()>> pipeline_jobs;
+
         // mesh gbuffer
-        {
+        pipeline_jobs.push_back([this]() {
             RHIDescriptorSetLayout*      descriptorset_layouts[3] = {m_descriptor_infos[_mesh_global].layout,
                                                               m_descriptor_infos[_per_mesh].layout,
                                                               m_descriptor_infos[_mesh_per_material].layout};
@@ -956,12 +976,32 @@ namespace Piccolo
                 throw std::runtime_error("create mesh gbuffer graphics pipeline");
             }
 
+            if (m_mesh_cull_pass)
+            {
+                // the same state, the instances are read from the buffers written by the mesh cull pass
+                RHIShader* gpu_driven_vert_shader_module = m_rhi->createShaderModule(MESH_GPU_DRIVEN_VERT);
+                shader_stages[0].module                  = gpu_driven_vert_shader_module;
+
+                m_render_pipelines[_render_pipeline_type_mesh_gbuffer_gpu_driven].layout =
+                    m_render_pipelines[_render_pipeline_type_mesh_gbuffer].layout;
+                if (RHI_SUCCESS !=
+                    m_rhi->createGraphicsPipelines(RHI_NULL_HANDLE,
+                                                   1,
+                                                   &pipelineInfo,
+                                                   m_render_pipelines[_render_pipeline_type_mesh_gbuffer_gpu_driven].pipeline))
+                {
+                    throw std::runtime_error("create mesh gbuffer gpu driven graphics pipeline");
+                }
+
+                m_rhi->destroyShaderModule(gpu_driven_vert_shader_module);
+            }
+
             m_rhi->destroyShaderModule(vert_shader_module);
             m_rhi->destroyShaderModule(frag_shader_module);
-        }
+        });
 
         // deferred lighting
-        {
+        pipeline_jobs.push_back([this]() {
             RHIDescriptorSetLayout*      descriptorset_layouts[3] = {m_descriptor_infos[_mesh_global].layout,
                                                               m_descriptor_infos[_deferred_lighting].layout,
                                                               m_descriptor_infos[_skybox].layout};
@@ -1099,10 +1139,10 @@ namespace Piccolo
 
             m_rhi->destroyShaderModule(vert_shader_module);
             m_rhi->destroyShaderModule(frag_shader_module);
-        }
+        });
 
         // mesh lighting
-        {
+        pipeline_jobs.push_back([this]() {
             RHIDescriptorSetLayout*      descriptorset_layouts[3] = {m_descriptor_infos[_mesh_global].layout,
                                                                      m_descriptor_infos[_per_mesh].layout,
                                                                      m_descriptor_infos[_mesh_per_material].layout};
@@ -1236,12 +1276,32 @@ namespace Piccolo
                 throw std::runtime_error("create mesh lighting graphics pipeline");
             }
 
+            if (m_mesh_cull_pass)
+            {
+                // the same state, the instances are read from the buffers written by the mesh cull pass
+                RHIShader* gpu_driven_vert_shader_module = m_rhi->createShaderModule(MESH_GPU_DRIVEN_VERT);
+                shader_stages[0].module                  = gpu_driven_vert_shader_module;
+
+                m_render_pipelines[_render_pipeline_type_mesh_lighting_gpu_driven].layout =
+                    m_render_pipelines[_render_pipeline_type_mesh_lighting].layout;
+                if (RHI_SUCCESS !=
+                    m_rhi->createGraphicsPipelines(RHI_NULL_HANDLE,
+                                                   1,
+                                                   &pipelineInfo,
+                                                   m_render_pipelines[_render_pipeline_type_mesh_lighting_gpu_driven].pipeline))
+                {
+                    throw std::runtime_error("create mesh lighting gpu driven graphics pipeline");
+                }
+
+                m_rhi->destroyShaderModule(gpu_driven_vert_shader_module);
+            }
+
             m_rhi->destroyShaderModule(vert_shader_module);
             m_rhi->destroyShaderModule(frag_shader_module);
-        }
+        });
 
         // skybox
-        {
+        pipeline_jobs.push_back([this]() {
             RHIDescriptorSetLayout*      descriptorset_layouts[1] = {m_descriptor_infos[_skybox].layout};
             RHIPipelineLayoutCreateInfo pipeline_layout_create_info {};
             pipeline_layout_create_info.sType          = RHI_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
@@ -1375,10 +1435,10 @@ namespace Piccolo
 
             m_rhi->destroyShaderModule(vert_shader_module);
             m_rhi->destroyShaderModule(frag_shader_module);
-        }
+        });
 
         // draw axis
-        {
+        pipeline_jobs.push_back([this]() {
             RHIDescriptorSetLayout*     descriptorset_layouts[1] = {m_descriptor_infos[_axis].layout};
             RHIPipelineLayoutCreateInfo pipeline_layout_create_info {};
             pipeline_layout_create_info.sType          = RHI_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
@@ -1511,7 +1571,9 @@ namespace Piccolo
 
             m_rhi->destroyShaderModule(vert_shader_module);
             m_rhi->destroyShaderModule(frag_shader_module);
-        }
+        });
+
+        g_runtime_global_context.m_job_system->parallelRun(pipeline_jobs);
     }
 
     void MainCameraPass::setupDescriptorSet()
@@ -1557,7 +1619,7 @@ namespace Piccolo
         RHIDescriptorBufferInfo mesh_per_drawcall_vertex_blending_storage_buffer_info = {};
         mesh_per_drawcall_vertex_blending_storage_buffer_info.offset                 = 0;
         mesh_per_drawcall_vertex_blending_storage_buffer_info.range =
-            sizeof(MeshPerdrawcallVertexBlendingStorageBufferObject);
+            sizeof(MeshJointPaletteStorageBufferObject);
         mesh_per_drawcall_vertex_blending_storage_buffer_info.buffer =
             m_global_render_resource->_storage_buffer._global_upload_ringbuffer;
         assert(mesh_per_drawcall_vertex_blending_storage_buffer_info.range <
@@ -1591,7 +1653,15 @@ namespace Piccolo
         directional_light_shadow_texture_image_info.imageView = m_directional_light_shadow_color_image_view;
         directional_light_shadow_texture_image_info.imageLayout = RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
-        RHIWriteDescriptorSet mesh_descriptor_writes_info[8];
+        RHIDescriptorBufferInfo point_light_cluster_storage_buffer_info = {};
+        point_light_cluster_storage_buffer_info.offset                 = 0;
+        point_light_cluster_storage_buffer_info.range = sizeof(MeshPointLightClusterStorageBufferObject);
+        point_light_cluster_storage_buffer_info.buffer =
+            m_global_render_resource->_storage_buffer._global_upload_ringbuffer;
+        assert(point_light_cluster_storage_buffer_info.range <
+               m_global_render_resource->_storage_buffer._max_storage_buffer_range);
+
+        RHIWriteDescriptorSet mesh_descriptor_writes_info[9];
 
         mesh_descriptor_writes_info[0].sType           = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
         mesh_descriptor_writes_info[0].pNext           = NULL;
@@ -1645,10 +1715,47 @@ namespace Piccolo
         mesh_descriptor_writes_info[7].dstBinding = 7;
         mesh_descriptor_writes_info[7].pImageInfo = &directional_light_shadow_texture_image_info;
 
+        mesh_descriptor_writes_info[8]             = mesh_descriptor_writes_info[0];
+        mesh_descriptor_writes_info[8].dstBinding  = 8;
+        mesh_descriptor_writes_info[8].pBufferInfo = &point_light_cluster_storage_buffer_info;
+
         m_rhi->updateDescriptorSets(sizeof(mesh_descriptor_writes_info) / sizeof(mesh_descriptor_writes_info[0]),
                                     mesh_descriptor_writes_info,
                                     0,
                                     NULL);
+
+        if (m_mesh_cull_pass)
+        {
+            // the gpu driven variant reads the culled instances instead of the per drawcall storage buffers
+            if (RHI_SUCCESS != m_rhi->allocateDescriptorSets(&mesh_global_descriptor_set_alloc_info,
+                                                             m_gpu_driven_mesh_global_descriptor_set))
+            {
+                throw std::runtime_error("allocate gpu driven mesh global descriptor set");
+            }
+
+            RHIDescriptorBufferInfo mesh_cull_instance_storage_buffer_info = {};
+            mesh_cull_instance_storage_buffer_info.offset                 = 0;
+            mesh_cull_instance_storage_buffer_info.range =
+                sizeof(VulkanMeshCullInstance) * s_mesh_cull_max_instance_count;
+            mesh_cull_instance_storage_buffer_info.buffer = m_mesh_cull_pass->getInstanceBuffer();
+
+            RHIDescriptorBufferInfo mesh_cull_visible_instance_storage_buffer_info = {};
+            mesh_cull_visible_instance_storage_buffer_info.offset                 = 0;
+            mesh_cull_visible_instance_storage_buffer_info.range  = sizeof(uint32_t) * s_mesh_cull_max_instance_count;
+            mesh_cull_visible_instance_storage_buffer_info.buffer = m_mesh_cull_pass->getVisibleInstanceBuffer();
+
+            mesh_descriptor_writes_info[1].pBufferInfo = &mesh_cull_instance_storage_buffer_info;
+            mesh_descriptor_writes_info[2].pBufferInfo = &mesh_cull_visible_instance_storage_buffer_info;
+            for (RHIWriteDescriptorSet& descriptor_write : mesh_descriptor_writes_info)
+            {
+                descriptor_write.dstSet = m_gpu_driven_mesh_global_descriptor_set;
+            }
+
+            m_rhi->updateDescriptorSets(sizeof(mesh_descriptor_writes_info) / sizeof(mesh_descriptor_writes_info[0]),
+                                        mesh_descriptor_writes_info,
+                                        0,
+                                        NULL);
+        }
     }
 
     void MainCameraPass::setupSkyboxDescriptorSet()
@@ -1945,6 +2052,7 @@ namespace Piccolo
         float color[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
         m_rhi->pushEvent(m_rhi->getCurrentCommandBuffer(), "BasePass", color);
 
+        uploadPointLightClusters();
         drawMeshGbuffer();
 
         m_rhi->popEvent(m_rhi->getCurrentCommandBuffer());
@@ -2048,6 +2156,7 @@ namespace Piccolo
         float color[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
         m_rhi->pushEvent(m_rhi->getCurrentCommandBuffer(), "Forward Lighting", color);
 
+        uploadPointLightClusters();
         drawMeshLighting();
         drawSkybox();
         particle_pass.draw();
@@ -2100,33 +2209,53 @@ namespace Piccolo
         m_rhi->cmdEndRenderPassPFN(m_rhi->getCurrentCommandBuffer());
     }
 
-    void MainCameraPass::drawMeshGbuffer()
+    void MainCameraPass::uploadPointLightClusters()
     {
-        struct MeshNode
-        {
-            const Matrix4x4* model_matrix {nullptr};
-            const Matrix4x4* joint_matrices {nullptr};
-            uint32_t         joint_count {0};
-        };
-
-        std::map<VulkanPBRMaterial*, std::map<VulkanMesh*, std::vector<MeshNode>>> main_camera_mesh_drawcall_batch;
+        uint32_t cluster_dynamic_offset =
+            roundUp(m_global_render_resource->_storage_buffer
+                        ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()],
+                    m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
 
-        // reorganize mesh
-        for (RenderMeshNode& node : *(m_visiable_nodes.p_main_camera_visible_mesh_nodes))
-        {
-            auto& mesh_instanced = main_camera_mesh_drawcall_batch[node.ref_material];
-            auto& mesh_nodes     = mesh_instanced[node.ref_mesh];
+        m_global_render_resource->_storage_buffer._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] =
+            cluster_dynamic_offset + sizeof(MeshPointLightClusterStorageBufferObject);
+        assert(m_global_render_resource->_storage_buffer
+                   ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] <=
+               (m_global_render_resource->_storage_buffer
+                    ._global_upload_ringbuffers_begin[m_rhi->getCurrentFrameIndex()] +
+                m_global_render_resource->_storage_buffer
+                    ._global_upload_ringbuffers_size[m_rhi->getCurrentFrameIndex()]));
 
-            MeshNode temp;
-            temp.model_matrix = node.model_matrix;
-            if (node.enable_vertex_blending)
-            {
-                temp.joint_matrices = node.joint_matrices;
-                temp.joint_count    = node.joint_count;
-            }
+        m_point_light_cluster_dynamic_offset = cluster_dynamic_offset;
+
+        MeshPointLightClusterStorageBufferObject& cluster_storage_buffer_object =
+            (*reinterpret_cast<MeshPointLightClusterStorageBufferObject*>(
+                reinterpret_cast<uintptr_t>(
+                    m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
+                cluster_dynamic_offset));
+
+        // only the used part of the light and index arrays is copied, the ranges are read for every froxel
+        const MeshPointLightClusterStorageBufferObject& clusters = *m_point_light_cluster_storage_buffer_object;
+        cluster_storage_buffer_object.point_light_num   = clusters.point_light_num;
+        cluster_storage_buffer_object.light_index_num   = clusters.light_index_num;
+        cluster_storage_buffer_object.depth_slice_scale = clusters.depth_slice_scale;
+        cluster_storage_buffer_object.depth_slice_bias  = clusters.depth_slice_bias;
+        memcpy(cluster_storage_buffer_object.point_lights,
+               clusters.point_lights,
+               sizeof(clusters.point_lights[0]) * clusters.point_light_num);
+        memcpy(cluster_storage_buffer_object.cluster_ranges, clusters.cluster_ranges, sizeof(clusters.cluster_ranges));
+        memcpy(cluster_storage_buffer_object.light_indices,
+               clusters.light_indices,
+               sizeof(clusters.light_indices[0]) * clusters.light_index_num);
+    }
 
-            mesh_nodes.push_back(temp);
-        }
+    void MainCameraPass::drawMeshGbuffer()
+    {
+        // with the gpu driven path only the skinned meshes are left to the cpu
+        bool gpu_driven = m_mesh_cull_pass && m_mesh_cull_pass->isActive();
+        m_mesh_draw_list.build(*(m_visiable_nodes.p_main_camera_visible_mesh_nodes),
+                               true,
+                               &m_mesh_perframe_storage_buffer_object.camera_position,
+                               gpu_driven);
 
         float color[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
         m_rhi->pushEvent(m_rhi->getCurrentCommandBuffer(), "Mesh GBuffer", color);
@@ -2157,175 +2286,140 @@ namespace Piccolo
                 m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
             perframe_dynamic_offset)) = m_mesh_perframe_storage_buffer_object;
 
-        for (auto& pair1 : main_camera_mesh_drawcall_batch)
+        VulkanPBRMaterial* bound_material = nullptr;
+        for (const RenderDrawBatch& batch : m_mesh_draw_list.getBatches())
         {
-            VulkanPBRMaterial& material       = (*pair1.first);
-            auto&              mesh_instanced = pair1.second;
-
-            // bind per material
-            m_rhi->cmdBindDescriptorSetsPFN(m_rhi->getCurrentCommandBuffer(),
-                                            RHI_PIPELINE_BIND_POINT_GRAPHICS,
-                                            m_render_pipelines[_render_pipeline_type_mesh_gbuffer].layout,
-                                            2,
-                                            1,
-                                            &material.material_descriptor_set,
-                                            0,
-                                            NULL);
-
-            // TODO: render from near to far
-
-            for (auto& pair2 : mesh_instanced)
+            // bind per material, batches sharing a material are adjacent in the draw list
+            if (batch.material != bound_material)
             {
-                VulkanMesh& mesh       = (*pair2.first);
-                auto&       mesh_nodes = pair2.second;
+                bound_material = batch.material;
+                m_rhi->cmdBindDescriptorSetsPFN(m_rhi->getCurrentCommandBuffer(),
+                                                RHI_PIPELINE_BIND_POINT_GRAPHICS,
+                                                m_render_pipelines[_render_pipeline_type_mesh_gbuffer].layout,
+                                                2,
+                                                1,
+                                                &bound_material->material_descriptor_set,
+                                                0,
+                                                NULL);
+            }
 
-                uint32_t total_instance_count = static_cast<uint32_t>(mesh_nodes.size());
-                if (total_instance_count > 0)
+            VulkanMesh&               mesh       = *batch.mesh;
+            const RenderDrawInstance* mesh_nodes = m_mesh_draw_list.getInstances(batch);
+
+            uint32_t total_instance_count = batch.instance_count;
+            if (total_instance_count > 0)
+            {
+                // bind per mesh
+                m_rhi->cmdBindDescriptorSetsPFN(m_rhi->getCurrentCommandBuffer(),
+                                                RHI_PIPELINE_BIND_POINT_GRAPHICS,
+                                                m_render_pipelines[_render_pipeline_type_mesh_gbuffer].layout,
+                                                1,
+                                                1,
+                                                &mesh.mesh_vertex_blending_descriptor_set,
+                                                0,
+                                                NULL);
+
+                RHIBuffer* vertex_buffers[] = {mesh.mesh_vertex_position_buffer,
+                                             mesh.mesh_vertex_varying_enable_blending_buffer,
+                                             mesh.mesh_vertex_varying_buffer};
+                RHIDeviceSize offsets[]        = {0, 0, 0};
+
+                // a pre-skinned instance reads the vertices the skinning pass wrote for it
+                if (batch.is_pre_skinned)
                 {
-                    // bind per mesh
+                    const SkinnedVertexBuffer& skinned_vertices = m_global_render_resource->_skinned_vertex_buffer;
+
+                    vertex_buffers[0] = skinned_vertices._position_buffer;
+                    vertex_buffers[1] = skinned_vertices._varying_enable_blending_buffer;
+                    offsets[0]        = sizeof(MeshVertex::VulkanMeshVertexPostition) * batch.skinned_vertex_offset;
+                    offsets[1] =
+                        sizeof(MeshVertex::VulkanMeshVertexVaryingEnableBlending) * batch.skinned_vertex_offset;
+                }
+
+                m_rhi->cmdBindVertexBuffersPFN(m_rhi->getCurrentCommandBuffer(),
+                                               0,
+                                               (sizeof(vertex_buffers) / sizeof(vertex_buffers[0])),
+                                               vertex_buffers,
+                                               offsets);
+                m_rhi->cmdBindIndexBufferPFN(m_rhi->getCurrentCommandBuffer(), mesh.mesh_index_buffer, 0, RHI_INDEX_TYPE_UINT16);
+
+                uint32_t drawcall_max_instance_count =
+                    (sizeof(MeshPerdrawcallStorageBufferObject::mesh_instances) /
+                     sizeof(MeshPerdrawcallStorageBufferObject::mesh_instances[0]));
+                uint32_t drawcall_count =
+                    roundUp(total_instance_count, drawcall_max_instance_count) / drawcall_max_instance_count;
+
+                for (uint32_t drawcall_index = 0; drawcall_index < drawcall_count; ++drawcall_index)
+                {
+                    uint32_t current_instance_count =
+                        ((total_instance_count - drawcall_max_instance_count * drawcall_index) <
+                         drawcall_max_instance_count) ?
+                            (total_instance_count - drawcall_max_instance_count * drawcall_index) :
+                            drawcall_max_instance_count;
+
+                    // per drawcall storage buffer
+                    uint32_t perdrawcall_dynamic_offset =
+                        roundUp(m_global_render_resource->_storage_buffer
+                                    ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()],
+                                m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
+                    m_global_render_resource->_storage_buffer
+                        ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] =
+                        perdrawcall_dynamic_offset + sizeof(MeshPerdrawcallStorageBufferObject);
+                    assert(m_global_render_resource->_storage_buffer
+                               ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] <=
+                           (m_global_render_resource->_storage_buffer
+                                ._global_upload_ringbuffers_begin[m_rhi->getCurrentFrameIndex()] +
+                            m_global_render_resource->_storage_buffer
+                                ._global_upload_ringbuffers_size[m_rhi->getCurrentFrameIndex()]));
+
+                    MeshPerdrawcallStorageBufferObject& perdrawcall_storage_buffer_object =
+                        (*reinterpret_cast<MeshPerdrawcallStorageBufferObject*>(
+                            reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
+                                                            ._global_upload_ringbuffer_memory_pointer) +
+                            perdrawcall_dynamic_offset));
+                    for (uint32_t i = 0; i < current_instance_count; ++i)
+                    {
+                        perdrawcall_storage_buffer_object.mesh_instances[i].model_matrix =
+                            *mesh_nodes[drawcall_max_instance_count * drawcall_index + i].model_matrix;
+                        perdrawcall_storage_buffer_object.mesh_instances[i].enable_vertex_blending =
+                            mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_count > 0 ? 1.0 : -1.0;
+                        perdrawcall_storage_buffer_object.mesh_instances[i].joint_palette_offset =
+                            mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_palette_offset;
+                    }
+
+                    // the skinned instances read their joints from the palette of the frame
+                    uint32_t per_drawcall_vertex_blending_dynamic_offset =
+                        m_global_render_resource->_storage_buffer._joint_palette_dynamic_offset;
+
+                    // bind perdrawcall
+                    uint32_t dynamic_offsets[4] = {perframe_dynamic_offset,
+                                                   perdrawcall_dynamic_offset,
+                                                   per_drawcall_vertex_blending_dynamic_offset,
+                                                   m_point_light_cluster_dynamic_offset};
                     m_rhi->cmdBindDescriptorSetsPFN(m_rhi->getCurrentCommandBuffer(),
                                                     RHI_PIPELINE_BIND_POINT_GRAPHICS,
                                                     m_render_pipelines[_render_pipeline_type_mesh_gbuffer].layout,
-                                                    1,
-                                                    1,
-                                                    &mesh.mesh_vertex_blending_descriptor_set,
                                                     0,
-                                                    NULL);
-
-
-                    RHIBuffer* vertex_buffers[] = {mesh.mesh_vertex_position_buffer,
-                                                 mesh.mesh_vertex_varying_enable_blending_buffer,
-                                                 mesh.mesh_vertex_varying_buffer};
-                    RHIDeviceSize offsets[]        = {0, 0, 0};
-                    m_rhi->cmdBindVertexBuffersPFN(m_rhi->getCurrentCommandBuffer(),
-                                                   0,
-                                                   (sizeof(vertex_buffers) / sizeof(vertex_buffers[0])),
-                                                   vertex_buffers,
-                                                   offsets);
-                    m_rhi->cmdBindIndexBufferPFN(m_rhi->getCurrentCommandBuffer(), mesh.mesh_index_buffer, 0, RHI_INDEX_TYPE_UINT16);
-
-                    uint32_t drawcall_max_instance_count =
-                        (sizeof(MeshPerdrawcallStorageBufferObject::mesh_instances) /
-                         sizeof(MeshPerdrawcallStorageBufferObject::mesh_instances[0]));
-                    uint32_t drawcall_count =
-                        roundUp(total_instance_count, drawcall_max_instance_count) / drawcall_max_instance_count;
-
-                    for (uint32_t drawcall_index = 0; drawcall_index < drawcall_count; ++drawcall_index)
-                    {
-                        uint32_t current_instance_count =
-                            ((total_instance_count - drawcall_max_instance_count * drawcall_index) <
-                             drawcall_max_instance_count) ?
-                                (total_instance_count - drawcall_max_instance_count * drawcall_index) :
-                                drawcall_max_instance_count;
-
-                        // per drawcall storage buffer
-                        uint32_t perdrawcall_dynamic_offset =
-                            roundUp(m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()],
-                                    m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                        m_global_render_resource->_storage_buffer
-                            ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] =
-                            perdrawcall_dynamic_offset + sizeof(MeshPerdrawcallStorageBufferObject);
-                        assert(m_global_render_resource->_storage_buffer
-                                   ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] <=
-                               (m_global_render_resource->_storage_buffer
-                                    ._global_upload_ringbuffers_begin[m_rhi->getCurrentFrameIndex()] +
-                                m_global_render_resource->_storage_buffer
-                                    ._global_upload_ringbuffers_size[m_rhi->getCurrentFrameIndex()]));
-
-                        MeshPerdrawcallStorageBufferObject& perdrawcall_storage_buffer_object =
-                            (*reinterpret_cast<MeshPerdrawcallStorageBufferObject*>(
-                                reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
-                                                                ._global_upload_ringbuffer_memory_pointer) +
-                                perdrawcall_dynamic_offset));
-                        for (uint32_t i = 0; i < current_instance_count; ++i)
-                        {
-                            perdrawcall_storage_buffer_object.mesh_instances[i].model_matrix =
-                                *mesh_nodes[drawcall_max_instance_count * drawcall_index + i].model_matrix;
-                            perdrawcall_storage_buffer_object.mesh_instances[i].enable_vertex_blending =
-                                mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices ? 1.0 :
-                                                                                                              -1.0;
-                        }
-
-                        // per drawcall vertex blending storage buffer
-                        uint32_t per_drawcall_vertex_blending_dynamic_offset;
-                        bool     least_one_enable_vertex_blending = true;
-                        for (uint32_t i = 0; i < current_instance_count; ++i)
-                        {
-                            if (!mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices)
-                            {
-                                least_one_enable_vertex_blending = false;
-                                break;
-                            }
-                        }
-                        if (least_one_enable_vertex_blending)
-                        {
-                            per_drawcall_vertex_blending_dynamic_offset =
-                                roundUp(m_global_render_resource->_storage_buffer
-                                            ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()],
-                                        m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                            m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] =
-                                per_drawcall_vertex_blending_dynamic_offset +
-                                sizeof(MeshPerdrawcallVertexBlendingStorageBufferObject);
-                            assert(m_global_render_resource->_storage_buffer
-                                       ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] <=
-                                   (m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_begin[m_rhi->getCurrentFrameIndex()] +
-                                    m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_size[m_rhi->getCurrentFrameIndex()]));
-
-                            MeshPerdrawcallVertexBlendingStorageBufferObject&
-                                per_drawcall_vertex_blending_storage_buffer_object =
-                                    (*reinterpret_cast<MeshPerdrawcallVertexBlendingStorageBufferObject*>(
-                                        reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
-                                                                        ._global_upload_ringbuffer_memory_pointer) +
-                                        per_drawcall_vertex_blending_dynamic_offset));
-                            for (uint32_t i = 0; i < current_instance_count; ++i)
-                            {
-                                if (mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices)
-                                {
-                                    for (uint32_t j = 0;
-                                         j < mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_count;
-                                         ++j)
-                                    {
-                                        per_drawcall_vertex_blending_storage_buffer_object
-                                            .joint_matrices[s_mesh_vertex_blending_max_joint_count * i + j] =
-                                            mesh_nodes[drawcall_max_instance_count * drawcall_index + i]
-                                                .joint_matrices[j];
-                                    }
-                                }
-                            }
-                        }
-                        else
-                        {
-                            per_drawcall_vertex_blending_dynamic_offset = 0;
-                        }
-
-                        // bind perdrawcall
-                        uint32_t dynamic_offsets[3] = {perframe_dynamic_offset,
-                                                       perdrawcall_dynamic_offset,
-                                                       per_drawcall_vertex_blending_dynamic_offset};
-                        m_rhi->cmdBindDescriptorSetsPFN(m_rhi->getCurrentCommandBuffer(),
-                                                        RHI_PIPELINE_BIND_POINT_GRAPHICS,
-                                                        m_render_pipelines[_render_pipeline_type_mesh_gbuffer].layout,
-                                                        0,
-                                                        1,
-                                                        &m_descriptor_infos[_mesh_global].descriptor_set,
-                                                        3,
-                                                        dynamic_offsets);
-
-                        m_rhi->cmdDrawIndexedPFN(m_rhi->getCurrentCommandBuffer(),
-                                                 mesh.mesh_index_count,
-                                                 current_instance_count,
-                                                 0,
-                                                 0,
-                                                 0);
-                    }
+                                                    1,
+                                                    &m_descriptor_infos[_mesh_global].descriptor_set,
+                                                    4,
+                                                    dynamic_offsets);
+
+                    m_rhi->cmdDrawIndexedPFN(m_rhi->getCurrentCommandBuffer(),
+                                             mesh.mesh_index_count,
+                                             current_instance_count,
+                                             0,
+                                             0,
+                                             0);
                 }
             }
         }
 
+        if (gpu_driven)
+        {
+            drawMeshGpuDriven(_render_pipeline_type_mesh_gbuffer_gpu_driven, perframe_dynamic_offset);
+        }
+
         m_rhi->popEvent(m_rhi->getCurrentCommandBuffer());
     }
 
@@ -2360,14 +2454,15 @@ namespace Piccolo
         RHIDescriptorSet* descriptor_sets[3] = {m_descriptor_infos[_mesh_global].descriptor_set,
                                               m_descriptor_infos[_deferred_lighting].descriptor_set,
                                               m_descriptor_infos[_skybox].descriptor_set};
-        uint32_t        dynamic_offsets[4] = {perframe_dynamic_offset, perframe_dynamic_offset, 0, 0};
+        uint32_t          dynamic_offsets[5] = {
+            perframe_dynamic_offset, perframe_dynamic_offset, 0, m_point_light_cluster_dynamic_offset, 0};
         m_rhi->cmdBindDescriptorSetsPFN(m_rhi->getCurrentCommandBuffer(),
                                         RHI_PIPELINE_BIND_POINT_GRAPHICS,
                                         m_render_pipelines[_render_pipeline_type_deferred_lighting].layout,
                                         0,
                                         3,
                                         descriptor_sets,
-                                        4,
+                                        5,
                                         dynamic_offsets);
 
         m_rhi->cmdDraw(m_rhi->getCurrentCommandBuffer(), 3, 1, 0, 0);
@@ -2375,31 +2470,12 @@ namespace Piccolo
 
     void MainCameraPass::drawMeshLighting()
     {
-        struct MeshNode
-        {
-            const Matrix4x4* model_matrix {nullptr};
-            const Matrix4x4* joint_matrices {nullptr};
-            uint32_t         joint_count {0};
-        };
-
-        std::map<VulkanPBRMaterial*, std::map<VulkanMesh*, std::vector<MeshNode>>> main_camera_mesh_drawcall_batch;
-
-        // reorganize mesh
-        for (RenderMeshNode& node : *(m_visiable_nodes.p_main_camera_visible_mesh_nodes))
-        {
-            auto& mesh_instanced = main_camera_mesh_drawcall_batch[node.ref_material];
-            auto& mesh_nodes     = mesh_instanced[node.ref_mesh];
-
-            MeshNode temp;
-            temp.model_matrix = node.model_matrix;
-            if (node.enable_vertex_blending)
-            {
-                temp.joint_matrices = node.joint_matrices;
-                temp.joint_count    = node.joint_count;
-            }
-
-            mesh_nodes.push_back(temp);
-        }
+        // with the gpu driven path only the skinned meshes are left to the cpu
+        bool gpu_driven = m_mesh_cull_pass && m_mesh_cull_pass->isActive();
+        m_mesh_draw_list.build(*(m_visiable_nodes.p_main_camera_visible_mesh_nodes),
+                               true,
+                               &m_mesh_perframe_storage_buffer_object.camera_position,
+                               gpu_driven);
 
         float color[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
         m_rhi->pushEvent(m_rhi->getCurrentCommandBuffer(), "Model", color);
@@ -2430,177 +2506,207 @@ namespace Piccolo
                 m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
             perframe_dynamic_offset)) = m_mesh_perframe_storage_buffer_object;
 
-        for (auto& pair1 : main_camera_mesh_drawcall_batch)
+        VulkanPBRMaterial* bound_material = nullptr;
+        for (const RenderDrawBatch& batch : m_mesh_draw_list.getBatches())
         {
-            VulkanPBRMaterial& material       = (*pair1.first);
-            auto&              mesh_instanced = pair1.second;
-
-            // bind per material
-            m_rhi->cmdBindDescriptorSetsPFN(m_rhi->getCurrentCommandBuffer(),
-                                            RHI_PIPELINE_BIND_POINT_GRAPHICS,
-                                            m_render_pipelines[_render_pipeline_type_mesh_lighting].layout,
-                                            2,
-                                            1,
-                                            &material.material_descriptor_set,
-                                            0,
-                                            NULL);
-
-            // TODO: render from near to far
-
-            for (auto& pair2 : mesh_instanced)
+            // bind per material, batches sharing a material are adjacent in the draw list
+            if (batch.material != bound_material)
             {
-                VulkanMesh& mesh       = (*pair2.first);
-                auto&       mesh_nodes = pair2.second;
+                bound_material = batch.material;
+                m_rhi->cmdBindDescriptorSetsPFN(m_rhi->getCurrentCommandBuffer(),
+                                                RHI_PIPELINE_BIND_POINT_GRAPHICS,
+                                                m_render_pipelines[_render_pipeline_type_mesh_lighting].layout,
+                                                2,
+                                                1,
+                                                &bound_material->material_descriptor_set,
+                                                0,
+                                                NULL);
+            }
+
+            VulkanMesh&               mesh       = *batch.mesh;
+            const RenderDrawInstance* mesh_nodes = m_mesh_draw_list.getInstances(batch);
+
+            uint32_t total_instance_count = batch.instance_count;
+            if (total_instance_count > 0)
+            {
+                // bind per mesh
+                m_rhi->cmdBindDescriptorSetsPFN(m_rhi->getCurrentCommandBuffer(),
+                                                RHI_PIPELINE_BIND_POINT_GRAPHICS,
+                                                m_render_pipelines[_render_pipeline_type_mesh_lighting].layout,
+                                                1,
+                                                1,
+                                                &mesh.mesh_vertex_blending_descriptor_set,
+                                                0,
+                                                NULL);
+
+                RHIBuffer*     vertex_buffers[3] = {mesh.mesh_vertex_position_buffer,
+                                             mesh.mesh_vertex_varying_enable_blending_buffer,
+                                             mesh.mesh_vertex_varying_buffer};
+                RHIDeviceSize offsets[]        = {0, 0, 0};
+
+                // a pre-skinned instance reads the vertices the skinning pass wrote for it
+                if (batch.is_pre_skinned)
+                {
+                    const SkinnedVertexBuffer& skinned_vertices = m_global_render_resource->_skinned_vertex_buffer;
+
+                    vertex_buffers[0] = skinned_vertices._position_buffer;
+                    vertex_buffers[1] = skinned_vertices._varying_enable_blending_buffer;
+                    offsets[0]        = sizeof(MeshVertex::VulkanMeshVertexPostition) * batch.skinned_vertex_offset;
+                    offsets[1] =
+                        sizeof(MeshVertex::VulkanMeshVertexVaryingEnableBlending) * batch.skinned_vertex_offset;
+                }
+
+                m_rhi->cmdBindVertexBuffersPFN(m_rhi->getCurrentCommandBuffer(),
+                                               0,
+                                               (sizeof(vertex_buffers) / sizeof(vertex_buffers[0])),
+                                               vertex_buffers,
+                                               offsets);
+                m_rhi->cmdBindIndexBufferPFN(m_rhi->getCurrentCommandBuffer(), mesh.mesh_index_buffer, 0, RHI_INDEX_TYPE_UINT16);
+
+                uint32_t drawcall_max_instance_count =
+                    (sizeof(MeshPerdrawcallStorageBufferObject::mesh_instances) /
+                     sizeof(MeshPerdrawcallStorageBufferObject::mesh_instances[0]));
+                uint32_t drawcall_count =
+                    roundUp(total_instance_count, drawcall_max_instance_count) / drawcall_max_instance_count;
 
-                uint32_t total_instance_count = static_cast<uint32_t>(mesh_nodes.size());
-                if (total_instance_count > 0)
+                for (uint32_t drawcall_index = 0; drawcall_index < drawcall_count; ++drawcall_index)
                 {
-                    // bind per mesh
+                    uint32_t current_instance_count =
+                        ((total_instance_count - drawcall_max_instance_count * drawcall_index) <
+                         drawcall_max_instance_count) ?
+                            (total_instance_count - drawcall_max_instance_count * drawcall_index) :
+                            drawcall_max_instance_count;
+
+                    // per drawcall storage buffer
+                    uint32_t perdrawcall_dynamic_offset =
+                        roundUp(m_global_render_resource->_storage_buffer
+                                    ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()],
+                                m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
+                    m_global_render_resource->_storage_buffer
+                        ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] =
+                        perdrawcall_dynamic_offset + sizeof(MeshPerdrawcallStorageBufferObject);
+                    assert(m_global_render_resource->_storage_buffer
+                               ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] <=
+                           (m_global_render_resource->_storage_buffer
+                                ._global_upload_ringbuffers_begin[m_rhi->getCurrentFrameIndex()] +
+                            m_global_render_resource->_storage_buffer
+                                ._global_upload_ringbuffers_size[m_rhi->getCurrentFrameIndex()]));
+
+                    MeshPerdrawcallStorageBufferObject& perdrawcall_storage_buffer_object =
+                        (*reinterpret_cast<MeshPerdrawcallStorageBufferObject*>(
+                            reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
+                                                            ._global_upload_ringbuffer_memory_pointer) +
+                            perdrawcall_dynamic_offset));
+                    for (uint32_t i = 0; i < current_instance_count; ++i)
+                    {
+                        perdrawcall_storage_buffer_object.mesh_instances[i].model_matrix =
+                            *mesh_nodes[drawcall_max_instance_count * drawcall_index + i].model_matrix;
+                        perdrawcall_storage_buffer_object.mesh_instances[i].enable_vertex_blending =
+                            mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_count > 0 ? 1.0 : -1.0;
+                        perdrawcall_storage_buffer_object.mesh_instances[i].joint_palette_offset =
+                            mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_palette_offset;
+                    }
+
+                    // the skinned instances read their joints from the palette of the frame
+                    uint32_t per_drawcall_vertex_blending_dynamic_offset =
+                        m_global_render_resource->_storage_buffer._joint_palette_dynamic_offset;
+
+                    // bind perdrawcall
+                    uint32_t dynamic_offsets[4] = {perframe_dynamic_offset,
+                                                   perdrawcall_dynamic_offset,
+                                                   per_drawcall_vertex_blending_dynamic_offset,
+                                                   m_point_light_cluster_dynamic_offset};
                     m_rhi->cmdBindDescriptorSetsPFN(m_rhi->getCurrentCommandBuffer(),
                                                     RHI_PIPELINE_BIND_POINT_GRAPHICS,
                                                     m_render_pipelines[_render_pipeline_type_mesh_lighting].layout,
-                                                    1,
-                                                    1,
-                                                    &mesh.mesh_vertex_blending_descriptor_set,
                                                     0,
-                                                    NULL);
-
-                    RHIBuffer*     vertex_buffers[3] = {mesh.mesh_vertex_position_buffer,
-                                                 mesh.mesh_vertex_varying_enable_blending_buffer,
-                                                 mesh.mesh_vertex_varying_buffer};
-                    RHIDeviceSize offsets[]        = {0, 0, 0};
-                    m_rhi->cmdBindVertexBuffersPFN(m_rhi->getCurrentCommandBuffer(),
-                                                   0,
-                                                   (sizeof(vertex_buffers) / sizeof(vertex_buffers[0])),
-                                                   vertex_buffers,
-                                                   offsets);
-                    m_rhi->cmdBindIndexBufferPFN(m_rhi->getCurrentCommandBuffer(), mesh.mesh_index_buffer, 0, RHI_INDEX_TYPE_UINT16);
-
-                    uint32_t drawcall_max_instance_count =
-                        (sizeof(MeshPerdrawcallStorageBufferObject::mesh_instances) /
-                         sizeof(MeshPerdrawcallStorageBufferObject::mesh_instances[0]));
-                    uint32_t drawcall_count =
-                        roundUp(total_instance_count, drawcall_max_instance_count) / drawcall_max_instance_count;
-
-                    for (uint32_t drawcall_index = 0; drawcall_index < drawcall_count; ++drawcall_index)
-                    {
-                        uint32_t current_instance_count =
-                            ((total_instance_count - drawcall_max_instance_count * drawcall_index) <
-                             drawcall_max_instance_count) ?
-                                (total_instance_count - drawcall_max_instance_count * drawcall_index) :
-                                drawcall_max_instance_count;
-
-                        // per drawcall storage buffer
-                        uint32_t perdrawcall_dynamic_offset =
-                            roundUp(m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()],
-                                    m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                        m_global_render_resource->_storage_buffer
-                            ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] =
-                            perdrawcall_dynamic_offset + sizeof(MeshPerdrawcallStorageBufferObject);
-                        assert(m_global_render_resource->_storage_buffer
-                                   ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] <=
-                               (m_global_render_resource->_storage_buffer
-                                    ._global_upload_ringbuffers_begin[m_rhi->getCurrentFrameIndex()] +
-                                m_global_render_resource->_storage_buffer
-                                    ._global_upload_ringbuffers_size[m_rhi->getCurrentFrameIndex()]));
-
-                        MeshPerdrawcallStorageBufferObject& perdrawcall_storage_buffer_object =
-                            (*reinterpret_cast<MeshPerdrawcallStorageBufferObject*>(
-                                reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
-                                                                ._global_upload_ringbuffer_memory_pointer) +
-                                perdrawcall_dynamic_offset));
-                        for (uint32_t i = 0; i < current_instance_count; ++i)
-                        {
-                            perdrawcall_storage_buffer_object.mesh_instances[i].model_matrix =
-                                *mesh_nodes[drawcall_max_instance_count * drawcall_index + i].model_matrix;
-                            perdrawcall_storage_buffer_object.mesh_instances[i].enable_vertex_blending =
-                                mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices ? 1.0 :
-                                                                                                              -1.0;
-                        }
-
-                        // per drawcall vertex blending storage buffer
-                        uint32_t per_drawcall_vertex_blending_dynamic_offset;
-                        bool     least_one_enable_vertex_blending = true;
-                        for (uint32_t i = 0; i < current_instance_count; ++i)
-                        {
-                            if (!mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices)
-                            {
-                                least_one_enable_vertex_blending = false;
-                                break;
-                            }
-                        }
-                        if (least_one_enable_vertex_blending)
-                        {
-                            per_drawcall_vertex_blending_dynamic_offset =
-                                roundUp(m_global_render_resource->_storage_buffer
-                                            ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()],
-                                        m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                            m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] =
-                                per_drawcall_vertex_blending_dynamic_offset +
-                                sizeof(MeshPerdrawcallVertexBlendingStorageBufferObject);
-                            assert(m_global_render_resource->_storage_buffer
-                                       ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] <=
-                                   (m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_begin[m_rhi->getCurrentFrameIndex()] +
-                                    m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_size[m_rhi->getCurrentFrameIndex()]));
-
-                            MeshPerdrawcallVertexBlendingStorageBufferObject&
-                                per_drawcall_vertex_blending_storage_buffer_object =
-                                    (*reinterpret_cast<MeshPerdrawcallVertexBlendingStorageBufferObject*>(
-                                        reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
-                                                                        ._global_upload_ringbuffer_memory_pointer) +
-                                        per_drawcall_vertex_blending_dynamic_offset));
-                            for (uint32_t i = 0; i < current_instance_count; ++i)
-                            {
-                                if (mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices)
-                                {
-                                    for (uint32_t j = 0;
-                                         j < mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_count;
-                                         ++j)
-                                    {
-                                        per_drawcall_vertex_blending_storage_buffer_object
-                                            .joint_matrices[s_mesh_vertex_blending_max_joint_count * i + j] =
-                                            mesh_nodes[drawcall_max_instance_count * drawcall_index + i]
-                                                .joint_matrices[j];
-                                    }
-                                }
-                            }
-                        }
-                        else
-                        {
-                            per_drawcall_vertex_blending_dynamic_offset = 0;
-                        }
-
-                        // bind perdrawcall
-                        uint32_t dynamic_offsets[3] = {perframe_dynamic_offset,
-                                                       perdrawcall_dynamic_offset,
-                                                       per_drawcall_vertex_blending_dynamic_offset};
-                        m_rhi->cmdBindDescriptorSetsPFN(m_rhi->getCurrentCommandBuffer(),
-                                                        RHI_PIPELINE_BIND_POINT_GRAPHICS,
-                                                        m_render_pipelines[_render_pipeline_type_mesh_lighting].layout,
-                                                        0,
-                                                        1,
-                                                        &m_descriptor_infos[_mesh_global].descriptor_set,
-                                                        3,
-                                                        dynamic_offsets);
-
-                        m_rhi->cmdDrawIndexedPFN(m_rhi->getCurrentCommandBuffer(),
-                                                 mesh.mesh_index_count,
-                                                 current_instance_count,
-                                                 0,
-                                                 0,
-                                                 0);
-                    }
+                                                    1,
+                                                    &m_descriptor_infos[_mesh_global].descriptor_set,
+                                                    4,
+                                                    dynamic_offsets);
+
+                    m_rhi->cmdDrawIndexedPFN(m_rhi->getCurrentCommandBuffer(),
+                                             mesh.mesh_index_count,
+                                             current_instance_count,
+                                             0,
+                                             0,
+                                             0);
                 }
             }
         }
 
+        if (gpu_driven)
+        {
+            drawMeshGpuDriven(_render_pipeline_type_mesh_lighting_gpu_driven, perframe_dynamic_offset);
+        }
+
         m_rhi->popEvent(m_rhi->getCurrentCommandBuffer());
     }
 
+    void MainCameraPass::drawMeshGpuDriven(RenderPipeLineType pipeline_type, uint32_t perframe_dynamic_offset)
+    {
+        m_rhi->cmdBindPipelinePFN(
+            m_rhi->getCurrentCommandBuffer(), RHI_PIPELINE_BIND_POINT_GRAPHICS, m_render_pipelines[pipeline_type].pipeline);
+
+        // the visible instance list is addressed with gl_InstanceIndex, so it needs no dynamic offset
+        uint32_t dynamic_offsets[4] = {perframe_dynamic_offset,
+                                       m_mesh_cull_pass->getInstanceBufferDynamicOffset(),
+                                       0,
+                                       m_point_light_cluster_dynamic_offset};
+        m_rhi->cmdBindDescriptorSetsPFN(m_rhi->getCurrentCommandBuffer(),
+                                        RHI_PIPELINE_BIND_POINT_GRAPHICS,
+                                        m_render_pipelines[pipeline_type].layout,
+                                        0,
+                                        1,
+                                        &m_gpu_driven_mesh_global_descriptor_set,
+                                        4,
+                                        dynamic_offsets);
+
+        const std::vector<MeshCullDraw>& draws          = m_mesh_cull_pass->getDraws();
+        VulkanPBRMaterial*               bound_material = nullptr;
+        for (uint32_t draw_index : m_mesh_cull_pass->getDrawOrder())
+        {
+            const MeshCullDraw& draw = draws[draw_index];
+            if (draw.instance_count == 0)
+            {
+                continue;
+            }
+
+            if (draw.material != bound_material)
+            {
+                bound_material = draw.material;
+                m_rhi->cmdBindDescriptorSetsPFN(m_rhi->getCurrentCommandBuffer(),
+                                                RHI_PIPELINE_BIND_POINT_GRAPHICS,
+                                                m_render_pipelines[pipeline_type].layout,
+                                                2,
+                                                1,
+                                                &bound_material->material_descriptor_set,
+                                                0,
+                                                NULL);
+            }
+
+            VulkanMesh& mesh             = *draw.mesh;
+            RHIBuffer*  vertex_buffers[] = {mesh.mesh_vertex_position_buffer,
+                                           mesh.mesh_vertex_varying_enable_blending_buffer,
+                                           mesh.mesh_vertex_varying_buffer};
+            RHIDeviceSize offsets[]      = {0, 0, 0};
+            m_rhi->cmdBindVertexBuffersPFN(m_rhi->getCurrentCommandBuffer(),
+                                           0,
+                                           (sizeof(vertex_buffers) / sizeof(vertex_buffers[0])),
+                                           vertex_buffers,
+                                           offsets);
+            m_rhi->cmdBindIndexBufferPFN(
+                m_rhi->getCurrentCommandBuffer(), mesh.mesh_index_buffer, 0, RHI_INDEX_TYPE_UINT16);
+
+            // the instance count of the command has been written by the culling shader
+            m_rhi->cmdDrawIndexedIndirect(m_rhi->getCurrentCommandBuffer(),
+                                          m_mesh_cull_pass->getDrawCommandBuffer(),
+                                          m_mesh_cull_pass->getDrawCommandOffset(draw_index),
+                                          1,
+                                          sizeof(VulkanDrawIndexedIndirectCommand));
+        }
+    }
+
     void MainCameraPass::drawSkybox()
     {
         uint32_t perframe_dynamic_offset =
@@ -2724,4 +2830,6 @@ namespace Piccolo
 
     void MainCameraPass::setParticlePass(std::shared_ptr<ParticlePass> pass) { m_particle_pass = pass; }
 
+    void MainCameraPass::setMeshCullPass(std::shared_ptr<MeshCullPass> pass) { m_mesh_cull_pass = pass; }
+
 } // namespace Piccolo
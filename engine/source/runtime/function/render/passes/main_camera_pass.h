@@ -1,5 +1,6 @@
 #pragma once
 
+#include "runtime/function/render/render_draw_list.h"
 #include "runtime/function/render/render_pass.h"
 
 #include "runtime/function/render/passes/color_grading_pass.h"
@@ -8,6 +9,7 @@
 #include "runtime/function/render/passes/tone_mapping_pass.h"
 #include "runtime/function/render/passes/ui_pass.h"
 #include "runtime/function/render/passes/particle_pass.h"
+#include "runtime/function/render/passes/mesh_cull_pass.h"
 
 namespace Piccolo
 {
@@ -44,6 +46,7 @@ namespace Piccolo
         // 2. sky box
         // 3. axis
         // 4. billboard type particle
+        // 5. model drawn from the indirect commands of the mesh cull pass
         enum RenderPipeLineType : uint8_t
         {
             _render_pipeline_type_mesh_gbuffer = 0,
@@ -52,6 +55,8 @@ namespace Piccolo
             _render_pipeline_type_skybox,
             _render_pipeline_type_axis,
             _render_pipeline_type_particle,
+            _render_pipeline_type_mesh_gbuffer_gpu_driven,
+            _render_pipeline_type_mesh_lighting_gpu_driven,
             _render_pipeline_type_count
         };
 
@@ -91,6 +96,7 @@ namespace Piccolo
         RHICommandBuffer* getRenderCommandBuffer();
 
         void setParticlePass(std::shared_ptr<ParticlePass> pass);
+        void setMeshCullPass(std::shared_ptr<MeshCullPass> pass);
 
     private:
         void setupParticlePass();
@@ -111,6 +117,8 @@ namespace Piccolo
         void drawMeshGbuffer();
         void drawDeferredLighting();
         void drawMeshLighting();
+        void drawMeshGpuDriven(RenderPipeLineType pipeline_type, uint32_t perframe_dynamic_offset);
+        void uploadPointLightClusters();
         void drawSkybox();
         void drawAxis();
 
@@ -119,5 +127,13 @@ namespace Piccolo
     private:
         std::vector<RHIFramebuffer*> m_swapchain_framebuffers;
         std::shared_ptr<ParticlePass> m_particle_pass;
+        std::shared_ptr<MeshCullPass> m_mesh_cull_pass;
+        RenderDrawList                m_mesh_draw_list;
+
+        RHIDescriptorSet* m_gpu_driven_mesh_global_descriptor_set {nullptr};
+
+        // owned by the render resource, uploaded once per frame and bound at binding 8 of every mesh global set
+        const MeshPointLightClusterStorageBufferObject* m_point_light_cluster_storage_buffer_object {nullptr};
+        uint32_t                                        m_point_light_cluster_dynamic_offset {0};
     };
 } // namespace Piccolo
@@ -0,0 +1,490 @@
+#include "runtime/function/render/passes/mesh_cull_pass.h"
+
+#include "runtime/function/render/render_helper.h"
+#include "runtime/function/render/render_mesh.h"
+#include "runtime/function/render/render_resource.h"
+
+#include "runtime/core/base/macro.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include <mesh_cull_comp.h>
+
+namespace Piccolo
+{
+    void MeshCullPass::initialize(const RenderPassInitInfo* init_info)
+    {
+        RenderPass::initialize(nullptr);
+
+        setupBuffers();
+        setupDescriptorSetLayout();
+        setupPipelines();
+        setupDescriptorSet();
+    }
+
+    void MeshCullPass::setupBuffers()
+    {
+        uint32_t frame_count = m_rhi->getMaxFramesInFlight();
+
+        m_rhi->createBuffer(sizeof(VulkanMeshCullInstance) * s_mesh_cull_max_instance_count * frame_count,
+                            RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                            RHI_MEMORY_PROPERTY_HOST_VISIBLE_BIT | RHI_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                            m_instance_buffer,
+                            m_instance_buffer_memory);
+        if (RHI_SUCCESS != m_rhi->mapMemory(m_instance_buffer_memory,
+                                            0,
+                                            RHI_WHOLE_SIZE,
+                                            0,
+                                            reinterpret_cast<void**>(&m_instance_buffer_pointer)))
+        {
+            throw std::runtime_error("map mesh cull instance buffer");
+        }
+
+        m_rhi->createBuffer(sizeof(VulkanDrawIndexedIndirectCommand) * s_mesh_cull_max_draw_count * frame_count,
+                            RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT | RHI_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+                            RHI_MEMORY_PROPERTY_HOST_VISIBLE_BIT | RHI_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                            m_draw_command_buffer,
+                            m_draw_command_buffer_memory);
+        if (RHI_SUCCESS != m_rhi->mapMemory(m_draw_command_buffer_memory,
+                                            0,
+                                            RHI_WHOLE_SIZE,
+                                            0,
+                                            reinterpret_cast<void**>(&m_draw_command_buffer_pointer)))
+        {
+            throw std::runtime_error("map mesh cull draw command buffer");
+        }
+
+        // the compute pass of a frame is ordered after the draws of the previous one on the same queue,
+        // so a single copy is enough
+        m_rhi->createBuffer(sizeof(uint32_t) * s_mesh_cull_max_instance_count,
+                            RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                            RHI_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                            m_visible_instance_buffer,
+                            m_visible_instance_buffer_memory);
+
+        m_frame_instance_versions.resize(frame_count);
+    }
+
+    void MeshCullPass::setupDescriptorSetLayout()
+    {
+        m_descriptor_infos.resize(1);
+
+        RHIDescriptorSetLayoutBinding mesh_cull_global_layout_bindings[4];
+
+        RHIDescriptorSetLayoutBinding& mesh_cull_global_layout_perframe_storage_buffer_binding =
+            mesh_cull_global_layout_bindings[0];
+        mesh_cull_global_layout_perframe_storage_buffer_binding.binding = 0;
+        mesh_cull_global_layout_perframe_storage_buffer_binding.descriptorType =
+            RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+        mesh_cull_global_layout_perframe_storage_buffer_binding.descriptorCount    = 1;
+        mesh_cull_global_layout_perframe_storage_buffer_binding.stageFlags         = RHI_SHADER_STAGE_COMPUTE_BIT;
+        mesh_cull_global_layout_perframe_storage_buffer_binding.pImmutableSamplers = NULL;
+
+        RHIDescriptorSetLayoutBinding& mesh_cull_global_layout_instance_storage_buffer_binding =
+            mesh_cull_global_layout_bindings[1];
+        mesh_cull_global_layout_instance_storage_buffer_binding.binding = 1;
+        mesh_cull_global_layout_instance_storage_buffer_binding.descriptorType =
+            RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+        mesh_cull_global_layout_instance_storage_buffer_binding.descriptorCount    = 1;
+        mesh_cull_global_layout_instance_storage_buffer_binding.stageFlags         = RHI_SHADER_STAGE_COMPUTE_BIT;
+        mesh_cull_global_layout_instance_storage_buffer_binding.pImmutableSamplers = NULL;
+
+        RHIDescriptorSetLayoutBinding& mesh_cull_global_layout_draw_command_storage_buffer_binding =
+            mesh_cull_global_layout_bindings[2];
+        mesh_cull_global_layout_draw_command_storage_buffer_binding.binding = 2;
+        mesh_cull_global_layout_draw_command_storage_buffer_binding.descriptorType =
+            RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+        mesh_cull_global_layout_draw_command_storage_buffer_binding.descriptorCount    = 1;
+        mesh_cull_global_layout_draw_command_storage_buffer_binding.stageFlags         = RHI_SHADER_STAGE_COMPUTE_BIT;
+        mesh_cull_global_layout_draw_command_storage_buffer_binding.pImmutableSamplers = NULL;
+
+        RHIDescriptorSetLayoutBinding& mesh_cull_global_layout_visible_instance_storage_buffer_binding =
+            mesh_cull_global_layout_bindings[3];
+        mesh_cull_global_layout_visible_instance_storage_buffer_binding.binding = 3;
+        mesh_cull_global_layout_visible_instance_storage_buffer_binding.descriptorType =
+            RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        mesh_cull_global_layout_visible_instance_storage_buffer_binding.descriptorCount = 1;
+        mesh_cull_global_layout_visible_instance_storage_buffer_binding.stageFlags = RHI_SHADER_STAGE_COMPUTE_BIT;
+        mesh_cull_global_layout_visible_instance_storage_buffer_binding.pImmutableSamplers = NULL;
+
+        RHIDescriptorSetLayoutCreateInfo mesh_cull_global_layout_create_info;
+        mesh_cull_global_layout_create_info.sType = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        mesh_cull_global_layout_create_info.pNext = NULL;
+        mesh_cull_global_layout_create_info.flags = 0;
+        mesh_cull_global_layout_create_info.bindingCount =
+            sizeof(mesh_cull_global_layout_bindings) / sizeof(mesh_cull_global_layout_bindings[0]);
+        mesh_cull_global_layout_create_info.pBindings = mesh_cull_global_layout_bindings;
+
+        if (RHI_SUCCESS !=
+            m_rhi->createDescriptorSetLayout(&mesh_cull_global_layout_create_info, m_descriptor_infos[0].layout))
+        {
+            throw std::runtime_error("create mesh cull global layout");
+        }
+    }
+
+    void MeshCullPass::setupPipelines()
+    {
+        m_render_pipelines.resize(1);
+
+        RHIDescriptorSetLayout*     descriptorset_layouts[1] = {m_descriptor_infos[0].layout};
+        RHIPipelineLayoutCreateInfo pipeline_layout_create_info {};
+        pipeline_layout_create_info.sType          = RHI_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipeline_layout_create_info.setLayoutCount = 1;
+        pipeline_layout_create_info.pSetLayouts    = descriptorset_layouts;
+
+        if (RHI_SUCCESS != m_rhi->createPipelineLayout(&pipeline_layout_create_info, m_render_pipelines[0].layout))
+        {
+            throw std::runtime_error("create mesh cull pipeline layout");
+        }
+
+        RHIShader* mesh_cull_compute_shader = m_rhi->createShaderModule(MESH_CULL_COMP);
+
+        RHIPipelineShaderStageCreateInfo shader_stage {};
+        shader_stage.sType  = RHI_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        shader_stage.stage  = RHI_SHADER_STAGE_COMPUTE_BIT;
+        shader_stage.module = mesh_cull_compute_shader;
+        shader_stage.pName  = "main";
+
+        RHIComputePipelineCreateInfo compute_pipeline_create_info {};
+        compute_pipeline_create_info.sType   = RHI_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        compute_pipeline_create_info.layout  = m_render_pipelines[0].layout;
+        compute_pipeline_create_info.flags   = 0;
+        compute_pipeline_create_info.pStages = &shader_stage;
+
+        if (RHI_SUCCESS != m_rhi->createComputePipelines(/*pipelineCache*/ nullptr,
+                                                         1,
+                                                         &compute_pipeline_create_info,
+                                                         m_render_pipelines[0].pipeline))
+        {
+            throw std::runtime_error("create mesh cull compute pipeline");
+        }
+
+        m_rhi->destroyShaderModule(mesh_cull_compute_shader);
+    }
+
+    void MeshCullPass::setupDescriptorSet()
+    {
+        RHIDescriptorSetAllocateInfo mesh_cull_global_descriptor_set_alloc_info;
+        mesh_cull_global_descriptor_set_alloc_info.sType              = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        mesh_cull_global_descriptor_set_alloc_info.pNext              = NULL;
+        mesh_cull_global_descriptor_set_alloc_info.descriptorPool     = m_rhi->getDescriptorPoor();
+        mesh_cull_global_descriptor_set_alloc_info.descriptorSetCount = 1;
+        mesh_cull_global_descriptor_set_alloc_info.pSetLayouts        = &m_descriptor_infos[0].layout;
+
+        if (RHI_SUCCESS != m_rhi->allocateDescriptorSets(&mesh_cull_global_descriptor_set_alloc_info,
+                                                         m_descriptor_infos[0].descriptor_set))
+        {
+            throw std::runtime_error("allocate mesh cull global descriptor set");
+        }
+
+        RHIDescriptorBufferInfo mesh_cull_perframe_storage_buffer_info = {};
+        // this offset plus dynamic_offset should not be greater than the size of the buffer
+        mesh_cull_perframe_storage_buffer_info.offset = 0;
+        // the range means the size actually used by the shader per draw call
+        mesh_cull_perframe_storage_buffer_info.range  = sizeof(MeshCullPerframeStorageBufferObject);
+        mesh_cull_perframe_storage_buffer_info.buffer =
+            m_global_render_resource->_storage_buffer._global_upload_ringbuffer;
+        assert(mesh_cull_perframe_storage_buffer_info.range <
+               m_global_render_resource->_storage_buffer._max_storage_buffer_range);
+
+        RHIDescriptorBufferInfo mesh_cull_instance_storage_buffer_info = {};
+        mesh_cull_instance_storage_buffer_info.offset                 = 0;
+        mesh_cull_instance_storage_buffer_info.range  = sizeof(VulkanMeshCullInstance) * s_mesh_cull_max_instance_count;
+        mesh_cull_instance_storage_buffer_info.buffer = m_instance_buffer;
+        assert(mesh_cull_instance_storage_buffer_info.range <
+               m_global_render_resource->_storage_buffer._max_storage_buffer_range);
+
+        RHIDescriptorBufferInfo mesh_cull_draw_command_storage_buffer_info = {};
+        mesh_cull_draw_command_storage_buffer_info.offset                 = 0;
+        mesh_cull_draw_command_storage_buffer_info.range =
+            sizeof(VulkanDrawIndexedIndirectCommand) * s_mesh_cull_max_draw_count;
+        mesh_cull_draw_command_storage_buffer_info.buffer = m_draw_command_buffer;
+
+        RHIDescriptorBufferInfo mesh_cull_visible_instance_storage_buffer_info = {};
+        mesh_cull_visible_instance_storage_buffer_info.offset                 = 0;
+        mesh_cull_visible_instance_storage_buffer_info.range  = sizeof(uint32_t) * s_mesh_cull_max_instance_count;
+        mesh_cull_visible_instance_storage_buffer_info.buffer = m_visible_instance_buffer;
+
+        RHIDescriptorSet* descriptor_set_to_write = m_descriptor_infos[0].descriptor_set;
+
+        RHIWriteDescriptorSet descriptor_writes[4];
+
+        RHIDescriptorBufferInfo* buffer_infos[4]     = {&mesh_cull_perframe_storage_buffer_info,
+                                                        &mesh_cull_instance_storage_buffer_info,
+                                                        &mesh_cull_draw_command_storage_buffer_info,
+                                                        &mesh_cull_visible_instance_storage_buffer_info};
+        RHIDescriptorType        descriptor_types[4] = {RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC,
+                                                        RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC,
+                                                        RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC,
+                                                        RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER};
+
+        for (uint32_t binding = 0; binding < 4; ++binding)
+        {
+            RHIWriteDescriptorSet& descriptor_write = descriptor_writes[binding];
+            descriptor_write.sType                  = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            descriptor_write.pNext                  = NULL;
+            descriptor_write.dstSet                 = descriptor_set_to_write;
+            descriptor_write.dstBinding             = binding;
+            descriptor_write.dstArrayElement        = 0;
+            descriptor_write.descriptorType         = descriptor_types[binding];
+            descriptor_write.descriptorCount        = 1;
+            descriptor_write.pBufferInfo            = buffer_infos[binding];
+        }
+
+        m_rhi->updateDescriptorSets(
+            sizeof(descriptor_writes) / sizeof(descriptor_writes[0]), descriptor_writes, 0, NULL);
+    }
+
+    uint32_t MeshCullPass::getInstanceBufferDynamicOffset() const
+    {
+        return sizeof(VulkanMeshCullInstance) * s_mesh_cull_max_instance_count * m_rhi->getCurrentFrameIndex();
+    }
+
+    RHIDeviceSize MeshCullPass::getDrawCommandOffset(uint32_t draw_index) const
+    {
+        return sizeof(VulkanDrawIndexedIndirectCommand) *
+               (s_mesh_cull_max_draw_count * m_rhi->getCurrentFrameIndex() + draw_index);
+    }
+
+    uint32_t MeshCullPass::getOrCreateDraw(VulkanPBRMaterial* material, VulkanMesh* mesh)
+    {
+        uint64_t draw_key = (static_cast<uint64_t>(material->sort_id) << 32) | mesh->sort_id;
+
+        auto found = m_draw_indices.find(draw_key);
+        if (found != m_draw_indices.end())
+        {
+            return found->second;
+        }
+
+        if (m_draws.size() >= s_mesh_cull_max_draw_count)
+        {
+            return s_mesh_cull_max_draw_count;
+        }
+
+        uint32_t draw_index = static_cast<uint32_t>(m_draws.size());
+
+        MeshCullDraw draw;
+        draw.material = material;
+        draw.mesh     = mesh;
+        m_draws.push_back(draw);
+        m_draw_indices[draw_key] = draw_index;
+        m_draw_order.push_back(draw_index);
+
+        return draw_index;
+    }
+
+    void MeshCullPass::preparePassData(std::shared_ptr<RenderResourceBase> render_resource)
+    {
+        RenderResource* vulkan_resource = static_cast<RenderResource*>(render_resource.get());
+
+        m_active = false;
+        if (!vulkan_resource || !m_visiable_nodes.p_render_entities)
+        {
+            return;
+        }
+
+        ClusterFrustum frustum = CreateClusterFrustumFromMatrix(
+            vulkan_resource->m_mesh_perframe_storage_buffer_object.proj_view_matrix, -1.0, 1.0, -1.0, 1.0, 0.0, 1.0);
+        m_mesh_cull_perframe_storage_buffer_object.frustum_planes[0] = frustum.m_plane_right;
+        m_mesh_cull_perframe_storage_buffer_object.frustum_planes[1] = frustum.m_plane_left;
+        m_mesh_cull_perframe_storage_buffer_object.frustum_planes[2] = frustum.m_plane_top;
+        m_mesh_cull_perframe_storage_buffer_object.frustum_planes[3] = frustum.m_plane_bottom;
+        m_mesh_cull_perframe_storage_buffer_object.frustum_planes[4] = frustum.m_plane_near;
+        m_mesh_cull_perframe_storage_buffer_object.frustum_planes[5] = frustum.m_plane_far;
+
+        // the draws are made again every frame from the entities, so that the material and mesh pairs of the removed
+        // entities or of an unloaded level are dropped, the draw indices stay the same while the scene does
+        m_draws.clear();
+        m_draw_order.clear();
+        m_draw_indices.clear();
+
+        // first pass: count the instances of every draw
+        const std::vector<RenderEntity>& entities = *m_visiable_nodes.p_render_entities;
+
+        m_entity_draw_indices.clear();
+
+        uint32_t instance_count = 0;
+        for (const RenderEntity& entity : entities)
+        {
+            if (entity.m_enable_vertex_blending)
+            {
+                continue;
+            }
+
+            uint32_t draw_index =
+                getOrCreateDraw(&vulkan_resource->getEntityMaterial(entity), &vulkan_resource->getEntityMesh(entity));
+            if (draw_index >= s_mesh_cull_max_draw_count || instance_count >= s_mesh_cull_max_instance_count)
+            {
+                if (!m_overflow_reported)
+                {
+                    LOG_WARN("the scene exceeds the gpu driven culling limits, meshes are drawn on the cpu path");
+                    m_overflow_reported = true;
+                }
+                return;
+            }
+
+            ++m_draws[draw_index].instance_count;
+            ++instance_count;
+            m_entity_draw_indices.push_back(draw_index);
+        }
+
+        // keep the draws of a material together so that the main camera pass binds every material once
+        std::sort(m_draw_order.begin(), m_draw_order.end(), [this](uint32_t lhs, uint32_t rhs) {
+            const MeshCullDraw& lhs_draw = m_draws[lhs];
+            const MeshCullDraw& rhs_draw = m_draws[rhs];
+            if (lhs_draw.material->sort_id != rhs_draw.material->sort_id)
+            {
+                return lhs_draw.material->sort_id < rhs_draw.material->sort_id;
+            }
+            return lhs_draw.mesh->sort_id < rhs_draw.mesh->sort_id;
+        });
+
+        uint32_t first_instance = 0;
+        for (MeshCullDraw& draw : m_draws)
+        {
+            draw.first_instance = first_instance;
+            first_instance += draw.instance_count;
+        }
+
+        // second pass: refresh the cpu copy, only the changed slots are uploaded again in draw
+        m_instances.resize(instance_count);
+        m_instance_versions.resize(instance_count, 0);
+
+        uint32_t instance_index = 0;
+        for (const RenderEntity& entity : entities)
+        {
+            if (entity.m_enable_vertex_blending)
+            {
+                continue;
+            }
+
+            // value initialized so that the padding compares equal
+            VulkanMeshCullInstance instance {};
+            instance.model_matrix     = entity.m_model_matrix;
+            instance.bounding_box_min = entity.m_bounding_box.getMinCorner();
+            instance.bounding_box_max = entity.m_bounding_box.getMaxCorner();
+            instance.draw_index       = m_entity_draw_indices[instance_index];
+
+            if (std::memcmp(&m_instances[instance_index], &instance, sizeof(instance)) != 0)
+            {
+                m_instances[instance_index] = instance;
+                ++m_instance_versions[instance_index];
+            }
+            ++instance_index;
+        }
+
+        m_instance_count = instance_count;
+        m_active         = true;
+    }
+
+    void MeshCullPass::draw()
+    {
+        if (!m_active)
+        {
+            return;
+        }
+
+        uint8_t current_frame_index = m_rhi->getCurrentFrameIndex();
+
+        // the fence of this frame has been waited, its regions are no longer read by the gpu
+        std::vector<uint32_t>&  frame_instance_versions = m_frame_instance_versions[current_frame_index];
+        VulkanMeshCullInstance* frame_instances =
+            m_instance_buffer_pointer + s_mesh_cull_max_instance_count * current_frame_index;
+        frame_instance_versions.resize(m_instance_count, UINT32_MAX);
+        for (uint32_t i = 0; i < m_instance_count; ++i)
+        {
+            if (frame_instance_versions[i] != m_instance_versions[i])
+            {
+                frame_instances[i]         = m_instances[i];
+                frame_instance_versions[i] = m_instance_versions[i];
+            }
+        }
+
+        // the instance counts are reset here and accumulated by the culling shader
+        VulkanDrawIndexedIndirectCommand* frame_draw_commands =
+            m_draw_command_buffer_pointer + s_mesh_cull_max_draw_count * current_frame_index;
+        for (uint32_t draw_index = 0; draw_index < m_draws.size(); ++draw_index)
+        {
+            VulkanDrawIndexedIndirectCommand& draw_command = frame_draw_commands[draw_index];
+            draw_command.index_count                       = m_draws[draw_index].mesh->mesh_index_count;
+            draw_command.instance_count                    = 0;
+            draw_command.first_index                       = 0;
+            draw_command.vertex_offset                     = 0;
+            draw_command.first_instance                    = m_draws[draw_index].first_instance;
+        }
+
+        m_mesh_cull_perframe_storage_buffer_object.instance_count = m_instance_count;
+
+        uint32_t perframe_dynamic_offset =
+            roundUp(m_global_render_resource->_storage_buffer._global_upload_ringbuffers_end[current_frame_index],
+                    m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
+        m_global_render_resource->_storage_buffer._global_upload_ringbuffers_end[current_frame_index] =
+            perframe_dynamic_offset + sizeof(MeshCullPerframeStorageBufferObject);
+        assert(m_global_render_resource->_storage_buffer._global_upload_ringbuffers_end[current_frame_index] <=
+               (m_global_render_resource->_storage_buffer._global_upload_ringbuffers_begin[current_frame_index] +
+                m_global_render_resource->_storage_buffer._global_upload_ringbuffers_size[current_frame_index]));
+
+        (*reinterpret_cast<MeshCullPerframeStorageBufferObject*>(
+            reinterpret_cast<uintptr_t>(
+                m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
+            perframe_dynamic_offset)) = m_mesh_cull_perframe_storage_buffer_object;
+
+        RHICommandBuffer* command_buffer = m_rhi->getCurrentCommandBuffer();
+
+        float color[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+        m_rhi->pushEvent(command_buffer, "Mesh Cull", color);
+
+        // the visible instance list of the previous frame may still be read by its draws
+        RHIMemoryBarrier memory_barrier {};
+        memory_barrier.sType         = RHI_STRUCTURE_TYPE_MEMORY_BARRIER;
+        memory_barrier.srcAccessMask = RHI_ACCESS_SHADER_READ_BIT | RHI_ACCESS_INDIRECT_COMMAND_READ_BIT;
+        memory_barrier.dstAccessMask = RHI_ACCESS_SHADER_WRITE_BIT;
+        m_rhi->cmdPipelineBarrier(command_buffer,
+                                  RHI_PIPELINE_STAGE_VERTEX_SHADER_BIT | RHI_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+                                  RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                  0,
+                                  1,
+                                  &memory_barrier,
+                                  0,
+                                  nullptr,
+                                  0,
+                                  nullptr);
+
+        if (m_instance_count > 0)
+        {
+            m_rhi->cmdBindPipelinePFN(command_buffer, RHI_PIPELINE_BIND_POINT_COMPUTE, m_render_pipelines[0].pipeline);
+
+            uint32_t dynamic_offsets[3] = {perframe_dynamic_offset,
+                                           getInstanceBufferDynamicOffset(),
+                                           static_cast<uint32_t>(getDrawCommandOffset(0))};
+            m_rhi->cmdBindDescriptorSetsPFN(command_buffer,
+                                            RHI_PIPELINE_BIND_POINT_COMPUTE,
+                                            m_render_pipelines[0].layout,
+                                            0,
+                                            1,
+                                            &m_descriptor_infos[0].descriptor_set,
+                                            3,
+                                            dynamic_offsets);
+
+            m_rhi->cmdDispatch(
+                command_buffer, roundUp(m_instance_count, s_mesh_cull_group_size) / s_mesh_cull_group_size, 1, 1);
+        }
+
+        memory_barrier.srcAccessMask = RHI_ACCESS_SHADER_WRITE_BIT;
+        memory_barrier.dstAccessMask = RHI_ACCESS_INDIRECT_COMMAND_READ_BIT | RHI_ACCESS_SHADER_READ_BIT;
+        m_rhi->cmdPipelineBarrier(command_buffer,
+                                  RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                  RHI_PIPELINE_STAGE_DRAW_INDIRECT_BIT | RHI_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+                                  0,
+                                  1,
+                                  &memory_barrier,
+                                  0,
+                                  nullptr,
+                                  0,
+                                  nullptr);
+
+        m_rhi->popEvent(command_buffer);
+    }
+} // namespace Piccolo
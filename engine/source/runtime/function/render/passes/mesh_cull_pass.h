@@ -0,0 +1,80 @@
+#pragma once
+
+#include "runtime/function/render/render_pass.h"
+
+#include <unordered_map>
+
+namespace Piccolo
+{
+    class RenderResourceBase;
+
+    // one indirect draw of the gpu driven path, its instances share the material and the mesh
+    struct MeshCullDraw
+    {
+        VulkanPBRMaterial* material {nullptr};
+        VulkanMesh*        mesh {nullptr};
+        uint32_t           instance_count {0}; // before culling
+        uint32_t           first_instance {0};
+    };
+
+    // culls the static mesh instances against the main camera frustum in a compute shader and writes the indirect
+    // draw commands consumed by the main camera pass, skinned meshes are still drawn on the cpu path
+    class MeshCullPass : public RenderPass
+    {
+    public:
+        void initialize(const RenderPassInitInfo* init_info) override final;
+        void preparePassData(std::shared_ptr<RenderResourceBase> render_resource) override final;
+        void draw() override final;
+
+        // false when the scene does not fit into the culling buffers, every mesh then takes the cpu path
+        bool isActive() const { return m_active; }
+
+        // indices into getDraws(), ordered by material
+        const std::vector<uint32_t>&     getDrawOrder() const { return m_draw_order; }
+        const std::vector<MeshCullDraw>& getDraws() const { return m_draws; }
+
+        RHIBuffer*    getInstanceBuffer() const { return m_instance_buffer; }
+        RHIBuffer*    getVisibleInstanceBuffer() const { return m_visible_instance_buffer; }
+        RHIBuffer*    getDrawCommandBuffer() const { return m_draw_command_buffer; }
+        uint32_t      getInstanceBufferDynamicOffset() const;
+        RHIDeviceSize getDrawCommandOffset(uint32_t draw_index) const;
+
+    private:
+        void setupBuffers();
+        void setupDescriptorSetLayout();
+        void setupPipelines();
+        void setupDescriptorSet();
+
+        uint32_t getOrCreateDraw(VulkanPBRMaterial* material, VulkanMesh* mesh);
+
+    private:
+        bool m_active {false};
+        bool m_overflow_reported {false};
+
+        MeshCullPerframeStorageBufferObject m_mesh_cull_perframe_storage_buffer_object;
+
+        // cpu copy of the instance buffer, a slot is uploaded again only after its version changed
+        std::vector<VulkanMeshCullInstance> m_instances;
+        std::vector<uint32_t>               m_instance_versions;
+        std::vector<std::vector<uint32_t>>  m_frame_instance_versions;
+        std::vector<uint32_t>               m_entity_draw_indices;
+        uint32_t                            m_instance_count {0};
+
+        std::vector<MeshCullDraw>              m_draws;
+        std::vector<uint32_t>                  m_draw_order;
+        std::unordered_map<uint64_t, uint32_t> m_draw_indices;
+
+        // host visible, one region per frame in flight
+        RHIBuffer*              m_instance_buffer {nullptr};
+        RHIDeviceMemory*        m_instance_buffer_memory {nullptr};
+        VulkanMeshCullInstance* m_instance_buffer_pointer {nullptr};
+
+        RHIBuffer*                        m_draw_command_buffer {nullptr};
+        RHIDeviceMemory*                  m_draw_command_buffer_memory {nullptr};
+        VulkanDrawIndexedIndirectCommand* m_draw_command_buffer_pointer {nullptr};
+
+        // written and read on the gpu only
+        RHIBuffer*       m_visible_instance_buffer {nullptr};
+        RHIDeviceMemory* m_visible_instance_buffer_memory {nullptr};
+    };
+} // namespace Piccolo
@@ -0,0 +1,352 @@
+#include "runtime/function/render/passes/mesh_skinning_pass.h"
+
+#include "runtime/function/render/render_helper.h"
+#include "runtime/function/render/render_mesh.h"
+#include "runtime/function/render/render_resource.h"
+
+#include "runtime/core/base/macro.h"
+
+#include <stdexcept>
+
+#include <mesh_skinning_comp.h>
+
+namespace Piccolo
+{
+    void MeshSkinningPass::initialize(const RenderPassInitInfo* init_info)
+    {
+        RenderPass::initialize(nullptr);
+
+        setupBuffers();
+        setupDescriptorSetLayout();
+        setupPipelines();
+        setupDescriptorSet();
+    }
+
+    void MeshSkinningPass::setupBuffers()
+    {
+        SkinnedVertexBuffer& skinned_vertex_buffer = m_global_render_resource->_skinned_vertex_buffer;
+
+        // written and read on the gpu only, the skinning of a frame is ordered after the draws of the previous one
+        // on the same queue, so a single copy is enough
+        m_rhi->createBuffer(sizeof(MeshVertex::VulkanMeshVertexPostition) * s_mesh_skinning_max_vertex_count,
+                            RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT | RHI_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                            RHI_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                            skinned_vertex_buffer._position_buffer,
+                            skinned_vertex_buffer._position_buffer_memory);
+
+        m_rhi->createBuffer(sizeof(MeshVertex::VulkanMeshVertexVaryingEnableBlending) *
+                                s_mesh_skinning_max_vertex_count,
+                            RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT | RHI_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                            RHI_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                            skinned_vertex_buffer._varying_enable_blending_buffer,
+                            skinned_vertex_buffer._varying_enable_blending_buffer_memory);
+    }
+
+    void MeshSkinningPass::setupDescriptorSetLayout()
+    {
+        m_descriptor_infos.resize(_layout_type_count);
+
+        {
+            RHIDescriptorSetLayoutBinding mesh_skinning_global_layout_bindings[4];
+
+            // the per dispatch data and the joint palette are in the upload ring buffer
+            RHIDescriptorType descriptor_types[4] = {RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC,
+                                                     RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC,
+                                                     RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                                                     RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER};
+
+            for (uint32_t binding = 0; binding < 4; ++binding)
+            {
+                RHIDescriptorSetLayoutBinding& layout_binding = mesh_skinning_global_layout_bindings[binding];
+                layout_binding.binding                        = binding;
+                layout_binding.descriptorType                 = descriptor_types[binding];
+                layout_binding.descriptorCount                = 1;
+                layout_binding.stageFlags                     = RHI_SHADER_STAGE_COMPUTE_BIT;
+                layout_binding.pImmutableSamplers             = NULL;
+            }
+
+            RHIDescriptorSetLayoutCreateInfo mesh_skinning_global_layout_create_info;
+            mesh_skinning_global_layout_create_info.sType = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+            mesh_skinning_global_layout_create_info.pNext = NULL;
+            mesh_skinning_global_layout_create_info.flags = 0;
+            mesh_skinning_global_layout_create_info.bindingCount =
+                sizeof(mesh_skinning_global_layout_bindings) / sizeof(mesh_skinning_global_layout_bindings[0]);
+            mesh_skinning_global_layout_create_info.pBindings = mesh_skinning_global_layout_bindings;
+
+            if (RHI_SUCCESS != m_rhi->createDescriptorSetLayout(&mesh_skinning_global_layout_create_info,
+                                                                m_descriptor_infos[_global].layout))
+            {
+                throw std::runtime_error("create mesh skinning global layout");
+            }
+        }
+
+        {
+            // positions, normals and tangents, joint bindings
+            RHIDescriptorSetLayoutBinding mesh_skinning_per_mesh_layout_bindings[3];
+
+            for (uint32_t binding = 0; binding < 3; ++binding)
+            {
+                RHIDescriptorSetLayoutBinding& layout_binding = mesh_skinning_per_mesh_layout_bindings[binding];
+                layout_binding.binding                        = binding;
+                layout_binding.descriptorType                 = RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                layout_binding.descriptorCount                = 1;
+                layout_binding.stageFlags                     = RHI_SHADER_STAGE_COMPUTE_BIT;
+                layout_binding.pImmutableSamplers             = NULL;
+            }
+
+            RHIDescriptorSetLayoutCreateInfo mesh_skinning_per_mesh_layout_create_info;
+            mesh_skinning_per_mesh_layout_create_info.sType = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+            mesh_skinning_per_mesh_layout_create_info.pNext = NULL;
+            mesh_skinning_per_mesh_layout_create_info.flags = 0;
+            mesh_skinning_per_mesh_layout_create_info.bindingCount =
+                sizeof(mesh_skinning_per_mesh_layout_bindings) / sizeof(mesh_skinning_per_mesh_layout_bindings[0]);
+            mesh_skinning_per_mesh_layout_create_info.pBindings = mesh_skinning_per_mesh_layout_bindings;
+
+            if (RHI_SUCCESS != m_rhi->createDescriptorSetLayout(&mesh_skinning_per_mesh_layout_create_info,
+                                                                m_descriptor_infos[_per_mesh].layout))
+            {
+                throw std::runtime_error("create mesh skinning per mesh layout");
+            }
+        }
+    }
+
+    void MeshSkinningPass::setupPipelines()
+    {
+        m_render_pipelines.resize(1);
+
+        RHIDescriptorSetLayout*     descriptorset_layouts[2] = {m_descriptor_infos[_global].layout,
+                                                                m_descriptor_infos[_per_mesh].layout};
+        RHIPipelineLayoutCreateInfo pipeline_layout_create_info {};
+        pipeline_layout_create_info.sType          = RHI_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipeline_layout_create_info.setLayoutCount = 2;
+        pipeline_layout_create_info.pSetLayouts    = descriptorset_layouts;
+
+        if (RHI_SUCCESS != m_rhi->createPipelineLayout(&pipeline_layout_create_info, m_render_pipelines[0].layout))
+        {
+            throw std::runtime_error("create mesh skinning pipeline layout");
+        }
+
+        RHIShader* mesh_skinning_compute_shader = m_rhi->createShaderModule(MESH_SKINNING_COMP);
+
+        RHIPipelineShaderStageCreateInfo shader_stage {};
+        shader_stage.sType  = RHI_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        shader_stage.stage  = RHI_SHADER_STAGE_COMPUTE_BIT;
+        shader_stage.module = mesh_skinning_compute_shader;
+        shader_stage.pName  = "main";
+
+        RHIComputePipelineCreateInfo compute_pipeline_create_info {};
+        compute_pipeline_create_info.sType   = RHI_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        compute_pipeline_create_info.layout  = m_render_pipelines[0].layout;
+        compute_pipeline_create_info.flags   = 0;
+        compute_pipeline_create_info.pStages = &shader_stage;
+
+        if (RHI_SUCCESS != m_rhi->createComputePipelines(/*pipelineCache*/ nullptr,
+                                                         1,
+                                                         &compute_pipeline_create_info,
+                                                         m_render_pipelines[0].pipeline))
+        {
+            throw std::runtime_error("create mesh skinning compute pipeline");
+        }
+
+        m_rhi->destroyShaderModule(mesh_skinning_compute_shader);
+    }
+
+    void MeshSkinningPass::setupDescriptorSet()
+    {
+        // the per mesh sets are allocated by RenderResource when a skinned mesh is uploaded
+        RHIDescriptorSetAllocateInfo mesh_skinning_global_descriptor_set_alloc_info;
+        mesh_skinning_global_descriptor_set_alloc_info.sType          = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        mesh_skinning_global_descriptor_set_alloc_info.pNext          = NULL;
+        mesh_skinning_global_descriptor_set_alloc_info.descriptorPool = m_rhi->getDescriptorPoor();
+        mesh_skinning_global_descriptor_set_alloc_info.descriptorSetCount = 1;
+        mesh_skinning_global_descriptor_set_alloc_info.pSetLayouts        = &m_descriptor_infos[_global].layout;
+
+        if (RHI_SUCCESS != m_rhi->allocateDescriptorSets(&mesh_skinning_global_descriptor_set_alloc_info,
+                                                         m_descriptor_infos[_global].descriptor_set))
+        {
+            throw std::runtime_error("allocate mesh skinning global descriptor set");
+        }
+
+        RHIDescriptorBufferInfo mesh_skinning_perdispatch_storage_buffer_info = {};
+        // this offset plus dynamic_offset should not be greater than the size of the buffer
+        mesh_skinning_perdispatch_storage_buffer_info.offset = 0;
+        // the range means the size actually used by the shader per dispatch
+        mesh_skinning_perdispatch_storage_buffer_info.range = sizeof(MeshSkinningPerdispatchStorageBufferObject);
+        mesh_skinning_perdispatch_storage_buffer_info.buffer =
+            m_global_render_resource->_storage_buffer._global_upload_ringbuffer;
+        assert(mesh_skinning_perdispatch_storage_buffer_info.range <
+               m_global_render_resource->_storage_buffer._max_storage_buffer_range);
+
+        RHIDescriptorBufferInfo mesh_skinning_joint_palette_storage_buffer_info = {};
+        mesh_skinning_joint_palette_storage_buffer_info.offset                 = 0;
+        mesh_skinning_joint_palette_storage_buffer_info.range = sizeof(MeshJointPaletteStorageBufferObject);
+        mesh_skinning_joint_palette_storage_buffer_info.buffer =
+            m_global_render_resource->_storage_buffer._global_upload_ringbuffer;
+        assert(mesh_skinning_joint_palette_storage_buffer_info.range <
+               m_global_render_resource->_storage_buffer._max_storage_buffer_range);
+
+        RHIDescriptorBufferInfo mesh_skinning_position_storage_buffer_info = {};
+        mesh_skinning_position_storage_buffer_info.offset                 = 0;
+        mesh_skinning_position_storage_buffer_info.range =
+            sizeof(MeshVertex::VulkanMeshVertexPostition) * s_mesh_skinning_max_vertex_count;
+        mesh_skinning_position_storage_buffer_info.buffer =
+            m_global_render_resource->_skinned_vertex_buffer._position_buffer;
+
+        RHIDescriptorBufferInfo mesh_skinning_varying_storage_buffer_info = {};
+        mesh_skinning_varying_storage_buffer_info.offset                 = 0;
+        mesh_skinning_varying_storage_buffer_info.range =
+            sizeof(MeshVertex::VulkanMeshVertexVaryingEnableBlending) * s_mesh_skinning_max_vertex_count;
+        mesh_skinning_varying_storage_buffer_info.buffer =
+            m_global_render_resource->_skinned_vertex_buffer._varying_enable_blending_buffer;
+
+        RHIDescriptorSet* descriptor_set_to_write = m_descriptor_infos[_global].descriptor_set;
+
+        RHIWriteDescriptorSet descriptor_writes[4];
+
+        RHIDescriptorBufferInfo* buffer_infos[4]     = {&mesh_skinning_perdispatch_storage_buffer_info,
+                                                        &mesh_skinning_joint_palette_storage_buffer_info,
+                                                        &mesh_skinning_position_storage_buffer_info,
+                                                        &mesh_skinning_varying_storage_buffer_info};
+        RHIDescriptorType        descriptor_types[4] = {RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC,
+                                                        RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC,
+                                                        RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                                                        RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER};
+
+        for (uint32_t binding = 0; binding < 4; ++binding)
+        {
+            RHIWriteDescriptorSet& descriptor_write = descriptor_writes[binding];
+            descriptor_write.sType                  = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            descriptor_write.pNext                  = NULL;
+            descriptor_write.dstSet                 = descriptor_set_to_write;
+            descriptor_write.dstBinding             = binding;
+            descriptor_write.dstArrayElement        = 0;
+            descriptor_write.descriptorType         = descriptor_types[binding];
+            descriptor_write.descriptorCount        = 1;
+            descriptor_write.pBufferInfo            = buffer_infos[binding];
+        }
+
+        m_rhi->updateDescriptorSets(
+            sizeof(descriptor_writes) / sizeof(descriptor_writes[0]), descriptor_writes, 0, NULL);
+    }
+
+    void MeshSkinningPass::preparePassData(std::shared_ptr<RenderResourceBase> render_resource)
+    {
+        RenderResource* vulkan_resource = static_cast<RenderResource*>(render_resource.get());
+
+        m_jobs.clear();
+        if (!vulkan_resource || !m_visiable_nodes.p_render_entities)
+        {
+            return;
+        }
+
+        // RenderScene has placed the vertices of the pre-skinned entities while packing the joint palette
+        for (const RenderEntity& entity : *m_visiable_nodes.p_render_entities)
+        {
+            if (!entity.m_is_pre_skinned)
+            {
+                continue;
+            }
+
+            VulkanMesh& mesh = vulkan_resource->getEntityMesh(entity);
+            if (mesh.mesh_skinning_descriptor_set == nullptr)
+            {
+                continue;
+            }
+
+            MeshSkinningJob job;
+            job.mesh                  = &mesh;
+            job.joint_palette_offset  = entity.m_joint_palette_offset;
+            job.skinned_vertex_offset = entity.m_skinned_vertex_offset;
+            job.joint_count           = entity.m_joint_palette_count;
+            m_jobs.push_back(job);
+        }
+    }
+
+    void MeshSkinningPass::draw()
+    {
+        if (m_jobs.empty())
+        {
+            return;
+        }
+
+        uint8_t           current_frame_index = m_rhi->getCurrentFrameIndex();
+        RHICommandBuffer* command_buffer      = m_rhi->getCurrentCommandBuffer();
+
+        float color[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+        m_rhi->pushEvent(command_buffer, "Mesh Skinning", color);
+
+        // the skinned vertices of the previous frame may still be read by its draws
+        RHIMemoryBarrier memory_barrier {};
+        memory_barrier.sType         = RHI_STRUCTURE_TYPE_MEMORY_BARRIER;
+        memory_barrier.srcAccessMask = RHI_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+        memory_barrier.dstAccessMask = RHI_ACCESS_SHADER_WRITE_BIT;
+        m_rhi->cmdPipelineBarrier(command_buffer,
+                                  RHI_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                                  RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                  0,
+                                  1,
+                                  &memory_barrier,
+                                  0,
+                                  nullptr,
+                                  0,
+                                  nullptr);
+
+        m_rhi->cmdBindPipelinePFN(command_buffer, RHI_PIPELINE_BIND_POINT_COMPUTE, m_render_pipelines[0].pipeline);
+
+        for (const MeshSkinningJob& job : m_jobs)
+        {
+            uint32_t perdispatch_dynamic_offset =
+                roundUp(m_global_render_resource->_storage_buffer._global_upload_ringbuffers_end[current_frame_index],
+                        m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
+            m_global_render_resource->_storage_buffer._global_upload_ringbuffers_end[current_frame_index] =
+                perdispatch_dynamic_offset + sizeof(MeshSkinningPerdispatchStorageBufferObject);
+            assert(m_global_render_resource->_storage_buffer._global_upload_ringbuffers_end[current_frame_index] <=
+                   (m_global_render_resource->_storage_buffer._global_upload_ringbuffers_begin[current_frame_index] +
+                    m_global_render_resource->_storage_buffer._global_upload_ringbuffers_size[current_frame_index]));
+
+            MeshSkinningPerdispatchStorageBufferObject& perdispatch_storage_buffer_object =
+                (*reinterpret_cast<MeshSkinningPerdispatchStorageBufferObject*>(
+                    reinterpret_cast<uintptr_t>(
+                        m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
+                    perdispatch_dynamic_offset));
+            perdispatch_storage_buffer_object.vertex_count          = job.mesh->mesh_vertex_count;
+            perdispatch_storage_buffer_object.joint_palette_offset  = job.joint_palette_offset;
+            perdispatch_storage_buffer_object.skinned_vertex_offset = job.skinned_vertex_offset;
+            perdispatch_storage_buffer_object.joint_count           = job.joint_count;
+
+            RHIDescriptorSet* descriptor_sets[2] = {m_descriptor_infos[_global].descriptor_set,
+                                                    job.mesh->mesh_skinning_descriptor_set};
+            uint32_t          dynamic_offsets[2] = {
+                perdispatch_dynamic_offset, m_global_render_resource->_storage_buffer._joint_palette_dynamic_offset};
+            m_rhi->cmdBindDescriptorSetsPFN(command_buffer,
+                                            RHI_PIPELINE_BIND_POINT_COMPUTE,
+                                            m_render_pipelines[0].layout,
+                                            0,
+                                            2,
+                                            descriptor_sets,
+                                            2,
+                                            dynamic_offsets);
+
+            m_rhi->cmdDispatch(command_buffer,
+                               roundUp(job.mesh->mesh_vertex_count, s_mesh_skinning_group_size) /
+                                   s_mesh_skinning_group_size,
+                               1,
+                               1);
+        }
+
+        memory_barrier.srcAccessMask = RHI_ACCESS_SHADER_WRITE_BIT;
+        memory_barrier.dstAccessMask = RHI_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+        m_rhi->cmdPipelineBarrier(command_buffer,
+                                  RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                  RHI_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                                  0,
+                                  1,
+                                  &memory_barrier,
+                                  0,
+                                  nullptr,
+                                  0,
+                                  nullptr);
+
+        m_rhi->popEvent(command_buffer);
+    }
+} // namespace Piccolo
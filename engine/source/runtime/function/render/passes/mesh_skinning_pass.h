@@ -0,0 +1,43 @@
+#pragma once
+
+#include "runtime/function/render/render_pass.h"
+
+namespace Piccolo
+{
+    class RenderResourceBase;
+
+    // one skinned entity of the frame, its vertices are written to the skinned vertex buffer
+    struct MeshSkinningJob
+    {
+        VulkanMesh* mesh {nullptr};
+        uint32_t    joint_palette_offset {0};
+        uint32_t    skinned_vertex_offset {0};
+        uint32_t    joint_count {0};
+    };
+
+    // blends the vertices of the pre-skinned entities once per frame in a compute shader, the mesh passes then draw
+    // them from the skinned vertex buffer as static geometry instead of blending them again in each vertex shader
+    class MeshSkinningPass : public RenderPass
+    {
+    public:
+        enum LayoutType : uint8_t
+        {
+            _global = 0,
+            _per_mesh,
+            _layout_type_count
+        };
+
+        void initialize(const RenderPassInitInfo* init_info) override final;
+        void preparePassData(std::shared_ptr<RenderResourceBase> render_resource) override final;
+        void draw() override final;
+
+    private:
+        void setupBuffers();
+        void setupDescriptorSetLayout();
+        void setupPipelines();
+        void setupDescriptorSet();
+
+    private:
+        std::vector<MeshSkinningJob> m_jobs;
+    };
+} // namespace Piccolo
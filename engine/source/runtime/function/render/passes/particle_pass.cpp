@@ -8,12 +8,23 @@
 #include "runtime/function/render/render_system.h"
 
 #include "core/base/macro.h"
+#include <cmath>
 #include <fstream>
 
+#include "particle_composite_frag.h"
 #include "particle_emit_comp.h"
 #include "particle_kickoff_comp.h"
 #include "particle_simulate_comp.h"
+#include "particle_sort_bin_comp.h"
+#include "particle_sort_histogram_comp.h"
+#include "particle_sort_keys_comp.h"
+#include "particle_sort_kickoff_comp.h"
+#include "particle_sort_scan_comp.h"
+#include "particle_sort_scatter_comp.h"
+#include "post_process_vert.h"
 #include <particlebillboard_frag.h>
+#include <particlebillboard_half_resolution_frag.h>
+#include <particlebillboard_sorted_vert.h>
 #include <particlebillboard_vert.h>
 
 namespace Piccolo
@@ -29,9 +40,10 @@ namespace Piccolo
         rhi->freeMemory(m_alive_list_next_memory);
         rhi->freeMemory(m_dead_list_memory);
         rhi->freeMemory(m_particle_component_res_memory);
-        rhi->freeMemory(m_position_render_memory);
 
-        rhi->destroyBuffer(m_position_render_buffer);
+        // the render buffer is shared by the emitters and freed by the pass
+        m_position_render_buffer = nullptr;
+
         rhi->destroyBuffer(m_position_device_buffer);
         rhi->destroyBuffer(m_position_host_buffer);
         rhi->destroyBuffer(m_counter_device_buffer);
@@ -41,6 +53,14 @@ namespace Piccolo
         rhi->destroyBuffer(m_alive_list_next_buffer);
         rhi->destroyBuffer(m_dead_list_buffer);
         rhi->destroyBuffer(m_particle_component_res_buffer);
+
+        if (m_cpu_upload_buffer)
+        {
+            rhi->freeMemory(m_cpu_upload_memory);
+            rhi->destroyBuffer(m_cpu_upload_buffer);
+            m_cpu_upload_mapped   = nullptr;
+            m_cpu_upload_capacity = 0;
+        }
     }
 
     void ParticlePass::copyNormalAndDepthImage()
@@ -48,18 +68,22 @@ namespace Piccolo
         uint8_t index =
             (m_rhi->getCurrentFrameIndex() + m_rhi->getMaxFramesInFlight() - 1) % m_rhi->getMaxFramesInFlight();
 
-        m_rhi->waitForFencesPFN(1, &(m_rhi->getFenceList()[index]), VK_TRUE, UINT64_MAX);
+        // the command buffers of this slot were last used max frames in flight ago, the fence is signaled already
+        // unless the gpu is that far behind
+        m_rhi->waitForFencesPFN(1, &m_compute_fences[index], VK_TRUE, UINT64_MAX);
+
+        RHICommandBuffer* copy_command_buffer = m_copy_command_buffers[index];
 
         RHICommandBufferBeginInfo command_buffer_begin_info {};
         command_buffer_begin_info.sType            = RHI_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
         command_buffer_begin_info.flags            = 0;
         command_buffer_begin_info.pInheritanceInfo = nullptr;
 
-        bool res_begin_command_buffer = m_rhi->beginCommandBufferPFN(m_copy_command_buffer, &command_buffer_begin_info);
+        bool res_begin_command_buffer = m_rhi->beginCommandBufferPFN(copy_command_buffer, &command_buffer_begin_info);
         assert(RHI_SUCCESS == res_begin_command_buffer);
 
         float color[4] = {1.0f, 1.0f, 1.0f, 1.0f};
-        m_rhi->pushEvent(m_copy_command_buffer, "Copy Depth Image for Particle", color);
+        m_rhi->pushEvent(copy_command_buffer, "Copy Depth Image for Particle", color);
 
         // depth image
         RHIImageSubresourceRange subresourceRange = {RHI_IMAGE_ASPECT_DEPTH_BIT, 0, 1, 0, 1};
@@ -75,7 +99,7 @@ namespace Piccolo
             imagememorybarrier.dstAccessMask = RHI_ACCESS_TRANSFER_WRITE_BIT;
             imagememorybarrier.image         = m_dst_depth_image;
 
-            m_rhi->cmdPipelineBarrier(m_copy_command_buffer,
+            m_rhi->cmdPipelineBarrier(copy_command_buffer,
                                       RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                       RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                       0,
@@ -92,7 +116,7 @@ namespace Piccolo
             imagememorybarrier.dstAccessMask = RHI_ACCESS_TRANSFER_READ_BIT;
             imagememorybarrier.image         = m_src_depth_image;
 
-            m_rhi->cmdPipelineBarrier(m_copy_command_buffer,
+            m_rhi->cmdPipelineBarrier(copy_command_buffer,
                                       RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                       RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                       0,
@@ -103,7 +127,7 @@ namespace Piccolo
                                       1,
                                       &imagememorybarrier);
 
-            m_rhi->cmdCopyImageToImage(m_copy_command_buffer,
+            m_rhi->cmdCopyImageToImage(copy_command_buffer,
                                        m_src_depth_image,
                                        RHI_IMAGE_ASPECT_DEPTH_BIT,
                                        m_dst_depth_image,
@@ -117,7 +141,7 @@ namespace Piccolo
             imagememorybarrier.dstAccessMask =
                 RHI_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | RHI_ACCESS_SHADER_READ_BIT;
 
-            m_rhi->cmdPipelineBarrier(m_copy_command_buffer,
+            m_rhi->cmdPipelineBarrier(copy_command_buffer,
                                       RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                       RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                       0,
@@ -134,7 +158,7 @@ namespace Piccolo
             imagememorybarrier.srcAccessMask = RHI_ACCESS_TRANSFER_WRITE_BIT;
             imagememorybarrier.dstAccessMask = RHI_ACCESS_SHADER_READ_BIT;
 
-            m_rhi->cmdPipelineBarrier(m_copy_command_buffer,
+            m_rhi->cmdPipelineBarrier(copy_command_buffer,
                                       RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                       RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                       0,
@@ -146,9 +170,9 @@ namespace Piccolo
                                       &imagememorybarrier);
         }
 
-        m_rhi->popEvent(m_copy_command_buffer); // end depth image copy label
+        m_rhi->popEvent(copy_command_buffer); // end depth image copy label
 
-        m_rhi->pushEvent(m_copy_command_buffer, "Copy Normal Image for Particle", color);
+        m_rhi->pushEvent(copy_command_buffer, "Copy Normal Image for Particle", color);
 
         // color image
         subresourceRange                    = {RHI_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
@@ -160,7 +184,7 @@ namespace Piccolo
             imagememorybarrier.dstAccessMask = RHI_ACCESS_TRANSFER_WRITE_BIT;
             imagememorybarrier.image         = m_dst_normal_image;
 
-            m_rhi->cmdPipelineBarrier(m_copy_command_buffer,
+            m_rhi->cmdPipelineBarrier(copy_command_buffer,
                                       RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                       RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                       0,
@@ -177,7 +201,7 @@ namespace Piccolo
             imagememorybarrier.dstAccessMask = RHI_ACCESS_TRANSFER_READ_BIT;
             imagememorybarrier.image         = m_src_normal_image;
 
-            m_rhi->cmdPipelineBarrier(m_copy_command_buffer,
+            m_rhi->cmdPipelineBarrier(copy_command_buffer,
                                       RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                       RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                       0,
@@ -188,7 +212,7 @@ namespace Piccolo
                                       1,
                                       &imagememorybarrier);
 
-            m_rhi->cmdCopyImageToImage(m_copy_command_buffer,
+            m_rhi->cmdCopyImageToImage(copy_command_buffer,
                                        m_src_normal_image,
                                        RHI_IMAGE_ASPECT_COLOR_BIT,
                                        m_dst_normal_image,
@@ -201,7 +225,7 @@ namespace Piccolo
             imagememorybarrier.srcAccessMask = RHI_ACCESS_TRANSFER_WRITE_BIT;
             imagememorybarrier.dstAccessMask = RHI_ACCESS_COLOR_ATTACHMENT_READ_BIT | RHI_ACCESS_SHADER_READ_BIT;
 
-            m_rhi->cmdPipelineBarrier(m_copy_command_buffer,
+            m_rhi->cmdPipelineBarrier(copy_command_buffer,
                                       RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                       RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                       0,
@@ -218,7 +242,7 @@ namespace Piccolo
             imagememorybarrier.srcAccessMask = RHI_ACCESS_TRANSFER_WRITE_BIT;
             imagememorybarrier.dstAccessMask = RHI_ACCESS_SHADER_READ_BIT;
 
-            m_rhi->cmdPipelineBarrier(m_copy_command_buffer,
+            m_rhi->cmdPipelineBarrier(copy_command_buffer,
                                       RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                       RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                       0,
@@ -230,33 +254,31 @@ namespace Piccolo
                                       &imagememorybarrier);
         }
 
-        m_rhi->popEvent(m_copy_command_buffer);
+        m_rhi->popEvent(copy_command_buffer);
 
-        bool res_end_command_buffer = m_rhi->endCommandBufferPFN(m_copy_command_buffer);
+        bool res_end_command_buffer = m_rhi->endCommandBufferPFN(copy_command_buffer);
         assert(RHI_SUCCESS == res_end_command_buffer);
 
-        bool res_reset_fences = m_rhi->resetFencesPFN(1, &m_rhi->getFenceList()[index]);
-        assert(RHI_SUCCESS == res_reset_fences);
-
-        RHIPipelineStageFlags wait_stages[] = {RHI_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-        RHISubmitInfo         submit_info   = {};
-        submit_info.sType                   = RHI_STRUCTURE_TYPE_SUBMIT_INFO;
-        submit_info.waitSemaphoreCount      = 1;
-        submit_info.pWaitSemaphores         = &(m_rhi->getTextureCopySemaphore(index));
-        submit_info.pWaitDstStageMask       = wait_stages;
-        submit_info.commandBufferCount      = 1;
-        submit_info.pCommandBuffers         = &m_copy_command_buffer;
-        submit_info.signalSemaphoreCount    = 0;
-        submit_info.pSignalSemaphores       = nullptr;
-        bool res_queue_submit =
-            m_rhi->queueSubmit(m_rhi->getGraphicsQueue(), 1, &submit_info, m_rhi->getFenceList()[index]);
+        RHIPipelineStageFlags wait_stages[]       = {RHI_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
+        const RHISemaphore*   signal_semaphores[] = {m_copy_finished_semaphores[index]};
+        RHISubmitInfo         submit_info         = {};
+        submit_info.sType                         = RHI_STRUCTURE_TYPE_SUBMIT_INFO;
+        submit_info.waitSemaphoreCount            = 1;
+        submit_info.pWaitSemaphores               = &(m_rhi->getTextureCopySemaphore(index));
+        submit_info.pWaitDstStageMask             = wait_stages;
+        submit_info.commandBufferCount            = 1;
+        submit_info.pCommandBuffers               = &copy_command_buffer;
+        submit_info.signalSemaphoreCount          = 1;
+        submit_info.pSignalSemaphores             = signal_semaphores;
+        bool res_queue_submit = m_rhi->queueSubmit(m_rhi->getGraphicsQueue(), 1, &submit_info, nullptr);
         assert(RHI_SUCCESS == res_queue_submit);
-
-        m_rhi->queueWaitIdle(m_rhi->getGraphicsQueue());
     }
 
     void ParticlePass::updateAfterFramebufferRecreate()
     {
+        // the simulation still in flight reads the copied images
+        waitForSimulation();
+
         m_rhi->destroyImage(m_dst_depth_image);
         m_rhi->freeMemory(m_dst_depth_image_memory);
 
@@ -304,10 +326,69 @@ namespace Piccolo
                                m_src_normal_image_view);
 
         updateDescriptorSet();
+
+        if (m_is_half_resolution_enabled)
+        {
+            freeHalfResolutionTarget();
+            setupHalfResolutionTarget();
+        }
+        if (m_sort_state_buffer)
+        {
+            updateSortDescriptorSets();
+        }
+
+        // the half resolution particles are tested against the depth copy, which is only valid after the next copy
+        m_is_drawing_sorted_particles = false;
     }
 
     void ParticlePass::draw()
     {
+        if (m_is_drawing_sorted_particles)
+        {
+            float color[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+            m_rhi->pushEvent(m_render_command_buffer, "ParticleBillboard Sorted", color);
+
+            m_rhi->cmdSetViewportPFN(m_render_command_buffer, 0, 1, m_rhi->getSwapchainInfo().viewport);
+            m_rhi->cmdSetScissorPFN(m_render_command_buffer, 0, 1, m_rhi->getSwapchainInfo().scissor);
+
+            if (m_is_half_resolution_enabled)
+            {
+                // the particles were blended by drawHalfResolution
+                m_rhi->cmdBindPipelinePFN(
+                    m_render_command_buffer, RHI_PIPELINE_BIND_POINT_GRAPHICS, m_composite_pipeline);
+                m_rhi->cmdBindDescriptorSetsPFN(m_render_command_buffer,
+                                                RHI_PIPELINE_BIND_POINT_GRAPHICS,
+                                                m_composite_pipeline_layout,
+                                                0,
+                                                1,
+                                                &m_composite_descriptor_set,
+                                                0,
+                                                NULL);
+                m_rhi->cmdDraw(m_render_command_buffer, 3, 1, 0, 0);
+            }
+            else
+            {
+                m_rhi->cmdBindPipelinePFN(
+                    m_render_command_buffer, RHI_PIPELINE_BIND_POINT_GRAPHICS, m_sorted_billboard_pipeline);
+                m_rhi->cmdBindDescriptorSetsPFN(m_render_command_buffer,
+                                                RHI_PIPELINE_BIND_POINT_GRAPHICS,
+                                                m_sorted_billboard_pipeline_layout,
+                                                0,
+                                                1,
+                                                &m_sorted_billboard_descriptor_set,
+                                                0,
+                                                NULL);
+                m_rhi->cmdDrawIndirect(m_render_command_buffer,
+                                       m_sort_state_buffer,
+                                       offsetof(ParticleSortState, draw_argument),
+                                       1,
+                                       sizeof(uvec4));
+            }
+
+            m_rhi->popEvent(m_render_command_buffer);
+            return;
+        }
+
         for (int i = 0; i < m_emitter_count; ++i)
         {
             float color[4] = {1.0f, 1.0f, 1.0f, 1.0f};
@@ -326,7 +407,19 @@ namespace Piccolo
                                             0,
                                             NULL);
 
-            m_rhi->cmdDraw(m_render_command_buffer, 4, m_emitter_buffer_batches[i].m_num_particle, 0, 0);
+            // the instance count is written by the simulation of the previous frame
+            if (m_is_drawing_cpu_particles)
+            {
+                m_rhi->cmdDraw(m_render_command_buffer, 4, m_emitter_buffer_batches[i].m_num_particle, 0, 0);
+            }
+            else
+            {
+                m_rhi->cmdDrawIndirect(m_render_command_buffer,
+                                       m_emitter_buffer_batches[i].m_indirect_dispatch_argument_buffer,
+                                       s_argument_offset_draw,
+                                       1,
+                                       sizeof(uvec4));
+            }
 
             m_rhi->popEvent(m_render_command_buffer);
         }
@@ -424,8 +517,9 @@ namespace Piccolo
             particlebillboard_perframe_storage_buffer_info.buffer = m_particle_billboard_uniform_buffer;
 
             RHIDescriptorBufferInfo particlebillboard_perdrawcall_storage_buffer_info = {};
-            particlebillboard_perdrawcall_storage_buffer_info.offset                  = 0;
-            particlebillboard_perdrawcall_storage_buffer_info.range                   = RHI_WHOLE_SIZE;
+            particlebillboard_perdrawcall_storage_buffer_info.offset =
+                m_emitter_buffer_batches[eid].m_position_render_offset;
+            particlebillboard_perdrawcall_storage_buffer_info.range = sizeof(Particle) * s_max_particles;
             particlebillboard_perdrawcall_storage_buffer_info.buffer =
                 m_emitter_buffer_batches[eid].m_position_render_buffer;
 
@@ -491,13 +585,47 @@ namespace Piccolo
 
     void ParticlePass::setEmitterCount(int count)
     {
+        waitForSimulation();
+
         for (int i = 0; i < m_emitter_buffer_batches.size(); ++i)
         {
             m_emitter_buffer_batches[i].freeUpBatch(m_rhi);
         }
 
+        freeSortBuffers();
+        if (m_particle_render_buffer)
+        {
+            m_rhi->freeMemory(m_particle_render_memory);
+            m_rhi->destroyBuffer(m_particle_render_buffer);
+            m_particle_render_buffer = nullptr;
+        }
+
         m_emitter_count = count;
         m_emitter_buffer_batches.resize(m_emitter_count);
+        if (m_emitter_count == 0)
+        {
+            return;
+        }
+
+        // the emitter ranges are bound as storage buffers, the offsets have to stay aligned
+        static_assert(sizeof(Particle) * s_max_particles % 256 == 0, "misaligned emitter render buffer range");
+        m_rhi->createBufferAndInitialize(RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT | RHI_BUFFER_USAGE_TRANSFER_SRC_BIT |
+                                             RHI_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                         RHI_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                         m_particle_render_buffer,
+                                         m_particle_render_memory,
+                                         sizeof(Particle) * s_max_particles * m_emitter_count);
+
+        for (int i = 0; i < m_emitter_count; ++i)
+        {
+            m_emitter_buffer_batches[i].m_position_render_buffer = m_particle_render_buffer;
+            m_emitter_buffer_batches[i].m_position_render_offset = sizeof(Particle) * s_max_particles * i;
+        }
+
+        if (m_is_sort_enabled)
+        {
+            setupSortBuffers();
+        }
     }
 
     void ParticlePass::createEmitter(int id, const ParticleEmitterDesc& desc)
@@ -523,7 +651,9 @@ namespace Piccolo
             const VkDeviceSize      indirectArgumentSize = sizeof(IndirectArgumemt);
             struct IndirectArgumemt indirectargument     = {};
             indirectargument.alive_flap_bit              = 1;
-            m_rhi->createBufferAndInitialize(RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT | RHI_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+            indirectargument.draw_argument               = {4, m_emitter_buffer_batches[id].m_num_particle, 0, 0};
+            m_rhi->createBufferAndInitialize(RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT | RHI_BUFFER_USAGE_TRANSFER_DST_BIT |
+                                                 RHI_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
                                              RHI_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
                                              m_emitter_buffer_batches[id].m_indirect_dispatch_argument_buffer,
                                              m_emitter_buffer_batches[id].m_indirect_dispatch_argument_memory,
@@ -567,23 +697,32 @@ namespace Piccolo
         RHIFence*       fence = nullptr;
         ParticleCounter counterNext {};
         {
+            // one slot per frame in flight, kept mapped for the delayed read back of the simulation
             m_rhi->createBufferAndInitialize(RHI_BUFFER_USAGE_TRANSFER_SRC_BIT | RHI_BUFFER_USAGE_TRANSFER_DST_BIT,
-                                             RHI_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+                                             RHI_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                                 RHI_MEMORY_PROPERTY_HOST_COHERENT_BIT,
                                              m_emitter_buffer_batches[id].m_counter_host_buffer,
                                              m_emitter_buffer_batches[id].m_counter_host_memory,
-                                             counterBufferSize,
+                                             counterBufferSize * m_rhi->getMaxFramesInFlight(),
                                              &counter,
                                              sizeof(counter));
 
-            // Flush writes to host visible buffer
-            void* mapped;
-
-            m_rhi->mapMemory(m_emitter_buffer_batches[id].m_counter_host_memory, 0, RHI_WHOLE_SIZE, 0, &mapped);
-
-            m_rhi->flushMappedMemoryRanges(
-                nullptr, m_emitter_buffer_batches[id].m_counter_host_memory, 0, RHI_WHOLE_SIZE);
+            if (RHI_SUCCESS != m_rhi->mapMemory(m_emitter_buffer_batches[id].m_counter_host_memory,
+                                                0,
+                                                RHI_WHOLE_SIZE,
+                                                0,
+                                                &m_emitter_buffer_batches[id].m_counter_host_mapped))
+            {
+                throw std::runtime_error("map counter host buffer");
+            }
 
-            m_rhi->unmapMemory(m_emitter_buffer_batches[id].m_counter_host_memory);
+            for (uint32_t i = 0; i < m_rhi->getMaxFramesInFlight(); ++i)
+            {
+                memcpy(reinterpret_cast<char*>(m_emitter_buffer_batches[id].m_counter_host_mapped) +
+                           counterBufferSize * i,
+                       &counter,
+                       sizeof(counter));
+            }
 
             m_rhi->createBufferAndInitialize(RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT | RHI_BUFFER_USAGE_TRANSFER_SRC_BIT |
                                                  RHI_BUFFER_USAGE_TRANSFER_DST_BIT,
@@ -699,13 +838,6 @@ namespace Piccolo
                                              m_emitter_buffer_batches[id].m_position_device_memory,
                                              staggingBuferSize);
 
-            m_rhi->createBufferAndInitialize(RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT | RHI_BUFFER_USAGE_TRANSFER_SRC_BIT |
-                                                 RHI_BUFFER_USAGE_TRANSFER_DST_BIT,
-                                             RHI_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                                             m_emitter_buffer_batches[id].m_position_render_buffer,
-                                             m_emitter_buffer_batches[id].m_position_render_memory,
-                                             staggingBuferSize);
-
             // Copy to staging buffer
             RHICommandBufferAllocateInfo cmdBufAllocateInfo {};
             cmdBufAllocateInfo.sType              = RHI_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
@@ -772,6 +904,11 @@ namespace Piccolo
         allocateDescriptorSet();
         updateDescriptorSet();
         setupParticleDescriptorSet();
+
+        if (m_sort_state_buffer)
+        {
+            updateSortDescriptorSets();
+        }
     }
 
     void ParticlePass::setupParticlePass()
@@ -781,21 +918,66 @@ namespace Piccolo
         setupPipelines();
         setupAttachments();
 
+        const GlobalParticleRes& global_res = m_particle_manager->getGlobalParticleRes();
+        m_is_sort_enabled                   = global_res.m_enable_depth_sort;
+        m_is_half_resolution_enabled        = m_is_sort_enabled && global_res.m_enable_half_resolution;
+        if (m_is_sort_enabled)
+        {
+            if (m_is_half_resolution_enabled)
+            {
+                setupHalfResolutionRenderPass();
+            }
+            setupSortResources();
+            setupSortPipelines();
+            if (m_is_half_resolution_enabled)
+            {
+                setupHalfResolutionTarget();
+            }
+        }
+
+        uint32_t frame_count = m_rhi->getMaxFramesInFlight();
+        m_compute_command_buffers.resize(frame_count);
+        m_copy_command_buffers.resize(frame_count);
+        m_copy_finished_semaphores.resize(frame_count);
+        m_simulate_finished_semaphores.resize(frame_count);
+        m_compute_fences.resize(frame_count);
+
         RHICommandBufferAllocateInfo cmdBufAllocateInfo {};
         cmdBufAllocateInfo.sType              = RHI_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
         cmdBufAllocateInfo.commandPool        = m_rhi->getCommandPoor();
         cmdBufAllocateInfo.level              = RHI_COMMAND_BUFFER_LEVEL_PRIMARY;
         cmdBufAllocateInfo.commandBufferCount = 1;
-        if (RHI_SUCCESS != m_rhi->allocateCommandBuffers(&cmdBufAllocateInfo, m_compute_command_buffer))
-            throw std::runtime_error("alloc compute command buffer");
-        if (RHI_SUCCESS != m_rhi->allocateCommandBuffers(&cmdBufAllocateInfo, m_copy_command_buffer))
-            throw std::runtime_error("alloc copy command buffer");
 
+        RHISemaphoreCreateInfo semaphoreCreateInfo {};
+        semaphoreCreateInfo.sType = RHI_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+        // signaled, so that the first wait of each slot does not block
         RHIFenceCreateInfo fenceCreateInfo {};
         fenceCreateInfo.sType = RHI_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-        fenceCreateInfo.flags = 0;
-        if (RHI_SUCCESS != m_rhi->createFence(&fenceCreateInfo, m_fence))
-            throw std::runtime_error("create fence");
+        fenceCreateInfo.flags = RHI_FENCE_CREATE_SIGNALED_BIT;
+
+        for (uint32_t i = 0; i < frame_count; ++i)
+        {
+            if (RHI_SUCCESS != m_rhi->allocateCommandBuffers(&cmdBufAllocateInfo, m_compute_command_buffers[i]))
+                throw std::runtime_error("alloc compute command buffer");
+            if (RHI_SUCCESS != m_rhi->allocateCommandBuffers(&cmdBufAllocateInfo, m_copy_command_buffers[i]))
+                throw std::runtime_error("alloc copy command buffer");
+            if (RHI_SUCCESS != m_rhi->createSemaphore(&semaphoreCreateInfo, m_copy_finished_semaphores[i]) ||
+                RHI_SUCCESS != m_rhi->createSemaphore(&semaphoreCreateInfo, m_simulate_finished_semaphores[i]))
+                throw std::runtime_error("create semaphore");
+            if (RHI_SUCCESS != m_rhi->createFence(&fenceCreateInfo, m_compute_fences[i]))
+                throw std::runtime_error("create fence");
+        }
+    }
+
+    void ParticlePass::waitForSimulation()
+    {
+        // the simulation of a frame finishes after its copy, which finishes after the rendering of the frame
+        if (!m_compute_fences.empty())
+        {
+            m_rhi->waitForFencesPFN(
+                static_cast<uint32_t>(m_compute_fences.size()), m_compute_fences.data(), RHI_TRUE, UINT64_MAX);
+        }
     }
 
     void ParticlePass::initialize(const RenderPassInitInfo* init_info)
@@ -1364,7 +1546,9 @@ namespace Piccolo
                 }
 
                 RHIDescriptorBufferInfo positionRenderbufferDescriptor = {
-                    m_emitter_buffer_batches[eid].m_position_render_buffer, 0, RHI_WHOLE_SIZE};
+                    m_emitter_buffer_batches[eid].m_position_render_buffer,
+                    m_emitter_buffer_batches[eid].m_position_render_offset,
+                    sizeof(Particle) * s_max_particles};
                 {
                     RHIWriteDescriptorSet& descriptorset = computeWriteDescriptorSets[9];
                     descriptorset.sType                  = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
@@ -1494,25 +1678,76 @@ namespace Piccolo
 
     void ParticlePass::simulate()
     {
+        uint8_t index =
+            (m_rhi->getCurrentFrameIndex() + m_rhi->getMaxFramesInFlight() - 1) % m_rhi->getMaxFramesInFlight();
+
+        // the counters of this slot were copied max frames in flight ago, the copy has waited for their fence
         for (auto i : m_emitter_tick_indices)
         {
-            RHICommandBufferBeginInfo cmdBufInfo {};
-            cmdBufInfo.sType = RHI_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            ParticleCounter counterNext {};
+            memcpy(&counterNext,
+                   reinterpret_cast<char*>(m_emitter_buffer_batches[i].m_counter_host_mapped) +
+                       sizeof(ParticleCounter) * index,
+                   sizeof(ParticleCounter));
 
-            // particle compute pass
-            if (RHI_SUCCESS != m_rhi->beginCommandBuffer(m_compute_command_buffer, &cmdBufInfo))
-            {
-                throw std::runtime_error("begin command buffer");
-            }
+            if constexpr (s_verbose_particle_alive_info)
+                LOG_INFO("{} {} {} {}",
+                         counterNext.dead_count,
+                         counterNext.alive_count,
+                         counterNext.alive_count_after_sim,
+                         counterNext.emit_count);
+            m_emitter_buffer_batches[i].m_num_particle = counterNext.alive_count_after_sim;
+        }
 
-            float color[4] = {1.0f, 1.0f, 1.0f, 1.0f};
-            m_rhi->pushEvent(m_compute_command_buffer, "Particle compute", color);
-            m_rhi->pushEvent(m_compute_command_buffer, "Particle Kickoff", color);
+        RHICommandBuffer* compute_command_buffer = m_compute_command_buffers[index];
+
+        RHICommandBufferBeginInfo cmdBufInfo {};
+        cmdBufInfo.sType = RHI_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+
+        // particle compute pass, all the ticked emitters in one submission
+        if (RHI_SUCCESS != m_rhi->beginCommandBuffer(compute_command_buffer, &cmdBufInfo))
+        {
+            throw std::runtime_error("begin command buffer");
+        }
+
+        float color[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+        m_rhi->pushEvent(compute_command_buffer, "Particle compute", color);
+
+        // the simulation of the previous frame ran on the same queue
+        RHIMemoryBarrier memoryBarrier {};
+        memoryBarrier.sType         = RHI_STRUCTURE_TYPE_MEMORY_BARRIER;
+        memoryBarrier.srcAccessMask = RHI_ACCESS_SHADER_WRITE_BIT | RHI_ACCESS_TRANSFER_WRITE_BIT;
+        memoryBarrier.dstAccessMask =
+            RHI_ACCESS_SHADER_READ_BIT | RHI_ACCESS_SHADER_WRITE_BIT | RHI_ACCESS_INDIRECT_COMMAND_READ_BIT;
+
+        m_rhi->cmdPipelineBarrier(compute_command_buffer,
+                                  RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT | RHI_PIPELINE_STAGE_TRANSFER_BIT,
+                                  RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT | RHI_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+                                  0,
+                                  1,
+                                  &memoryBarrier,
+                                  0,
+                                  nullptr,
+                                  0,
+                                  nullptr);
+
+        // the emitters were simulated by the logic tick, the compute passes are skipped
+        m_is_drawing_cpu_particles    = m_particle_manager->isCpuSimulationEnabled();
+        m_is_drawing_sorted_particles = m_sort_state_buffer != nullptr;
+        if (m_is_drawing_cpu_particles)
+        {
+            uploadCpuParticles(compute_command_buffer, index);
+            m_emitter_tick_indices.clear();
+        }
+
+        for (auto i : m_emitter_tick_indices)
+        {
+            m_rhi->pushEvent(compute_command_buffer, "Particle Kickoff", color);
 
-            m_rhi->cmdBindPipelinePFN(m_compute_command_buffer, RHI_PIPELINE_BIND_POINT_COMPUTE, m_kickoff_pipeline);
+            m_rhi->cmdBindPipelinePFN(compute_command_buffer, RHI_PIPELINE_BIND_POINT_COMPUTE, m_kickoff_pipeline);
             RHIDescriptorSet* descriptorsets[2] = {m_descriptor_infos[i * 3].descriptor_set,
                                                    m_descriptor_infos[i * 3 + 1].descriptor_set};
-            m_rhi->cmdBindDescriptorSetsPFN(m_compute_command_buffer,
+            m_rhi->cmdBindDescriptorSetsPFN(compute_command_buffer,
                                             RHI_PIPELINE_BIND_POINT_COMPUTE,
                                             m_render_pipelines[0].layout,
                                             0,
@@ -1521,10 +1756,9 @@ namespace Piccolo
                                             0,
                                             0);
 
+            m_rhi->cmdDispatch(compute_command_buffer, 1, 1, 1);
 
-            m_rhi->cmdDispatch(m_compute_command_buffer, 1, 1, 1);
-
-            m_rhi->popEvent(m_compute_command_buffer); // end particle kickoff label
+            m_rhi->popEvent(compute_command_buffer); // end particle kickoff label
 
             RHIBufferMemoryBarrier bufferBarrier {};
             bufferBarrier.sType               = RHI_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
@@ -1535,7 +1769,7 @@ namespace Piccolo
             bufferBarrier.srcQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
             bufferBarrier.dstQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
 
-            m_rhi->cmdPipelineBarrier(m_compute_command_buffer,
+            m_rhi->cmdPipelineBarrier(compute_command_buffer,
                                       RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
                                       RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                       0,
@@ -1553,7 +1787,7 @@ namespace Piccolo
             bufferBarrier.srcQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
             bufferBarrier.dstQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
 
-            m_rhi->cmdPipelineBarrier(m_compute_command_buffer,
+            m_rhi->cmdPipelineBarrier(compute_command_buffer,
                                       RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
                                       RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                       0,
@@ -1564,15 +1798,15 @@ namespace Piccolo
                                       0,
                                       nullptr);
 
-            m_rhi->pushEvent(m_compute_command_buffer, "Particle Emit", color);
+            m_rhi->pushEvent(compute_command_buffer, "Particle Emit", color);
 
-            m_rhi->cmdBindPipelinePFN(m_compute_command_buffer, RHI_PIPELINE_BIND_POINT_COMPUTE, m_emit_pipeline);
+            m_rhi->cmdBindPipelinePFN(compute_command_buffer, RHI_PIPELINE_BIND_POINT_COMPUTE, m_emit_pipeline);
 
-            m_rhi->cmdDispatchIndirect(m_compute_command_buffer,
+            m_rhi->cmdDispatchIndirect(compute_command_buffer,
                                        m_emitter_buffer_batches[i].m_indirect_dispatch_argument_buffer,
                                        s_argument_offset_emit);
 
-            m_rhi->popEvent(m_compute_command_buffer); // end particle emit label
+            m_rhi->popEvent(compute_command_buffer); // end particle emit label
 
             bufferBarrier.buffer              = m_emitter_buffer_batches[i].m_position_device_buffer;
             bufferBarrier.size                = RHI_WHOLE_SIZE;
@@ -1581,7 +1815,7 @@ namespace Piccolo
             bufferBarrier.srcQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
             bufferBarrier.dstQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
 
-            m_rhi->cmdPipelineBarrier(m_compute_command_buffer,
+            m_rhi->cmdPipelineBarrier(compute_command_buffer,
                                       RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
                                       RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                       0,
@@ -1599,7 +1833,7 @@ namespace Piccolo
             bufferBarrier.srcQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
             bufferBarrier.dstQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
 
-            m_rhi->cmdPipelineBarrier(m_compute_command_buffer,
+            m_rhi->cmdPipelineBarrier(compute_command_buffer,
                                       RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
                                       RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                       0,
@@ -1617,7 +1851,7 @@ namespace Piccolo
             bufferBarrier.srcQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
             bufferBarrier.dstQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
 
-            m_rhi->cmdPipelineBarrier(m_compute_command_buffer,
+            m_rhi->cmdPipelineBarrier(compute_command_buffer,
                                       RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
                                       RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                       0,
@@ -1635,7 +1869,7 @@ namespace Piccolo
             bufferBarrier.srcQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
             bufferBarrier.dstQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
 
-            m_rhi->cmdPipelineBarrier(m_compute_command_buffer,
+            m_rhi->cmdPipelineBarrier(compute_command_buffer,
                                       RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
                                       RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                       0,
@@ -1653,7 +1887,7 @@ namespace Piccolo
             bufferBarrier.srcQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
             bufferBarrier.dstQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
 
-            m_rhi->cmdPipelineBarrier(m_compute_command_buffer,
+            m_rhi->cmdPipelineBarrier(compute_command_buffer,
                                       RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
                                       RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                       0,
@@ -1671,7 +1905,7 @@ namespace Piccolo
             bufferBarrier.srcQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
             bufferBarrier.dstQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
 
-            m_rhi->cmdPipelineBarrier(m_compute_command_buffer,
+            m_rhi->cmdPipelineBarrier(compute_command_buffer,
                                       RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
                                       RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                                       0,
@@ -1682,43 +1916,16 @@ namespace Piccolo
                                       0,
                                       nullptr);
 
-            m_rhi->pushEvent(m_compute_command_buffer, "Particle Simulate", color);
+            m_rhi->pushEvent(compute_command_buffer, "Particle Simulate", color);
 
-            m_rhi->cmdBindPipelinePFN(m_compute_command_buffer, RHI_PIPELINE_BIND_POINT_COMPUTE, m_simulate_pipeline);
-            m_rhi->cmdDispatchIndirect(m_compute_command_buffer,
+            m_rhi->cmdBindPipelinePFN(compute_command_buffer, RHI_PIPELINE_BIND_POINT_COMPUTE, m_simulate_pipeline);
+            m_rhi->cmdDispatchIndirect(compute_command_buffer,
                                        m_emitter_buffer_batches[i].m_indirect_dispatch_argument_buffer,
                                        s_argument_offset_simulate);
 
-            m_rhi->popEvent(m_compute_command_buffer); // end particle simulate label
-
-            if (RHI_SUCCESS != m_rhi->endCommandBuffer(m_compute_command_buffer))
-            {
-                throw std::runtime_error("end command buffer");
-            }
-            m_rhi->resetFencesPFN(1, &m_fence);
-
-            RHISubmitInfo computeSubmitInfo {};
-            computeSubmitInfo.sType              = RHI_STRUCTURE_TYPE_SUBMIT_INFO;
-            computeSubmitInfo.pWaitDstStageMask  = 0;
-            computeSubmitInfo.commandBufferCount = 1;
-            computeSubmitInfo.pCommandBuffers    = &m_compute_command_buffer;
+            m_rhi->popEvent(compute_command_buffer); // end particle simulate label
 
-            if (RHI_SUCCESS != m_rhi->queueSubmit(m_rhi->getComputeQueue(), 1, &computeSubmitInfo, m_fence))
-            {
-                throw std::runtime_error("compute queue submit");
-            }
-
-            if (RHI_SUCCESS != m_rhi->waitForFencesPFN(1, &m_fence, RHI_TRUE, UINT64_MAX))
-            {
-                throw std::runtime_error("wait for fence");
-            }
-
-            if (RHI_SUCCESS != m_rhi->beginCommandBuffer(m_compute_command_buffer, &cmdBufInfo))
-            {
-                throw std::runtime_error("begin command buffer");
-            }
-
-            m_rhi->pushEvent(m_compute_command_buffer, "Copy Particle Counter Buffer", color);
+            m_rhi->pushEvent(compute_command_buffer, "Copy Particle Counter Buffer", color);
 
             // Barrier to ensure that shader writes are finished before buffer is read back from GPU
             bufferBarrier.srcAccessMask       = RHI_ACCESS_SHADER_WRITE_BIT;
@@ -1728,7 +1935,7 @@ namespace Piccolo
             bufferBarrier.srcQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
             bufferBarrier.dstQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
 
-            m_rhi->cmdPipelineBarrier(m_compute_command_buffer,
+            m_rhi->cmdPipelineBarrier(compute_command_buffer,
                                       RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
                                       RHI_PIPELINE_STAGE_TRANSFER_BIT,
                                       0,
@@ -1738,19 +1945,30 @@ namespace Piccolo
                                       &bufferBarrier,
                                       0,
                                       nullptr);
-            // Read back to host visible buffer
 
+            // Read back to the slot of this frame, the host reads it max frames in flight later
             RHIBufferCopy copyRegion {};
             copyRegion.srcOffset = 0;
-            copyRegion.dstOffset = 0;
+            copyRegion.dstOffset = sizeof(ParticleCounter) * index;
             copyRegion.size      = sizeof(ParticleCounter);
 
-            m_rhi->cmdCopyBuffer(m_compute_command_buffer,
+            m_rhi->cmdCopyBuffer(compute_command_buffer,
                                  m_emitter_buffer_batches[i].m_counter_device_buffer,
                                  m_emitter_buffer_batches[i].m_counter_host_buffer,
                                  1,
                                  &copyRegion);
 
+            // the alive count becomes the instance count of the billboard draw
+            copyRegion.srcOffset = offsetof(ParticleCounter, alive_count_after_sim);
+            copyRegion.dstOffset = s_argument_offset_draw + offsetof(uvec4, y);
+            copyRegion.size      = sizeof(uint32_t);
+
+            m_rhi->cmdCopyBuffer(compute_command_buffer,
+                                 m_emitter_buffer_batches[i].m_counter_device_buffer,
+                                 m_emitter_buffer_batches[i].m_indirect_dispatch_argument_buffer,
+                                 1,
+                                 &copyRegion);
+
             // Barrier to ensure that buffer copy is finished before host reading from it
             bufferBarrier.srcAccessMask       = RHI_ACCESS_TRANSFER_WRITE_BIT;
             bufferBarrier.dstAccessMask       = RHI_ACCESS_HOST_READ_BIT;
@@ -1759,7 +1977,7 @@ namespace Piccolo
             bufferBarrier.srcQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
             bufferBarrier.dstQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
 
-            m_rhi->cmdPipelineBarrier(m_compute_command_buffer,
+            m_rhi->cmdPipelineBarrier(compute_command_buffer,
                                       RHI_PIPELINE_STAGE_TRANSFER_BIT,
                                       RHI_PIPELINE_STAGE_HOST_BIT,
                                       0,
@@ -1770,58 +1988,114 @@ namespace Piccolo
                                       0,
                                       nullptr);
 
-            m_rhi->popEvent(m_compute_command_buffer); // end particle counter copy label
+            m_rhi->popEvent(compute_command_buffer); // end particle counter copy label
+        }
 
-            m_rhi->popEvent(m_compute_command_buffer); // end particle compute label
+        if (m_is_drawing_sorted_particles)
+        {
+            sortParticles(compute_command_buffer, index);
+        }
 
-            if (RHI_SUCCESS != m_rhi->endCommandBuffer(m_compute_command_buffer))
-            {
-                throw std::runtime_error("end command buffer");
-            }
+        m_rhi->popEvent(compute_command_buffer); // end particle compute label
+
+        if (RHI_SUCCESS != m_rhi->endCommandBuffer(compute_command_buffer))
+        {
+            throw std::runtime_error("end command buffer");
+        }
+
+        // submitted even without ticked emitters, the semaphores of the frame have to be consumed and signaled
+        m_rhi->resetFencesPFN(1, &m_compute_fences[index]);
+
+        RHIPipelineStageFlags waitStageMask = RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT | RHI_PIPELINE_STAGE_TRANSFER_BIT;
+        const RHISemaphore*   signalSemaphores[] = {m_simulate_finished_semaphores[index]};
+        RHISubmitInfo         computeSubmitInfo {};
+        computeSubmitInfo.sType                = RHI_STRUCTURE_TYPE_SUBMIT_INFO;
+        computeSubmitInfo.waitSemaphoreCount   = 1;
+        computeSubmitInfo.pWaitSemaphores      = &m_copy_finished_semaphores[index];
+        computeSubmitInfo.pWaitDstStageMask    = &waitStageMask;
+        computeSubmitInfo.commandBufferCount   = 1;
+        computeSubmitInfo.pCommandBuffers      = &compute_command_buffer;
+        computeSubmitInfo.signalSemaphoreCount = 1;
+        computeSubmitInfo.pSignalSemaphores    = signalSemaphores;
+
+        if (RHI_SUCCESS != m_rhi->queueSubmit(m_rhi->getComputeQueue(), 1, &computeSubmitInfo, m_compute_fences[index]))
+        {
+            throw std::runtime_error("compute queue submit");
+        }
+
+        // the next frame draws the particles from the simulated buffers and the indirect draw arguments
+        m_rhi->addRenderingWaitSemaphore(m_simulate_finished_semaphores[index],
+                                         RHI_PIPELINE_STAGE_DRAW_INDIRECT_BIT | RHI_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+                                             RHI_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+
+        m_emitter_tick_indices.clear();
+        m_emitter_transform_indices.clear();
+    }
+
+    void ParticlePass::uploadCpuParticles(RHICommandBuffer* command_buffer, uint8_t index)
+    {
+        static_assert(sizeof(ParticleRenderData) == sizeof(Particle), "the uploaded particles are drawn as is");
+
+        // the particles of all the emitters are sorted together on the gpu
+        ParticleCpuSimulator* simulator = m_particle_manager->getCpuSimulator();
+        if (!m_is_drawing_sorted_particles)
+        {
+            simulator->sortByViewDepth(g_runtime_global_context.m_render_system->getRenderCamera()->getViewMatrix());
+        }
 
-            // Submit compute work
-            m_rhi->resetFencesPFN(1, &m_fence);
-            computeSubmitInfo                        = {};
-            const VkPipelineStageFlags waitStageMask = RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
-            computeSubmitInfo.sType                  = RHI_STRUCTURE_TYPE_SUBMIT_INFO;
-            computeSubmitInfo.pWaitDstStageMask      = &waitStageMask;
-            computeSubmitInfo.commandBufferCount     = 1;
-            computeSubmitInfo.pCommandBuffers        = &m_compute_command_buffer;
+        float color[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+        m_rhi->pushEvent(command_buffer, "Particle Upload", color);
 
-            if (RHI_SUCCESS != m_rhi->queueSubmit(m_rhi->getComputeQueue(), 1, &computeSubmitInfo, m_fence))
+        for (int i = 0; i < m_emitter_count; ++i)
+        {
+            ParticleEmitterBufferBatch& batch = m_emitter_buffer_batches[i];
+
+            batch.m_num_particle = simulator->getAliveCount(i);
+            if (batch.m_num_particle == 0)
             {
-                throw std::runtime_error("compute queue submit");
+                continue;
             }
 
-            if (RHI_SUCCESS != m_rhi->waitForFencesPFN(1, &m_fence, RHI_TRUE, UINT64_MAX))
+            if (batch.m_num_particle > batch.m_cpu_upload_capacity)
             {
-                throw std::runtime_error("wait for fence");
-            }
+                // the other slots may still be read by the frames in flight
+                waitForSimulation();
 
-            m_rhi->queueWaitIdle(m_rhi->getComputeQueue());
+                if (batch.m_cpu_upload_buffer)
+                {
+                    m_rhi->freeMemory(batch.m_cpu_upload_memory);
+                    m_rhi->destroyBuffer(batch.m_cpu_upload_buffer);
+                }
 
-            // Make device writes visible to the host
-            void* mapped;
-            m_rhi->mapMemory(m_emitter_buffer_batches[i].m_counter_host_memory, 0, RHI_WHOLE_SIZE, 0, &mapped);
+                batch.m_cpu_upload_capacity = std::min(std::max(batch.m_num_particle, batch.m_cpu_upload_capacity * 2),
+                                                       static_cast<uint32_t>(s_max_particles));
+                m_rhi->createBuffer(sizeof(ParticleRenderData) * batch.m_cpu_upload_capacity *
+                                        m_rhi->getMaxFramesInFlight(),
+                                    RHI_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                    RHI_MEMORY_PROPERTY_HOST_VISIBLE_BIT | RHI_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                    batch.m_cpu_upload_buffer,
+                                    batch.m_cpu_upload_memory);
+                if (RHI_SUCCESS !=
+                    m_rhi->mapMemory(batch.m_cpu_upload_memory, 0, RHI_WHOLE_SIZE, 0, &batch.m_cpu_upload_mapped))
+                {
+                    throw std::runtime_error("map particle upload buffer");
+                }
+            }
 
-            m_rhi->invalidateMappedMemoryRanges(
-                nullptr, m_emitter_buffer_batches[i].m_counter_host_memory, 0, RHI_WHOLE_SIZE);
+            RHIDeviceSize slot_offset = sizeof(ParticleRenderData) * batch.m_cpu_upload_capacity * index;
+            char*         slot        = reinterpret_cast<char*>(batch.m_cpu_upload_mapped) + slot_offset;
+            simulator->writeRenderParticles(i, reinterpret_cast<ParticleRenderData*>(slot));
 
-            // Copy to output
-            ParticleCounter counterNext {};
-            memcpy(&counterNext, mapped, sizeof(ParticleCounter));
-            m_rhi->unmapMemory(m_emitter_buffer_batches[i].m_counter_host_memory);
+            RHIBufferCopy copyRegion {};
+            copyRegion.srcOffset = slot_offset;
+            copyRegion.dstOffset = batch.m_position_render_offset;
+            copyRegion.size      = sizeof(ParticleRenderData) * batch.m_num_particle;
 
-            if constexpr (s_verbose_particle_alive_info)
-                LOG_INFO("{} {} {} {}",
-                         counterNext.dead_count,
-                         counterNext.alive_count,
-                         counterNext.alive_count_after_sim,
-                         counterNext.emit_count);
-            m_emitter_buffer_batches[i].m_num_particle = counterNext.alive_count_after_sim;
+            m_rhi->cmdCopyBuffer(
+                command_buffer, batch.m_cpu_upload_buffer, batch.m_position_render_buffer, 1, &copyRegion);
         }
-        m_emitter_tick_indices.clear();
-        m_emitter_transform_indices.clear();
+
+        m_rhi->popEvent(command_buffer); // end particle upload label
     }
 
     void ParticlePass::prepareUniformBuffer()
@@ -1972,4 +2246,859 @@ namespace Piccolo
     {
         m_emitter_transform_indices = transform_indices;
     }
-} // namespace Piccolo
\ No newline at end of file
+
+    void ParticlePass::setupSortResources()
+    {
+        // compute, the state, the pass shift, the particles, the keys and values in and out, the histogram and the
+        // visibility of the binned particles
+        {
+            RHIDescriptorSetLayoutBinding sort_layout_bindings[9] = {};
+            for (uint32_t binding = 0; binding < 9; ++binding)
+            {
+                sort_layout_bindings[binding].binding         = binding;
+                sort_layout_bindings[binding].descriptorType  = RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                sort_layout_bindings[binding].descriptorCount = 1;
+                sort_layout_bindings[binding].stageFlags      = RHI_SHADER_STAGE_COMPUTE_BIT;
+            }
+            sort_layout_bindings[1].descriptorType = RHI_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+
+            RHIDescriptorSetLayoutCreateInfo sort_layout_create_info {};
+            sort_layout_create_info.sType        = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+            sort_layout_create_info.bindingCount = sizeof(sort_layout_bindings) / sizeof(sort_layout_bindings[0]);
+            sort_layout_create_info.pBindings    = sort_layout_bindings;
+
+            if (RHI_SUCCESS != m_rhi->createDescriptorSetLayout(&sort_layout_create_info, m_sort_descriptor_set_layout))
+            {
+                throw std::runtime_error("create particle sort layout");
+            }
+        }
+
+        // particlebillboard_sorted.vert, particlebillboard.frag and particlebillboard_half_resolution.frag
+        {
+            RHIDescriptorSetLayoutBinding billboard_layout_bindings[7] = {};
+            for (uint32_t binding = 0; binding < 7; ++binding)
+            {
+                billboard_layout_bindings[binding].binding         = binding;
+                billboard_layout_bindings[binding].descriptorType  = RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                billboard_layout_bindings[binding].descriptorCount = 1;
+                billboard_layout_bindings[binding].stageFlags      = RHI_SHADER_STAGE_VERTEX_BIT;
+            }
+            billboard_layout_bindings[2].descriptorType = RHI_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            billboard_layout_bindings[2].stageFlags     = RHI_SHADER_STAGE_FRAGMENT_BIT;
+            billboard_layout_bindings[3].descriptorType = RHI_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+            billboard_layout_bindings[6].descriptorType = RHI_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            billboard_layout_bindings[6].stageFlags     = RHI_SHADER_STAGE_FRAGMENT_BIT;
+
+            RHIDescriptorSetLayoutCreateInfo billboard_layout_create_info {};
+            billboard_layout_create_info.sType = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+            billboard_layout_create_info.bindingCount =
+                sizeof(billboard_layout_bindings) / sizeof(billboard_layout_bindings[0]);
+            billboard_layout_create_info.pBindings = billboard_layout_bindings;
+
+            if (RHI_SUCCESS != m_rhi->createDescriptorSetLayout(&billboard_layout_create_info,
+                                                                m_sorted_billboard_descriptor_set_layout))
+            {
+                throw std::runtime_error("create particle sorted billboard layout");
+            }
+        }
+
+        // particle_composite.frag
+        if (m_is_half_resolution_enabled)
+        {
+            RHIDescriptorSetLayoutBinding composite_layout_binding {};
+            composite_layout_binding.binding         = 0;
+            composite_layout_binding.descriptorType  = RHI_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            composite_layout_binding.descriptorCount = 1;
+            composite_layout_binding.stageFlags      = RHI_SHADER_STAGE_FRAGMENT_BIT;
+
+            RHIDescriptorSetLayoutCreateInfo composite_layout_create_info {};
+            composite_layout_create_info.sType        = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+            composite_layout_create_info.bindingCount = 1;
+            composite_layout_create_info.pBindings    = &composite_layout_binding;
+
+            if (RHI_SUCCESS !=
+                m_rhi->createDescriptorSetLayout(&composite_layout_create_info, m_composite_descriptor_set_layout))
+            {
+                throw std::runtime_error("create particle composite layout");
+            }
+        }
+
+        RHIDescriptorSetAllocateInfo descriptor_set_alloc_info {};
+        descriptor_set_alloc_info.sType              = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        descriptor_set_alloc_info.descriptorPool     = m_rhi->getDescriptorPoor();
+        descriptor_set_alloc_info.descriptorSetCount = 1;
+
+        descriptor_set_alloc_info.pSetLayouts = &m_sort_descriptor_set_layout;
+        for (uint32_t i = 0; i < s_sort_descriptor_set_count; ++i)
+        {
+            if (RHI_SUCCESS != m_rhi->allocateDescriptorSets(&descriptor_set_alloc_info, m_sort_descriptor_sets[i]))
+            {
+                throw std::runtime_error("allocate particle sort descriptor set");
+            }
+        }
+
+        descriptor_set_alloc_info.pSetLayouts = &m_sorted_billboard_descriptor_set_layout;
+        if (RHI_SUCCESS !=
+            m_rhi->allocateDescriptorSets(&descriptor_set_alloc_info, m_sorted_billboard_descriptor_set))
+        {
+            throw std::runtime_error("allocate particle sorted billboard descriptor set");
+        }
+
+        if (m_is_half_resolution_enabled)
+        {
+            descriptor_set_alloc_info.pSetLayouts = &m_composite_descriptor_set_layout;
+            if (RHI_SUCCESS != m_rhi->allocateDescriptorSets(&descriptor_set_alloc_info, m_composite_descriptor_set))
+            {
+                throw std::runtime_error("allocate particle composite descriptor set");
+            }
+        }
+
+        // the digit shift of every radix pass, the depth in the low half of the keys and the tile in the high half
+        uint32_t pass_shifts[s_sort_pass_count * s_sort_pass_uniform_stride / sizeof(uint32_t)] = {};
+        for (uint32_t pass = 0; pass < s_sort_pass_count; ++pass)
+        {
+            pass_shifts[pass * s_sort_pass_uniform_stride / sizeof(uint32_t)] = pass * 8;
+        }
+        m_rhi->createBufferAndInitialize(RHI_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                                         RHI_MEMORY_PROPERTY_HOST_VISIBLE_BIT | RHI_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                         m_sort_pass_uniform_buffer,
+                                         m_sort_pass_uniform_memory,
+                                         sizeof(pass_shifts),
+                                         pass_shifts,
+                                         sizeof(pass_shifts));
+    }
+
+    void ParticlePass::setupSortPipelines()
+    {
+        {
+            RHIPipelineLayoutCreateInfo pipeline_layout_create_info {};
+            pipeline_layout_create_info.sType          = RHI_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+            pipeline_layout_create_info.setLayoutCount = 1;
+            pipeline_layout_create_info.pSetLayouts    = &m_sort_descriptor_set_layout;
+
+            if (m_rhi->createPipelineLayout(&pipeline_layout_create_info, m_sort_pipeline_layout) != RHI_SUCCESS)
+            {
+                throw std::runtime_error("create particle sort pipeline layout");
+            }
+
+            pipeline_layout_create_info.pSetLayouts = &m_sorted_billboard_descriptor_set_layout;
+            if (m_rhi->createPipelineLayout(&pipeline_layout_create_info, m_sorted_billboard_pipeline_layout) !=
+                RHI_SUCCESS)
+            {
+                throw std::runtime_error("create particle sorted billboard pipeline layout");
+            }
+
+            if (m_is_half_resolution_enabled)
+            {
+                pipeline_layout_create_info.pSetLayouts = &m_composite_descriptor_set_layout;
+                if (m_rhi->createPipelineLayout(&pipeline_layout_create_info, m_composite_pipeline_layout) !=
+                    RHI_SUCCESS)
+                {
+                    throw std::runtime_error("create particle composite pipeline layout");
+                }
+            }
+        }
+
+        // compute
+        {
+            struct SortPipeline
+            {
+                RHIPipeline*&                     pipeline;
+                const std::vector<unsigned char>& shader_code;
+            } sort_pipelines[] = {{m_sort_keys_pipeline, PARTICLE_SORT_KEYS_COMP},
+                                  {m_sort_kickoff_pipeline, PARTICLE_SORT_KICKOFF_COMP},
+                                  {m_sort_histogram_pipeline, PARTICLE_SORT_HISTOGRAM_COMP},
+                                  {m_sort_scan_pipeline, PARTICLE_SORT_SCAN_COMP},
+                                  {m_sort_scatter_pipeline, PARTICLE_SORT_SCATTER_COMP},
+                                  {m_sort_bin_pipeline, PARTICLE_SORT_BIN_COMP}};
+
+            RHIPipelineShaderStageCreateInfo shader_stage {};
+            shader_stage.sType = RHI_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+            shader_stage.stage = RHI_SHADER_STAGE_COMPUTE_BIT;
+            shader_stage.pName = "main";
+
+            RHIComputePipelineCreateInfo compute_pipeline_create_info {};
+            compute_pipeline_create_info.sType   = RHI_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+            compute_pipeline_create_info.layout  = m_sort_pipeline_layout;
+            compute_pipeline_create_info.pStages = &shader_stage;
+
+            for (SortPipeline& sort_pipeline : sort_pipelines)
+            {
+                shader_stage.module = m_rhi->createShaderModule(sort_pipeline.shader_code);
+                if (RHI_SUCCESS !=
+                    m_rhi->createComputePipelines(nullptr, 1, &compute_pipeline_create_info, sort_pipeline.pipeline))
+                {
+                    throw std::runtime_error("create particle sort pipeline");
+                }
+                m_rhi->destroyShaderModule(shader_stage.module);
+            }
+        }
+
+        // graphics, the sorted billboards in the forward lighting subpass, in the half resolution target and the
+        // composite of the target
+        {
+            RHIShader* vert_shader_module = m_rhi->createShaderModule(PARTICLEBILLBOARD_SORTED_VERT);
+            RHIShader* frag_shader_module = m_rhi->createShaderModule(PARTICLEBILLBOARD_FRAG);
+
+            RHIPipelineShaderStageCreateInfo shader_stages[2] = {};
+            shader_stages[0].sType  = RHI_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+            shader_stages[0].stage  = RHI_SHADER_STAGE_VERTEX_BIT;
+            shader_stages[0].module = vert_shader_module;
+            shader_stages[0].pName  = "main";
+            shader_stages[1].sType  = RHI_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+            shader_stages[1].stage  = RHI_SHADER_STAGE_FRAGMENT_BIT;
+            shader_stages[1].module = frag_shader_module;
+            shader_stages[1].pName  = "main";
+
+            RHIPipelineVertexInputStateCreateInfo vertex_input_state_create_info {};
+            vertex_input_state_create_info.sType = RHI_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+
+            RHIPipelineInputAssemblyStateCreateInfo input_assembly_create_info {};
+            input_assembly_create_info.sType    = RHI_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+            input_assembly_create_info.topology = RHI_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP;
+            input_assembly_create_info.primitiveRestartEnable = RHI_FALSE;
+
+            RHIPipelineViewportStateCreateInfo viewport_state_create_info {};
+            viewport_state_create_info.sType         = RHI_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+            viewport_state_create_info.viewportCount = 1;
+            viewport_state_create_info.pViewports    = m_rhi->getSwapchainInfo().viewport;
+            viewport_state_create_info.scissorCount  = 1;
+            viewport_state_create_info.pScissors     = m_rhi->getSwapchainInfo().scissor;
+
+            RHIPipelineRasterizationStateCreateInfo rasterization_state_create_info {};
+            rasterization_state_create_info.sType = RHI_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+            rasterization_state_create_info.depthClampEnable        = RHI_FALSE;
+            rasterization_state_create_info.rasterizerDiscardEnable = RHI_FALSE;
+            rasterization_state_create_info.polygonMode             = RHI_POLYGON_MODE_FILL;
+            rasterization_state_create_info.lineWidth               = 1.0f;
+            rasterization_state_create_info.cullMode                = RHI_CULL_MODE_NONE;
+            rasterization_state_create_info.frontFace               = RHI_FRONT_FACE_CLOCKWISE;
+            rasterization_state_create_info.depthBiasEnable         = RHI_FALSE;
+
+            RHIPipelineMultisampleStateCreateInfo multisample_state_create_info {};
+            multisample_state_create_info.sType = RHI_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+            multisample_state_create_info.sampleShadingEnable  = RHI_FALSE;
+            multisample_state_create_info.rasterizationSamples = RHI_SAMPLE_COUNT_1_BIT;
+
+            // premultiplied over, like the unsorted billboards
+            RHIPipelineColorBlendAttachmentState color_blend_attachment {};
+            color_blend_attachment.colorWriteMask = RHI_COLOR_COMPONENT_R_BIT | RHI_COLOR_COMPONENT_G_BIT |
+                                                    RHI_COLOR_COMPONENT_B_BIT | RHI_COLOR_COMPONENT_A_BIT;
+            color_blend_attachment.blendEnable         = RHI_TRUE;
+            color_blend_attachment.srcColorBlendFactor = RHI_BLEND_FACTOR_ONE;
+            color_blend_attachment.dstColorBlendFactor = RHI_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+            color_blend_attachment.colorBlendOp        = RHI_BLEND_OP_ADD;
+            color_blend_attachment.srcAlphaBlendFactor = RHI_BLEND_FACTOR_ONE;
+            color_blend_attachment.dstAlphaBlendFactor = RHI_BLEND_FACTOR_ZERO;
+            color_blend_attachment.alphaBlendOp        = RHI_BLEND_OP_ADD;
+
+            RHIPipelineColorBlendStateCreateInfo color_blend_state_create_info {};
+            color_blend_state_create_info.sType           = RHI_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+            color_blend_state_create_info.logicOpEnable   = RHI_FALSE;
+            color_blend_state_create_info.logicOp         = RHI_LOGIC_OP_COPY;
+            color_blend_state_create_info.attachmentCount = 1;
+            color_blend_state_create_info.pAttachments    = &color_blend_attachment;
+
+            RHIPipelineDepthStencilStateCreateInfo depth_stencil_create_info {};
+            depth_stencil_create_info.sType            = RHI_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+            depth_stencil_create_info.depthTestEnable  = RHI_TRUE;
+            depth_stencil_create_info.depthWriteEnable = RHI_FALSE;
+            depth_stencil_create_info.depthCompareOp   = RHI_COMPARE_OP_LESS;
+            depth_stencil_create_info.depthBoundsTestEnable = RHI_FALSE;
+            depth_stencil_create_info.stencilTestEnable     = RHI_FALSE;
+
+            RHIDynamicState dynamic_states[] = {RHI_DYNAMIC_STATE_VIEWPORT, RHI_DYNAMIC_STATE_SCISSOR};
+
+            RHIPipelineDynamicStateCreateInfo dynamic_state_create_info {};
+            dynamic_state_create_info.sType             = RHI_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+            dynamic_state_create_info.dynamicStateCount = 2;
+            dynamic_state_create_info.pDynamicStates    = dynamic_states;
+
+            RHIGraphicsPipelineCreateInfo pipeline_info {};
+            pipeline_info.sType               = RHI_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+            pipeline_info.stageCount          = 2;
+            pipeline_info.pStages             = shader_stages;
+            pipeline_info.pVertexInputState   = &vertex_input_state_create_info;
+            pipeline_info.pInputAssemblyState = &input_assembly_create_info;
+            pipeline_info.pViewportState      = &viewport_state_create_info;
+            pipeline_info.pRasterizationState = &rasterization_state_create_info;
+            pipeline_info.pMultisampleState   = &multisample_state_create_info;
+            pipeline_info.pColorBlendState    = &color_blend_state_create_info;
+            pipeline_info.pDepthStencilState  = &depth_stencil_create_info;
+            pipeline_info.layout              = m_sorted_billboard_pipeline_layout;
+            pipeline_info.renderPass          = m_render_pass;
+            pipeline_info.subpass             = _main_camera_subpass_forward_lighting;
+            pipeline_info.basePipelineHandle  = RHI_NULL_HANDLE;
+            pipeline_info.pDynamicState       = &dynamic_state_create_info;
+
+            if (m_rhi->createGraphicsPipelines(RHI_NULL_HANDLE, 1, &pipeline_info, m_sorted_billboard_pipeline) !=
+                RHI_SUCCESS)
+            {
+                throw std::runtime_error("create particle sorted billboard graphics pipeline");
+            }
+
+            if (m_is_half_resolution_enabled)
+            {
+                RHIShader* half_resolution_frag_shader_module =
+                    m_rhi->createShaderModule(PARTICLEBILLBOARD_HALF_RESOLUTION_FRAG);
+                shader_stages[1].module = half_resolution_frag_shader_module;
+
+                // the target has no depth, the fragment shader tests the depth copy and the coverage is accumulated
+                // for the composite
+                depth_stencil_create_info.depthTestEnable  = RHI_FALSE;
+                color_blend_attachment.dstAlphaBlendFactor = RHI_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+
+                pipeline_info.renderPass = m_framebuffer.render_pass;
+                pipeline_info.subpass    = 0;
+
+                if (m_rhi->createGraphicsPipelines(
+                        RHI_NULL_HANDLE, 1, &pipeline_info, m_half_resolution_billboard_pipeline) != RHI_SUCCESS)
+                {
+                    throw std::runtime_error("create particle half resolution billboard graphics pipeline");
+                }
+
+                RHIShader* composite_vert_shader_module = m_rhi->createShaderModule(POST_PROCESS_VERT);
+                RHIShader* composite_frag_shader_module = m_rhi->createShaderModule(PARTICLE_COMPOSITE_FRAG);
+                shader_stages[0].module                 = composite_vert_shader_module;
+                shader_stages[1].module                 = composite_frag_shader_module;
+
+                input_assembly_create_info.topology        = RHI_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+                color_blend_attachment.dstAlphaBlendFactor = RHI_BLEND_FACTOR_ZERO;
+
+                pipeline_info.layout     = m_composite_pipeline_layout;
+                pipeline_info.renderPass = m_render_pass;
+                pipeline_info.subpass    = _main_camera_subpass_forward_lighting;
+
+                if (m_rhi->createGraphicsPipelines(RHI_NULL_HANDLE, 1, &pipeline_info, m_composite_pipeline) !=
+                    RHI_SUCCESS)
+                {
+                    throw std::runtime_error("create particle composite graphics pipeline");
+                }
+
+                m_rhi->destroyShaderModule(half_resolution_frag_shader_module);
+                m_rhi->destroyShaderModule(composite_vert_shader_module);
+                m_rhi->destroyShaderModule(composite_frag_shader_module);
+            }
+
+            m_rhi->destroyShaderModule(vert_shader_module);
+            m_rhi->destroyShaderModule(frag_shader_module);
+        }
+    }
+
+    void ParticlePass::setupSortBuffers()
+    {
+        uint32_t      particle_count = static_cast<uint32_t>(s_max_particles) * m_emitter_count;
+        RHIDeviceSize key_size       = sizeof(uint32_t) * particle_count;
+
+        // the sorted billboards read the particles of all the emitters through one binding
+        RHIPhysicalDeviceProperties physical_device_properties {};
+        m_rhi->getPhysicalDeviceProperties(&physical_device_properties);
+        if (sizeof(Particle) * particle_count > physical_device_properties.limits.maxStorageBufferRange)
+        {
+            LOG_WARN("{} particle emitters exceed the storage buffer range, the particles are not depth sorted",
+                     m_emitter_count);
+            return;
+        }
+
+        m_sort_state_size = sizeof(ParticleSortState) + sizeof(uint32_t) * m_emitter_count;
+
+        // written by every simulation before the particles are drawn from it
+        m_rhi->createBuffer(m_sort_state_size,
+                            RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT | RHI_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+                                RHI_BUFFER_USAGE_TRANSFER_DST_BIT,
+                            RHI_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                            m_sort_state_buffer,
+                            m_sort_state_memory);
+
+        m_rhi->createBuffer(m_sort_state_size * m_rhi->getMaxFramesInFlight(),
+                            RHI_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                            RHI_MEMORY_PROPERTY_HOST_VISIBLE_BIT | RHI_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                            m_sort_state_host_buffer,
+                            m_sort_state_host_memory);
+        if (RHI_SUCCESS !=
+            m_rhi->mapMemory(m_sort_state_host_memory, 0, RHI_WHOLE_SIZE, 0, &m_sort_state_host_mapped))
+        {
+            throw std::runtime_error("map particle sort state buffer");
+        }
+
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            m_rhi->createBuffer(key_size,
+                                RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                RHI_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                m_sort_key_buffers[i],
+                                m_sort_key_memories[i]);
+            m_rhi->createBuffer(key_size,
+                                RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                RHI_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                m_sort_value_buffers[i],
+                                m_sort_value_memories[i]);
+        }
+
+        uint32_t block_count = (particle_count + s_particle_sort_block_size - 1) / s_particle_sort_block_size;
+        m_rhi->createBuffer(sizeof(uint32_t) * s_particle_sort_group_size * block_count,
+                            RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                            RHI_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                            m_sort_histogram_buffer,
+                            m_sort_histogram_memory);
+        m_rhi->createBuffer(key_size,
+                            RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                            RHI_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                            m_sort_visibility_buffer,
+                            m_sort_visibility_memory);
+    }
+
+    void ParticlePass::freeSortBuffers()
+    {
+        if (!m_sort_state_buffer)
+        {
+            return;
+        }
+
+        m_rhi->freeMemory(m_sort_state_memory);
+        m_rhi->destroyBuffer(m_sort_state_buffer);
+        m_rhi->freeMemory(m_sort_state_host_memory);
+        m_rhi->destroyBuffer(m_sort_state_host_buffer);
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            m_rhi->freeMemory(m_sort_key_memories[i]);
+            m_rhi->destroyBuffer(m_sort_key_buffers[i]);
+            m_rhi->freeMemory(m_sort_value_memories[i]);
+            m_rhi->destroyBuffer(m_sort_value_buffers[i]);
+        }
+        m_rhi->freeMemory(m_sort_histogram_memory);
+        m_rhi->destroyBuffer(m_sort_histogram_buffer);
+        m_rhi->freeMemory(m_sort_visibility_memory);
+        m_rhi->destroyBuffer(m_sort_visibility_buffer);
+
+        m_sort_state_buffer           = nullptr;
+        m_sort_state_host_mapped      = nullptr;
+        m_is_drawing_sorted_particles = false;
+    }
+
+    void ParticlePass::updateSortDescriptorSets()
+    {
+        // the keys are generated into the first buffers, then every radix pass reads the output of the previous one,
+        // the depth passes go 0 -> 1 -> 0 and the tile passes 0 -> 1 -> 2
+        const uint32_t set_buffers[s_sort_descriptor_set_count][2] = {{0, 0}, {0, 1}, {1, 0}, {0, 1}, {1, 2}};
+
+        for (uint32_t set_index = 0; set_index < s_sort_descriptor_set_count; ++set_index)
+        {
+            uint32_t pass = set_index == 0 ? 0 : set_index - 1;
+
+            RHIDescriptorBufferInfo buffer_infos[9] = {
+                {m_sort_state_buffer, 0, RHI_WHOLE_SIZE},
+                {m_sort_pass_uniform_buffer, s_sort_pass_uniform_stride * pass, sizeof(uint32_t)},
+                {m_particle_render_buffer, 0, RHI_WHOLE_SIZE},
+                {m_sort_key_buffers[set_buffers[set_index][0]], 0, RHI_WHOLE_SIZE},
+                {m_sort_value_buffers[set_buffers[set_index][0]], 0, RHI_WHOLE_SIZE},
+                {m_sort_key_buffers[set_buffers[set_index][1]], 0, RHI_WHOLE_SIZE},
+                {m_sort_value_buffers[set_buffers[set_index][1]], 0, RHI_WHOLE_SIZE},
+                {m_sort_histogram_buffer, 0, RHI_WHOLE_SIZE},
+                {m_sort_visibility_buffer, 0, RHI_WHOLE_SIZE}};
+
+            RHIWriteDescriptorSet descriptor_writes[9] = {};
+            for (uint32_t binding = 0; binding < 9; ++binding)
+            {
+                descriptor_writes[binding].sType           = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                descriptor_writes[binding].dstSet          = m_sort_descriptor_sets[set_index];
+                descriptor_writes[binding].dstBinding      = binding;
+                descriptor_writes[binding].descriptorType  = RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                descriptor_writes[binding].descriptorCount = 1;
+                descriptor_writes[binding].pBufferInfo     = &buffer_infos[binding];
+            }
+            descriptor_writes[1].descriptorType = RHI_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+
+            m_rhi->updateDescriptorSets(9, descriptor_writes, 0, NULL);
+        }
+
+        // the billboards are drawn in the depth order
+        RHIDescriptorBufferInfo billboard_buffer_infos[5] = {
+            {m_sort_state_buffer, 0, RHI_WHOLE_SIZE},
+            {m_particle_render_buffer, 0, RHI_WHOLE_SIZE},
+            {m_particle_billboard_uniform_buffer, 0, RHI_WHOLE_SIZE},
+            {m_sort_value_buffers[0], 0, RHI_WHOLE_SIZE},
+            {m_sort_visibility_buffer, 0, RHI_WHOLE_SIZE}};
+
+        RHIDescriptorImageInfo spark_texture_image_info {};
+        spark_texture_image_info.sampler     = m_rhi->getOrCreateDefaultSampler(Default_Sampler_Linear);
+        spark_texture_image_info.imageView   = m_particle_billboard_texture_image_view;
+        spark_texture_image_info.imageLayout = RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+        RHIDescriptorImageInfo scene_depth_image_info {};
+        scene_depth_image_info.sampler     = m_rhi->getOrCreateDefaultSampler(Default_Sampler_Nearest);
+        scene_depth_image_info.imageView   = m_src_depth_image_view;
+        scene_depth_image_info.imageLayout = RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+        const uint32_t billboard_buffer_bindings[5] = {0, 1, 3, 4, 5};
+
+        RHIWriteDescriptorSet billboard_descriptor_writes[7] = {};
+        for (uint32_t i = 0; i < 5; ++i)
+        {
+            RHIWriteDescriptorSet& descriptor_write = billboard_descriptor_writes[i];
+            descriptor_write.sType                  = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            descriptor_write.dstSet                 = m_sorted_billboard_descriptor_set;
+            descriptor_write.dstBinding             = billboard_buffer_bindings[i];
+            descriptor_write.descriptorType         = RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            descriptor_write.descriptorCount        = 1;
+            descriptor_write.pBufferInfo            = &billboard_buffer_infos[i];
+        }
+        billboard_descriptor_writes[2].descriptorType = RHI_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+
+        billboard_descriptor_writes[5].sType           = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        billboard_descriptor_writes[5].dstSet          = m_sorted_billboard_descriptor_set;
+        billboard_descriptor_writes[5].dstBinding      = 2;
+        billboard_descriptor_writes[5].descriptorType  = RHI_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        billboard_descriptor_writes[5].descriptorCount = 1;
+        billboard_descriptor_writes[5].pImageInfo      = &spark_texture_image_info;
+
+        billboard_descriptor_writes[6]            = billboard_descriptor_writes[5];
+        billboard_descriptor_writes[6].dstBinding = 6;
+        billboard_descriptor_writes[6].pImageInfo = &scene_depth_image_info;
+
+        m_rhi->updateDescriptorSets(7, billboard_descriptor_writes, 0, NULL);
+    }
+
+    void ParticlePass::setupHalfResolutionRenderPass()
+    {
+        m_framebuffer.attachments.resize(1);
+        m_framebuffer.attachments[0].format = RHI_FORMAT_R16G16B16A16_SFLOAT;
+
+        RHIAttachmentDescription particle_color_attachment_description {};
+        particle_color_attachment_description.format         = m_framebuffer.attachments[0].format;
+        particle_color_attachment_description.samples        = RHI_SAMPLE_COUNT_1_BIT;
+        particle_color_attachment_description.loadOp         = RHI_ATTACHMENT_LOAD_OP_CLEAR;
+        particle_color_attachment_description.storeOp        = RHI_ATTACHMENT_STORE_OP_STORE;
+        particle_color_attachment_description.stencilLoadOp  = RHI_ATTACHMENT_LOAD_OP_DONT_CARE;
+        particle_color_attachment_description.stencilStoreOp = RHI_ATTACHMENT_STORE_OP_DONT_CARE;
+        particle_color_attachment_description.initialLayout  = RHI_IMAGE_LAYOUT_UNDEFINED;
+        particle_color_attachment_description.finalLayout    = RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+        RHIAttachmentReference particle_color_attachment_reference {};
+        particle_color_attachment_reference.attachment = 0;
+        particle_color_attachment_reference.layout     = RHI_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+        RHISubpassDescription particle_pass {};
+        particle_pass.pipelineBindPoint    = RHI_PIPELINE_BIND_POINT_GRAPHICS;
+        particle_pass.colorAttachmentCount = 1;
+        particle_pass.pColorAttachments    = &particle_color_attachment_reference;
+
+        RHISubpassDependency dependencies[2] = {};
+
+        // the composite of the previous frame has read the target
+        RHISubpassDependency& previous_composite_dependency = dependencies[0];
+        previous_composite_dependency.srcSubpass            = RHI_SUBPASS_EXTERNAL;
+        previous_composite_dependency.dstSubpass            = 0;
+        previous_composite_dependency.srcStageMask          = RHI_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+        previous_composite_dependency.dstStageMask          = RHI_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        previous_composite_dependency.srcAccessMask         = 0;
+        previous_composite_dependency.dstAccessMask         = RHI_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+        RHISubpassDependency& composite_dependency = dependencies[1];
+        composite_dependency.srcSubpass            = 0;
+        composite_dependency.dstSubpass            = RHI_SUBPASS_EXTERNAL;
+        composite_dependency.srcStageMask          = RHI_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        composite_dependency.dstStageMask          = RHI_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+        composite_dependency.srcAccessMask         = RHI_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        composite_dependency.dstAccessMask         = RHI_ACCESS_SHADER_READ_BIT;
+
+        RHIRenderPassCreateInfo renderpass_create_info {};
+        renderpass_create_info.sType           = RHI_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+        renderpass_create_info.attachmentCount = 1;
+        renderpass_create_info.pAttachments    = &particle_color_attachment_description;
+        renderpass_create_info.subpassCount    = 1;
+        renderpass_create_info.pSubpasses      = &particle_pass;
+        renderpass_create_info.dependencyCount = (sizeof(dependencies) / sizeof(dependencies[0]));
+        renderpass_create_info.pDependencies   = dependencies;
+
+        if (RHI_SUCCESS != m_rhi->createRenderPass(&renderpass_create_info, m_framebuffer.render_pass))
+        {
+            throw std::runtime_error("create particle half resolution render pass");
+        }
+    }
+
+    void ParticlePass::setupHalfResolutionTarget()
+    {
+        m_framebuffer.width  = (m_rhi->getSwapchainInfo().extent.width + 1) / 2;
+        m_framebuffer.height = (m_rhi->getSwapchainInfo().extent.height + 1) / 2;
+
+        FrameBufferAttachment& particle_color_attachment = m_framebuffer.attachments[0];
+        m_rhi->createImage(m_framebuffer.width,
+                           m_framebuffer.height,
+                           particle_color_attachment.format,
+                           RHI_IMAGE_TILING_OPTIMAL,
+                           RHI_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | RHI_IMAGE_USAGE_SAMPLED_BIT,
+                           RHI_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                           particle_color_attachment.image,
+                           particle_color_attachment.mem,
+                           0,
+                           1,
+                           1);
+        m_rhi->createImageView(particle_color_attachment.image,
+                               particle_color_attachment.format,
+                               RHI_IMAGE_ASPECT_COLOR_BIT,
+                               RHI_IMAGE_VIEW_TYPE_2D,
+                               1,
+                               1,
+                               particle_color_attachment.view);
+
+        RHIFramebufferCreateInfo framebuffer_create_info {};
+        framebuffer_create_info.sType           = RHI_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+        framebuffer_create_info.renderPass      = m_framebuffer.render_pass;
+        framebuffer_create_info.attachmentCount = 1;
+        framebuffer_create_info.pAttachments    = &particle_color_attachment.view;
+        framebuffer_create_info.width           = m_framebuffer.width;
+        framebuffer_create_info.height          = m_framebuffer.height;
+        framebuffer_create_info.layers          = 1;
+
+        if (RHI_SUCCESS != m_rhi->createFramebuffer(&framebuffer_create_info, m_framebuffer.framebuffer))
+        {
+            throw std::runtime_error("create particle half resolution framebuffer");
+        }
+
+        RHIDescriptorImageInfo particle_color_image_info {};
+        particle_color_image_info.sampler     = m_rhi->getOrCreateDefaultSampler(Default_Sampler_Linear);
+        particle_color_image_info.imageView   = particle_color_attachment.view;
+        particle_color_image_info.imageLayout = RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+        RHIWriteDescriptorSet composite_descriptor_write {};
+        composite_descriptor_write.sType           = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        composite_descriptor_write.dstSet          = m_composite_descriptor_set;
+        composite_descriptor_write.dstBinding      = 0;
+        composite_descriptor_write.descriptorType  = RHI_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        composite_descriptor_write.descriptorCount = 1;
+        composite_descriptor_write.pImageInfo      = &particle_color_image_info;
+
+        m_rhi->updateDescriptorSets(1, &composite_descriptor_write, 0, NULL);
+    }
+
+    void ParticlePass::freeHalfResolutionTarget()
+    {
+        m_rhi->destroyFramebuffer(m_framebuffer.framebuffer);
+        m_rhi->destroyImageView(m_framebuffer.attachments[0].view);
+        m_rhi->destroyImage(m_framebuffer.attachments[0].image);
+        m_rhi->freeMemory(m_framebuffer.attachments[0].mem);
+    }
+
+    void ParticlePass::drawHalfResolution()
+    {
+        if (!m_is_drawing_sorted_particles || !m_is_half_resolution_enabled)
+        {
+            return;
+        }
+
+        float color[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+        m_rhi->pushEvent(m_render_command_buffer, "ParticleBillboard Half Resolution", color);
+
+        RHIRenderPassBeginInfo renderpass_begin_info {};
+        renderpass_begin_info.sType             = RHI_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        renderpass_begin_info.renderPass        = m_framebuffer.render_pass;
+        renderpass_begin_info.framebuffer       = m_framebuffer.framebuffer;
+        renderpass_begin_info.renderArea.offset = {0, 0};
+        renderpass_begin_info.renderArea.extent = {static_cast<uint32_t>(m_framebuffer.width),
+                                                   static_cast<uint32_t>(m_framebuffer.height)};
+
+        RHIClearValue clear_value {};
+        clear_value.color                     = {{0.0f, 0.0f, 0.0f, 0.0f}};
+        renderpass_begin_info.clearValueCount = 1;
+        renderpass_begin_info.pClearValues    = &clear_value;
+
+        m_rhi->cmdBeginRenderPassPFN(m_render_command_buffer, &renderpass_begin_info, RHI_SUBPASS_CONTENTS_INLINE);
+
+        // the viewport of the scene at half resolution
+        RHIViewport viewport = *m_rhi->getSwapchainInfo().viewport;
+        viewport.x *= 0.5f;
+        viewport.y *= 0.5f;
+        viewport.width *= 0.5f;
+        viewport.height *= 0.5f;
+
+        RHIRect2D scissor = *m_rhi->getSwapchainInfo().scissor;
+        scissor.offset.x /= 2;
+        scissor.offset.y /= 2;
+        scissor.extent.width  = (scissor.extent.width + 1) / 2;
+        scissor.extent.height = (scissor.extent.height + 1) / 2;
+
+        m_rhi->cmdBindPipelinePFN(
+            m_render_command_buffer, RHI_PIPELINE_BIND_POINT_GRAPHICS, m_half_resolution_billboard_pipeline);
+        m_rhi->cmdSetViewportPFN(m_render_command_buffer, 0, 1, &viewport);
+        m_rhi->cmdSetScissorPFN(m_render_command_buffer, 0, 1, &scissor);
+        m_rhi->cmdBindDescriptorSetsPFN(m_render_command_buffer,
+                                        RHI_PIPELINE_BIND_POINT_GRAPHICS,
+                                        m_sorted_billboard_pipeline_layout,
+                                        0,
+                                        1,
+                                        &m_sorted_billboard_descriptor_set,
+                                        0,
+                                        NULL);
+        m_rhi->cmdDrawIndirect(m_render_command_buffer,
+                               m_sort_state_buffer,
+                               offsetof(ParticleSortState, draw_argument),
+                               1,
+                               sizeof(uvec4));
+
+        m_rhi->cmdEndRenderPassPFN(m_render_command_buffer);
+
+        m_rhi->popEvent(m_render_command_buffer);
+    }
+
+    void ParticlePass::sortParticles(RHICommandBuffer* command_buffer, uint8_t index)
+    {
+        float color[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+        m_rhi->pushEvent(command_buffer, "Particle Sort", color);
+
+        // the state of the frame, the alive counts follow it
+        std::shared_ptr<RenderCamera> camera          = g_runtime_global_context.m_render_system->getRenderCamera();
+        const RHIViewport*            viewport        = m_rhi->getSwapchainInfo().viewport;
+        uint32_t max_per_tile    = std::max(m_particle_manager->getGlobalParticleRes().m_max_particles_per_tile, 0);
+        uint32_t sort_pass_count = max_per_tile > 0 ? s_sort_pass_count : 2;
+
+        ParticleSortState state {};
+        state.view_projection_matrix = m_particlebillboard_perframe_storage_buffer_object.proj_view_matrix;
+        state.depth_range =
+            Vector4(camera->m_znear, camera->m_zfar, 65535.0f / (camera->m_zfar - camera->m_znear), 0.0f);
+        state.tile_grid.x   = static_cast<uint32_t>(std::ceil(viewport->width / s_particle_sort_tile_size));
+        state.tile_grid.y   = static_cast<uint32_t>(std::ceil(viewport->height / s_particle_sort_tile_size));
+        state.tile_grid.z   = s_particle_sort_tile_size;
+        state.tile_grid.w   = max_per_tile;
+        state.viewport_size = Vector4(viewport->width, viewport->height, 0.0f, 0.0f);
+        state.sort_counts.z = s_max_particles;
+
+        RHIDeviceSize slot_offset = m_sort_state_size * index;
+        char*         slot        = reinterpret_cast<char*>(m_sort_state_host_mapped) + slot_offset;
+        memcpy(slot, &state, sizeof(ParticleSortState));
+
+        // the compute passes and the copies of the counters are done
+        RHIMemoryBarrier memory_barrier {};
+        memory_barrier.sType         = RHI_STRUCTURE_TYPE_MEMORY_BARRIER;
+        memory_barrier.srcAccessMask = RHI_ACCESS_SHADER_WRITE_BIT | RHI_ACCESS_TRANSFER_WRITE_BIT;
+        memory_barrier.dstAccessMask = RHI_ACCESS_TRANSFER_READ_BIT | RHI_ACCESS_TRANSFER_WRITE_BIT;
+
+        m_rhi->cmdPipelineBarrier(command_buffer,
+                                  RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT | RHI_PIPELINE_STAGE_TRANSFER_BIT,
+                                  RHI_PIPELINE_STAGE_TRANSFER_BIT,
+                                  0,
+                                  1,
+                                  &memory_barrier,
+                                  0,
+                                  nullptr,
+                                  0,
+                                  nullptr);
+
+        RHIBufferCopy copyRegion {};
+        copyRegion.srcOffset = slot_offset;
+        copyRegion.dstOffset = 0;
+        copyRegion.size      = sizeof(ParticleSortState);
+
+        if (m_is_drawing_cpu_particles)
+        {
+            uint32_t* alive_counts = reinterpret_cast<uint32_t*>(slot + sizeof(ParticleSortState));
+            for (int i = 0; i < m_emitter_count; ++i)
+            {
+                alive_counts[i] = m_emitter_buffer_batches[i].m_num_particle;
+            }
+            copyRegion.size = m_sort_state_size;
+        }
+        m_rhi->cmdCopyBuffer(command_buffer, m_sort_state_host_buffer, m_sort_state_buffer, 1, &copyRegion);
+
+        if (!m_is_drawing_cpu_particles)
+        {
+            for (int i = 0; i < m_emitter_count; ++i)
+            {
+                copyRegion.srcOffset = offsetof(ParticleCounter, alive_count_after_sim);
+                copyRegion.dstOffset = sizeof(ParticleSortState) + sizeof(uint32_t) * i;
+                copyRegion.size      = sizeof(uint32_t);
+
+                m_rhi->cmdCopyBuffer(command_buffer,
+                                     m_emitter_buffer_batches[i].m_counter_device_buffer,
+                                     m_sort_state_buffer,
+                                     1,
+                                     &copyRegion);
+            }
+        }
+
+        memory_barrier.srcAccessMask = RHI_ACCESS_TRANSFER_WRITE_BIT;
+        memory_barrier.dstAccessMask = RHI_ACCESS_SHADER_READ_BIT | RHI_ACCESS_SHADER_WRITE_BIT;
+
+        m_rhi->cmdPipelineBarrier(command_buffer,
+                                  RHI_PIPELINE_STAGE_TRANSFER_BIT,
+                                  RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                  0,
+                                  1,
+                                  &memory_barrier,
+                                  0,
+                                  nullptr,
+                                  0,
+                                  nullptr);
+
+        // every dispatch reads what the previous one wrote, some of them through the indirect arguments
+        memory_barrier.srcAccessMask = RHI_ACCESS_SHADER_WRITE_BIT;
+        memory_barrier.dstAccessMask =
+            RHI_ACCESS_SHADER_READ_BIT | RHI_ACCESS_SHADER_WRITE_BIT | RHI_ACCESS_INDIRECT_COMMAND_READ_BIT;
+        auto dispatch_barrier = [&]() {
+            m_rhi->cmdPipelineBarrier(command_buffer,
+                                      RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                      RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT | RHI_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+                                      0,
+                                      1,
+                                      &memory_barrier,
+                                      0,
+                                      nullptr,
+                                      0,
+                                      nullptr);
+        };
+
+        m_rhi->cmdBindDescriptorSetsPFN(command_buffer,
+                                        RHI_PIPELINE_BIND_POINT_COMPUTE,
+                                        m_sort_pipeline_layout,
+                                        0,
+                                        1,
+                                        &m_sort_descriptor_sets[0],
+                                        0,
+                                        0);
+
+        m_rhi->cmdBindPipelinePFN(command_buffer, RHI_PIPELINE_BIND_POINT_COMPUTE, m_sort_keys_pipeline);
+        m_rhi->cmdDispatch(command_buffer,
+                           (s_max_particles + s_particle_sort_group_size - 1) / s_particle_sort_group_size,
+                           m_emitter_count,
+                           1);
+        dispatch_barrier();
+
+        m_rhi->cmdBindPipelinePFN(command_buffer, RHI_PIPELINE_BIND_POINT_COMPUTE, m_sort_kickoff_pipeline);
+        m_rhi->cmdDispatch(command_buffer, 1, 1, 1);
+        dispatch_barrier();
+
+        for (uint32_t pass = 0; pass < sort_pass_count; ++pass)
+        {
+            m_rhi->cmdBindDescriptorSetsPFN(command_buffer,
+                                            RHI_PIPELINE_BIND_POINT_COMPUTE,
+                                            m_sort_pipeline_layout,
+                                            0,
+                                            1,
+                                            &m_sort_descriptor_sets[pass + 1],
+                                            0,
+                                            0);
+
+            m_rhi->cmdBindPipelinePFN(command_buffer, RHI_PIPELINE_BIND_POINT_COMPUTE, m_sort_histogram_pipeline);
+            m_rhi->cmdDispatchIndirect(command_buffer, m_sort_state_buffer, offsetof(ParticleSortState, sort_dispatch));
+            dispatch_barrier();
+
+            m_rhi->cmdBindPipelinePFN(command_buffer, RHI_PIPELINE_BIND_POINT_COMPUTE, m_sort_scan_pipeline);
+            m_rhi->cmdDispatch(command_buffer, 1, 1, 1);
+            dispatch_barrier();
+
+            m_rhi->cmdBindPipelinePFN(command_buffer, RHI_PIPELINE_BIND_POINT_COMPUTE, m_sort_scatter_pipeline);
+            m_rhi->cmdDispatchIndirect(command_buffer, m_sort_state_buffer, offsetof(ParticleSortState, sort_dispatch));
+            dispatch_barrier();
+        }
+
+        // the last pass left the keys grouped by tile
+        if (max_per_tile > 0)
+        {
+            m_rhi->cmdBindPipelinePFN(command_buffer, RHI_PIPELINE_BIND_POINT_COMPUTE, m_sort_bin_pipeline);
+            m_rhi->cmdDispatchIndirect(
+                command_buffer, m_sort_state_buffer, offsetof(ParticleSortState, particle_dispatch));
+        }
+
+        m_rhi->popEvent(command_buffer); // end particle sort label
+    }
+} // namespace Piccolo
@@ -35,9 +35,19 @@ namespace Piccolo
         RHIDeviceMemory* m_alive_list_next_memory = nullptr;
         RHIDeviceMemory* m_dead_list_memory = nullptr;
         RHIDeviceMemory* m_particle_component_res_memory = nullptr;
-        RHIDeviceMemory* m_position_render_memory = nullptr;
+
+        // the range of the emitter in the render buffer shared by all the emitters, which is owned by the pass
+        RHIDeviceSize m_position_render_offset {0};
 
         void* m_emitter_desc_mapped {nullptr};
+        // one counter per frame in flight, written by the simulation of that frame
+        void* m_counter_host_mapped {nullptr};
+
+        // the particles of the cpu simulation, a slot of m_cpu_upload_capacity particles per frame in flight
+        RHIBuffer*       m_cpu_upload_buffer = nullptr;
+        RHIDeviceMemory* m_cpu_upload_memory = nullptr;
+        void*            m_cpu_upload_mapped {nullptr};
+        uint32_t         m_cpu_upload_capacity {0};
 
         ParticleEmitterDesc m_emitter_desc;
 
@@ -54,6 +64,10 @@ namespace Piccolo
 
         void draw() override final;
 
+        // blends the sorted particles into the half resolution target, recorded before the main camera pass, which
+        // composites them
+        void drawHalfResolution();
+
         void simulate();
 
         void copyNormalAndDepthImage();
@@ -97,13 +111,35 @@ namespace Piccolo
 
         void setupParticleDescriptorSet();
 
+        void waitForSimulation();
+
+        void uploadCpuParticles(RHICommandBuffer* command_buffer, uint8_t index);
+
+        void setupSortResources();
+
+        void setupSortPipelines();
+
+        void setupSortBuffers();
+
+        void freeSortBuffers();
+
+        void updateSortDescriptorSets();
+
+        void setupHalfResolutionRenderPass();
+
+        void setupHalfResolutionTarget();
+
+        void freeHalfResolutionTarget();
+
+        void sortParticles(RHICommandBuffer* command_buffer, uint8_t index);
+
         RHIPipeline* m_kickoff_pipeline = nullptr;
         RHIPipeline* m_emit_pipeline = nullptr;
         RHIPipeline* m_simulate_pipeline = nullptr;
 
-        RHICommandBuffer* m_compute_command_buffer = nullptr;
-        RHICommandBuffer* m_render_command_buffer = nullptr;
-        RHICommandBuffer* m_copy_command_buffer = nullptr;
+        std::vector<RHICommandBuffer*> m_compute_command_buffers;
+        std::vector<RHICommandBuffer*> m_copy_command_buffers;
+        RHICommandBuffer*              m_render_command_buffer = nullptr;
 
         RHIBuffer* m_scene_uniform_buffer = nullptr;
         RHIBuffer* m_compute_uniform_buffer = nullptr;
@@ -111,7 +147,11 @@ namespace Piccolo
 
         RHIViewport m_viewport_params;
 
-        RHIFence* m_fence = nullptr;
+        // the copy of the frame is waited by its simulation, which in turn is waited by the rendering of the next
+        // frame, the fence tells when the command buffers and the counter slot of the frame can be reused
+        std::vector<RHISemaphore*> m_copy_finished_semaphores;
+        std::vector<RHISemaphore*> m_simulate_finished_semaphores;
+        std::vector<RHIFence*>     m_compute_fences;
 
         RHIImage*        m_src_depth_image = nullptr;
         RHIImage*        m_dst_normal_image = nullptr;
@@ -177,11 +217,14 @@ namespace Piccolo
         // indirect dispath parameter offset
         static const uint32_t s_argument_offset_emit     = 0;
         static const uint32_t s_argument_offset_simulate = s_argument_offset_emit + sizeof(uvec4);
+        static const uint32_t s_argument_offset_draw     = s_argument_offset_simulate + 2 * sizeof(uvec4);
         struct IndirectArgumemt
         {
             uvec4 emit_argument;
             uvec4 simulate_argument;
             int   alive_flap_bit;
+            int   padding[3];
+            uvec4 draw_argument; // vertex count, instance count, first vertex, first instance
         };
 
         struct ParticleCounter
@@ -199,6 +242,79 @@ namespace Piccolo
 
         int m_emitter_count;
 
+        // set by the simulation of the previous frame, whose particles are drawn
+        bool m_is_drawing_cpu_particles {false};
+        bool m_is_drawing_sorted_particles {false};
+
+        // the particles of all the emitters, s_max_particles per emitter, so that they can be drawn in one call
+        RHIBuffer*       m_particle_render_buffer = nullptr;
+        RHIDeviceMemory* m_particle_render_memory = nullptr;
+
+        /*
+         * depth sort, the keys of the live particles are sorted by four radix passes of 8 bits, the two depth passes
+         * leave the draw order in the first key buffer, the two tile passes group it by tile in the third one
+         */
+        struct ParticleSortState
+        {
+            Matrix4x4 view_projection_matrix;
+            Vector4   depth_range;       // near, far, depth key scale
+            uvec4     tile_grid;         // tile count x, tile count y, tile size, max particles per tile
+            Vector4   viewport_size;     // width, height
+            uvec4     sort_counts;       // sorted particles, sort blocks, particles per emitter
+            uvec4     sort_dispatch;     // written by particle_sort_kickoff.comp
+            uvec4     particle_dispatch; // written by particle_sort_kickoff.comp
+            uvec4     draw_argument;     // written by particle_sort_kickoff.comp
+        };
+
+        static const uint32_t s_sort_pass_count = 4;
+        // the shift of a radix pass, one uniform buffer range per pass
+        static const uint32_t s_sort_pass_uniform_stride = 256;
+        // the key generation set, followed by one set per radix pass
+        static const uint32_t s_sort_descriptor_set_count = s_sort_pass_count + 1;
+
+        bool m_is_sort_enabled {false};
+        bool m_is_half_resolution_enabled {false};
+
+        RHIDescriptorSetLayout* m_sort_descriptor_set_layout = nullptr;
+        RHIPipelineLayout*      m_sort_pipeline_layout = nullptr;
+        RHIPipeline*            m_sort_keys_pipeline = nullptr;
+        RHIPipeline*            m_sort_kickoff_pipeline = nullptr;
+        RHIPipeline*            m_sort_histogram_pipeline = nullptr;
+        RHIPipeline*            m_sort_scan_pipeline = nullptr;
+        RHIPipeline*            m_sort_scatter_pipeline = nullptr;
+        RHIPipeline*            m_sort_bin_pipeline = nullptr;
+        RHIDescriptorSet*       m_sort_descriptor_sets[s_sort_descriptor_set_count] {};
+
+        // the state is written by the host through one staging slot per frame in flight
+        RHIBuffer*       m_sort_state_buffer = nullptr;
+        RHIDeviceMemory* m_sort_state_memory = nullptr;
+        RHIBuffer*       m_sort_state_host_buffer = nullptr;
+        RHIDeviceMemory* m_sort_state_host_memory = nullptr;
+        void*            m_sort_state_host_mapped {nullptr};
+        RHIDeviceSize    m_sort_state_size {0};
+        RHIBuffer*       m_sort_pass_uniform_buffer = nullptr;
+        RHIDeviceMemory* m_sort_pass_uniform_memory = nullptr;
+        RHIBuffer*       m_sort_key_buffers[3] {};
+        RHIDeviceMemory* m_sort_key_memories[3] {};
+        RHIBuffer*       m_sort_value_buffers[3] {};
+        RHIDeviceMemory* m_sort_value_memories[3] {};
+        RHIBuffer*       m_sort_histogram_buffer = nullptr;
+        RHIDeviceMemory* m_sort_histogram_memory = nullptr;
+        RHIBuffer*       m_sort_visibility_buffer = nullptr;
+        RHIDeviceMemory* m_sort_visibility_memory = nullptr;
+
+        RHIDescriptorSetLayout* m_sorted_billboard_descriptor_set_layout = nullptr;
+        RHIPipelineLayout*      m_sorted_billboard_pipeline_layout = nullptr;
+        RHIPipeline*            m_sorted_billboard_pipeline = nullptr;
+        RHIPipeline*            m_half_resolution_billboard_pipeline = nullptr;
+        RHIDescriptorSet*       m_sorted_billboard_descriptor_set = nullptr;
+
+        // the half resolution target is m_framebuffer, which is composited in the forward lighting subpass
+        RHIDescriptorSetLayout* m_composite_descriptor_set_layout = nullptr;
+        RHIPipelineLayout*      m_composite_pipeline_layout = nullptr;
+        RHIPipeline*            m_composite_pipeline = nullptr;
+        RHIDescriptorSet*       m_composite_descriptor_set = nullptr;
+
         static constexpr bool s_verbose_particle_alive_info {false};
 
         std::vector<ParticleEmitterID> m_emitter_tick_indices;
@@ -1,11 +1,13 @@
 #pragma once
 
 #include "runtime/core/math/vector2.h"
+#include "runtime/function/render/render_draw_list.h"
 #include "runtime/function/render/render_pass.h"
 
 namespace Piccolo
 {
     class RenderResourceBase;
+    class RenderResource;
 
     struct PickPassInitInfo : RenderPassInitInfo
     {
@@ -39,5 +41,10 @@ namespace Piccolo
         RHIImageView*      _object_id_image_view = nullptr;
 
         RHIDescriptorSetLayout* _per_mesh_layout = nullptr;
+
+        RenderDrawList m_mesh_draw_list;
+
+        // pick() resets the ring buffer, so the joint palette of the frame is uploaded again from here
+        RenderResource* m_render_resource {nullptr};
     };
 } // namespace Piccolo
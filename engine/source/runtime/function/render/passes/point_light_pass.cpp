@@ -9,6 +9,7 @@
 #include <mesh_point_light_shadow_geom.h>
 #include <mesh_point_light_shadow_vert.h>
 
+#include <algorithm>
 #include <map>
 #include <stdexcept>
 #include <vector>
@@ -158,6 +159,15 @@ namespace Piccolo
         {
             throw std::runtime_error("create point light shadow render pass");
         }
+
+        // compatible with the framebuffer, the layers which are not cleared keep the cached lights
+        point_light_shadow_color_attachment_description.loadOp        = RHI_ATTACHMENT_LOAD_OP_LOAD;
+        point_light_shadow_color_attachment_description.initialLayout = RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+        if (m_rhi->createRenderPass(&renderpass_create_info, m_cached_layers_render_pass) != RHI_SUCCESS)
+        {
+            throw std::runtime_error("create point light shadow cached layers render pass");
+        }
     }
     void PointLightShadowPass::setupFramebuffer()
     {
@@ -414,7 +424,7 @@ namespace Piccolo
         RHIDescriptorBufferInfo mesh_point_light_shadow_per_drawcall_vertex_blending_storage_buffer_info = {};
         mesh_point_light_shadow_per_drawcall_vertex_blending_storage_buffer_info.offset                 = 0;
         mesh_point_light_shadow_per_drawcall_vertex_blending_storage_buffer_info.range =
-            sizeof(MeshPointLightShadowPerdrawcallVertexBlendingStorageBufferObject);
+            sizeof(MeshJointPaletteStorageBufferObject);
         mesh_point_light_shadow_per_drawcall_vertex_blending_storage_buffer_info.buffer =
             m_global_render_resource->_storage_buffer._global_upload_ringbuffer;
         assert(mesh_point_light_shadow_per_drawcall_vertex_blending_storage_buffer_info.range <
@@ -469,35 +479,36 @@ namespace Piccolo
     }
     void PointLightShadowPass::drawModel()
     {
-        struct MeshNode
-        {
-            const Matrix4x4* model_matrix {nullptr};
-            const Matrix4x4* joint_matrices {nullptr};
-            uint32_t         joint_count {0};
-        };
+        const std::vector<RenderPointLightShadow>& point_light_shadows = *(m_visiable_nodes.p_point_light_shadows);
 
-        std::map<VulkanPBRMaterial*, std::map<VulkanMesh*, std::vector<MeshNode>>> point_lights_mesh_drawcall_batch;
+        uint32_t const point_light_num =
+            std::min(m_mesh_point_light_shadow_perframe_storage_buffer_object.point_light_num,
+                     static_cast<uint32_t>(point_light_shadows.size()));
 
-        // reorganize mesh
-        for (RenderMeshNode& node : *(m_visiable_nodes.p_point_lights_visible_mesh_nodes))
-        {
-            auto& mesh_instanced = point_lights_mesh_drawcall_batch[node.ref_material];
-            auto& mesh_nodes     = mesh_instanced[node.ref_mesh];
+        // the cached layers are only there if the shadow map was drawn last frame
+        bool const is_drawing_meshes  = m_rhi->isPointLightShadowEnabled();
+        bool const keep_cached_layers = is_drawing_meshes && m_has_drawn_layers;
+        m_has_drawn_layers            = is_drawing_meshes;
 
-            MeshNode temp;
-            temp.model_matrix = node.model_matrix;
-            if (node.enable_vertex_blending)
+        if (keep_cached_layers)
+        {
+            bool is_all_cached = true;
+            for (uint32_t light_index = 0; light_index < point_light_num; ++light_index)
             {
-                temp.joint_matrices = node.joint_matrices;
-                temp.joint_count    = node.joint_count;
+                is_all_cached &= point_light_shadows[light_index].is_cached;
             }
 
-            mesh_nodes.push_back(temp);
+            // the shadow map is left as it is, already in the layout the lighting reads it in
+            if (is_all_cached)
+            {
+                return;
+            }
         }
 
         RHIRenderPassBeginInfo renderpass_begin_info {};
         renderpass_begin_info.sType             = RHI_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-        renderpass_begin_info.renderPass        = m_framebuffer.render_pass;
+        renderpass_begin_info.renderPass =
+            keep_cached_layers ? m_cached_layers_render_pass : m_framebuffer.render_pass;
         renderpass_begin_info.framebuffer       = m_framebuffer.framebuffer;
         renderpass_begin_info.renderArea.offset = {0, 0};
         renderpass_begin_info.renderArea.extent = {s_point_light_shadow_map_dimension,
@@ -511,7 +522,7 @@ namespace Piccolo
 
         m_rhi->cmdBeginRenderPassPFN(m_rhi->getCurrentCommandBuffer(), &renderpass_begin_info, RHI_SUBPASS_CONTENTS_INLINE);
 
-        if (m_rhi->isPointLightShadowEnabled())
+        if (is_drawing_meshes)
         {
             float color[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
             m_rhi->pushEvent(m_rhi->getCurrentCommandBuffer(), "Mesh", color);
@@ -519,178 +530,66 @@ namespace Piccolo
             m_rhi->cmdBindPipelinePFN(
                 m_rhi->getCurrentCommandBuffer(), RHI_PIPELINE_BIND_POINT_GRAPHICS, m_render_pipelines[0].pipeline);
 
-            // perframe storage buffer
-            uint32_t perframe_dynamic_offset =
-                roundUp(m_global_render_resource->_storage_buffer._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()],
-                        m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
+            // every light draws its own casters into its two layers
+            for (uint32_t light_index = 0; light_index < point_light_num; ++light_index)
+            {
+                const RenderPointLightShadow& point_light_shadow = point_light_shadows[light_index];
+                if (keep_cached_layers && point_light_shadow.is_cached)
+                {
+                    continue;
+                }
 
-            m_global_render_resource->_storage_buffer._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] =
-                perframe_dynamic_offset + sizeof(MeshPerframeStorageBufferObject);
+                if (keep_cached_layers)
+                {
+                    // the load op kept the color of every layer, the depth is cleared as a whole
+                    RHIClearAttachment clear_attachments[1];
+                    clear_attachments[0].aspectMask                  = RHI_IMAGE_ASPECT_COLOR_BIT;
+                    clear_attachments[0].colorAttachment             = 0;
+                    clear_attachments[0].clearValue.color.float32[0] = 1.0f;
+                    clear_attachments[0].clearValue.color.float32[1] = 0.0f;
+                    clear_attachments[0].clearValue.color.float32[2] = 0.0f;
+                    clear_attachments[0].clearValue.color.float32[3] = 0.0f;
+                    RHIClearRect clear_rects[1];
+                    clear_rects[0].baseArrayLayer = 2 * light_index;
+                    clear_rects[0].layerCount     = 2;
+                    clear_rects[0].rect           = {{0, 0},
+                                                     {s_point_light_shadow_map_dimension,
+                                                      s_point_light_shadow_map_dimension}};
+                    m_rhi->cmdClearAttachmentsPFN(m_rhi->getCurrentCommandBuffer(),
+                                                  sizeof(clear_attachments) / sizeof(clear_attachments[0]),
+                                                  clear_attachments,
+                                                  sizeof(clear_rects) / sizeof(clear_rects[0]),
+                                                  clear_rects);
+                }
 
-            assert(m_global_render_resource->_storage_buffer._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] <=
-                   (m_global_render_resource->_storage_buffer._global_upload_ringbuffers_begin[m_rhi->getCurrentFrameIndex()] +
-                    m_global_render_resource->_storage_buffer._global_upload_ringbuffers_size[m_rhi->getCurrentFrameIndex()]));
+                m_mesh_draw_list.build(point_light_shadow.visible_mesh_nodes, false, nullptr);
+                if (m_mesh_draw_list.getBatches().empty())
+                {
+                    continue;
+                }
 
-            MeshPointLightShadowPerframeStorageBufferObject& perframe_storage_buffer_object =
-                    (*reinterpret_cast<MeshPointLightShadowPerframeStorageBufferObject*>(
-                    reinterpret_cast<uintptr_t>(
-                        m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
-                    perframe_dynamic_offset));
-            perframe_storage_buffer_object = m_mesh_point_light_shadow_perframe_storage_buffer_object;
+                // perframe storage buffer, the geometry shader only emits the layers of this light
+                uint32_t perframe_dynamic_offset =
+                    roundUp(m_global_render_resource->_storage_buffer._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()],
+                            m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
 
-            for (auto& pair1 : point_lights_mesh_drawcall_batch)
-            {
-                VulkanPBRMaterial& material       = (*pair1.first);
-                auto&              mesh_instanced = pair1.second;
+                m_global_render_resource->_storage_buffer._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] =
+                    perframe_dynamic_offset + sizeof(MeshPointLightShadowPerframeStorageBufferObject);
 
-                // TODO: render from near to far
+                assert(m_global_render_resource->_storage_buffer._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] <=
+                       (m_global_render_resource->_storage_buffer._global_upload_ringbuffers_begin[m_rhi->getCurrentFrameIndex()] +
+                        m_global_render_resource->_storage_buffer._global_upload_ringbuffers_size[m_rhi->getCurrentFrameIndex()]));
 
-                for (auto& pair2 : mesh_instanced)
-                {
-                    VulkanMesh& mesh       = (*pair2.first);
-                    auto&       mesh_nodes = pair2.second;
+                MeshPointLightShadowPerframeStorageBufferObject& perframe_storage_buffer_object =
+                        (*reinterpret_cast<MeshPointLightShadowPerframeStorageBufferObject*>(
+                        reinterpret_cast<uintptr_t>(
+                            m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
+                        perframe_dynamic_offset));
+                perframe_storage_buffer_object = m_mesh_point_light_shadow_perframe_storage_buffer_object;
+                perframe_storage_buffer_object.first_point_light_index = light_index;
+                perframe_storage_buffer_object.point_light_num         = 1;
 
-                    uint32_t total_instance_count = static_cast<uint32_t>(mesh_nodes.size());
-                    if (total_instance_count > 0)
-                    {
-                        // bind per mesh
-                        m_rhi->cmdBindDescriptorSetsPFN(m_rhi->getCurrentCommandBuffer(),
-                                                        RHI_PIPELINE_BIND_POINT_GRAPHICS,
-                                                        m_render_pipelines[0].layout,
-                                                        1,
-                                                        1,
-                                                        &mesh.mesh_vertex_blending_descriptor_set,
-                                                        0,
-                                                        NULL);
-
-                        RHIBuffer*     vertex_buffers[] = {mesh.mesh_vertex_position_buffer};
-                        RHIDeviceSize offsets[]        = {0};
-                        m_rhi->cmdBindVertexBuffersPFN(
-                            m_rhi->getCurrentCommandBuffer(), 0, 1, vertex_buffers, offsets);
-                        m_rhi->cmdBindIndexBufferPFN(
-                            m_rhi->getCurrentCommandBuffer(), mesh.mesh_index_buffer, 0, RHI_INDEX_TYPE_UINT16);
-
-                        uint32_t drawcall_max_instance_count =
-                            (sizeof(MeshPointLightShadowPerdrawcallStorageBufferObject::mesh_instances) /
-                             sizeof(MeshPointLightShadowPerdrawcallStorageBufferObject::mesh_instances[0]));
-                        uint32_t drawcall_count = roundUp(total_instance_count, drawcall_max_instance_count) / drawcall_max_instance_count;
-
-                        for (uint32_t drawcall_index = 0; drawcall_index < drawcall_count; ++drawcall_index)
-                        {
-                            uint32_t current_instance_count =
-                                ((total_instance_count - drawcall_max_instance_count * drawcall_index) <
-                                 drawcall_max_instance_count) ?
-                                    (total_instance_count - drawcall_max_instance_count * drawcall_index) :
-                                    drawcall_max_instance_count;
-
-                            // perdrawcall storage buffer
-                            uint32_t perdrawcall_dynamic_offset =
-                                roundUp(m_global_render_resource->_storage_buffer
-                                            ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()],
-                                        m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                            m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] =
-                                perdrawcall_dynamic_offset + sizeof(MeshPointLightShadowPerdrawcallStorageBufferObject);
-                            assert(m_global_render_resource->_storage_buffer
-                                       ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] <=
-                                   (m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_begin[m_rhi->getCurrentFrameIndex()] +
-                                    m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_size[m_rhi->getCurrentFrameIndex()]));
-
-                            MeshPointLightShadowPerdrawcallStorageBufferObject& perdrawcall_storage_buffer_object =
-                                (*reinterpret_cast<MeshPointLightShadowPerdrawcallStorageBufferObject*>(
-                                    reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
-                                                                    ._global_upload_ringbuffer_memory_pointer) +
-                                    perdrawcall_dynamic_offset));
-                            for (uint32_t i = 0; i < current_instance_count; ++i)
-                            {
-                                perdrawcall_storage_buffer_object.mesh_instances[i].model_matrix =
-                                    *mesh_nodes[drawcall_max_instance_count * drawcall_index + i].model_matrix;
-                                perdrawcall_storage_buffer_object.mesh_instances[i].enable_vertex_blending =
-                                    mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices ? 1.0 :
-                                                                                                                  -1.0;
-                            }
-
-                            // per drawcall vertex blending storage buffer
-                            uint32_t per_drawcall_vertex_blending_dynamic_offset;
-                            bool     least_one_enable_vertex_blending = true;
-                            for (uint32_t i = 0; i < current_instance_count; ++i)
-                            {
-                                if (!mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices)
-                                {
-                                    least_one_enable_vertex_blending = false;
-                                    break;
-                                }
-                            }
-                            if (mesh.enable_vertex_blending)
-                            {
-                                per_drawcall_vertex_blending_dynamic_offset = roundUp(
-                                    m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()],
-                                    m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                                m_global_render_resource->_storage_buffer
-                                    ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] =
-                                    per_drawcall_vertex_blending_dynamic_offset +
-                                    sizeof(MeshPointLightShadowPerdrawcallVertexBlendingStorageBufferObject);
-                                assert(m_global_render_resource->_storage_buffer
-                                           ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] <=
-                                       (m_global_render_resource->_storage_buffer
-                                            ._global_upload_ringbuffers_begin[m_rhi->getCurrentFrameIndex()] +
-                                        m_global_render_resource->_storage_buffer
-                                            ._global_upload_ringbuffers_size[m_rhi->getCurrentFrameIndex()]));
-
-                                MeshPointLightShadowPerdrawcallVertexBlendingStorageBufferObject&
-                                    per_drawcall_vertex_blending_storage_buffer_object =
-                                        (*reinterpret_cast<
-                                            MeshPointLightShadowPerdrawcallVertexBlendingStorageBufferObject*>(
-                                            reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
-                                                                            ._global_upload_ringbuffer_memory_pointer) +
-                                            per_drawcall_vertex_blending_dynamic_offset));
-                                for (uint32_t i = 0; i < current_instance_count; ++i)
-                                {
-                                    if (mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices)
-                                    {
-                                        for (uint32_t j = 0;
-                                             j <
-                                             mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_count;
-                                             ++j)
-                                        {
-                                            per_drawcall_vertex_blending_storage_buffer_object
-                                                .joint_matrices[s_mesh_vertex_blending_max_joint_count * i + j] =
-                                                mesh_nodes[drawcall_max_instance_count * drawcall_index + i]
-                                                    .joint_matrices[j];
-                                        }
-                                    }
-                                }
-                            }
-                            else
-                            {
-                                per_drawcall_vertex_blending_dynamic_offset = 0;
-                            }
-
-                            // bind perdrawcall
-                            uint32_t dynamic_offsets[3] = {perframe_dynamic_offset,
-                                                           perdrawcall_dynamic_offset,
-                                                           per_drawcall_vertex_blending_dynamic_offset};
-                            m_rhi->cmdBindDescriptorSetsPFN(m_rhi->getCurrentCommandBuffer(),
-                                                            RHI_PIPELINE_BIND_POINT_GRAPHICS,
-                                                            m_render_pipelines[0].layout,
-                                                            0,
-                                                            1,
-                                                            &m_descriptor_infos[0].descriptor_set,
-                                                            (sizeof(dynamic_offsets) / sizeof(dynamic_offsets[0])),
-                                                            dynamic_offsets);
-
-                            m_rhi->cmdDrawIndexedPFN(m_rhi->getCurrentCommandBuffer(),
-                                                     mesh.mesh_index_count,
-                                                     current_instance_count,
-                                                     0,
-                                                     0,
-                                                     0);
-                        }
-                    }
-                }
+                drawCasters(perframe_dynamic_offset);
             }
 
             m_rhi->popEvent(m_rhi->getCurrentCommandBuffer());
@@ -699,4 +598,110 @@ namespace Piccolo
         m_rhi->cmdEndRenderPassPFN(m_rhi->getCurrentCommandBuffer());
     }
 
+    void PointLightShadowPass::drawCasters(uint32_t perframe_dynamic_offset)
+    {
+        for (const RenderDrawBatch& batch : m_mesh_draw_list.getBatches())
+        {
+            VulkanMesh&               mesh       = *batch.mesh;
+            const RenderDrawInstance* mesh_nodes = m_mesh_draw_list.getInstances(batch);
+
+            uint32_t total_instance_count = batch.instance_count;
+            if (total_instance_count > 0)
+            {
+                // bind per mesh
+                m_rhi->cmdBindDescriptorSetsPFN(m_rhi->getCurrentCommandBuffer(),
+                                                RHI_PIPELINE_BIND_POINT_GRAPHICS,
+                                                m_render_pipelines[0].layout,
+                                                1,
+                                                1,
+                                                &mesh.mesh_vertex_blending_descriptor_set,
+                                                0,
+                                                NULL);
+
+                RHIBuffer*     vertex_buffers[] = {mesh.mesh_vertex_position_buffer};
+                RHIDeviceSize offsets[]        = {0};
+
+                // a pre-skinned instance reads the vertices the skinning pass wrote for it
+                if (batch.is_pre_skinned)
+                {
+                    vertex_buffers[0] = m_global_render_resource->_skinned_vertex_buffer._position_buffer;
+                    offsets[0]        = sizeof(MeshVertex::VulkanMeshVertexPostition) * batch.skinned_vertex_offset;
+                }
+
+                m_rhi->cmdBindVertexBuffersPFN(
+                    m_rhi->getCurrentCommandBuffer(), 0, 1, vertex_buffers, offsets);
+                m_rhi->cmdBindIndexBufferPFN(
+                    m_rhi->getCurrentCommandBuffer(), mesh.mesh_index_buffer, 0, RHI_INDEX_TYPE_UINT16);
+
+                uint32_t drawcall_max_instance_count =
+                    (sizeof(MeshPointLightShadowPerdrawcallStorageBufferObject::mesh_instances) /
+                     sizeof(MeshPointLightShadowPerdrawcallStorageBufferObject::mesh_instances[0]));
+                uint32_t drawcall_count = roundUp(total_instance_count, drawcall_max_instance_count) / drawcall_max_instance_count;
+
+                for (uint32_t drawcall_index = 0; drawcall_index < drawcall_count; ++drawcall_index)
+                {
+                    uint32_t current_instance_count =
+                        ((total_instance_count - drawcall_max_instance_count * drawcall_index) <
+                         drawcall_max_instance_count) ?
+                            (total_instance_count - drawcall_max_instance_count * drawcall_index) :
+                            drawcall_max_instance_count;
+
+                    // perdrawcall storage buffer
+                    uint32_t perdrawcall_dynamic_offset =
+                        roundUp(m_global_render_resource->_storage_buffer
+                                    ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()],
+                                m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
+                    m_global_render_resource->_storage_buffer
+                        ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] =
+                        perdrawcall_dynamic_offset + sizeof(MeshPointLightShadowPerdrawcallStorageBufferObject);
+                    assert(m_global_render_resource->_storage_buffer
+                               ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] <=
+                           (m_global_render_resource->_storage_buffer
+                                ._global_upload_ringbuffers_begin[m_rhi->getCurrentFrameIndex()] +
+                            m_global_render_resource->_storage_buffer
+                                ._global_upload_ringbuffers_size[m_rhi->getCurrentFrameIndex()]));
+
+                    MeshPointLightShadowPerdrawcallStorageBufferObject& perdrawcall_storage_buffer_object =
+                        (*reinterpret_cast<MeshPointLightShadowPerdrawcallStorageBufferObject*>(
+                            reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
+                                                            ._global_upload_ringbuffer_memory_pointer) +
+                            perdrawcall_dynamic_offset));
+                    for (uint32_t i = 0; i < current_instance_count; ++i)
+                    {
+                        perdrawcall_storage_buffer_object.mesh_instances[i].model_matrix =
+                            *mesh_nodes[drawcall_max_instance_count * drawcall_index + i].model_matrix;
+                        perdrawcall_storage_buffer_object.mesh_instances[i].enable_vertex_blending =
+                            mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_count > 0 ? 1.0 : -1.0;
+                        perdrawcall_storage_buffer_object.mesh_instances[i].joint_palette_offset =
+                            mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_palette_offset;
+                    }
+
+                    // the skinned instances read their joints from the palette of the frame
+                    uint32_t per_drawcall_vertex_blending_dynamic_offset =
+                        m_global_render_resource->_storage_buffer._joint_palette_dynamic_offset;
+
+                    // bind perdrawcall
+                    uint32_t dynamic_offsets[3] = {perframe_dynamic_offset,
+                                                   perdrawcall_dynamic_offset,
+                                                   per_drawcall_vertex_blending_dynamic_offset};
+                    m_rhi->cmdBindDescriptorSetsPFN(m_rhi->getCurrentCommandBuffer(),
+                                                    RHI_PIPELINE_BIND_POINT_GRAPHICS,
+                                                    m_render_pipelines[0].layout,
+                                                    0,
+                                                    1,
+                                                    &m_descriptor_infos[0].descriptor_set,
+                                                    (sizeof(dynamic_offsets) / sizeof(dynamic_offsets[0])),
+                                                    dynamic_offsets);
+
+                    m_rhi->cmdDrawIndexedPFN(m_rhi->getCurrentCommandBuffer(),
+                                             mesh.mesh_index_count,
+                                             current_instance_count,
+                                             0,
+                                             0,
+                                             0);
+                }
+            }
+        }
+    }
+
 } // namespace Piccolo
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "runtime/function/render/render_draw_list.h"
 #include "runtime/function/render/render_pass.h"
 
 namespace Piccolo
@@ -24,9 +25,15 @@ namespace Piccolo
         void setupPipelines();
         void setupDescriptorSet();
         void drawModel();
+        void drawCasters(uint32_t perframe_dynamic_offset);
 
     private:
         RHIDescriptorSetLayout* m_per_mesh_layout;
         MeshPointLightShadowPerframeStorageBufferObject m_mesh_point_light_shadow_perframe_storage_buffer_object;
+        RenderDrawList                                  m_mesh_draw_list;
+
+        // loads the shadow map instead of clearing it, so that the layers of the cached lights are kept
+        RHIRenderPass* m_cached_layers_render_pass {nullptr};
+        bool           m_has_drawn_layers {false};
     };
 } // namespace Piccolo
@@ -10,6 +10,8 @@
 #include <vk_mem_alloc.h>
 #include <vulkan/vulkan.h>
 
+#include <vector>
+
 namespace Piccolo
 {
     static const uint32_t s_point_light_shadow_map_dimension       = 2048;
@@ -18,7 +20,31 @@ namespace Piccolo
     // TODO: 64 may not be the best
     static uint32_t const s_mesh_per_drawcall_max_instance_count = 64;
     static uint32_t const s_mesh_vertex_blending_max_joint_count = 1024;
+    // the joints of all the skinned entities of a frame, the entities which no longer fit are drawn in bind pose
+    static uint32_t const s_mesh_joint_palette_max_joint_count   = 65536;
     static uint32_t const s_max_point_light_count                = 15;
+    static uint32_t const s_max_directional_light_cascade_count  = 4;
+    // point lights which moved or whose casters changed are redrawn oldest first, at most this many in a frame
+    static uint32_t const s_point_light_shadow_update_budget     = 4;
+    // point lights beyond s_max_point_light_count are shaded through the clusters but cast no shadow
+    static uint32_t const s_max_clustered_point_light_count      = 512;
+    static uint32_t const s_point_light_cluster_dimension_x      = 16;
+    static uint32_t const s_point_light_cluster_dimension_y      = 9;
+    static uint32_t const s_point_light_cluster_dimension_z      = 24;
+    static uint32_t const s_point_light_cluster_count            = s_point_light_cluster_dimension_x *
+                                                                   s_point_light_cluster_dimension_y *
+                                                                   s_point_light_cluster_dimension_z;
+    static uint32_t const s_max_point_light_cluster_index_count  = 65536;
+    static uint32_t const s_mesh_cull_group_size                 = 64;
+    static uint32_t const s_mesh_cull_max_instance_count         = 32768;
+    static uint32_t const s_mesh_cull_max_draw_count             = 4096;
+    static uint32_t const s_mesh_skinning_group_size             = 64;
+    // the pre-skinned vertices of a frame, the skinned entities beyond them are blended in the vertex shaders
+    static uint32_t const s_mesh_skinning_max_vertex_count       = 524288;
+    // one thread per radix digit, a sort block is scattered by one group
+    static uint32_t const s_particle_sort_group_size             = 256;
+    static uint32_t const s_particle_sort_block_size             = 1024;
+    static uint32_t const s_particle_sort_tile_size              = 32;
     // should sync the macros in "shader_include/constants.h"
 
     struct VulkanSceneDirectionalLight
@@ -44,19 +70,38 @@ namespace Piccolo
         float                       _padding_camera_position;
         Vector3                     ambient_light;
         float                       _padding_ambient_light;
-        uint32_t                    point_light_num;
-        uint32_t                    _padding_point_light_num_1;
-        uint32_t                    _padding_point_light_num_2;
-        uint32_t                    _padding_point_light_num_3;
-        VulkanScenePointLight       scene_point_lights[s_max_point_light_count];
         VulkanSceneDirectionalLight scene_directional_light;
-        Matrix4x4                   directional_light_proj_view;
+        uint32_t                    directional_light_cascade_count;
+        uint32_t                    _padding_directional_light_cascade_count_1;
+        uint32_t                    _padding_directional_light_cascade_count_2;
+        uint32_t                    _padding_directional_light_cascade_count_3;
+        Matrix4x4                   directional_light_proj_views[s_max_directional_light_cascade_count];
+    };
+
+    // lights of cluster x + X * (y + Y * z) are light_indices[offset, offset + count)
+    struct VulkanPointLightClusterRange
+    {
+        uint32_t offset;
+        uint32_t count;
+    };
+
+    // froxels of the main camera frustum, logarithmic in the view depth, with the point lights touching them
+    struct MeshPointLightClusterStorageBufferObject
+    {
+        uint32_t                     point_light_num;
+        uint32_t                     light_index_num;
+        // the z slice of a view depth d is log(d) * depth_slice_scale + depth_slice_bias
+        float                        depth_slice_scale;
+        float                        depth_slice_bias;
+        VulkanScenePointLight        point_lights[s_max_clustered_point_light_count];
+        VulkanPointLightClusterRange cluster_ranges[s_point_light_cluster_count];
+        uint32_t                     light_indices[s_max_point_light_cluster_index_count];
     };
 
     struct VulkanMeshInstance
     {
         float     enable_vertex_blending;
-        float     _padding_enable_vertex_blending_1;
+        uint32_t  joint_palette_offset;
         float     _padding_enable_vertex_blending_2;
         float     _padding_enable_vertex_blending_3;
         Matrix4x4 model_matrix;
@@ -67,9 +112,53 @@ namespace Piccolo
         VulkanMeshInstance mesh_instances[s_mesh_per_drawcall_max_instance_count];
     };
 
-    struct MeshPerdrawcallVertexBlendingStorageBufferObject
+    // affine joint matrix, the first three rows of the matrix the vertex shader multiplies the positions by
+    struct VulkanJointMatrix
+    {
+        Vector4 rows[3];
+    };
+
+    struct MeshJointPaletteStorageBufferObject
+    {
+        VulkanJointMatrix joint_matrices[s_mesh_joint_palette_max_joint_count];
+    };
+
+    // gpu driven mesh culling
+    struct MeshCullPerframeStorageBufferObject
+    {
+        Vector4  frustum_planes[6];
+        uint32_t instance_count;
+        uint32_t _padding_instance_count_1;
+        uint32_t _padding_instance_count_2;
+        uint32_t _padding_instance_count_3;
+    };
+
+    struct VulkanMeshCullInstance
+    {
+        Matrix4x4 model_matrix;
+        Vector3   bounding_box_min;
+        uint32_t  draw_index;
+        Vector3   bounding_box_max;
+        float     _padding_bounding_box_max;
+    };
+
+    // the layout of VkDrawIndexedIndirectCommand
+    struct VulkanDrawIndexedIndirectCommand
     {
-        Matrix4x4 joint_matrices[s_mesh_vertex_blending_max_joint_count * s_mesh_per_drawcall_max_instance_count];
+        uint32_t index_count;
+        uint32_t instance_count;
+        uint32_t first_index;
+        int32_t  vertex_offset;
+        uint32_t first_instance;
+    };
+
+    // pre-skinning of one entity, the inputs are the vertex buffers of its mesh
+    struct MeshSkinningPerdispatchStorageBufferObject
+    {
+        uint32_t vertex_count;
+        uint32_t joint_palette_offset;
+        uint32_t skinned_vertex_offset;
+        uint32_t joint_count;
     };
 
     struct MeshPerMaterialUniformBufferObject
@@ -88,8 +177,9 @@ namespace Piccolo
 
     struct MeshPointLightShadowPerframeStorageBufferObject
     {
+        // the lights drawn are [first_point_light_index, first_point_light_index + point_light_num)
         uint32_t point_light_num;
-        uint32_t _padding_point_light_num_1;
+        uint32_t first_point_light_index;
         uint32_t _padding_point_light_num_2;
         uint32_t _padding_point_light_num_3;
         Vector4  point_lights_position_and_radius[s_max_point_light_count];
@@ -100,11 +190,6 @@ namespace Piccolo
         VulkanMeshInstance mesh_instances[s_mesh_per_drawcall_max_instance_count];
     };
 
-    struct MeshPointLightShadowPerdrawcallVertexBlendingStorageBufferObject
-    {
-        Matrix4x4 joint_matrices[s_mesh_vertex_blending_max_joint_count * s_mesh_per_drawcall_max_instance_count];
-    };
-
     struct MeshDirectionalLightShadowPerframeStorageBufferObject
     {
         Matrix4x4 light_proj_view;
@@ -115,11 +200,6 @@ namespace Piccolo
         VulkanMeshInstance mesh_instances[s_mesh_per_drawcall_max_instance_count];
     };
 
-    struct MeshDirectionalLightShadowPerdrawcallVertexBlendingStorageBufferObject
-    {
-        Matrix4x4 joint_matrices[s_mesh_vertex_blending_max_joint_count * s_mesh_per_drawcall_max_instance_count];
-    };
-
     struct AxisStorageBufferObject
     {
         Matrix4x4 model_matrix  = Matrix4x4::IDENTITY;
@@ -165,16 +245,14 @@ namespace Piccolo
         Matrix4x4 model_matrices[s_mesh_per_drawcall_max_instance_count];
         uint32_t  node_ids[s_mesh_per_drawcall_max_instance_count];
         float     enable_vertex_blendings[s_mesh_per_drawcall_max_instance_count];
-    };
-
-    struct MeshInefficientPickPerdrawcallVertexBlendingStorageBufferObject
-    {
-        Matrix4x4 joint_matrices[s_mesh_vertex_blending_max_joint_count * s_mesh_per_drawcall_max_instance_count];
+        uint32_t  joint_palette_offsets[s_mesh_per_drawcall_max_instance_count];
     };
 
     // mesh
     struct VulkanMesh
     {
+        uint32_t sort_id {0}; // dense id used by the draw list sort keys
+
         bool enable_vertex_blending;
 
         uint32_t mesh_vertex_count;
@@ -188,7 +266,9 @@ namespace Piccolo
         RHIBuffer*    mesh_vertex_joint_binding_buffer;
         VmaAllocation mesh_vertex_joint_binding_buffer_allocation;
 
-        RHIDescriptorSet* mesh_vertex_blending_descriptor_set;
+        RHIDescriptorSet* mesh_vertex_blending_descriptor_set {nullptr};
+        // the vertex buffers read by the skinning pass, null unless pre-skinning is enabled
+        RHIDescriptorSet* mesh_skinning_descriptor_set {nullptr};
 
         RHIBuffer*    mesh_vertex_varying_buffer;
         VmaAllocation mesh_vertex_varying_buffer_allocation;
@@ -202,6 +282,8 @@ namespace Piccolo
     // material
     struct VulkanPBRMaterial
     {
+        uint32_t sort_id {0}; // dense id used by the draw list sort keys
+
         RHIImage*       base_color_texture_image;
         RHIImageView*   base_color_image_view;
         VmaAllocation   base_color_image_allocation;
@@ -225,19 +307,38 @@ namespace Piccolo
         RHIBuffer*      material_uniform_buffer;
         VmaAllocation   material_uniform_buffer_allocation;
 
-        RHIDescriptorSet* material_descriptor_set;
+        RHIDescriptorSet* material_descriptor_set {nullptr};
     };
 
     // nodes
     struct RenderMeshNode
     {
         const Matrix4x4*   model_matrix {nullptr};
-        const Matrix4x4*   joint_matrices {nullptr};
+        uint32_t           joint_palette_offset {0};
         uint32_t           joint_count {0};
         VulkanMesh*        ref_mesh {nullptr};
         VulkanPBRMaterial* ref_material {nullptr};
         uint32_t           node_id;
         bool               enable_vertex_blending {false};
+        // drawn from the vertices the skinning pass wrote, starting at skinned_vertex_offset
+        bool     is_pre_skinned {false};
+        uint32_t skinned_vertex_offset {0};
+    };
+
+    struct RenderDirectionalLightCascade
+    {
+        Matrix4x4                   light_proj_view {Matrix4x4::IDENTITY};
+        std::vector<RenderMeshNode> visible_mesh_nodes;
+        // the tile drawn for the cascade last frame holds the same casters seen from the same light, so it can be kept
+        bool is_cached {false};
+    };
+
+    struct RenderPointLightShadow
+    {
+        std::vector<RenderMeshNode> visible_mesh_nodes;
+        // the two layers of the light were drawn with the same casters from the same position, or the light waits for
+        // its turn in the update budget and keeps them a little longer
+        bool is_cached {false};
     };
 
     struct RenderAxisNode
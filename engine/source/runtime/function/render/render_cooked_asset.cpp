@@ -0,0 +1,183 @@
+#include "runtime/function/render/render_cooked_asset.h"
+
+#include "runtime/core/base/macro.h"
+#include "runtime/core/meta/binary_stream.h"
+
+#include "runtime/platform/file_service/file_service.h"
+
+#include "runtime/resource/asset_manager/asset_manager.h"
+
+#include <cstdlib>
+#include <fstream>
+
+namespace Piccolo
+{
+    namespace
+    {
+        bool writeCookedFile(const std::filesystem::path& cooked_path,
+                             uint64_t                     format,
+                             const BinaryWriter&          writer,
+                             const void*                  data0,
+                             size_t                       size0,
+                             const void*                  data1 = nullptr,
+                             size_t                       size1 = 0)
+        {
+            std::ofstream cooked_file(cooked_path, std::ios::binary | std::ios::trunc);
+            if (!cooked_file)
+            {
+                LOG_ERROR("open file {} failed!", cooked_path.generic_string());
+                return false;
+            }
+
+            CookedAssetHeader header;
+            header.magic       = AssetManager::s_cooked_asset_magic;
+            header.version     = AssetManager::s_cooked_asset_version;
+            header.schema_hash = format;
+
+            cooked_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            cooked_file.write(writer.getBuffer().data(), writer.getBuffer().size());
+            cooked_file.write(static_cast<const char*>(data0), size0);
+            if (data1)
+            {
+                cooked_file.write(static_cast<const char*>(data1), size1);
+            }
+            cooked_file.flush();
+
+            return static_cast<bool>(cooked_file);
+        }
+
+        bool openCookedFile(const std::filesystem::path& cooked_path, uint64_t format, MappedFile& cooked_file)
+        {
+            if (cooked_path.empty() || !cooked_file.open(cooked_path))
+            {
+                return false;
+            }
+
+            CookedAssetHeader header;
+            if (cooked_file.size() < sizeof(header))
+            {
+                return false;
+            }
+            std::memcpy(&header, cooked_file.data(), sizeof(header));
+            return header.magic == AssetManager::s_cooked_asset_magic &&
+                   header.version == AssetManager::s_cooked_asset_version && header.schema_hash == format;
+        }
+    } // namespace
+
+    bool CookedRenderAsset::saveTexture(const std::filesystem::path& cooked_path,
+                                        const TextureData&           texture,
+                                        uint32_t                     channel_count,
+                                        uint32_t                     channel_size)
+    {
+        BinaryWriter writer;
+        writer.writeValue(texture.m_width);
+        writer.writeValue(texture.m_height);
+        writer.writeValue(channel_count);
+        writer.writeValue(channel_size);
+
+        size_t pixels_size = static_cast<size_t>(texture.m_width) * texture.m_height * channel_count * channel_size;
+        return writeCookedFile(cooked_path, s_texture_format, writer, texture.m_pixels, pixels_size);
+    }
+
+    std::shared_ptr<TextureData> CookedRenderAsset::loadTexture(const std::filesystem::path& cooked_path,
+                                                                uint32_t                     channel_count,
+                                                                uint32_t                     channel_size)
+    {
+        MappedFile cooked_file;
+        if (!openCookedFile(cooked_path, s_texture_format, cooked_file))
+        {
+            return nullptr;
+        }
+
+        BinaryReader reader(cooked_file.data() + sizeof(CookedAssetHeader), cooked_file.data() + cooked_file.size());
+
+        uint32_t width = 0, height = 0, cooked_channel_count = 0, cooked_channel_size = 0;
+        reader.readValue(width);
+        reader.readValue(height);
+        reader.readValue(cooked_channel_count);
+        reader.readValue(cooked_channel_size);
+
+        size_t pixels_size = static_cast<size_t>(width) * height * channel_count * channel_size;
+        if (reader.hasError() || cooked_channel_count != channel_count || cooked_channel_size != channel_size ||
+            pixels_size == 0 || reader.getRemainingSize() < pixels_size)
+        {
+            LOG_WARN("cooked texture {} does not match, decoding the source instead", cooked_path.generic_string());
+            return nullptr;
+        }
+
+        std::shared_ptr<TextureData> texture = std::make_shared<TextureData>();
+        // freed by TextureData like the pixels of stb_image
+        texture->m_pixels = std::malloc(pixels_size);
+        reader.readBytes(texture->m_pixels, pixels_size);
+        texture->m_width  = width;
+        texture->m_height = height;
+
+        return texture;
+    }
+
+    bool CookedRenderAsset::saveStaticMesh(const std::filesystem::path& cooked_path,
+                                           const StaticMeshData&        mesh_data,
+                                           const AxisAlignedBox&        bounding_box)
+    {
+        BinaryWriter writer;
+        writer.writeValue(static_cast<uint64_t>(mesh_data.m_vertex_buffer->m_size));
+        writer.writeValue(static_cast<uint64_t>(mesh_data.m_index_buffer->m_size));
+        for (const Vector3& corner : {bounding_box.getMinCorner(), bounding_box.getMaxCorner()})
+        {
+            writer.writeValue(corner.x);
+            writer.writeValue(corner.y);
+            writer.writeValue(corner.z);
+        }
+
+        return writeCookedFile(cooked_path,
+                               s_static_mesh_format,
+                               writer,
+                               mesh_data.m_vertex_buffer->m_data,
+                               mesh_data.m_vertex_buffer->m_size,
+                               mesh_data.m_index_buffer->m_data,
+                               mesh_data.m_index_buffer->m_size);
+    }
+
+    bool CookedRenderAsset::loadStaticMesh(const std::filesystem::path& cooked_path,
+                                           StaticMeshData&              mesh_data,
+                                           AxisAlignedBox&              bounding_box)
+    {
+        MappedFile cooked_file;
+        if (!openCookedFile(cooked_path, s_static_mesh_format, cooked_file))
+        {
+            return false;
+        }
+
+        BinaryReader reader(cooked_file.data() + sizeof(CookedAssetHeader), cooked_file.data() + cooked_file.size());
+
+        uint64_t vertex_buffer_size = 0, index_buffer_size = 0;
+        reader.readValue(vertex_buffer_size);
+        reader.readValue(index_buffer_size);
+
+        Vector3 corners[2];
+        for (Vector3& corner : corners)
+        {
+            reader.readValue(corner.x);
+            reader.readValue(corner.y);
+            reader.readValue(corner.z);
+        }
+
+        if (reader.hasError() || reader.getRemainingSize() != vertex_buffer_size + index_buffer_size)
+        {
+            LOG_WARN("cooked mesh {} is truncated, loading the source instead", cooked_path.generic_string());
+            return false;
+        }
+
+        mesh_data.m_vertex_buffer = std::make_shared<BufferData>(static_cast<size_t>(vertex_buffer_size));
+        mesh_data.m_index_buffer  = std::make_shared<BufferData>(static_cast<size_t>(index_buffer_size));
+        reader.readBytes(mesh_data.m_vertex_buffer->m_data, mesh_data.m_vertex_buffer->m_size);
+        reader.readBytes(mesh_data.m_index_buffer->m_data, mesh_data.m_index_buffer->m_size);
+
+        if (vertex_buffer_size != 0)
+        {
+            bounding_box.merge(corners[0]);
+            bounding_box.merge(corners[1]);
+        }
+        return true;
+    }
+} // namespace Piccolo
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "runtime/core/math/axis_aligned.h"
+#include "runtime/function/render/render_type.h"
+
+#include <filesystem>
+#include <memory>
+
+namespace Piccolo
+{
+    // binary forms of the render assets written by the asset cooker, they are loaded instead of decoding the images
+    // and expanding the obj files, the file starts with a CookedAssetHeader like the cooked reflected assets
+    class CookedRenderAsset
+    {
+    public:
+        // kept in CookedAssetHeader::schema_hash, bump when the layout of a form changes
+        static constexpr uint64_t s_texture_format     = 0x7465787475726501; // "texture" 1
+        static constexpr uint64_t s_static_mesh_format = 0x6d65736801;       // "mesh" 1
+
+        static bool saveTexture(const std::filesystem::path& cooked_path,
+                                const TextureData&           texture,
+                                uint32_t                     channel_count,
+                                uint32_t                     channel_size);
+        // nullptr when the file is missing or holds another pixel layout, the caller sets the format
+        static std::shared_ptr<TextureData>
+        loadTexture(const std::filesystem::path& cooked_path, uint32_t channel_count, uint32_t channel_size);
+
+        static bool saveStaticMesh(const std::filesystem::path& cooked_path,
+                                   const StaticMeshData&        mesh_data,
+                                   const AxisAlignedBox&        bounding_box);
+        // bounding_box is merged with the box of the mesh
+        static bool
+        loadStaticMesh(const std::filesystem::path& cooked_path, StaticMeshData& mesh_data, AxisAlignedBox& bounding_box);
+    };
+} // namespace Piccolo
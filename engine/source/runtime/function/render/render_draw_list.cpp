@@ -0,0 +1,124 @@
+#include "runtime/function/render/render_draw_list.h"
+
+#include <cstring>
+
+namespace Piccolo
+{
+    void RenderDrawList::build(const std::vector<RenderMeshNode>& nodes,
+                               bool                               group_by_material,
+                               const Vector3*                     view_position,
+                               bool                               vertex_blending_only)
+    {
+        m_keys.resize(nodes.size());
+        m_indices.resize(nodes.size());
+        m_batches.clear();
+
+        constexpr uint64_t material_id_mask = (uint64_t(1) << k_material_id_bits) - 1;
+        constexpr uint64_t mesh_id_mask     = (uint64_t(1) << k_mesh_id_bits) - 1;
+
+        uint32_t node_count = 0;
+        for (uint32_t node_index = 0; node_index < static_cast<uint32_t>(nodes.size()); ++node_index)
+        {
+            const RenderMeshNode& node = nodes[node_index];
+            if (vertex_blending_only && !node.enable_vertex_blending)
+            {
+                continue;
+            }
+
+            uint64_t material_id = group_by_material ? (node.ref_material->sort_id & material_id_mask) : 0;
+            uint64_t mesh_id     = node.ref_mesh->sort_id & mesh_id_mask;
+
+            // the bits of a non negative float are ordered like its value, the high bits are enough to sort by
+            uint64_t depth = 0;
+            if (view_position)
+            {
+                float    squared_distance = view_position->squaredDistance(node.model_matrix->getTrans());
+                uint32_t distance_bits;
+                memcpy(&distance_bits, &squared_distance, sizeof(distance_bits));
+                depth = distance_bits >> (32 - k_depth_bits);
+            }
+
+            m_keys[node_count] = (material_id << (k_mesh_id_bits + k_depth_bits)) | (mesh_id << k_depth_bits) | depth;
+            m_indices[node_count] = node_index;
+            ++node_count;
+        }
+
+        m_keys.resize(node_count);
+        m_indices.resize(node_count);
+        m_instances.resize(node_count);
+
+        radixSort();
+
+        // gather the instances in key order and split them into batches
+        for (uint32_t sorted_index = 0; sorted_index < node_count; ++sorted_index)
+        {
+            const RenderMeshNode& node = nodes[m_indices[sorted_index]];
+
+            RenderDrawInstance& instance = m_instances[sorted_index];
+            instance.model_matrix         = node.model_matrix;
+            instance.joint_palette_offset = node.joint_palette_offset;
+            instance.joint_count          = node.enable_vertex_blending ? node.joint_count : 0;
+            instance.node_id              = node.node_id;
+
+            VulkanPBRMaterial* material = group_by_material ? node.ref_material : nullptr;
+            if (m_batches.empty() || m_batches.back().mesh != node.ref_mesh || m_batches.back().material != material ||
+                m_batches.back().is_pre_skinned || node.is_pre_skinned)
+            {
+                RenderDrawBatch batch;
+                batch.material              = material;
+                batch.mesh                  = node.ref_mesh;
+                batch.first_instance        = sorted_index;
+                batch.is_pre_skinned        = node.is_pre_skinned;
+                batch.skinned_vertex_offset = node.skinned_vertex_offset;
+                m_batches.push_back(batch);
+            }
+            ++m_batches.back().instance_count;
+        }
+    }
+
+    void RenderDrawList::radixSort()
+    {
+        size_t count = m_keys.size();
+        if (count < 2)
+        {
+            return;
+        }
+
+        m_scratch_keys.resize(count);
+        m_scratch_indices.resize(count);
+
+        // least significant digit first, 8 bits per pass, stable so equal keys keep the visible node order
+        for (uint32_t shift = 0; shift < 64; shift += 8)
+        {
+            uint32_t histogram[256] = {};
+            for (size_t i = 0; i < count; ++i)
+            {
+                ++histogram[(m_keys[i] >> shift) & 0xFF];
+            }
+
+            // every key has the same digit, the pass would not move anything
+            if (histogram[(m_keys[0] >> shift) & 0xFF] == count)
+            {
+                continue;
+            }
+
+            uint32_t offset = 0;
+            for (uint32_t digit = 0; digit < 256; ++digit)
+            {
+                uint32_t digit_count = histogram[digit];
+                histogram[digit]     = offset;
+                offset += digit_count;
+            }
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                uint32_t destination           = histogram[(m_keys[i] >> shift) & 0xFF]++;
+                m_scratch_keys[destination]    = m_keys[i];
+                m_scratch_indices[destination] = m_indices[i];
+            }
+
+            m_keys.swap(m_scratch_keys);
+            m_indices.swap(m_scratch_indices);
+        }
+    }
+} // namespace Piccolo
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "runtime/core/math/vector3.h"
+#include "runtime/function/render/render_common.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Piccolo
+{
+    struct RenderDrawInstance
+    {
+        const Matrix4x4* model_matrix {nullptr};
+        uint32_t         joint_palette_offset {0};
+        uint32_t         joint_count {0}; // 0 unless the node enables vertex blending
+        uint32_t         node_id {0};
+    };
+
+    // consecutive instances sharing the same material and mesh, a pre-skinned instance has its own vertices and so
+    // always gets a batch of its own
+    struct RenderDrawBatch
+    {
+        VulkanPBRMaterial* material {nullptr};
+        VulkanMesh*        mesh {nullptr};
+        uint32_t           first_instance {0};
+        uint32_t           instance_count {0};
+        bool               is_pre_skinned {false};
+        uint32_t           skinned_vertex_offset {0};
+    };
+
+    // draw list ordered by a 64 bit sort key, the storage is kept by the owning pass and reused every frame,
+    // so building it does not allocate once the capacity has been reached
+    class RenderDrawList
+    {
+    public:
+        // key layout from the most significant bit: material id (22), mesh id (22), view depth (20)
+        static constexpr uint32_t k_material_id_bits {22};
+        static constexpr uint32_t k_mesh_id_bits {22};
+        static constexpr uint32_t k_depth_bits {20};
+
+        // group_by_material is off for the passes which do not bind materials, such as the shadow passes,
+        // instances are ordered from near to far only when a view position is given, vertex_blending_only keeps the
+        // skinned nodes which the gpu driven path leaves to the cpu
+        void build(const std::vector<RenderMeshNode>& nodes,
+                   bool                               group_by_material,
+                   const Vector3*                     view_position,
+                   bool                               vertex_blending_only = false);
+
+        const std::vector<RenderDrawBatch>& getBatches() const { return m_batches; }
+        const RenderDrawInstance*           getInstances(const RenderDrawBatch& batch) const
+        {
+            return m_instances.data() + batch.first_instance;
+        }
+
+    private:
+        void radixSort();
+
+    private:
+        std::vector<uint64_t> m_keys;
+        std::vector<uint32_t> m_indices;
+        std::vector<uint64_t> m_scratch_keys;
+        std::vector<uint32_t> m_scratch_indices;
+
+        std::vector<RenderDrawInstance> m_instances;
+        std::vector<RenderDrawBatch>    m_batches;
+    };
+} // namespace Piccolo
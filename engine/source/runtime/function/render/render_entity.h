@@ -19,6 +19,14 @@ namespace Piccolo
         bool                   m_enable_vertex_blending {false};
         std::vector<Matrix4x4> m_joint_matrices;
         AxisAlignedBox         m_bounding_box;
+        // where m_joint_matrices are in the joint palette of the frame, set by RenderScene, no joints draw bind pose
+        uint32_t m_joint_palette_offset {0};
+        uint32_t m_joint_palette_count {0};
+        // where the skinning pass writes the vertices, set by RenderScene while pre-skinning is enabled
+        bool     m_is_pre_skinned {false};
+        uint32_t m_skinned_vertex_offset {0};
+        // m_bounding_box in world space, kept in sync by RenderScene
+        AxisAlignedBox m_world_bounding_box;
 
         // material
         size_t  m_material_asset_id {0};
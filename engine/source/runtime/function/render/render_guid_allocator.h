@@ -90,6 +90,9 @@ namespace Piccolo
             return allocated_guids;
         }
 
+        // guid to element, lets the assets be looked up by what they were loaded from
+        const std::unordered_map<size_t, T>& getGuidElements() const { return m_guid_elements_map; }
+
         void clear()
         {
             m_elements_guid_map.clear();
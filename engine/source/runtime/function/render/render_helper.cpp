@@ -259,78 +259,70 @@ namespace Piccolo
         return true;
     }
 
-    Matrix4x4 CalculateDirectionalLightCamera(RenderScene& scene, RenderCamera& camera)
+    void CalculateFrustumSliceCorners(RenderCamera& camera, float split_near, float split_far, Vector3 corners[8])
     {
-        Matrix4x4 proj_view_matrix;
+        Matrix4x4 proj_view_matrix         = camera.getPersProjMatrix() * camera.getViewMatrix();
+        Matrix4x4 inverse_proj_view_matrix = proj_view_matrix.inverse();
+
+        auto unproject = [&inverse_proj_view_matrix](float x, float y, float z) {
+            Vector4 point_with_w = inverse_proj_view_matrix * Vector4(x, y, z, 1.0);
+            return Vector3(point_with_w.x / point_with_w.w,
+                           point_with_w.y / point_with_w.w,
+                           point_with_w.z / point_with_w.w);
+        };
+
+        // the depth of the projection goes from 0 on the near plane to 1 on the far plane, and the points on an edge
+        // of the frustum are linear in the view distance
+        float const near_t = (split_near - camera.m_znear) / (camera.m_zfar - camera.m_znear);
+        float const far_t  = (split_far - camera.m_znear) / (camera.m_zfar - camera.m_znear);
+
+        float const frustum_edges_ndc_space[4][2] = {{-1.0f, -1.0f}, {1.0f, -1.0f}, {1.0f, 1.0f}, {-1.0f, 1.0f}};
+        for (size_t i = 0; i < 4; ++i)
         {
-            Matrix4x4 view_matrix = camera.getViewMatrix();
-            Matrix4x4 proj_matrix = camera.getPersProjMatrix();
-            proj_view_matrix      = proj_matrix * view_matrix;
+            Vector3 near_point =
+                unproject(frustum_edges_ndc_space[i][0], frustum_edges_ndc_space[i][1], 0.0f);
+            Vector3 far_point = unproject(frustum_edges_ndc_space[i][0], frustum_edges_ndc_space[i][1], 1.0f);
+
+            corners[i]     = near_point + (far_point - near_point) * near_t;
+            corners[i + 4] = near_point + (far_point - near_point) * far_t;
         }
+    }
 
-        BoundingBox frustum_bounding_box;
+    Matrix4x4
+    CalculateDirectionalLightCamera(RenderScene& scene, RenderCamera& camera, float split_near, float split_far)
+    {
         // CascadedShadowMaps11 / CreateFrustumPointsFromCascadeInterval
+        BoundingBox frustum_bounding_box;
         {
-            Vector3 const g_frustum_points_ndc_space[8] = {Vector3(-1.0f, -1.0f, 1.0f),
-                                                             Vector3(1.0f, -1.0f, 1.0f),
-                                                             Vector3(1.0f, 1.0f, 1.0f),
-                                                             Vector3(-1.0f, 1.0f, 1.0f),
-                                                             Vector3(-1.0f, -1.0f, 0.0f),
-                                                             Vector3(1.0f, -1.0f, 0.0f),
-                                                             Vector3(1.0f, 1.0f, 0.0f),
-                                                             Vector3(-1.0f, 1.0f, 0.0f)};
-
-            Matrix4x4 inverse_proj_view_matrix = proj_view_matrix.inverse();
+            Vector3 frustum_points[8];
+            CalculateFrustumSliceCorners(camera, split_near, split_far, frustum_points);
 
             frustum_bounding_box.min_bound = Vector3(FLT_MAX, FLT_MAX, FLT_MAX);
-            frustum_bounding_box.max_bound = Vector3(FLT_MIN, FLT_MIN, FLT_MIN);
-
-            size_t const CORNER_COUNT = 8;
-            for (size_t i = 0; i < CORNER_COUNT; ++i)
+            frustum_bounding_box.max_bound = Vector3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+            for (const Vector3& frustum_point : frustum_points)
             {
-                Vector4 frustum_point_with_w = inverse_proj_view_matrix * Vector4(g_frustum_points_ndc_space[i].x,
-                                                                                      g_frustum_points_ndc_space[i].y,
-                                                                                      g_frustum_points_ndc_space[i].z,
-                                                                                      1.0);
-                Vector3   frustum_point        = Vector3(frustum_point_with_w.x / frustum_point_with_w.w,
-                                                frustum_point_with_w.y / frustum_point_with_w.w,
-                                                frustum_point_with_w.z / frustum_point_with_w.w);
-
                 frustum_bounding_box.merge(frustum_point);
             }
         }
 
-        BoundingBox scene_bounding_box;
-        {
-            scene_bounding_box.min_bound = Vector3(FLT_MAX, FLT_MAX, FLT_MAX);
-            scene_bounding_box.max_bound = Vector3(FLT_MIN, FLT_MIN, FLT_MIN);
-
-            for (const RenderEntity& entity : scene.m_render_entities)
-            {
-                BoundingBox mesh_asset_bounding_box {entity.m_bounding_box.getMinCorner(),
-                                                     entity.m_bounding_box.getMaxCorner()};
-
-                BoundingBox mesh_bounding_box_world =
-                    BoundingBoxTransform(mesh_asset_bounding_box, entity.m_model_matrix);
-                scene_bounding_box.merge(mesh_bounding_box_world);
-            }
-        }
+        // maintained by the scene as the entities change, nothing is transformed here
+        const AxisAlignedBox& scene_bounds = scene.getSceneBoundingBox();
+        BoundingBox           scene_bounding_box {scene_bounds.getMinCorner(), scene_bounds.getMaxCorner()};
 
         // CascadedShadowMaps11 / ComputeNearAndFar
         Matrix4x4 light_view;
         Matrix4x4 light_proj;
         {
             Vector3 box_center((frustum_bounding_box.max_bound.x + frustum_bounding_box.min_bound.x) * 0.5,
-                                 (frustum_bounding_box.max_bound.y + frustum_bounding_box.min_bound.y) * 0.5,
-                                 (frustum_bounding_box.max_bound.z + frustum_bounding_box.min_bound.z));
+                               (frustum_bounding_box.max_bound.y + frustum_bounding_box.min_bound.y) * 0.5,
+                               (frustum_bounding_box.max_bound.z + frustum_bounding_box.min_bound.z) * 0.5);
             Vector3 box_extents((frustum_bounding_box.max_bound.x - frustum_bounding_box.min_bound.x) * 0.5,
-                                  (frustum_bounding_box.max_bound.y - frustum_bounding_box.min_bound.y) * 0.5,
-                                  (frustum_bounding_box.max_bound.z - frustum_bounding_box.min_bound.z) * 0.5);
+                                (frustum_bounding_box.max_bound.y - frustum_bounding_box.min_bound.y) * 0.5,
+                                (frustum_bounding_box.max_bound.z - frustum_bounding_box.min_bound.z) * 0.5);
 
-            Vector3 eye =
-                box_center + scene.m_directional_light.m_direction * box_extents.length();
+            Vector3 eye    = box_center + scene.m_directional_light.m_direction * box_extents.length();
             Vector3 center = box_center;
-            light_view       = Math::makeLookAtMatrix(eye, center, Vector3(0.0, 0.0, 1.0));
+            light_view     = Math::makeLookAtMatrix(eye, center, Vector3(0.0, 0.0, 1.0));
 
             BoundingBox frustum_bounding_box_light_view = BoundingBoxTransform(frustum_bounding_box, light_view);
             BoundingBox scene_bounding_box_light_view   = BoundingBoxTransform(scene_bounding_box, light_view);
@@ -347,4 +339,25 @@ namespace Piccolo
         Matrix4x4 light_proj_view = (light_proj * light_view);
         return light_proj_view;
     }
+
+    Matrix4x4 CalculateDirectionalLightSphereCamera(RenderScene& scene, BoundingSphere const& sphere)
+    {
+        const AxisAlignedBox& scene_bounds = scene.getSceneBoundingBox();
+        BoundingBox           scene_bounding_box {scene_bounds.getMinCorner(), scene_bounds.getMaxCorner()};
+
+        Vector3   eye        = sphere.m_center + scene.m_directional_light.m_direction * sphere.m_radius;
+        Matrix4x4 light_view = Math::makeLookAtMatrix(eye, sphere.m_center, Vector3(0.0, 0.0, 1.0));
+
+        // the sides stay at the sphere, only the depth follows the scene bounds
+        BoundingBox scene_bounding_box_light_view = BoundingBoxTransform(scene_bounding_box, light_view);
+        Matrix4x4   light_proj = Math::makeOrthographicProjectionMatrix01(-sphere.m_radius,
+                                                                        sphere.m_radius,
+                                                                        -sphere.m_radius,
+                                                                        sphere.m_radius,
+                                                                        -scene_bounding_box_light_view.max_bound.z,
+                                                                        -scene_bounding_box_light_view.min_bound.z);
+
+        Matrix4x4 light_proj_view = (light_proj * light_view);
+        return light_proj_view;
+    }
 } // namespace Piccolo
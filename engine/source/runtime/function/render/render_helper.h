@@ -81,5 +81,16 @@ namespace Piccolo
 
     bool BoxIntersectsWithSphere(BoundingBox const& b, BoundingSphere const& s);
 
-    Matrix4x4 CalculateDirectionalLightCamera(RenderScene& scene, RenderCamera& camera);
+    // corners of the part of the camera frustum between the view distances split_near and split_far, the first four
+    // are on the near side
+    void CalculateFrustumSliceCorners(RenderCamera& camera, float split_near, float split_far, Vector3 corners[8]);
+
+    // light camera of the cascade covering the view distances [split_near, split_far], fitted to the part of the scene
+    // bounds inside that slice of the camera frustum
+    Matrix4x4
+    CalculateDirectionalLightCamera(RenderScene& scene, RenderCamera& camera, float split_near, float split_far);
+
+    // light camera of a fixed size around the sphere, it only changes with the sphere, the light and the scene bounds,
+    // so that a cascade drawn with it can be kept across frames
+    Matrix4x4 CalculateDirectionalLightSphereCamera(RenderScene& scene, BoundingSphere const& sphere);
 } // namespace Piccolo
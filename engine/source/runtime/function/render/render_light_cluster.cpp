@@ -0,0 +1,149 @@
+#include "runtime/function/render/render_light_cluster.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace Piccolo
+{
+    void RenderLightClusterGrid::build(MeshPointLightClusterStorageBufferObject& clusters,
+                                       const Matrix4x4&                          view_matrix,
+                                       const Matrix4x4&                          proj_matrix,
+                                       float                                     znear,
+                                       float                                     zfar)
+    {
+        constexpr uint32_t dimension_x = s_point_light_cluster_dimension_x;
+        constexpr uint32_t dimension_y = s_point_light_cluster_dimension_y;
+        constexpr uint32_t dimension_z = s_point_light_cluster_dimension_z;
+
+        // slice z starts at the view depth znear * (zfar / znear) ^ (z / dimension_z)
+        znear                      = std::max(znear, 0.0001f);
+        zfar                       = std::max(zfar, znear * 1.0001f);
+        float const log_depth_span = std::log(zfar / znear);
+        clusters.depth_slice_scale = static_cast<float>(dimension_z) / log_depth_span;
+        clusters.depth_slice_bias  = -static_cast<float>(dimension_z) * std::log(znear) / log_depth_span;
+
+        auto depth_to_slice = [&clusters, znear](float depth) {
+            float slice =
+                std::log(std::max(depth, znear)) * clusters.depth_slice_scale + clusters.depth_slice_bias;
+            return static_cast<uint32_t>(std::min(std::max(slice, 0.0f), static_cast<float>(dimension_z - 1)));
+        };
+        auto uv_to_cluster = [](float uv, uint32_t dimension) {
+            float cluster = std::floor(uv * static_cast<float>(dimension));
+            return static_cast<uint32_t>(std::min(std::max(cluster, 0.0f), static_cast<float>(dimension - 1)));
+        };
+
+        uint32_t const point_light_num = std::min(clusters.point_light_num, s_max_clustered_point_light_count);
+
+        m_light_bounds.resize(point_light_num);
+        m_cluster_counts.assign(s_point_light_cluster_count, 0);
+
+        // the froxels touched by every light, from the screen space bounds of its view space box
+        for (uint32_t light_index = 0; light_index < point_light_num; ++light_index)
+        {
+            const VulkanScenePointLight& point_light = clusters.point_lights[light_index];
+            LightClusterBounds&          bounds      = m_light_bounds[light_index];
+
+            Vector4 const center_view_space = view_matrix * Vector4(point_light.position, 1.0f);
+            float const   radius            = point_light.radius;
+
+            // the view space looks down -z
+            float const center_depth = -center_view_space.z;
+            bounds.is_visible        = center_depth + radius > znear && center_depth - radius < zfar;
+            if (!bounds.is_visible)
+            {
+                continue;
+            }
+
+            bounds.min_z = depth_to_slice(center_depth - radius);
+            bounds.max_z = depth_to_slice(center_depth + radius);
+
+            // the corners behind the near plane are pulled onto it, the box stays in front of the camera so the
+            // projected corners bound its projection
+            float const box_max_z = std::min(center_view_space.z + radius, -znear);
+            float const box_min_z = std::min(center_view_space.z - radius, -znear);
+
+            float min_u = FLT_MAX, max_u = -FLT_MAX;
+            float min_v = FLT_MAX, max_v = -FLT_MAX;
+            for (uint32_t corner = 0; corner < 8; ++corner)
+            {
+                Vector4 const corner_view_space((corner & 1) ? center_view_space.x + radius :
+                                                               center_view_space.x - radius,
+                                                (corner & 2) ? center_view_space.y + radius :
+                                                               center_view_space.y - radius,
+                                                (corner & 4) ? box_max_z : box_min_z,
+                                                1.0f);
+                Vector4 const corner_clip = proj_matrix * corner_view_space;
+
+                float const u = corner_clip.x / corner_clip.w * 0.5f + 0.5f;
+                float const v = corner_clip.y / corner_clip.w * 0.5f + 0.5f;
+                min_u         = std::min(min_u, u);
+                max_u         = std::max(max_u, u);
+                min_v         = std::min(min_v, v);
+                max_v         = std::max(max_v, v);
+            }
+
+            if (max_u < 0.0f || min_u > 1.0f || max_v < 0.0f || min_v > 1.0f)
+            {
+                bounds.is_visible = false;
+                continue;
+            }
+
+            bounds.min_x = uv_to_cluster(min_u, dimension_x);
+            bounds.max_x = uv_to_cluster(max_u, dimension_x);
+            bounds.min_y = uv_to_cluster(min_v, dimension_y);
+            bounds.max_y = uv_to_cluster(max_v, dimension_y);
+
+            for (uint32_t z = bounds.min_z; z <= bounds.max_z; ++z)
+            {
+                for (uint32_t y = bounds.min_y; y <= bounds.max_y; ++y)
+                {
+                    for (uint32_t x = bounds.min_x; x <= bounds.max_x; ++x)
+                    {
+                        ++m_cluster_counts[x + dimension_x * (y + dimension_y * z)];
+                    }
+                }
+            }
+        }
+
+        // the froxels are laid out one after another, the counts are cut once the index list is full
+        uint32_t light_index_num = 0;
+        for (uint32_t cluster_index = 0; cluster_index < s_point_light_cluster_count; ++cluster_index)
+        {
+            uint32_t const count = std::min(m_cluster_counts[cluster_index],
+                                            s_max_point_light_cluster_index_count - light_index_num);
+
+            clusters.cluster_ranges[cluster_index].offset = light_index_num;
+            clusters.cluster_ranges[cluster_index].count  = 0;
+            m_cluster_counts[cluster_index]               = count;
+            light_index_num += count;
+        }
+        clusters.light_index_num = light_index_num;
+
+        for (uint32_t light_index = 0; light_index < point_light_num; ++light_index)
+        {
+            const LightClusterBounds& bounds = m_light_bounds[light_index];
+            if (!bounds.is_visible)
+            {
+                continue;
+            }
+
+            for (uint32_t z = bounds.min_z; z <= bounds.max_z; ++z)
+            {
+                for (uint32_t y = bounds.min_y; y <= bounds.max_y; ++y)
+                {
+                    for (uint32_t x = bounds.min_x; x <= bounds.max_x; ++x)
+                    {
+                        uint32_t const                cluster_index = x + dimension_x * (y + dimension_y * z);
+                        VulkanPointLightClusterRange& range         = clusters.cluster_ranges[cluster_index];
+                        if (range.count < m_cluster_counts[cluster_index])
+                        {
+                            clusters.light_indices[range.offset + range.count] = light_index;
+                            ++range.count;
+                        }
+                    }
+                }
+            }
+        }
+    }
+} // namespace Piccolo
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "runtime/core/math/matrix4.h"
+#include "runtime/function/render/render_common.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Piccolo
+{
+    // froxel grid of the main camera frustum, uniform in screen space and logarithmic in the view depth, the lights
+    // of every froxel are listed once per frame on the cpu so that a fragment only loops over the lights which can
+    // reach it, the storage is kept by the owner and reused every frame
+    class RenderLightClusterGrid
+    {
+    public:
+        // reads the first point_light_num point lights of clusters and writes its slice settings, ranges and indices,
+        // a froxel loses the lights which no longer fit once s_max_point_light_cluster_index_count is reached
+        void build(MeshPointLightClusterStorageBufferObject& clusters,
+                   const Matrix4x4&                          view_matrix,
+                   const Matrix4x4&                          proj_matrix,
+                   float                                     znear,
+                   float                                     zfar);
+
+    private:
+        // inclusive froxel bounds touched by a light
+        struct LightClusterBounds
+        {
+            uint32_t min_x, max_x;
+            uint32_t min_y, max_y;
+            uint32_t min_z, max_z;
+            bool     is_visible;
+        };
+
+        std::vector<LightClusterBounds> m_light_bounds;
+        std::vector<uint32_t>           m_cluster_counts;
+    };
+} // namespace Piccolo
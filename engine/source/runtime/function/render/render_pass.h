@@ -44,10 +44,11 @@ namespace Piccolo
 
     struct VisiableNodes
     {
-        std::vector<RenderMeshNode>*              p_directional_light_visible_mesh_nodes {nullptr};
-        std::vector<RenderMeshNode>*              p_point_lights_visible_mesh_nodes {nullptr};
-        std::vector<RenderMeshNode>*              p_main_camera_visible_mesh_nodes {nullptr};
-        RenderAxisNode*                           p_axis_node {nullptr};
+        std::vector<RenderDirectionalLightCascade>* p_directional_light_cascades {nullptr};
+        std::vector<RenderPointLightShadow>*        p_point_light_shadows {nullptr};
+        std::vector<RenderMeshNode>*                p_main_camera_visible_mesh_nodes {nullptr};
+        RenderAxisNode*                             p_axis_node {nullptr};
+        const std::vector<RenderEntity>*            p_render_entities {nullptr};
     };
 
     class RenderPass : public RenderPassBase
@@ -5,6 +5,8 @@
 #include "runtime/function/render/passes/combine_ui_pass.h"
 #include "runtime/function/render/passes/directional_light_pass.h"
 #include "runtime/function/render/passes/main_camera_pass.h"
+#include "runtime/function/render/passes/mesh_cull_pass.h"
+#include "runtime/function/render/passes/mesh_skinning_pass.h"
 #include "runtime/function/render/passes/pick_pass.h"
 #include "runtime/function/render/passes/point_light_pass.h"
 #include "runtime/function/render/passes/tone_mapping_pass.h"
@@ -14,9 +16,26 @@
 #include "runtime/function/render/debugdraw/debug_draw_manager.h"
 
 #include "runtime/core/base/macro.h"
+#include "runtime/core/job/job_system.h"
+
+#include <chrono>
+#include <functional>
 
 namespace Piccolo
 {
+    namespace
+    {
+        // reports the setup time of one pass, which is mostly spent on creating its pipelines
+        void initializePassTimed(const char* pass_name, const std::function<void()>& initialize_pass)
+        {
+            auto start_time = std::chrono::steady_clock::now();
+            initialize_pass();
+            auto duration =
+                std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time);
+            LOG_INFO("{} initialized in {} ms", pass_name, duration.count() / 1000.0);
+        }
+    } // namespace
+
     void RenderPipeline::initialize(RenderPipelineInitInfo init_info)
     {
         m_point_light_shadow_pass = std::make_shared<PointLightShadowPass>();
@@ -45,8 +64,8 @@ namespace Piccolo
         m_fxaa_pass->setCommonInfo(pass_common_info);
         m_particle_pass->setCommonInfo(pass_common_info);
 
-        m_point_light_shadow_pass->initialize(nullptr);
-        m_directional_light_pass->initialize(nullptr);
+        initializePassTimed("point light shadow pass", [&]() { m_point_light_shadow_pass->initialize(nullptr); });
+        initializePassTimed("directional light shadow pass", [&]() { m_directional_light_pass->initialize(nullptr); });
 
         std::shared_ptr<MainCameraPass> main_camera_pass = std::static_pointer_cast<MainCameraPass>(m_main_camera_pass);
         std::shared_ptr<RenderPass>     _main_camera_pass = std::static_pointer_cast<RenderPass>(m_main_camera_pass);
@@ -54,7 +73,30 @@ namespace Piccolo
 
         ParticlePassInitInfo particle_init_info{};
         particle_init_info.m_particle_manager = g_runtime_global_context.m_particle_manager;
-        m_particle_pass->initialize(&particle_init_info);
+        initializePassTimed("particle pass", [&]() { m_particle_pass->initialize(&particle_init_info); });
+
+        if (init_info.enable_gpu_driven_rendering)
+        {
+            if (m_rhi->isGpuDrivenRenderingSupported())
+            {
+                m_mesh_cull_pass = std::make_shared<MeshCullPass>();
+                m_mesh_cull_pass->setCommonInfo(pass_common_info);
+                initializePassTimed("mesh cull pass", [&]() { m_mesh_cull_pass->initialize(nullptr); });
+                main_camera_pass->setMeshCullPass(std::static_pointer_cast<MeshCullPass>(m_mesh_cull_pass));
+            }
+            else
+            {
+                LOG_WARN("gpu driven rendering is not supported by the device, meshes are drawn on the cpu path");
+            }
+        }
+
+        // RenderResource allocates the per mesh sets of the skinned meshes with the layout of this pass
+        if (init_info.enable_pre_skinning)
+        {
+            m_mesh_skinning_pass = std::make_shared<MeshSkinningPass>();
+            m_mesh_skinning_pass->setCommonInfo(pass_common_info);
+            initializePassTimed("mesh skinning pass", [&]() { m_mesh_skinning_pass->initialize(nullptr); });
+        }
 
         main_camera_pass->m_point_light_shadow_color_image_view =
             std::static_pointer_cast<RenderPass>(m_point_light_shadow_pass)->getFramebufferImageViews()[0];
@@ -64,7 +106,7 @@ namespace Piccolo
         MainCameraPassInitInfo main_camera_init_info;
         main_camera_init_info.enble_fxaa = init_info.enable_fxaa;
         main_camera_pass->setParticlePass(particle_pass);
-        m_main_camera_pass->initialize(&main_camera_init_info);
+        initializePassTimed("main camera pass", [&]() { m_main_camera_pass->initialize(&main_camera_init_info); });
 
         std::static_pointer_cast<ParticlePass>(m_particle_pass)->setupParticlePass();
 
@@ -74,24 +116,22 @@ namespace Piccolo
         std::static_pointer_cast<DirectionalLightShadowPass>(m_directional_light_pass)
             ->setPerMeshLayout(descriptor_layouts[MainCameraPass::LayoutType::_per_mesh]);
 
-        m_point_light_shadow_pass->postInitialize();
-        m_directional_light_pass->postInitialize();
+        initializePassTimed("point light shadow pipelines", [&]() { m_point_light_shadow_pass->postInitialize(); });
+        initializePassTimed("directional light shadow pipelines", [&]() { m_directional_light_pass->postInitialize(); });
 
         ToneMappingPassInitInfo tone_mapping_init_info;
         tone_mapping_init_info.render_pass = _main_camera_pass->getRenderPass();
         tone_mapping_init_info.input_attachment =
             _main_camera_pass->getFramebufferImageViews()[_main_camera_pass_backup_buffer_odd];
-        m_tone_mapping_pass->initialize(&tone_mapping_init_info);
 
         ColorGradingPassInitInfo color_grading_init_info;
         color_grading_init_info.render_pass = _main_camera_pass->getRenderPass();
         color_grading_init_info.input_attachment =
             _main_camera_pass->getFramebufferImageViews()[_main_camera_pass_backup_buffer_even];
-        m_color_grading_pass->initialize(&color_grading_init_info);
 
         UIPassInitInfo ui_init_info;
         ui_init_info.render_pass = _main_camera_pass->getRenderPass();
-        m_ui_pass->initialize(&ui_init_info);
+        initializePassTimed("ui pass", [&]() { m_ui_pass->initialize(&ui_init_info); });
 
         CombineUIPassInitInfo combine_ui_init_info;
         combine_ui_init_info.render_pass = _main_camera_pass->getRenderPass();
@@ -99,18 +139,32 @@ namespace Piccolo
             _main_camera_pass->getFramebufferImageViews()[_main_camera_pass_backup_buffer_odd];
         combine_ui_init_info.ui_input_attachment =
             _main_camera_pass->getFramebufferImageViews()[_main_camera_pass_backup_buffer_even];
-        m_combine_ui_pass->initialize(&combine_ui_init_info);
 
         PickPassInitInfo pick_init_info;
         pick_init_info.per_mesh_layout = descriptor_layouts[MainCameraPass::LayoutType::_per_mesh];
-        m_pick_pass->initialize(&pick_init_info);
+        initializePassTimed("pick pass", [&]() { m_pick_pass->initialize(&pick_init_info); });
 
         FXAAPassInitInfo fxaa_init_info;
         fxaa_init_info.render_pass = _main_camera_pass->getRenderPass();
         fxaa_init_info.input_attachment =
             _main_camera_pass->getFramebufferImageViews()[_main_camera_pass_post_process_buffer_odd];
-        m_fxaa_pass->initialize(&fxaa_init_info);
 
+        // the post process passes only depend on the main camera pass and own everything else they create
+        std::vector<std::function<void()>> post_process_pass_jobs = {
+            [&]() {
+                initializePassTimed("tone mapping pass",
+                                    [&]() { m_tone_mapping_pass->initialize(&tone_mapping_init_info); });
+            },
+            [&]() {
+                initializePassTimed("color grading pass",
+                                    [&]() { m_color_grading_pass->initialize(&color_grading_init_info); });
+            },
+            [&]() {
+                initializePassTimed("combine ui pass",
+                                    [&]() { m_combine_ui_pass->initialize(&combine_ui_init_info); });
+            },
+            [&]() { initializePassTimed("fxaa pass", [&]() { m_fxaa_pass->initialize(&fxaa_init_info); }); }};
+        g_runtime_global_context.m_job_system->parallelRun(post_process_pass_jobs);
     }
 
     void RenderPipeline::forwardRender(std::shared_ptr<RHI> rhi, std::shared_ptr<RenderResourceBase> render_resource)
@@ -122,6 +176,9 @@ namespace Piccolo
 
         vulkan_rhi->waitForFences();
 
+        // the skinned draws of all the passes read their joints from the palette uploaded here
+        vulkan_resource->uploadJointPalette(vulkan_rhi->m_current_frame_index);
+
         vulkan_rhi->resetCommandPool();
 
         bool recreate_swapchain =
@@ -131,6 +188,16 @@ namespace Piccolo
             return;
         }
 
+        if (m_mesh_cull_pass)
+        {
+            static_cast<MeshCullPass*>(m_mesh_cull_pass.get())->draw();
+        }
+
+        if (m_mesh_skinning_pass)
+        {
+            static_cast<MeshSkinningPass*>(m_mesh_skinning_pass.get())->draw();
+        }
+
         static_cast<DirectionalLightShadowPass*>(m_directional_light_pass.get())->draw();
 
         static_cast<PointLightShadowPass*>(m_point_light_shadow_pass.get())->draw();
@@ -145,6 +212,7 @@ namespace Piccolo
         static_cast<ParticlePass*>(m_particle_pass.get())
             ->setRenderCommandBufferHandle(
                 static_cast<MainCameraPass*>(m_main_camera_pass.get())->getRenderCommandBuffer());
+        particle_pass.drawHalfResolution();
 
         static_cast<MainCameraPass*>(m_main_camera_pass.get())
             ->drawForward(color_grading_pass,
@@ -172,6 +240,9 @@ namespace Piccolo
 
         vulkan_rhi->waitForFences();
 
+        // the skinned draws of all the passes read their joints from the palette uploaded here
+        vulkan_resource->uploadJointPalette(vulkan_rhi->m_current_frame_index);
+
         vulkan_rhi->resetCommandPool();
 
         bool recreate_swapchain =
@@ -181,6 +252,16 @@ namespace Piccolo
             return;
         }
 
+        if (m_mesh_cull_pass)
+        {
+            static_cast<MeshCullPass*>(m_mesh_cull_pass.get())->draw();
+        }
+
+        if (m_mesh_skinning_pass)
+        {
+            static_cast<MeshSkinningPass*>(m_mesh_skinning_pass.get())->draw();
+        }
+
         static_cast<DirectionalLightShadowPass*>(m_directional_light_pass.get())->draw();
 
         static_cast<PointLightShadowPass*>(m_point_light_shadow_pass.get())->draw();
@@ -195,6 +276,7 @@ namespace Piccolo
         static_cast<ParticlePass*>(m_particle_pass.get())
             ->setRenderCommandBufferHandle(
                 static_cast<MainCameraPass*>(m_main_camera_pass.get())->getRenderCommandBuffer());
+        particle_pass.drawHalfResolution();
 
         static_cast<MainCameraPass*>(m_main_camera_pass.get())
             ->draw(color_grading_pass,
@@ -12,6 +12,14 @@ namespace Piccolo
         m_directional_light_pass->preparePassData(render_resource);
         m_point_light_shadow_pass->preparePassData(render_resource);
         m_particle_pass->preparePassData(render_resource);
+        if (m_mesh_cull_pass)
+        {
+            m_mesh_cull_pass->preparePassData(render_resource);
+        }
+        if (m_mesh_skinning_pass)
+        {
+            m_mesh_skinning_pass->preparePassData(render_resource);
+        }
         g_runtime_global_context.m_debugdraw_manager->preparePassData(render_resource);
     }
     void RenderPipelineBase::forwardRender(std::shared_ptr<RHI>                rhi,
@@ -15,6 +15,8 @@ namespace Piccolo
     struct RenderPipelineInitInfo
     {
         bool                                enable_fxaa {false};
+        bool                                enable_gpu_driven_rendering {false};
+        bool                                enable_pre_skinning {false};
         std::shared_ptr<RenderResourceBase> render_resource;
     };
 
@@ -49,6 +51,8 @@ namespace Piccolo
         std::shared_ptr<RenderPassBase> m_combine_ui_pass;
         std::shared_ptr<RenderPassBase> m_pick_pass;
         std::shared_ptr<RenderPassBase> m_particle_pass;
+        std::shared_ptr<RenderPassBase> m_mesh_cull_pass; // nullptr unless gpu driven rendering is enabled
+        std::shared_ptr<RenderPassBase> m_mesh_skinning_pass; // nullptr unless pre-skinning is enabled
 
     };
 } // namespace Piccolo
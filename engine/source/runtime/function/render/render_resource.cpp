@@ -11,6 +11,7 @@
 
 #include "runtime/core/base/macro.h"
 
+#include <algorithm>
 #include <stdexcept>
 
 namespace Piccolo
@@ -111,6 +112,37 @@ namespace Piccolo
         getOrCreateVulkanMaterial(rhi, render_entity, material_data);
     }
 
+    void RenderResource::reloadGameObjectRenderResource(std::shared_ptr<RHI> rhi,
+        RenderEntity         render_entity,
+        RenderMeshData       mesh_data)
+    {
+        auto it = m_vulkan_meshes.find(render_entity.m_mesh_asset_id);
+        if (it == m_vulkan_meshes.end())
+        {
+            getOrCreateVulkanMesh(rhi, render_entity, mesh_data);
+            return;
+        }
+
+        destroyVulkanMeshBuffers(rhi, it->second);
+        uploadVulkanMesh(rhi, mesh_data, it->second);
+        cacheMeshPickData(render_entity.m_mesh_asset_id, mesh_data);
+    }
+
+    void RenderResource::reloadGameObjectRenderResource(std::shared_ptr<RHI> rhi,
+        RenderEntity         render_entity,
+        RenderMaterialData   material_data)
+    {
+        auto it = m_vulkan_pbr_materials.find(render_entity.m_material_asset_id);
+        if (it == m_vulkan_pbr_materials.end())
+        {
+            getOrCreateVulkanMaterial(rhi, render_entity, material_data);
+            return;
+        }
+
+        destroyVulkanMaterialImages(rhi, it->second);
+        uploadVulkanMaterial(rhi, render_entity, material_data, it->second);
+    }
+
     void RenderResource::updatePerFrameBuffer(std::shared_ptr<RenderScene>  render_scene,
         std::shared_ptr<RenderCamera> camera)
     {
@@ -120,8 +152,10 @@ namespace Piccolo
         Matrix4x4 proj_view_matrix = proj_matrix * view_matrix;
 
         // ambient light
-        Vector3  ambient_light = render_scene->m_ambient_light.m_irradiance;
-        uint32_t point_light_num = static_cast<uint32_t>(render_scene->m_point_light_list.m_lights.size());
+        Vector3  ambient_light   = render_scene->m_ambient_light.m_irradiance;
+        // the lights beyond s_max_clustered_point_light_count are not shaded
+        uint32_t point_light_num = std::min(static_cast<uint32_t>(render_scene->m_point_light_list.m_lights.size()),
+                                            s_max_clustered_point_light_count);
 
         // set ubo data
         m_particle_collision_perframe_storage_buffer_object.view_matrix      = view_matrix;
@@ -131,11 +165,12 @@ namespace Piccolo
         m_mesh_perframe_storage_buffer_object.proj_view_matrix = proj_view_matrix;
         m_mesh_perframe_storage_buffer_object.camera_position = camera_position;
         m_mesh_perframe_storage_buffer_object.ambient_light = ambient_light;
-        m_mesh_perframe_storage_buffer_object.point_light_num = point_light_num;
-
 
-        m_mesh_point_light_shadow_perframe_storage_buffer_object.point_light_num = point_light_num;
-        // point lights
+        // point lights, only the first s_max_point_light_count have a shadow map
+        m_point_light_cluster_storage_buffer_object.point_light_num = point_light_num;
+        m_mesh_point_light_shadow_perframe_storage_buffer_object.point_light_num =
+            std::min(point_light_num, s_max_point_light_count);
+        m_mesh_point_light_shadow_perframe_storage_buffer_object.first_point_light_index = 0;
         for (uint32_t i = 0; i < point_light_num; i++)
         {
             Vector3 point_light_position = render_scene->m_point_light_list.m_lights[i].m_position;
@@ -144,13 +179,18 @@ namespace Piccolo
 
             float radius = render_scene->m_point_light_list.m_lights[i].calculateRadius();
 
-            m_mesh_perframe_storage_buffer_object.scene_point_lights[i].position  = point_light_position;
-            m_mesh_perframe_storage_buffer_object.scene_point_lights[i].radius    = radius;
-            m_mesh_perframe_storage_buffer_object.scene_point_lights[i].intensity = point_light_intensity;
+            m_point_light_cluster_storage_buffer_object.point_lights[i].position  = point_light_position;
+            m_point_light_cluster_storage_buffer_object.point_lights[i].radius    = radius;
+            m_point_light_cluster_storage_buffer_object.point_lights[i].intensity = point_light_intensity;
 
-            m_mesh_point_light_shadow_perframe_storage_buffer_object.point_lights_position_and_radius[i] =
-                Vector4(point_light_position, radius);
+            if (i < s_max_point_light_count)
+            {
+                m_mesh_point_light_shadow_perframe_storage_buffer_object.point_lights_position_and_radius[i] =
+                    Vector4(point_light_position, radius);
+            }
         }
+        m_point_light_cluster_grid.build(
+            m_point_light_cluster_storage_buffer_object, view_matrix, proj_matrix, camera->m_znear, camera->m_zfar);
 
         // directional light
         m_mesh_perframe_storage_buffer_object.scene_directional_light.direction =
@@ -281,47 +321,102 @@ namespace Piccolo
         else
         {
             VulkanMesh temp;
+            temp.sort_id = static_cast<uint32_t>(m_vulkan_meshes.size());
             auto       res = m_vulkan_meshes.insert(std::make_pair(assetid, std::move(temp)));
             assert(res.second);
 
-            uint32_t index_buffer_size = static_cast<uint32_t>(mesh_data.m_static_mesh_data.m_index_buffer->m_size);
-            void* index_buffer_data = mesh_data.m_static_mesh_data.m_index_buffer->m_data;
+            VulkanMesh& now_mesh = res.first->second;
+            uploadVulkanMesh(rhi, mesh_data, now_mesh);
+            cacheMeshPickData(assetid, mesh_data);
 
-            uint32_t vertex_buffer_size = static_cast<uint32_t>(mesh_data.m_static_mesh_data.m_vertex_buffer->m_size);
-            MeshVertexDataDefinition* vertex_buffer_data =
-                reinterpret_cast<MeshVertexDataDefinition*>(mesh_data.m_static_mesh_data.m_vertex_buffer->m_data);
+            return now_mesh;
+        }
+    }
 
-            VulkanMesh& now_mesh = res.first->second;
+    void RenderResource::uploadVulkanMesh(std::shared_ptr<RHI> rhi, RenderMeshData mesh_data, VulkanMesh& now_mesh)
+    {
+        uint32_t index_buffer_size = static_cast<uint32_t>(mesh_data.m_static_mesh_data.m_index_buffer->m_size);
+        void* index_buffer_data = mesh_data.m_static_mesh_data.m_index_buffer->m_data;
 
-            if (mesh_data.m_skeleton_binding_buffer)
-            {
-                uint32_t joint_binding_buffer_size = (uint32_t)mesh_data.m_skeleton_binding_buffer->m_size;
-                MeshVertexBindingDataDefinition* joint_binding_buffer_data =
-                    reinterpret_cast<MeshVertexBindingDataDefinition*>(mesh_data.m_skeleton_binding_buffer->m_data);
-                updateMeshData(rhi,
-                               true,
-                               index_buffer_size,
-                               index_buffer_data,
-                               vertex_buffer_size,
-                               vertex_buffer_data,
-                               joint_binding_buffer_size,
-                               joint_binding_buffer_data,
-                               now_mesh);
-            }
-            else
+        uint32_t vertex_buffer_size = static_cast<uint32_t>(mesh_data.m_static_mesh_data.m_vertex_buffer->m_size);
+        MeshVertexDataDefinition* vertex_buffer_data =
+            reinterpret_cast<MeshVertexDataDefinition*>(mesh_data.m_static_mesh_data.m_vertex_buffer->m_data);
+
+        if (mesh_data.m_skeleton_binding_buffer)
+        {
+            uint32_t joint_binding_buffer_size = (uint32_t)mesh_data.m_skeleton_binding_buffer->m_size;
+            MeshVertexBindingDataDefinition* joint_binding_buffer_data =
+                reinterpret_cast<MeshVertexBindingDataDefinition*>(mesh_data.m_skeleton_binding_buffer->m_data);
+            updateMeshData(rhi,
+                           true,
+                           index_buffer_size,
+                           index_buffer_data,
+                           vertex_buffer_size,
+                           vertex_buffer_data,
+                           joint_binding_buffer_size,
+                           joint_binding_buffer_data,
+                           now_mesh);
+        }
+        else
+        {
+            updateMeshData(rhi,
+                           false,
+                           index_buffer_size,
+                           index_buffer_data,
+                           vertex_buffer_size,
+                           vertex_buffer_data,
+                           0,
+                           NULL,
+                           now_mesh);
+        }
+    }
+
+    void RenderResource::cacheMeshPickData(size_t mesh_asset_id, const RenderMeshData& mesh_data)
+    {
+        const BufferData& vertex_buffer = *mesh_data.m_static_mesh_data.m_vertex_buffer;
+        const BufferData& index_buffer  = *mesh_data.m_static_mesh_data.m_index_buffer;
+
+        uint32_t const vertex_count = static_cast<uint32_t>(vertex_buffer.m_size / sizeof(MeshVertexDataDefinition));
+        uint32_t const index_count  = static_cast<uint32_t>(index_buffer.m_size / sizeof(uint16_t));
+
+        const MeshVertexDataDefinition* vertices =
+            reinterpret_cast<const MeshVertexDataDefinition*>(vertex_buffer.m_data);
+        const uint16_t* indices = reinterpret_cast<const uint16_t*>(index_buffer.m_data);
+
+        MeshPickData& pick_data = m_mesh_pick_datas[mesh_asset_id];
+        pick_data.positions.resize(vertex_count);
+        for (uint32_t vertex_index = 0; vertex_index < vertex_count; ++vertex_index)
+        {
+            pick_data.positions[vertex_index].position =
+                Vector3(vertices[vertex_index].x, vertices[vertex_index].y, vertices[vertex_index].z);
+        }
+        pick_data.indices.assign(indices, indices + index_count);
+
+        pick_data.joint_bindings.clear();
+        if (mesh_data.m_skeleton_binding_buffer)
+        {
+            const MeshVertexBindingDataDefinition* bindings =
+                reinterpret_cast<const MeshVertexBindingDataDefinition*>(mesh_data.m_skeleton_binding_buffer->m_data);
+
+            // the weights are normalized like the ones uploaded for the vertex shaders
+            pick_data.joint_bindings.resize(vertex_count);
+            for (uint32_t vertex_index = 0; vertex_index < vertex_count; ++vertex_index)
             {
-                updateMeshData(rhi,
-                               false,
-                               index_buffer_size,
-                               index_buffer_data,
-                               vertex_buffer_size,
-                               vertex_buffer_data,
-                               0,
-                               NULL,
-                               now_mesh);
+                const MeshVertexBindingDataDefinition& binding = bindings[vertex_index];
+                MeshVertex::VulkanMeshVertexJointBinding& joint_binding = pick_data.joint_bindings[vertex_index];
+
+                joint_binding.indices[0] = binding.m_index0;
+                joint_binding.indices[1] = binding.m_index1;
+                joint_binding.indices[2] = binding.m_index2;
+                joint_binding.indices[3] = binding.m_index3;
+
+                float total_weight = binding.m_weight0 + binding.m_weight1 + binding.m_weight2 + binding.m_weight3;
+                float inv_total_weight = (total_weight != 0.0f) ? 1.0f / total_weight : 1.0f;
+                joint_binding.weights  = Vector4(binding.m_weight0 * inv_total_weight,
+                                                binding.m_weight1 * inv_total_weight,
+                                                binding.m_weight2 * inv_total_weight,
+                                                binding.m_weight3 * inv_total_weight);
             }
-
-            return now_mesh;
         }
     }
 
@@ -329,8 +424,6 @@ namespace Piccolo
         RenderEntity         entity,
         RenderMaterialData   material_data)
     {
-        VulkanRHI* vulkan_context = static_cast<VulkanRHI*>(rhi.get());
-
         size_t assetid = entity.m_material_asset_id;
 
         auto it = m_vulkan_pbr_materials.find(assetid);
@@ -341,250 +434,291 @@ namespace Piccolo
         else
         {
             VulkanPBRMaterial temp;
+            temp.sort_id = static_cast<uint32_t>(m_vulkan_pbr_materials.size());
             auto              res = m_vulkan_pbr_materials.insert(std::make_pair(assetid, std::move(temp)));
             assert(res.second);
 
-            float empty_image[] = { 0.5f, 0.5f, 0.5f, 0.5f };
+            VulkanPBRMaterial& now_material = res.first->second;
+            uploadVulkanMaterial(rhi, entity, material_data, now_material);
 
-            void* base_color_image_pixels = empty_image;
-            uint32_t           base_color_image_width = 1;
-            uint32_t           base_color_image_height = 1;
-            RHIFormat base_color_image_format = RHIFormat::RHI_FORMAT_R8G8B8A8_SRGB;
-            if (material_data.m_base_color_texture)
-            {
-                base_color_image_pixels = material_data.m_base_color_texture->m_pixels;
-                base_color_image_width = static_cast<uint32_t>(material_data.m_base_color_texture->m_width);
-                base_color_image_height = static_cast<uint32_t>(material_data.m_base_color_texture->m_height);
-                base_color_image_format = material_data.m_base_color_texture->m_format;
-            }
+            return now_material;
+        }
+    }
 
-            void* metallic_roughness_image_pixels = empty_image;
-            uint32_t           metallic_roughness_width = 1;
-            uint32_t           metallic_roughness_height = 1;
-            RHIFormat metallic_roughness_format = RHIFormat::RHI_FORMAT_R8G8B8A8_UNORM;
-            if (material_data.m_metallic_roughness_texture)
-            {
-                metallic_roughness_image_pixels = material_data.m_metallic_roughness_texture->m_pixels;
-                metallic_roughness_width = static_cast<uint32_t>(material_data.m_metallic_roughness_texture->m_width);
-                metallic_roughness_height = static_cast<uint32_t>(material_data.m_metallic_roughness_texture->m_height);
-                metallic_roughness_format = material_data.m_metallic_roughness_texture->m_format;
-            }
+    void RenderResource::uploadVulkanMaterial(std::shared_ptr<RHI> rhi,
+                                              RenderEntity         entity,
+                                              RenderMaterialData   material_data,
+                                              VulkanPBRMaterial&   now_material)
+    {
+        VulkanRHI* vulkan_context = static_cast<VulkanRHI*>(rhi.get());
 
-            void* normal_roughness_image_pixels = empty_image;
-            uint32_t           normal_roughness_width = 1;
-            uint32_t           normal_roughness_height = 1;
-            RHIFormat normal_roughness_format = RHIFormat::RHI_FORMAT_R8G8B8A8_UNORM;
-            if (material_data.m_normal_texture)
-            {
-                normal_roughness_image_pixels = material_data.m_normal_texture->m_pixels;
-                normal_roughness_width = static_cast<uint32_t>(material_data.m_normal_texture->m_width);
-                normal_roughness_height = static_cast<uint32_t>(material_data.m_normal_texture->m_height);
-                normal_roughness_format = material_data.m_normal_texture->m_format;
-            }
+        float empty_image[] = { 0.5f, 0.5f, 0.5f, 0.5f };
 
-            void* occlusion_image_pixels = empty_image;
-            uint32_t           occlusion_image_width = 1;
-            uint32_t           occlusion_image_height = 1;
-            RHIFormat occlusion_image_format = RHIFormat::RHI_FORMAT_R8G8B8A8_UNORM;
-            if (material_data.m_occlusion_texture)
-            {
-                occlusion_image_pixels = material_data.m_occlusion_texture->m_pixels;
-                occlusion_image_width = static_cast<uint32_t>(material_data.m_occlusion_texture->m_width);
-                occlusion_image_height = static_cast<uint32_t>(material_data.m_occlusion_texture->m_height);
-                occlusion_image_format = material_data.m_occlusion_texture->m_format;
-            }
+        void* base_color_image_pixels = empty_image;
+        uint32_t           base_color_image_width = 1;
+        uint32_t           base_color_image_height = 1;
+        RHIFormat base_color_image_format = RHIFormat::RHI_FORMAT_R8G8B8A8_SRGB;
+        if (material_data.m_base_color_texture)
+        {
+            base_color_image_pixels = material_data.m_base_color_texture->m_pixels;
+            base_color_image_width = static_cast<uint32_t>(material_data.m_base_color_texture->m_width);
+            base_color_image_height = static_cast<uint32_t>(material_data.m_base_color_texture->m_height);
+            base_color_image_format = material_data.m_base_color_texture->m_format;
+        }
 
-            void* emissive_image_pixels = empty_image;
-            uint32_t           emissive_image_width = 1;
-            uint32_t           emissive_image_height = 1;
-            RHIFormat emissive_image_format = RHIFormat::RHI_FORMAT_R8G8B8A8_UNORM;
-            if (material_data.m_emissive_texture)
-            {
-                emissive_image_pixels = material_data.m_emissive_texture->m_pixels;
-                emissive_image_width  = static_cast<uint32_t>(material_data.m_emissive_texture->m_width);
-                emissive_image_height = static_cast<uint32_t>(material_data.m_emissive_texture->m_height);
-                emissive_image_format = material_data.m_emissive_texture->m_format;
-            }
+        void* metallic_roughness_image_pixels = empty_image;
+        uint32_t           metallic_roughness_width = 1;
+        uint32_t           metallic_roughness_height = 1;
+        RHIFormat metallic_roughness_format = RHIFormat::RHI_FORMAT_R8G8B8A8_UNORM;
+        if (material_data.m_metallic_roughness_texture)
+        {
+            metallic_roughness_image_pixels = material_data.m_metallic_roughness_texture->m_pixels;
+            metallic_roughness_width = static_cast<uint32_t>(material_data.m_metallic_roughness_texture->m_width);
+            metallic_roughness_height = static_cast<uint32_t>(material_data.m_metallic_roughness_texture->m_height);
+            metallic_roughness_format = material_data.m_metallic_roughness_texture->m_format;
+        }
 
-            VulkanPBRMaterial& now_material = res.first->second;
+        void* normal_roughness_image_pixels = empty_image;
+        uint32_t           normal_roughness_width = 1;
+        uint32_t           normal_roughness_height = 1;
+        RHIFormat normal_roughness_format = RHIFormat::RHI_FORMAT_R8G8B8A8_UNORM;
+        if (material_data.m_normal_texture)
+        {
+            normal_roughness_image_pixels = material_data.m_normal_texture->m_pixels;
+            normal_roughness_width = static_cast<uint32_t>(material_data.m_normal_texture->m_width);
+            normal_roughness_height = static_cast<uint32_t>(material_data.m_normal_texture->m_height);
+            normal_roughness_format = material_data.m_normal_texture->m_format;
+        }
 
-            // similiarly to the vertex/index buffer, we should allocate the uniform
-            // buffer in DEVICE_LOCAL memory and use the temp stage buffer to copy the
-            // data
-            {
-                // temporary staging buffer
-
-                RHIDeviceSize buffer_size = sizeof(MeshPerMaterialUniformBufferObject);
-
-                RHIBuffer* inefficient_staging_buffer = RHI_NULL_HANDLE;
-                RHIDeviceMemory* inefficient_staging_buffer_memory = RHI_NULL_HANDLE;
-                rhi->createBuffer(
-                    buffer_size,
-                    RHI_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                    RHI_MEMORY_PROPERTY_HOST_VISIBLE_BIT | RHI_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                    inefficient_staging_buffer,
-                    inefficient_staging_buffer_memory);
-                // RHI_BUFFER_USAGE_TRANSFER_SRC_BIT: buffer can be used as source in a
-                // memory transfer operation
-
-                void* staging_buffer_data = nullptr;
-                rhi->mapMemory(
-                    inefficient_staging_buffer_memory,
-                    0,
-                    buffer_size,
-                    0,
-                    &staging_buffer_data);
-                
-                MeshPerMaterialUniformBufferObject& material_uniform_buffer_info =
-                    (*static_cast<MeshPerMaterialUniformBufferObject*>(staging_buffer_data));
-                material_uniform_buffer_info.is_blend = entity.m_blend;
-                material_uniform_buffer_info.is_double_sided = entity.m_double_sided;
-                material_uniform_buffer_info.baseColorFactor = entity.m_base_color_factor;
-                material_uniform_buffer_info.metallicFactor = entity.m_metallic_factor;
-                material_uniform_buffer_info.roughnessFactor = entity.m_roughness_factor;
-                material_uniform_buffer_info.normalScale = entity.m_normal_scale;
-                material_uniform_buffer_info.occlusionStrength = entity.m_occlusion_strength;
-                material_uniform_buffer_info.emissiveFactor = entity.m_emissive_factor;
-
-                rhi->unmapMemory(inefficient_staging_buffer_memory);
-
-                // use the vmaAllocator to allocate asset uniform buffer
-                RHIBufferCreateInfo bufferInfo = { RHI_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
-                bufferInfo.size = buffer_size;
-                bufferInfo.usage = RHI_BUFFER_USAGE_UNIFORM_BUFFER_BIT | RHI_BUFFER_USAGE_TRANSFER_DST_BIT;
-
-                VmaAllocationCreateInfo allocInfo = {};
-                allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
-
-                rhi->createBufferWithAlignmentVMA(
-                    vulkan_context->m_assets_allocator,
-                    &bufferInfo,
-                    &allocInfo,
-                    m_global_render_resource._storage_buffer._min_uniform_buffer_offset_alignment,
-                    now_material.material_uniform_buffer,
-                    &now_material.material_uniform_buffer_allocation,
-                    NULL);
-
-                // use the data from staging buffer
-                rhi->copyBuffer(inefficient_staging_buffer, now_material.material_uniform_buffer, 0, 0, buffer_size);
-
-                // release staging buffer
-                rhi->destroyBuffer(inefficient_staging_buffer);
-                rhi->freeMemory(inefficient_staging_buffer_memory);
-            }
+        void* occlusion_image_pixels = empty_image;
+        uint32_t           occlusion_image_width = 1;
+        uint32_t           occlusion_image_height = 1;
+        RHIFormat occlusion_image_format = RHIFormat::RHI_FORMAT_R8G8B8A8_UNORM;
+        if (material_data.m_occlusion_texture)
+        {
+            occlusion_image_pixels = material_data.m_occlusion_texture->m_pixels;
+            occlusion_image_width = static_cast<uint32_t>(material_data.m_occlusion_texture->m_width);
+            occlusion_image_height = static_cast<uint32_t>(material_data.m_occlusion_texture->m_height);
+            occlusion_image_format = material_data.m_occlusion_texture->m_format;
+        }
 
-            TextureDataToUpdate update_texture_data;
-            update_texture_data.base_color_image_pixels         = base_color_image_pixels;
-            update_texture_data.base_color_image_width          = base_color_image_width;
-            update_texture_data.base_color_image_height         = base_color_image_height;
-            update_texture_data.base_color_image_format         = base_color_image_format;
-            update_texture_data.metallic_roughness_image_pixels = metallic_roughness_image_pixels;
-            update_texture_data.metallic_roughness_image_width  = metallic_roughness_width;
-            update_texture_data.metallic_roughness_image_height = metallic_roughness_height;
-            update_texture_data.metallic_roughness_image_format = metallic_roughness_format;
-            update_texture_data.normal_roughness_image_pixels   = normal_roughness_image_pixels;
-            update_texture_data.normal_roughness_image_width    = normal_roughness_width;
-            update_texture_data.normal_roughness_image_height   = normal_roughness_height;
-            update_texture_data.normal_roughness_image_format   = normal_roughness_format;
-            update_texture_data.occlusion_image_pixels          = occlusion_image_pixels;
-            update_texture_data.occlusion_image_width           = occlusion_image_width;
-            update_texture_data.occlusion_image_height          = occlusion_image_height;
-            update_texture_data.occlusion_image_format          = occlusion_image_format;
-            update_texture_data.emissive_image_pixels           = emissive_image_pixels;
-            update_texture_data.emissive_image_width            = emissive_image_width;
-            update_texture_data.emissive_image_height           = emissive_image_height;
-            update_texture_data.emissive_image_format           = emissive_image_format;
-            update_texture_data.now_material                    = &now_material;
-
-            updateTextureImageData(rhi, update_texture_data);
-
-            RHIDescriptorSetAllocateInfo material_descriptor_set_alloc_info;
-            material_descriptor_set_alloc_info.sType = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-            material_descriptor_set_alloc_info.pNext = NULL;
-            material_descriptor_set_alloc_info.descriptorPool = vulkan_context->m_descriptor_pool;
-            material_descriptor_set_alloc_info.descriptorSetCount = 1;
-            material_descriptor_set_alloc_info.pSetLayouts        = m_material_descriptor_set_layout;
-
-            if (RHI_SUCCESS != rhi->allocateDescriptorSets(
-                &material_descriptor_set_alloc_info,
-                now_material.material_descriptor_set))
+        void* emissive_image_pixels = empty_image;
+        uint32_t           emissive_image_width = 1;
+        uint32_t           emissive_image_height = 1;
+        RHIFormat emissive_image_format = RHIFormat::RHI_FORMAT_R8G8B8A8_UNORM;
+        if (material_data.m_emissive_texture)
+        {
+            emissive_image_pixels = material_data.m_emissive_texture->m_pixels;
+            emissive_image_width  = static_cast<uint32_t>(material_data.m_emissive_texture->m_width);
+            emissive_image_height = static_cast<uint32_t>(material_data.m_emissive_texture->m_height);
+            emissive_image_format = material_data.m_emissive_texture->m_format;
+        }
+
+        // similiarly to the vertex/index buffer, we should allocate the uniform
+        // buffer in DEVICE_LOCAL memory and use the temp stage buffer to copy the
+        // data
+        {
+            // temporary staging buffer
+
+            RHIDeviceSize buffer_size = sizeof(MeshPerMaterialUniformBufferObject);
+
+            RHIStagingBufferAllocation staging_allocation;
+            if (!rhi->allocateStagingBuffer(buffer_size, 16, staging_allocation))
             {
-                throw std::runtime_error("allocate material descriptor set");
+                throw std::runtime_error("allocate material staging buffer");
             }
 
-            RHIDescriptorBufferInfo material_uniform_buffer_info = {};
-            material_uniform_buffer_info.offset = 0;
-            material_uniform_buffer_info.range = sizeof(MeshPerMaterialUniformBufferObject);
-            material_uniform_buffer_info.buffer = now_material.material_uniform_buffer;
-
-            RHIDescriptorImageInfo base_color_image_info = {};
-            base_color_image_info.imageLayout = RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-            base_color_image_info.imageView = now_material.base_color_image_view;
-            base_color_image_info.sampler = rhi->getOrCreateMipmapSampler(base_color_image_width,
-                                                                          base_color_image_height);
-
-            RHIDescriptorImageInfo metallic_roughness_image_info = {};
-            metallic_roughness_image_info.imageLayout = RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-            metallic_roughness_image_info.imageView = now_material.metallic_roughness_image_view;
-            metallic_roughness_image_info.sampler = rhi->getOrCreateMipmapSampler(metallic_roughness_width,
-                                                                                  metallic_roughness_height);
-
-            RHIDescriptorImageInfo normal_roughness_image_info = {};
-            normal_roughness_image_info.imageLayout = RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-            normal_roughness_image_info.imageView = now_material.normal_image_view;
-            normal_roughness_image_info.sampler = rhi->getOrCreateMipmapSampler(normal_roughness_width,
-                                                                                normal_roughness_height);
-
-            RHIDescriptorImageInfo occlusion_image_info = {};
-            occlusion_image_info.imageLayout = RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-            occlusion_image_info.imageView = now_material.occlusion_image_view;
-            occlusion_image_info.sampler = rhi->getOrCreateMipmapSampler(occlusion_image_width,occlusion_image_height);
-
-            RHIDescriptorImageInfo emissive_image_info = {};
-            emissive_image_info.imageLayout = RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-            emissive_image_info.imageView = now_material.emissive_image_view;
-            emissive_image_info.sampler = rhi->getOrCreateMipmapSampler(emissive_image_width, emissive_image_height);
-
-            RHIWriteDescriptorSet mesh_descriptor_writes_info[6];
-
-            mesh_descriptor_writes_info[0].sType = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            mesh_descriptor_writes_info[0].pNext = NULL;
-            mesh_descriptor_writes_info[0].dstSet = now_material.material_descriptor_set;
-            mesh_descriptor_writes_info[0].dstBinding = 0;
-            mesh_descriptor_writes_info[0].dstArrayElement = 0;
-            mesh_descriptor_writes_info[0].descriptorType = RHI_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-            mesh_descriptor_writes_info[0].descriptorCount = 1;
-            mesh_descriptor_writes_info[0].pBufferInfo = &material_uniform_buffer_info;
-
-            mesh_descriptor_writes_info[1].sType = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            mesh_descriptor_writes_info[1].pNext = NULL;
-            mesh_descriptor_writes_info[1].dstSet = now_material.material_descriptor_set;
-            mesh_descriptor_writes_info[1].dstBinding = 1;
-            mesh_descriptor_writes_info[1].dstArrayElement = 0;
-            mesh_descriptor_writes_info[1].descriptorType = RHI_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-            mesh_descriptor_writes_info[1].descriptorCount = 1;
-            mesh_descriptor_writes_info[1].pImageInfo = &base_color_image_info;
-
-            mesh_descriptor_writes_info[2] = mesh_descriptor_writes_info[1];
-            mesh_descriptor_writes_info[2].dstBinding = 2;
-            mesh_descriptor_writes_info[2].pImageInfo = &metallic_roughness_image_info;
-
-            mesh_descriptor_writes_info[3] = mesh_descriptor_writes_info[1];
-            mesh_descriptor_writes_info[3].dstBinding = 3;
-            mesh_descriptor_writes_info[3].pImageInfo = &normal_roughness_image_info;
-
-            mesh_descriptor_writes_info[4] = mesh_descriptor_writes_info[1];
-            mesh_descriptor_writes_info[4].dstBinding = 4;
-            mesh_descriptor_writes_info[4].pImageInfo = &occlusion_image_info;
-
-            mesh_descriptor_writes_info[5] = mesh_descriptor_writes_info[1];
-            mesh_descriptor_writes_info[5].dstBinding = 5;
-            mesh_descriptor_writes_info[5].pImageInfo = &emissive_image_info;
-
-            rhi->updateDescriptorSets(6, mesh_descriptor_writes_info, 0, nullptr);
+            MeshPerMaterialUniformBufferObject& material_uniform_buffer_info =
+                (*static_cast<MeshPerMaterialUniformBufferObject*>(staging_allocation.mapped_data));
+            material_uniform_buffer_info.is_blend = entity.m_blend;
+            material_uniform_buffer_info.is_double_sided = entity.m_double_sided;
+            material_uniform_buffer_info.baseColorFactor = entity.m_base_color_factor;
+            material_uniform_buffer_info.metallicFactor = entity.m_metallic_factor;
+            material_uniform_buffer_info.roughnessFactor = entity.m_roughness_factor;
+            material_uniform_buffer_info.normalScale = entity.m_normal_scale;
+            material_uniform_buffer_info.occlusionStrength = entity.m_occlusion_strength;
+            material_uniform_buffer_info.emissiveFactor = entity.m_emissive_factor;
+
+            // use the vmaAllocator to allocate asset uniform buffer
+            RHIBufferCreateInfo bufferInfo = { RHI_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+            bufferInfo.size = buffer_size;
+            bufferInfo.usage = RHI_BUFFER_USAGE_UNIFORM_BUFFER_BIT | RHI_BUFFER_USAGE_TRANSFER_DST_BIT;
+
+            VmaAllocationCreateInfo allocInfo = {};
+            allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
 
-            return now_material;
+            rhi->createBufferWithAlignmentVMA(
+                vulkan_context->m_assets_allocator,
+                &bufferInfo,
+                &allocInfo,
+                m_global_render_resource._storage_buffer._min_uniform_buffer_offset_alignment,
+                now_material.material_uniform_buffer,
+                &now_material.material_uniform_buffer_allocation,
+                NULL);
+
+            // use the data from staging buffer
+            rhi->enqueueCopyBuffer(staging_allocation, now_material.material_uniform_buffer, 0, 0, buffer_size);
         }
+
+        TextureDataToUpdate update_texture_data;
+        update_texture_data.base_color_image_pixels         = base_color_image_pixels;
+        update_texture_data.base_color_image_width          = base_color_image_width;
+        update_texture_data.base_color_image_height         = base_color_image_height;
+        update_texture_data.base_color_image_format         = base_color_image_format;
+        update_texture_data.metallic_roughness_image_pixels = metallic_roughness_image_pixels;
+        update_texture_data.metallic_roughness_image_width  = metallic_roughness_width;
+        update_texture_data.metallic_roughness_image_height = metallic_roughness_height;
+        update_texture_data.metallic_roughness_image_format = metallic_roughness_format;
+        update_texture_data.normal_roughness_image_pixels   = normal_roughness_image_pixels;
+        update_texture_data.normal_roughness_image_width    = normal_roughness_width;
+        update_texture_data.normal_roughness_image_height   = normal_roughness_height;
+        update_texture_data.normal_roughness_image_format   = normal_roughness_format;
+        update_texture_data.occlusion_image_pixels          = occlusion_image_pixels;
+        update_texture_data.occlusion_image_width           = occlusion_image_width;
+        update_texture_data.occlusion_image_height          = occlusion_image_height;
+        update_texture_data.occlusion_image_format          = occlusion_image_format;
+        update_texture_data.emissive_image_pixels           = emissive_image_pixels;
+        update_texture_data.emissive_image_width            = emissive_image_width;
+        update_texture_data.emissive_image_height           = emissive_image_height;
+        update_texture_data.emissive_image_format           = emissive_image_format;
+        update_texture_data.now_material                    = &now_material;
+
+        updateTextureImageData(rhi, update_texture_data);
+
+        RHIDescriptorSetAllocateInfo material_descriptor_set_alloc_info;
+        material_descriptor_set_alloc_info.sType = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        material_descriptor_set_alloc_info.pNext = NULL;
+        material_descriptor_set_alloc_info.descriptorPool = vulkan_context->m_descriptor_pool;
+        material_descriptor_set_alloc_info.descriptorSetCount = 1;
+        material_descriptor_set_alloc_info.pSetLayouts        = m_material_descriptor_set_layout;
+
+        // the pool cannot free single sets, a reloaded material rewrites the set it already has
+        if (now_material.material_descriptor_set == nullptr &&
+            RHI_SUCCESS != rhi->allocateDescriptorSets(
+            &material_descriptor_set_alloc_info,
+            now_material.material_descriptor_set))
+        {
+            throw std::runtime_error("allocate material descriptor set");
+        }
+
+        RHIDescriptorBufferInfo material_uniform_buffer_info = {};
+        material_uniform_buffer_info.offset = 0;
+        material_uniform_buffer_info.range = sizeof(MeshPerMaterialUniformBufferObject);
+        material_uniform_buffer_info.buffer = now_material.material_uniform_buffer;
+
+        RHIDescriptorImageInfo base_color_image_info = {};
+        base_color_image_info.imageLayout = RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        base_color_image_info.imageView = now_material.base_color_image_view;
+        base_color_image_info.sampler = rhi->getOrCreateMipmapSampler(base_color_image_width,
+                                                                      base_color_image_height);
+
+        RHIDescriptorImageInfo metallic_roughness_image_info = {};
+        metallic_roughness_image_info.imageLayout = RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        metallic_roughness_image_info.imageView = now_material.metallic_roughness_image_view;
+        metallic_roughness_image_info.sampler = rhi->getOrCreateMipmapSampler(metallic_roughness_width,
+                                                                              metallic_roughness_height);
+
+        RHIDescriptorImageInfo normal_roughness_image_info = {};
+        normal_roughness_image_info.imageLayout = RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        normal_roughness_image_info.imageView = now_material.normal_image_view;
+        normal_roughness_image_info.sampler = rhi->getOrCreateMipmapSampler(normal_roughness_width,
+                                                                            normal_roughness_height);
+
+        RHIDescriptorImageInfo occlusion_image_info = {};
+        occlusion_image_info.imageLayout = RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        occlusion_image_info.imageView = now_material.occlusion_image_view;
+        occlusion_image_info.sampler = rhi->getOrCreateMipmapSampler(occlusion_image_width,occlusion_image_height);
+
+        RHIDescriptorImageInfo emissive_image_info = {};
+        emissive_image_info.imageLayout = RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        emissive_image_info.imageView = now_material.emissive_image_view;
+        emissive_image_info.sampler = rhi->getOrCreateMipmapSampler(emissive_image_width, emissive_image_height);
+
+        RHIWriteDescriptorSet mesh_descriptor_writes_info[6];
+
+        mesh_descriptor_writes_info[0].sType = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        mesh_descriptor_writes_info[0].pNext = NULL;
+        mesh_descriptor_writes_info[0].dstSet = now_material.material_descriptor_set;
+        mesh_descriptor_writes_info[0].dstBinding = 0;
+        mesh_descriptor_writes_info[0].dstArrayElement = 0;
+        mesh_descriptor_writes_info[0].descriptorType = RHI_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        mesh_descriptor_writes_info[0].descriptorCount = 1;
+        mesh_descriptor_writes_info[0].pBufferInfo = &material_uniform_buffer_info;
+
+        mesh_descriptor_writes_info[1].sType = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        mesh_descriptor_writes_info[1].pNext = NULL;
+        mesh_descriptor_writes_info[1].dstSet = now_material.material_descriptor_set;
+        mesh_descriptor_writes_info[1].dstBinding = 1;
+        mesh_descriptor_writes_info[1].dstArrayElement = 0;
+        mesh_descriptor_writes_info[1].descriptorType = RHI_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        mesh_descriptor_writes_info[1].descriptorCount = 1;
+        mesh_descriptor_writes_info[1].pImageInfo = &base_color_image_info;
+
+        mesh_descriptor_writes_info[2] = mesh_descriptor_writes_info[1];
+        mesh_descriptor_writes_info[2].dstBinding = 2;
+        mesh_descriptor_writes_info[2].pImageInfo = &metallic_roughness_image_info;
+
+        mesh_descriptor_writes_info[3] = mesh_descriptor_writes_info[1];
+        mesh_descriptor_writes_info[3].dstBinding = 3;
+        mesh_descriptor_writes_info[3].pImageInfo = &normal_roughness_image_info;
+
+        mesh_descriptor_writes_info[4] = mesh_descriptor_writes_info[1];
+        mesh_descriptor_writes_info[4].dstBinding = 4;
+        mesh_descriptor_writes_info[4].pImageInfo = &occlusion_image_info;
+
+        mesh_descriptor_writes_info[5] = mesh_descriptor_writes_info[1];
+        mesh_descriptor_writes_info[5].dstBinding = 5;
+        mesh_descriptor_writes_info[5].pImageInfo = &emissive_image_info;
+
+        rhi->updateDescriptorSets(6, mesh_descriptor_writes_info, 0, nullptr);
+    }
+
+    void RenderResource::destroyVulkanMeshBuffers(std::shared_ptr<RHI> rhi, VulkanMesh& now_mesh)
+    {
+        VmaAllocator allocator = static_cast<VulkanRHI*>(rhi.get())->m_assets_allocator;
+
+        rhi->destroyBufferVMA(
+            allocator, now_mesh.mesh_vertex_position_buffer, now_mesh.mesh_vertex_position_buffer_allocation);
+        rhi->destroyBufferVMA(allocator,
+                              now_mesh.mesh_vertex_varying_enable_blending_buffer,
+                              now_mesh.mesh_vertex_varying_enable_blending_buffer_allocation);
+        rhi->destroyBufferVMA(
+            allocator, now_mesh.mesh_vertex_varying_buffer, now_mesh.mesh_vertex_varying_buffer_allocation);
+        if (now_mesh.enable_vertex_blending)
+        {
+            rhi->destroyBufferVMA(allocator,
+                                  now_mesh.mesh_vertex_joint_binding_buffer,
+                                  now_mesh.mesh_vertex_joint_binding_buffer_allocation);
+        }
+        rhi->destroyBufferVMA(allocator, now_mesh.mesh_index_buffer, now_mesh.mesh_index_buffer_allocation);
+    }
+
+    void RenderResource::destroyVulkanMaterialImages(std::shared_ptr<RHI> rhi, VulkanPBRMaterial& now_material)
+    {
+        VmaAllocator allocator = static_cast<VulkanRHI*>(rhi.get())->m_assets_allocator;
+
+        auto destroy_image = [&](RHIImage*& image, RHIImageView*& image_view, VmaAllocation allocation) {
+            rhi->destroyImageView(image_view);
+            RHI_DELETE_PTR(image_view);
+            rhi->destroyImageVMA(allocator, image, allocation);
+        };
+        destroy_image(now_material.base_color_texture_image,
+                      now_material.base_color_image_view,
+                      now_material.base_color_image_allocation);
+        destroy_image(now_material.metallic_roughness_texture_image,
+                      now_material.metallic_roughness_image_view,
+                      now_material.metallic_roughness_image_allocation);
+        destroy_image(
+            now_material.normal_texture_image, now_material.normal_image_view, now_material.normal_image_allocation);
+        destroy_image(now_material.occlusion_texture_image,
+                      now_material.occlusion_image_view,
+                      now_material.occlusion_image_allocation);
+        destroy_image(now_material.emissive_texture_image,
+                      now_material.emissive_image_view,
+                      now_material.emissive_image_allocation);
+
+        rhi->destroyBufferVMA(
+            allocator, now_material.material_uniform_buffer, now_material.material_uniform_buffer_allocation);
     }
 
     void RenderResource::updateMeshData(std::shared_ptr<RHI>                   rhi,
@@ -647,38 +781,30 @@ namespace Piccolo
                 vertex_varying_enable_blending_buffer_offset + vertex_varying_enable_blending_buffer_size;
             RHIDeviceSize vertex_joint_binding_buffer_offset = vertex_varying_buffer_offset + vertex_varying_buffer_size;
 
-            // temporary staging buffer
-            RHIDeviceSize inefficient_staging_buffer_size =
+            // staging memory, recycled once the upload batch is finished on the gpu
+            RHIDeviceSize staging_buffer_size =
                 vertex_position_buffer_size + vertex_varying_enable_blending_buffer_size + vertex_varying_buffer_size +
                 vertex_joint_binding_buffer_size;
-            RHIBuffer* inefficient_staging_buffer = RHI_NULL_HANDLE;
-            RHIDeviceMemory* inefficient_staging_buffer_memory = RHI_NULL_HANDLE;
-            rhi->createBuffer(inefficient_staging_buffer_size,
-                              RHI_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                              RHI_MEMORY_PROPERTY_HOST_VISIBLE_BIT | RHI_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                              inefficient_staging_buffer,
-                              inefficient_staging_buffer_memory);
-
-            void* inefficient_staging_buffer_data;
-            rhi->mapMemory(inefficient_staging_buffer_memory,
-                           0,
-                           RHI_WHOLE_SIZE,
-                           0,
-                           &inefficient_staging_buffer_data);
+            RHIStagingBufferAllocation staging_allocation;
+            if (!rhi->allocateStagingBuffer(staging_buffer_size, 16, staging_allocation))
+            {
+                throw std::runtime_error("allocate mesh vertex staging buffer");
+            }
+            void* staging_buffer_data = staging_allocation.mapped_data;
 
             MeshVertex::VulkanMeshVertexPostition* mesh_vertex_positions =
                 reinterpret_cast<MeshVertex::VulkanMeshVertexPostition*>(
-                    reinterpret_cast<uintptr_t>(inefficient_staging_buffer_data) + vertex_position_buffer_offset);
+                    reinterpret_cast<uintptr_t>(staging_buffer_data) + vertex_position_buffer_offset);
             MeshVertex::VulkanMeshVertexVaryingEnableBlending* mesh_vertex_blending_varyings =
                 reinterpret_cast<MeshVertex::VulkanMeshVertexVaryingEnableBlending*>(
-                    reinterpret_cast<uintptr_t>(inefficient_staging_buffer_data) +
+                    reinterpret_cast<uintptr_t>(staging_buffer_data) +
                     vertex_varying_enable_blending_buffer_offset);
             MeshVertex::VulkanMeshVertexVarying* mesh_vertex_varyings =
                 reinterpret_cast<MeshVertex::VulkanMeshVertexVarying*>(
-                    reinterpret_cast<uintptr_t>(inefficient_staging_buffer_data) + vertex_varying_buffer_offset);
+                    reinterpret_cast<uintptr_t>(staging_buffer_data) + vertex_varying_buffer_offset);
             MeshVertex::VulkanMeshVertexJointBinding* mesh_vertex_joint_binding =
                 reinterpret_cast<MeshVertex::VulkanMeshVertexJointBinding*>(
-                    reinterpret_cast<uintptr_t>(inefficient_staging_buffer_data) + vertex_joint_binding_buffer_offset);
+                    reinterpret_cast<uintptr_t>(staging_buffer_data) + vertex_joint_binding_buffer_offset);
 
             for (uint32_t vertex_index = 0; vertex_index < vertex_count; ++vertex_index)
             {
@@ -725,15 +851,15 @@ namespace Piccolo
                         joint_binding_buffer_data[vertex_buffer_index].m_weight3 * inv_total_weight);
             }
 
-            rhi->unmapMemory(inefficient_staging_buffer_memory);
-
             // use the vmaAllocator to allocate asset vertex buffer
             RHIBufferCreateInfo bufferInfo = { RHI_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
 
             VmaAllocationCreateInfo allocInfo = {};
             allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
 
-            bufferInfo.usage = RHI_BUFFER_USAGE_VERTEX_BUFFER_BIT | RHI_BUFFER_USAGE_TRANSFER_DST_BIT;
+            // the positions and the normals are read by the skinning pass as well
+            bufferInfo.usage = RHI_BUFFER_USAGE_VERTEX_BUFFER_BIT | RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                               RHI_BUFFER_USAGE_TRANSFER_DST_BIT;
             bufferInfo.size = vertex_position_buffer_size;
             rhi->createBufferVMA(vulkan_context->m_assets_allocator,
                                  &bufferInfo,
@@ -748,6 +874,7 @@ namespace Piccolo
                                  now_mesh.mesh_vertex_varying_enable_blending_buffer,
                                  &now_mesh.mesh_vertex_varying_enable_blending_buffer_allocation,
                                  NULL);
+            bufferInfo.usage = RHI_BUFFER_USAGE_VERTEX_BUFFER_BIT | RHI_BUFFER_USAGE_TRANSFER_DST_BIT;
             bufferInfo.size = vertex_varying_buffer_size;
             rhi->createBufferVMA(vulkan_context->m_assets_allocator,
                                  &bufferInfo,
@@ -766,30 +893,26 @@ namespace Piccolo
                                  NULL);
 
             // use the data from staging buffer
-            rhi->copyBuffer(inefficient_staging_buffer,
-                            now_mesh.mesh_vertex_position_buffer,
-                            vertex_position_buffer_offset,
-                            0,
-                            vertex_position_buffer_size);
-            rhi->copyBuffer(inefficient_staging_buffer,
-                            now_mesh.mesh_vertex_varying_enable_blending_buffer,
-                            vertex_varying_enable_blending_buffer_offset,
-                            0,
-                            vertex_varying_enable_blending_buffer_size);
-            rhi->copyBuffer(inefficient_staging_buffer,
-                            now_mesh.mesh_vertex_varying_buffer,
-                            vertex_varying_buffer_offset,
-                            0,
-                            vertex_varying_buffer_size);
-            rhi->copyBuffer(inefficient_staging_buffer,
-                            now_mesh.mesh_vertex_joint_binding_buffer,
-                            vertex_joint_binding_buffer_offset,
-                            0,
-                            vertex_joint_binding_buffer_size);
-
-            // release staging buffer
-            rhi->destroyBuffer(inefficient_staging_buffer);
-            rhi->freeMemory(inefficient_staging_buffer_memory);
+            rhi->enqueueCopyBuffer(staging_allocation,
+                                   now_mesh.mesh_vertex_position_buffer,
+                                   vertex_position_buffer_offset,
+                                   0,
+                                   vertex_position_buffer_size);
+            rhi->enqueueCopyBuffer(staging_allocation,
+                                   now_mesh.mesh_vertex_varying_enable_blending_buffer,
+                                   vertex_varying_enable_blending_buffer_offset,
+                                   0,
+                                   vertex_varying_enable_blending_buffer_size);
+            rhi->enqueueCopyBuffer(staging_allocation,
+                                   now_mesh.mesh_vertex_varying_buffer,
+                                   vertex_varying_buffer_offset,
+                                   0,
+                                   vertex_varying_buffer_size);
+            rhi->enqueueCopyBuffer(staging_allocation,
+                                   now_mesh.mesh_vertex_joint_binding_buffer,
+                                   vertex_joint_binding_buffer_offset,
+                                   0,
+                                   vertex_joint_binding_buffer_size);
 
             // update descriptor set
             RHIDescriptorSetAllocateInfo mesh_vertex_blending_per_mesh_descriptor_set_alloc_info;
@@ -800,7 +923,9 @@ namespace Piccolo
             mesh_vertex_blending_per_mesh_descriptor_set_alloc_info.descriptorSetCount = 1;
             mesh_vertex_blending_per_mesh_descriptor_set_alloc_info.pSetLayouts        = m_mesh_descriptor_set_layout;
 
-            if (RHI_SUCCESS != rhi->allocateDescriptorSets(
+            // kept by a reloaded mesh, see uploadVulkanMaterial
+            if (now_mesh.mesh_vertex_blending_descriptor_set == nullptr &&
+                RHI_SUCCESS != rhi->allocateDescriptorSets(
                 &mesh_vertex_blending_per_mesh_descriptor_set_alloc_info,
                 now_mesh.mesh_vertex_blending_descriptor_set))
             {
@@ -836,6 +961,15 @@ namespace Piccolo
                                       descriptor_writes,
                                       0,
                                       NULL);
+
+            if (m_mesh_skinning_descriptor_set_layout)
+            {
+                updateMeshSkinningDescriptorSet(rhi,
+                                                now_mesh,
+                                                vertex_position_buffer_size,
+                                                vertex_varying_enable_blending_buffer_size,
+                                                vertex_joint_binding_buffer_size);
+            }
         }
         else
         {
@@ -853,34 +987,26 @@ namespace Piccolo
             RHIDeviceSize vertex_varying_buffer_offset =
                 vertex_varying_enable_blending_buffer_offset + vertex_varying_enable_blending_buffer_size;
 
-            // temporary staging buffer
-            RHIDeviceSize inefficient_staging_buffer_size =
+            // staging memory, recycled once the upload batch is finished on the gpu
+            RHIDeviceSize staging_buffer_size =
                 vertex_position_buffer_size + vertex_varying_enable_blending_buffer_size + vertex_varying_buffer_size;
-            RHIBuffer* inefficient_staging_buffer = RHI_NULL_HANDLE;
-            RHIDeviceMemory* inefficient_staging_buffer_memory = RHI_NULL_HANDLE;
-            rhi->createBuffer(inefficient_staging_buffer_size,
-                              RHI_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                              RHI_MEMORY_PROPERTY_HOST_VISIBLE_BIT | RHI_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                              inefficient_staging_buffer,
-                              inefficient_staging_buffer_memory);
-
-            void* inefficient_staging_buffer_data;
-            rhi->mapMemory(inefficient_staging_buffer_memory,
-                           0,
-                           RHI_WHOLE_SIZE,
-                           0,
-                           &inefficient_staging_buffer_data);
+            RHIStagingBufferAllocation staging_allocation;
+            if (!rhi->allocateStagingBuffer(staging_buffer_size, 16, staging_allocation))
+            {
+                throw std::runtime_error("allocate mesh vertex staging buffer");
+            }
+            void* staging_buffer_data = staging_allocation.mapped_data;
 
             MeshVertex::VulkanMeshVertexPostition* mesh_vertex_positions =
                 reinterpret_cast<MeshVertex::VulkanMeshVertexPostition*>(
-                    reinterpret_cast<uintptr_t>(inefficient_staging_buffer_data) + vertex_position_buffer_offset);
+                    reinterpret_cast<uintptr_t>(staging_buffer_data) + vertex_position_buffer_offset);
             MeshVertex::VulkanMeshVertexVaryingEnableBlending* mesh_vertex_blending_varyings =
                 reinterpret_cast<MeshVertex::VulkanMeshVertexVaryingEnableBlending*>(
-                    reinterpret_cast<uintptr_t>(inefficient_staging_buffer_data) +
+                    reinterpret_cast<uintptr_t>(staging_buffer_data) +
                     vertex_varying_enable_blending_buffer_offset);
             MeshVertex::VulkanMeshVertexVarying* mesh_vertex_varyings =
                 reinterpret_cast<MeshVertex::VulkanMeshVertexVarying*>(
-                    reinterpret_cast<uintptr_t>(inefficient_staging_buffer_data) + vertex_varying_buffer_offset);
+                    reinterpret_cast<uintptr_t>(staging_buffer_data) + vertex_varying_buffer_offset);
 
             for (uint32_t vertex_index = 0; vertex_index < vertex_count; ++vertex_index)
             {
@@ -902,8 +1028,6 @@ namespace Piccolo
                     Vector2(vertex_buffer_data[vertex_index].u, vertex_buffer_data[vertex_index].v);
             }
 
-            rhi->unmapMemory(inefficient_staging_buffer_memory);
-
             // use the vmaAllocator to allocate asset vertex buffer
             RHIBufferCreateInfo bufferInfo = { RHI_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
             bufferInfo.usage = RHI_BUFFER_USAGE_VERTEX_BUFFER_BIT | RHI_BUFFER_USAGE_TRANSFER_DST_BIT;
@@ -934,25 +1058,21 @@ namespace Piccolo
                                  NULL);
 
             // use the data from staging buffer
-            rhi->copyBuffer(inefficient_staging_buffer,
-                            now_mesh.mesh_vertex_position_buffer,
-                            vertex_position_buffer_offset,
-                            0,
-                            vertex_position_buffer_size);
-            rhi->copyBuffer(inefficient_staging_buffer,
-                            now_mesh.mesh_vertex_varying_enable_blending_buffer,
-                            vertex_varying_enable_blending_buffer_offset,
-                            0,
-                            vertex_varying_enable_blending_buffer_size);
-            rhi->copyBuffer(inefficient_staging_buffer,
-                            now_mesh.mesh_vertex_varying_buffer,
-                            vertex_varying_buffer_offset,
-                            0,
-                            vertex_varying_buffer_size);
-
-            // release staging buffer
-            rhi->destroyBuffer(inefficient_staging_buffer);
-            rhi->freeMemory(inefficient_staging_buffer_memory);
+            rhi->enqueueCopyBuffer(staging_allocation,
+                                   now_mesh.mesh_vertex_position_buffer,
+                                   vertex_position_buffer_offset,
+                                   0,
+                                   vertex_position_buffer_size);
+            rhi->enqueueCopyBuffer(staging_allocation,
+                                   now_mesh.mesh_vertex_varying_enable_blending_buffer,
+                                   vertex_varying_enable_blending_buffer_offset,
+                                   0,
+                                   vertex_varying_enable_blending_buffer_size);
+            rhi->enqueueCopyBuffer(staging_allocation,
+                                   now_mesh.mesh_vertex_varying_buffer,
+                                   vertex_varying_buffer_offset,
+                                   0,
+                                   vertex_varying_buffer_size);
 
             // update descriptor set
             RHIDescriptorSetAllocateInfo mesh_vertex_blending_per_mesh_descriptor_set_alloc_info;
@@ -963,7 +1083,9 @@ namespace Piccolo
             mesh_vertex_blending_per_mesh_descriptor_set_alloc_info.descriptorSetCount = 1;
             mesh_vertex_blending_per_mesh_descriptor_set_alloc_info.pSetLayouts        = m_mesh_descriptor_set_layout;
 
-            if (RHI_SUCCESS != rhi->allocateDescriptorSets(
+            // kept by a reloaded mesh, see uploadVulkanMaterial
+            if (now_mesh.mesh_vertex_blending_descriptor_set == nullptr &&
+                RHI_SUCCESS != rhi->allocateDescriptorSets(
                 &mesh_vertex_blending_per_mesh_descriptor_set_alloc_info,
                 now_mesh.mesh_vertex_blending_descriptor_set))
             {
@@ -1003,6 +1125,56 @@ namespace Piccolo
         }
     }
 
+    void RenderResource::updateMeshSkinningDescriptorSet(std::shared_ptr<RHI> rhi,
+                                                         VulkanMesh&          now_mesh,
+                                                         RHIDeviceSize        vertex_position_buffer_size,
+                                                         RHIDeviceSize vertex_varying_enable_blending_buffer_size,
+                                                         RHIDeviceSize vertex_joint_binding_buffer_size)
+    {
+        RHIDescriptorSetAllocateInfo mesh_skinning_per_mesh_descriptor_set_alloc_info;
+        mesh_skinning_per_mesh_descriptor_set_alloc_info.sType          = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        mesh_skinning_per_mesh_descriptor_set_alloc_info.pNext          = NULL;
+        mesh_skinning_per_mesh_descriptor_set_alloc_info.descriptorPool = rhi->getDescriptorPoor();
+        mesh_skinning_per_mesh_descriptor_set_alloc_info.descriptorSetCount = 1;
+        mesh_skinning_per_mesh_descriptor_set_alloc_info.pSetLayouts        = m_mesh_skinning_descriptor_set_layout;
+
+        // kept by a reloaded mesh like its vertex blending descriptor set
+        if (now_mesh.mesh_skinning_descriptor_set == nullptr &&
+            RHI_SUCCESS != rhi->allocateDescriptorSets(&mesh_skinning_per_mesh_descriptor_set_alloc_info,
+                                                       now_mesh.mesh_skinning_descriptor_set))
+        {
+            throw std::runtime_error("allocate mesh skinning per mesh descriptor set");
+        }
+
+        RHIDescriptorBufferInfo buffer_infos[3] = {};
+        buffer_infos[0].offset                  = 0;
+        buffer_infos[0].range                   = vertex_position_buffer_size;
+        buffer_infos[0].buffer                  = now_mesh.mesh_vertex_position_buffer;
+        buffer_infos[1].offset                  = 0;
+        buffer_infos[1].range                   = vertex_varying_enable_blending_buffer_size;
+        buffer_infos[1].buffer                  = now_mesh.mesh_vertex_varying_enable_blending_buffer;
+        buffer_infos[2].offset                  = 0;
+        buffer_infos[2].range                   = vertex_joint_binding_buffer_size;
+        buffer_infos[2].buffer                  = now_mesh.mesh_vertex_joint_binding_buffer;
+
+        RHIWriteDescriptorSet descriptor_writes[3];
+        for (uint32_t binding = 0; binding < 3; ++binding)
+        {
+            RHIWriteDescriptorSet& descriptor_write = descriptor_writes[binding];
+            descriptor_write.sType                  = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            descriptor_write.pNext                  = NULL;
+            descriptor_write.dstSet                 = now_mesh.mesh_skinning_descriptor_set;
+            descriptor_write.dstBinding             = binding;
+            descriptor_write.dstArrayElement        = 0;
+            descriptor_write.descriptorType         = RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            descriptor_write.descriptorCount        = 1;
+            descriptor_write.pBufferInfo            = &buffer_infos[binding];
+        }
+
+        rhi->updateDescriptorSets(
+            sizeof(descriptor_writes) / sizeof(descriptor_writes[0]), descriptor_writes, 0, NULL);
+    }
+
     void RenderResource::updateIndexBuffer(std::shared_ptr<RHI> rhi,
                                            uint32_t             index_buffer_size,
                                            void*                index_buffer_data,
@@ -1010,21 +1182,15 @@ namespace Piccolo
     {
         VulkanRHI* vulkan_context = static_cast<VulkanRHI*>(rhi.get());
 
-        // temp staging buffer
+        // staging memory, recycled once the upload batch is finished on the gpu
         RHIDeviceSize buffer_size = index_buffer_size;
 
-        RHIBuffer* inefficient_staging_buffer;
-        RHIDeviceMemory* inefficient_staging_buffer_memory;
-        rhi->createBuffer(buffer_size,
-                          RHI_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                          RHI_MEMORY_PROPERTY_HOST_VISIBLE_BIT | RHI_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                          inefficient_staging_buffer,
-                          inefficient_staging_buffer_memory);
-
-        void* staging_buffer_data;
-        rhi->mapMemory(inefficient_staging_buffer_memory, 0, buffer_size, 0, &staging_buffer_data);
-        memcpy(staging_buffer_data, index_buffer_data, (size_t)buffer_size);
-        rhi->unmapMemory(inefficient_staging_buffer_memory);
+        RHIStagingBufferAllocation staging_allocation;
+        if (!rhi->allocateStagingBuffer(buffer_size, 16, staging_allocation))
+        {
+            throw std::runtime_error("allocate mesh index staging buffer");
+        }
+        memcpy(staging_allocation.mapped_data, index_buffer_data, (size_t)buffer_size);
 
         // use the vmaAllocator to allocate asset index buffer
         RHIBufferCreateInfo bufferInfo = { RHI_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
@@ -1042,11 +1208,7 @@ namespace Piccolo
                              NULL);
 
         // use the data from staging buffer
-        rhi->copyBuffer( inefficient_staging_buffer, now_mesh.mesh_index_buffer, 0, 0, buffer_size);
-
-        // release temp staging buffer
-        rhi->destroyBuffer(inefficient_staging_buffer);
-        rhi->freeMemory(inefficient_staging_buffer_memory);
+        rhi->enqueueCopyBuffer(staging_allocation, now_mesh.mesh_index_buffer, 0, 0, buffer_size);
     }
 
     void RenderResource::updateTextureImageData(std::shared_ptr<RHI> rhi, const TextureDataToUpdate& texture_data)
@@ -1097,7 +1259,13 @@ namespace Piccolo
             texture_data.emissive_image_format);
     }
 
-    VulkanMesh& RenderResource::getEntityMesh(RenderEntity entity)
+    const MeshPickData* RenderResource::getEntityMeshPickData(const RenderEntity& entity) const
+    {
+        auto it = m_mesh_pick_datas.find(entity.m_mesh_asset_id);
+        return it != m_mesh_pick_datas.end() ? &it->second : nullptr;
+    }
+
+    VulkanMesh& RenderResource::getEntityMesh(const RenderEntity& entity)
     {
         size_t assetid = entity.m_mesh_asset_id;
 
@@ -1112,7 +1280,7 @@ namespace Piccolo
         }
     }
 
-    VulkanPBRMaterial& RenderResource::getEntityMaterial(RenderEntity entity)
+    VulkanPBRMaterial& RenderResource::getEntityMaterial(const RenderEntity& entity)
     {
         size_t assetid = entity.m_material_asset_id;
 
@@ -1133,6 +1301,30 @@ namespace Piccolo
             m_global_render_resource._storage_buffer._global_upload_ringbuffers_begin[current_frame_index];
     }
 
+    void RenderResource::uploadJointPalette(uint8_t current_frame_index)
+    {
+        StorageBuffer& storage_buffer = m_global_render_resource._storage_buffer;
+
+        // the whole palette is reserved since the descriptors cover all of it, only the used joints are copied
+        storage_buffer._joint_palette_dynamic_offset =
+            roundUp(storage_buffer._global_upload_ringbuffers_end[current_frame_index],
+                    storage_buffer._min_storage_buffer_offset_alignment);
+        storage_buffer._global_upload_ringbuffers_end[current_frame_index] =
+            storage_buffer._joint_palette_dynamic_offset + sizeof(MeshJointPaletteStorageBufferObject);
+        assert(storage_buffer._global_upload_ringbuffers_end[current_frame_index] <=
+               (storage_buffer._global_upload_ringbuffers_begin[current_frame_index] +
+                storage_buffer._global_upload_ringbuffers_size[current_frame_index]));
+
+        assert(m_joint_palette.size() <= s_mesh_joint_palette_max_joint_count);
+        if (!m_joint_palette.empty())
+        {
+            memcpy(reinterpret_cast<uint8_t*>(storage_buffer._global_upload_ringbuffer_memory_pointer) +
+                       storage_buffer._joint_palette_dynamic_offset,
+                   m_joint_palette.data(),
+                   sizeof(VulkanJointMatrix) * m_joint_palette.size());
+        }
+    }
+
     void RenderResource::createAndMapStorageBuffer(std::shared_ptr<RHI> rhi)
     {
         VulkanRHI* raw_rhi = static_cast<VulkanRHI*>(rhi.get());
@@ -5,6 +5,7 @@
 #include "runtime/function/render/interface/rhi.h"
 
 #include "runtime/function/render/render_common.h"
+#include "runtime/function/render/render_light_cluster.h"
 
 #include <vk_mem_alloc.h>
 #include <vulkan/vulkan.h>
@@ -84,6 +85,8 @@ namespace Piccolo
         std::vector<uint32_t> _global_upload_ringbuffers_begin;
         std::vector<uint32_t> _global_upload_ringbuffers_end;
         std::vector<uint32_t> _global_upload_ringbuffers_size;
+        // where the joint palette of the frame was uploaded, all the skinned draws of the frame bind it
+        uint32_t _joint_palette_dynamic_offset{ 0 };
 
         RHIBuffer* _global_null_descriptor_storage_buffer;
         RHIDeviceMemory* _global_null_descriptor_storage_buffer_memory;
@@ -94,11 +97,31 @@ namespace Piccolo
         void* _axis_inefficient_storage_buffer_memory_pointer;
     };
 
+    // vertices of the pre-skinned entities in the layout of the position and the varying enable blending vertex
+    // buffers, written by MeshSkinningPass and drawn as static geometry, null unless pre-skinning is enabled
+    struct SkinnedVertexBuffer
+    {
+        RHIBuffer*       _position_buffer {nullptr};
+        RHIDeviceMemory* _position_buffer_memory {nullptr};
+        RHIBuffer*       _varying_enable_blending_buffer {nullptr};
+        RHIDeviceMemory* _varying_enable_blending_buffer_memory {nullptr};
+    };
+
+    // the geometry of a mesh kept on the host for picking, the joint bindings are per vertex and only kept for the
+    // meshes with vertex blending
+    struct MeshPickData
+    {
+        std::vector<MeshVertex::VulkanMeshVertexPostition>    positions;
+        std::vector<MeshVertex::VulkanMeshVertexJointBinding> joint_bindings;
+        std::vector<uint16_t>                                 indices;
+    };
+
     struct GlobalRenderResource
     {
         IBLResource          _ibl_resource;
         ColorGradingResource _color_grading_resource;
         StorageBuffer        _storage_buffer;
+        SkinnedVertexBuffer  _skinned_vertex_buffer;
     };
 
     class RenderResource : public RenderResourceBase
@@ -122,37 +145,58 @@ namespace Piccolo
             RenderEntity         render_entity,
             RenderMaterialData   material_data) override final;
 
+        virtual void reloadGameObjectRenderResource(std::shared_ptr<RHI> rhi,
+            RenderEntity         render_entity,
+            RenderMeshData       mesh_data) override final;
+
+        virtual void reloadGameObjectRenderResource(std::shared_ptr<RHI> rhi,
+            RenderEntity         render_entity,
+            RenderMaterialData   material_data) override final;
+
         virtual void updatePerFrameBuffer(std::shared_ptr<RenderScene>  render_scene,
             std::shared_ptr<RenderCamera> camera) override final;
 
-        VulkanMesh& getEntityMesh(RenderEntity entity);
+        VulkanMesh& getEntityMesh(const RenderEntity& entity);
+
+        VulkanPBRMaterial& getEntityMaterial(const RenderEntity& entity);
 
-        VulkanPBRMaterial& getEntityMaterial(RenderEntity entity);
+        // null when the mesh of the entity was not uploaded
+        const MeshPickData* getEntityMeshPickData(const RenderEntity& entity) const;
 
         void resetRingBufferOffset(uint8_t current_frame_index);
 
+        // copies m_joint_palette into the ring buffer of the frame, after it was reset
+        void uploadJointPalette(uint8_t current_frame_index);
+
         // global rendering resource, include IBL data, global storage buffer
         GlobalRenderResource m_global_render_resource;
 
         // storage buffer objects
         MeshPerframeStorageBufferObject                 m_mesh_perframe_storage_buffer_object;
         MeshPointLightShadowPerframeStorageBufferObject m_mesh_point_light_shadow_perframe_storage_buffer_object;
-        MeshDirectionalLightShadowPerframeStorageBufferObject
-                                                       m_mesh_directional_light_shadow_perframe_storage_buffer_object;
+        MeshPointLightClusterStorageBufferObject        m_point_light_cluster_storage_buffer_object;
         AxisStorageBufferObject                        m_axis_storage_buffer_object;
         MeshInefficientPickPerframeStorageBufferObject m_mesh_inefficient_pick_perframe_storage_buffer_object;
         ParticleBillboardPerframeStorageBufferObject   m_particlebillboard_perframe_storage_buffer_object;
         ParticleCollisionPerframeStorageBufferObject   m_particle_collision_perframe_storage_buffer_object;
 
+        // joints of the skinned entities of the frame, filled by RenderScene
+        std::vector<VulkanJointMatrix> m_joint_palette;
+
         // cached mesh and material
         std::map<size_t, VulkanMesh>        m_vulkan_meshes;
         std::map<size_t, VulkanPBRMaterial> m_vulkan_pbr_materials;
+        std::map<size_t, MeshPickData>      m_mesh_pick_datas;
 
         // descriptor set layout in main camera pass will be used when uploading resource
         RHIDescriptorSetLayout* const* m_mesh_descriptor_set_layout {nullptr};
         RHIDescriptorSetLayout* const* m_material_descriptor_set_layout {nullptr};
+        // per mesh layout of the skinning pass, null unless pre-skinning is enabled
+        RHIDescriptorSetLayout* const* m_mesh_skinning_descriptor_set_layout {nullptr};
 
     private:
+        RenderLightClusterGrid m_point_light_cluster_grid;
+
         void createAndMapStorageBuffer(std::shared_ptr<RHI> rhi);
         void createIBLSamplers(std::shared_ptr<RHI> rhi);
         void createIBLTextures(std::shared_ptr<RHI>                        rhi,
@@ -163,6 +207,16 @@ namespace Piccolo
         VulkanPBRMaterial&
         getOrCreateVulkanMaterial(std::shared_ptr<RHI> rhi, RenderEntity entity, RenderMaterialData material_data);
 
+        void uploadVulkanMesh(std::shared_ptr<RHI> rhi, RenderMeshData mesh_data, VulkanMesh& now_mesh);
+        void cacheMeshPickData(size_t mesh_asset_id, const RenderMeshData& mesh_data);
+        void uploadVulkanMaterial(std::shared_ptr<RHI> rhi,
+                                  RenderEntity         entity,
+                                  RenderMaterialData   material_data,
+                                  VulkanPBRMaterial&   now_material);
+        // release the gpu memory of a cached asset, the sort id and the descriptor sets are kept for the reload
+        void destroyVulkanMeshBuffers(std::shared_ptr<RHI> rhi, VulkanMesh& now_mesh);
+        void destroyVulkanMaterialImages(std::shared_ptr<RHI> rhi, VulkanPBRMaterial& now_material);
+
         void updateMeshData(std::shared_ptr<RHI>                          rhi,
                             bool                                          enable_vertex_blending,
                             uint32_t                                      index_buffer_size,
@@ -181,6 +235,11 @@ namespace Piccolo
                                 uint32_t                                      index_buffer_size,
                                 uint16_t*                                     index_buffer_data,
                                 VulkanMesh&                                   now_mesh);
+        void updateMeshSkinningDescriptorSet(std::shared_ptr<RHI> rhi,
+                                             VulkanMesh&          now_mesh,
+                                             RHIDeviceSize        vertex_position_buffer_size,
+                                             RHIDeviceSize        vertex_varying_enable_blending_buffer_size,
+                                             RHIDeviceSize        vertex_joint_binding_buffer_size);
         void updateIndexBuffer(std::shared_ptr<RHI> rhi,
                                uint32_t             index_buffer_size,
                                void*                index_buffer_data,
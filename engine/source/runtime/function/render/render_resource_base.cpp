@@ -7,6 +7,7 @@
 #include "runtime/resource/res_type/data/mesh_data.h"
 
 #include "runtime/function/global/global_context.h"
+#include "runtime/function/render/render_cooked_asset.h"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
@@ -25,17 +26,16 @@ namespace Piccolo
         std::shared_ptr<AssetManager> asset_manager = g_runtime_global_context.m_asset_manager;
         ASSERT(asset_manager);
 
-        std::shared_ptr<TextureData> texture = std::make_shared<TextureData>();
-
-        int iw, ih, n;
-        texture->m_pixels =
-            stbi_loadf(asset_manager->getFullPath(file).generic_string().c_str(), &iw, &ih, &n, desired_channels);
+        std::shared_ptr<TextureData> texture =
+            CookedRenderAsset::loadTexture(asset_manager->findCookedPath(file), desired_channels, sizeof(float));
+        if (!texture)
+        {
+            texture = decodeTexture(asset_manager->getFullPath(file).generic_string(), desired_channels, true);
+        }
 
-        if (!texture->m_pixels)
+        if (!texture)
             return nullptr;
 
-        texture->m_width  = iw;
-        texture->m_height = ih;
         switch (desired_channels)
         {
             case 2:
@@ -62,16 +62,16 @@ namespace Piccolo
         std::shared_ptr<AssetManager> asset_manager = g_runtime_global_context.m_asset_manager;
         ASSERT(asset_manager);
 
-        std::shared_ptr<TextureData> texture = std::make_shared<TextureData>();
-
-        int iw, ih, n;
-        texture->m_pixels = stbi_load(asset_manager->getFullPath(file).generic_string().c_str(), &iw, &ih, &n, 4);
+        std::shared_ptr<TextureData> texture =
+            CookedRenderAsset::loadTexture(asset_manager->findCookedPath(file), 4, sizeof(uint8_t));
+        if (!texture)
+        {
+            texture = decodeTexture(asset_manager->getFullPath(file).generic_string(), 4, false);
+        }
 
-        if (!texture->m_pixels)
+        if (!texture)
             return nullptr;
 
-        texture->m_width        = iw;
-        texture->m_height       = ih;
         texture->m_format       = (is_srgb) ? RHIFormat::RHI_FORMAT_R8G8B8A8_SRGB :
                                               RHIFormat::RHI_FORMAT_R8G8B8A8_UNORM;
         texture->m_depth        = 1;
@@ -91,7 +91,11 @@ namespace Piccolo
 
         if (std::filesystem::path(source.m_mesh_file).extension() == ".obj")
         {
-            ret.m_static_mesh_data = loadStaticMesh(source.m_mesh_file, bounding_box);
+            if (!CookedRenderAsset::loadStaticMesh(
+                    asset_manager->findCookedPath(source.m_mesh_file), ret.m_static_mesh_data, bounding_box))
+            {
+                ret.m_static_mesh_data = loadStaticMesh(source.m_mesh_file, bounding_box);
+            }
         }
         else if (std::filesystem::path(source.m_mesh_file).extension() == ".json")
         {
@@ -147,7 +151,8 @@ namespace Piccolo
             }
         }
 
-        m_bounding_box_cache_map.insert(std::make_pair(source, bounding_box));
+        // overwritten, the mesh may have been reloaded
+        m_bounding_box_cache_map[source] = bounding_box;
 
         return ret;
     }
@@ -173,6 +178,30 @@ namespace Piccolo
         return AxisAlignedBox();
     }
 
+    std::shared_ptr<TextureData>
+    RenderResourceBase::decodeTexture(const std::string& file, int desired_channels, bool is_hdr)
+    {
+        std::shared_ptr<TextureData> texture = std::make_shared<TextureData>();
+
+        int iw, ih, n;
+        if (is_hdr)
+        {
+            texture->m_pixels = stbi_loadf(file.c_str(), &iw, &ih, &n, desired_channels);
+        }
+        else
+        {
+            texture->m_pixels = stbi_load(file.c_str(), &iw, &ih, &n, desired_channels);
+        }
+
+        if (!texture->m_pixels)
+            return nullptr;
+
+        texture->m_width  = iw;
+        texture->m_height = ih;
+
+        return texture;
+    }
+
     StaticMeshData RenderResourceBase::loadStaticMesh(std::string filename, AxisAlignedBox& bounding_box)
     {
         StaticMeshData mesh_data;
@@ -36,6 +36,16 @@ namespace Piccolo
                                                     RenderEntity         render_entity,
                                                     RenderMaterialData   material_data) = 0;
 
+        // rebuild the gpu copy of a cached asset in place after its files changed, the entities keep their asset ids
+        // the caller has to make sure the gpu is done with the old copy
+        virtual void reloadGameObjectRenderResource(std::shared_ptr<RHI> rhi,
+                                                    RenderEntity         render_entity,
+                                                    RenderMeshData       mesh_data) = 0;
+
+        virtual void reloadGameObjectRenderResource(std::shared_ptr<RHI> rhi,
+                                                    RenderEntity         render_entity,
+                                                    RenderMaterialData   material_data) = 0;
+
         virtual void updatePerFrameBuffer(std::shared_ptr<RenderScene>  render_scene,
                                           std::shared_ptr<RenderCamera> camera) = 0;
 
@@ -46,9 +56,12 @@ namespace Piccolo
         RenderMaterialData           loadMaterialData(const MaterialSourceDesc& source);
         AxisAlignedBox               getCachedBoudingBox(const MeshSourceDesc& source) const;
 
-    private:
-        StaticMeshData loadStaticMesh(std::string mesh_file, AxisAlignedBox& bounding_box);
+        // decode the source files without looking for their cooked forms, shared with the asset cooker
+        // decodeTexture only fills the pixels and the size
+        static std::shared_ptr<TextureData> decodeTexture(const std::string& file, int desired_channels, bool is_hdr);
+        static StaticMeshData               loadStaticMesh(std::string mesh_file, AxisAlignedBox& bounding_box);
 
+    private:
         std::unordered_map<MeshSourceDesc, AxisAlignedBox> m_bounding_box_cache_map;
     };
 } // namespace Piccolo
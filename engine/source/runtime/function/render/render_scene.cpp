@@ -1,10 +1,113 @@
 #include "runtime/function/render/render_scene.h"
+#include "runtime/function/render/render_camera.h"
 #include "runtime/function/render/render_helper.h"
 #include "runtime/function/render/render_pass.h"
 #include "runtime/function/render/render_resource.h"
+#include "runtime/function/render/render_skinning.h"
+
+#include "runtime/core/base/hash.h"
+
+#include <algorithm>
+#include <cmath>
 
 namespace Piccolo
 {
+    namespace
+    {
+        // the sphere of a cached cascade is larger than the slice of the camera frustum, so that it is only moved, and
+        // the cascade drawn again, after the camera went some way
+        const float s_cached_cascade_radius_scale = 1.25f;
+
+        // whether the box reaches the bounds on any side, so that the bounds may shrink once the box is gone
+        bool isOnBoundary(const AxisAlignedBox& box, const AxisAlignedBox& bounds)
+        {
+            for (size_t i = 0; i < 3; ++i)
+            {
+                if (box.getMinCorner()[i] <= bounds.getMinCorner()[i] ||
+                    box.getMaxCorner()[i] >= bounds.getMaxCorner()[i])
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // the part of the segment from origin to origin + direction inside the box, as fractions of the segment
+        bool intersectSegmentBox(const Vector3&        origin,
+                                 const Vector3&        direction,
+                                 const AxisAlignedBox& box,
+                                 float&                entry_distance)
+        {
+            float t_min = 0.0f;
+            float t_max = 1.0f;
+            for (size_t i = 0; i < 3; ++i)
+            {
+                float const min_corner = box.getMinCorner()[i];
+                float const max_corner = box.getMaxCorner()[i];
+                if (std::fabs(direction[i]) < 1e-8f)
+                {
+                    if (origin[i] < min_corner || origin[i] > max_corner)
+                    {
+                        return false;
+                    }
+                    continue;
+                }
+
+                float const inv_direction = 1.0f / direction[i];
+                float       t_near        = (min_corner - origin[i]) * inv_direction;
+                float       t_far         = (max_corner - origin[i]) * inv_direction;
+                if (t_near > t_far)
+                {
+                    std::swap(t_near, t_far);
+                }
+                t_min = std::max(t_min, t_near);
+                t_max = std::min(t_max, t_far);
+                if (t_min > t_max)
+                {
+                    return false;
+                }
+            }
+            entry_distance = t_min;
+            return true;
+        }
+
+        // moller trumbore, both sides of the triangle are hit
+        bool intersectSegmentTriangle(const Vector3& origin,
+                                      const Vector3& direction,
+                                      const Vector3& v0,
+                                      const Vector3& v1,
+                                      const Vector3& v2,
+                                      float&         distance)
+        {
+            Vector3 const edge1       = v1 - v0;
+            Vector3 const edge2       = v2 - v0;
+            Vector3 const p           = direction.crossProduct(edge2);
+            float const   determinant = edge1.dotProduct(p);
+            if (std::fabs(determinant) < 1e-12f)
+            {
+                return false;
+            }
+
+            float const   inv_determinant = 1.0f / determinant;
+            Vector3 const s               = origin - v0;
+            float const   u               = s.dotProduct(p) * inv_determinant;
+            if (u < 0.0f || u > 1.0f)
+            {
+                return false;
+            }
+
+            Vector3 const q = s.crossProduct(edge1);
+            float const   v = direction.dotProduct(q) * inv_determinant;
+            if (v < 0.0f || u + v > 1.0f)
+            {
+                return false;
+            }
+
+            distance = edge2.dotProduct(q) * inv_determinant;
+            return true;
+        }
+    } // namespace
+
     void RenderScene::clear()
     {
     }
@@ -12,6 +115,7 @@ namespace Piccolo
     void RenderScene::updateVisibleObjects(std::shared_ptr<RenderResource> render_resource,
                                            std::shared_ptr<RenderCamera>   camera)
     {
+        updateJointPalette(render_resource);
         updateVisibleObjectsDirectionalLight(render_resource, camera);
         updateVisibleObjectsPointLight(render_resource);
         updateVisibleObjectsMainCamera(render_resource, camera);
@@ -21,10 +125,11 @@ namespace Piccolo
 
     void RenderScene::setVisibleNodesReference()
     {
-        RenderPass::m_visiable_nodes.p_directional_light_visible_mesh_nodes = &m_directional_light_visible_mesh_nodes;
-        RenderPass::m_visiable_nodes.p_point_lights_visible_mesh_nodes      = &m_point_lights_visible_mesh_nodes;
-        RenderPass::m_visiable_nodes.p_main_camera_visible_mesh_nodes       = &m_main_camera_visible_mesh_nodes;
-        RenderPass::m_visiable_nodes.p_axis_node                            = &m_axis_node;
+        RenderPass::m_visiable_nodes.p_directional_light_cascades     = &m_directional_light_cascades;
+        RenderPass::m_visiable_nodes.p_point_light_shadows            = &m_point_light_shadows;
+        RenderPass::m_visiable_nodes.p_main_camera_visible_mesh_nodes = &m_main_camera_visible_mesh_nodes;
+        RenderPass::m_visiable_nodes.p_axis_node                      = &m_axis_node;
+        RenderPass::m_visiable_nodes.p_render_entities                = &m_render_entities;
     }
 
     GuidAllocator<GameObjectPartId>& RenderScene::getInstanceIdAllocator() { return m_instance_id_allocator; }
@@ -51,6 +156,99 @@ namespace Piccolo
         return GObjectID();
     }
 
+    bool RenderScene::pickMesh(std::shared_ptr<RenderResource> render_resource,
+                               const Matrix4x4&                proj_view_matrix,
+                               const Vector2&                  picked_uv,
+                               uint32_t&                       picked_mesh_id)
+    {
+        picked_mesh_id = 0;
+        if (picked_uv.x < 0.0f || picked_uv.x > 1.0f || picked_uv.y < 0.0f || picked_uv.y > 1.0f)
+        {
+            return true;
+        }
+
+        // the segment from the near to the far plane, the projection flips y so that the uv maps to ndc directly
+        Matrix4x4 const inverse_proj_view = proj_view_matrix.inverse();
+        float const     ndc_x             = picked_uv.x * 2.0f - 1.0f;
+        float const     ndc_y             = picked_uv.y * 2.0f - 1.0f;
+        Vector3 const   near_point        = inverse_proj_view * Vector3(ndc_x, ndc_y, 0.0f);
+        Vector3 const   far_point         = inverse_proj_view * Vector3(ndc_x, ndc_y, 1.0f);
+        Vector3 const   direction         = far_point - near_point;
+
+        m_pick_candidates.clear();
+        for (const RenderEntity& entity : m_render_entities)
+        {
+            float entry_distance;
+            if (intersectSegmentBox(near_point, direction, entity.m_world_bounding_box, entry_distance))
+            {
+                m_pick_candidates.push_back({&entity, entry_distance});
+            }
+        }
+        std::sort(m_pick_candidates.begin(),
+                  m_pick_candidates.end(),
+                  [](const PickCandidate& lhs, const PickCandidate& rhs) {
+                      return lhs.entry_distance < rhs.entry_distance;
+                  });
+
+        // the distances are fractions of the segment, which an affine transform keeps, so each entity is tested in
+        // its model space and the boxes behind the closest hit are skipped
+        float closest_distance = 1.0f;
+        for (const PickCandidate& candidate : m_pick_candidates)
+        {
+            if (candidate.entry_distance > closest_distance)
+            {
+                break;
+            }
+
+            const RenderEntity& entity    = *candidate.entity;
+            const MeshPickData* pick_data = render_resource->getEntityMeshPickData(entity);
+            if (pick_data == nullptr)
+            {
+                return false;
+            }
+
+            const MeshVertex::VulkanMeshVertexPostition* positions = pick_data->positions.data();
+            if (entity.m_enable_vertex_blending && entity.m_joint_palette_count > 0 &&
+                !pick_data->joint_bindings.empty())
+            {
+                uint32_t const vertex_count = static_cast<uint32_t>(pick_data->positions.size());
+                m_pick_skinned_positions.resize(vertex_count);
+                skinMeshVertices(vertex_count,
+                                 positions,
+                                 nullptr,
+                                 pick_data->joint_bindings.data(),
+                                 render_resource->m_joint_palette.data() + entity.m_joint_palette_offset,
+                                 entity.m_joint_palette_count,
+                                 m_pick_skinned_positions.data(),
+                                 nullptr);
+                positions = m_pick_skinned_positions.data();
+            }
+
+            Matrix4x4 const inverse_model_matrix = entity.m_model_matrix.inverse();
+            Vector3 const   model_origin         = inverse_model_matrix * near_point;
+            Vector4 const   model_direction_4    = inverse_model_matrix * Vector4(direction, 0.0f);
+            Vector3 const   model_direction(model_direction_4.x, model_direction_4.y, model_direction_4.z);
+
+            const std::vector<uint16_t>& indices = pick_data->indices;
+            for (size_t index = 0; index + 2 < indices.size(); index += 3)
+            {
+                float distance;
+                if (intersectSegmentTriangle(model_origin,
+                                             model_direction,
+                                             positions[indices[index]].position,
+                                             positions[indices[index + 1]].position,
+                                             positions[indices[index + 2]].position,
+                                             distance) &&
+                    distance >= 0.0f && distance < closest_distance)
+                {
+                    closest_distance = distance;
+                    picked_mesh_id   = entity.m_instance_id;
+                }
+            }
+        }
+        return true;
+    }
+
     void RenderScene::deleteEntityByGObjectID(GObjectID go_id)
     {
         for (auto it = m_mesh_object_id_map.begin(); it != m_mesh_object_id_map.end(); it++)
@@ -70,6 +268,10 @@ namespace Piccolo
             {
                 if (it->m_instance_id == find_guid)
                 {
+                    if (isOnBoundary(it->m_world_bounding_box, m_scene_bounding_box))
+                    {
+                        m_is_scene_bounding_box_dirty = true;
+                    }
                     m_render_entities.erase(it);
                     break;
                 }
@@ -82,48 +284,277 @@ namespace Piccolo
         m_instance_id_allocator.clear();
         m_mesh_object_id_map.clear();
         m_render_entities.clear();
+
+        m_scene_bounding_box          = AxisAlignedBox();
+        m_is_scene_bounding_box_dirty = false;
+    }
+
+    void RenderScene::addRenderEntity(const RenderEntity& render_entity)
+    {
+        m_render_entities.push_back(render_entity);
+        updateWorldBoundingBox(m_render_entities.back(), true);
+    }
+
+    void RenderScene::updateRenderEntity(const RenderEntity& render_entity)
+    {
+        for (RenderEntity& entity : m_render_entities)
+        {
+            if (entity.m_instance_id == render_entity.m_instance_id)
+            {
+                // most updates come from animations or materials, the entity stays where it is
+                bool is_moved = !(entity.m_model_matrix == render_entity.m_model_matrix) ||
+                                !(entity.m_bounding_box.getMinCorner() == render_entity.m_bounding_box.getMinCorner()) ||
+                                !(entity.m_bounding_box.getMaxCorner() == render_entity.m_bounding_box.getMaxCorner());
+
+                AxisAlignedBox world_bounding_box = entity.m_world_bounding_box;
+                entity                            = render_entity;
+                entity.m_world_bounding_box       = world_bounding_box;
+                if (is_moved)
+                {
+                    updateWorldBoundingBox(entity, false);
+                }
+                break;
+            }
+        }
+    }
+
+    void RenderScene::updateMeshBoundingBox(size_t mesh_asset_id, const AxisAlignedBox& bounding_box)
+    {
+        for (RenderEntity& entity : m_render_entities)
+        {
+            if (entity.m_mesh_asset_id == mesh_asset_id)
+            {
+                entity.m_bounding_box = bounding_box;
+                updateWorldBoundingBox(entity, false);
+            }
+        }
+
+        // the mesh itself changed, which the casters of a cached cascade or point light do not tell
+        for (DirectionalLightCascadeCache& cache : m_directional_light_cascade_caches)
+        {
+            cache.has_tile = false;
+        }
+        for (PointLightShadowCache& cache : m_point_light_shadow_caches)
+        {
+            cache.has_layers = false;
+        }
+    }
+
+    const AxisAlignedBox& RenderScene::getSceneBoundingBox()
+    {
+        if (m_is_scene_bounding_box_dirty)
+        {
+            m_scene_bounding_box = AxisAlignedBox();
+            for (const RenderEntity& entity : m_render_entities)
+            {
+                m_scene_bounding_box.merge(entity.m_world_bounding_box.getMinCorner());
+                m_scene_bounding_box.merge(entity.m_world_bounding_box.getMaxCorner());
+            }
+            m_is_scene_bounding_box_dirty = false;
+        }
+        return m_scene_bounding_box;
+    }
+
+    void RenderScene::updateWorldBoundingBox(RenderEntity& entity, bool is_new_entity)
+    {
+        // the old box may have been holding the scene bounds out, they are merged again when asked for
+        if (!is_new_entity && isOnBoundary(entity.m_world_bounding_box, m_scene_bounding_box))
+        {
+            m_is_scene_bounding_box_dirty = true;
+        }
+
+        BoundingBox world_bounding_box = BoundingBoxTransform(
+            BoundingBox(entity.m_bounding_box.getMinCorner(), entity.m_bounding_box.getMaxCorner()),
+            entity.m_model_matrix);
+
+        entity.m_world_bounding_box = AxisAlignedBox();
+        entity.m_world_bounding_box.merge(world_bounding_box.min_bound);
+        entity.m_world_bounding_box.merge(world_bounding_box.max_bound);
+
+        if (!m_is_scene_bounding_box_dirty)
+        {
+            m_scene_bounding_box.merge(world_bounding_box.min_bound);
+            m_scene_bounding_box.merge(world_bounding_box.max_bound);
+        }
+    }
+
+    void RenderScene::updateJointPalette(std::shared_ptr<RenderResource> render_resource)
+    {
+        std::vector<VulkanJointMatrix>& joint_palette = render_resource->m_joint_palette;
+        joint_palette.clear();
+
+        uint32_t skinned_vertex_count = 0;
+        for (RenderEntity& entity : m_render_entities)
+        {
+            assert(entity.m_joint_matrices.size() <= s_mesh_vertex_blending_max_joint_count);
+            uint32_t const joint_count = static_cast<uint32_t>(entity.m_joint_matrices.size());
+
+            entity.m_joint_palette_offset = static_cast<uint32_t>(joint_palette.size());
+            entity.m_joint_palette_count  = 0;
+            entity.m_is_pre_skinned       = false;
+            if (!entity.m_enable_vertex_blending || joint_count == 0 ||
+                joint_palette.size() + joint_count > s_mesh_joint_palette_max_joint_count)
+            {
+                continue;
+            }
+            entity.m_joint_palette_count = joint_count;
+
+            // the buffers are row major on the shader side, the fourth row of a joint matrix is always 0, 0, 0, 1
+            for (const Matrix4x4& joint_matrix : entity.m_joint_matrices)
+            {
+                joint_palette.emplace_back();
+                VulkanJointMatrix& palette_joint = joint_palette.back();
+                for (size_t row = 0; row < 3; ++row)
+                {
+                    palette_joint.rows[row] = Vector4(
+                        joint_matrix[row][0], joint_matrix[row][1], joint_matrix[row][2], joint_matrix[row][3]);
+                }
+            }
+
+            // the entities which no longer fit into the skinned vertex buffer are blended in the vertex shaders
+            const VulkanMesh& mesh = render_resource->getEntityMesh(entity);
+            if (m_enable_pre_skinning && mesh.enable_vertex_blending &&
+                skinned_vertex_count + mesh.mesh_vertex_count <= s_mesh_skinning_max_vertex_count)
+            {
+                entity.m_is_pre_skinned        = true;
+                entity.m_skinned_vertex_offset = skinned_vertex_count;
+                skinned_vertex_count += mesh.mesh_vertex_count;
+            }
+        }
     }
 
     void RenderScene::updateVisibleObjectsDirectionalLight(std::shared_ptr<RenderResource> render_resource,
                                                            std::shared_ptr<RenderCamera>   camera)
     {
-        Matrix4x4 directional_light_proj_view = CalculateDirectionalLightCamera(*this, *camera);
+        uint32_t const cascade_count =
+            std::clamp(m_directional_light_cascade_count, 1U, s_max_directional_light_cascade_count);
+        uint32_t const first_cached_cascade =
+            cascade_count - std::min(m_directional_light_cached_cascade_count, cascade_count);
 
-        render_resource->m_mesh_perframe_storage_buffer_object.directional_light_proj_view =
-            directional_light_proj_view;
-        render_resource->m_mesh_directional_light_shadow_perframe_storage_buffer_object.light_proj_view =
-            directional_light_proj_view;
+        m_directional_light_cascades.resize(cascade_count);
+        render_resource->m_mesh_perframe_storage_buffer_object.directional_light_cascade_count = cascade_count;
 
-        m_directional_light_visible_mesh_nodes.clear();
+        float split_near = camera->m_znear;
+        for (uint32_t cascade_index = 0; cascade_index < cascade_count; ++cascade_index)
+        {
+            float split_far = camera->m_zfar;
+            if (cascade_index + 1 < cascade_count)
+            {
+                if (cascade_index < m_directional_light_cascade_splits.size())
+                {
+                    split_far = m_directional_light_cascade_splits[cascade_index];
+                }
+                else
+                {
+                    // practical split scheme, blended from uniform to logarithmic
+                    float ratio         = static_cast<float>(cascade_index + 1) / static_cast<float>(cascade_count);
+                    float log_split     = camera->m_znear * std::pow(camera->m_zfar / camera->m_znear, ratio);
+                    float uniform_split = camera->m_znear + (camera->m_zfar - camera->m_znear) * ratio;
+                    split_far           = m_directional_light_split_lambda * log_split +
+                                (1.0f - m_directional_light_split_lambda) * uniform_split;
+                }
+                split_far = std::clamp(split_far, split_near, camera->m_zfar);
+            }
 
-        ClusterFrustum frustum =
-            CreateClusterFrustumFromMatrix(directional_light_proj_view, -1.0, 1.0, -1.0, 1.0, 0.0, 1.0);
+            RenderDirectionalLightCascade& cascade      = m_directional_light_cascades[cascade_index];
+            DirectionalLightCascadeCache&  cache        = m_directional_light_cascade_caches[cascade_index];
+            bool const                     is_cacheable = cascade_index >= first_cached_cascade;
+            if (is_cacheable)
+            {
+                Vector3 corners[8];
+                CalculateFrustumSliceCorners(*camera, split_near, split_far, corners);
 
-        for (const RenderEntity& entity : m_render_entities)
-        {
-            BoundingBox mesh_asset_bounding_box {entity.m_bounding_box.getMinCorner(),
-                                                 entity.m_bounding_box.getMaxCorner()};
+                Vector3 center = Vector3::ZERO;
+                for (const Vector3& corner : corners)
+                {
+                    center += corner;
+                }
+                center /= 8.0f;
 
-            if (TiledFrustumIntersectBox(frustum, BoundingBoxTransform(mesh_asset_bounding_box, entity.m_model_matrix)))
+                float radius = 0.0f;
+                for (const Vector3& corner : corners)
+                {
+                    radius = std::max(radius, center.distance(corner));
+                }
+
+                if (cache.radius == 0.0f || cache.center.distance(center) + radius > cache.radius)
+                {
+                    cache.center = center;
+                    cache.radius = radius * s_cached_cascade_radius_scale;
+                }
+                cascade.light_proj_view = CalculateDirectionalLightSphereCamera(*this, {cache.center, cache.radius});
+            }
+            else
             {
-                m_directional_light_visible_mesh_nodes.emplace_back();
-                RenderMeshNode& temp_node = m_directional_light_visible_mesh_nodes.back();
+                cache.radius            = 0.0f;
+                cache.has_tile          = false;
+                cascade.light_proj_view = CalculateDirectionalLightCamera(*this, *camera, split_near, split_far);
+            }
+            render_resource->m_mesh_perframe_storage_buffer_object.directional_light_proj_views[cascade_index] =
+                cascade.light_proj_view;
 
-                temp_node.model_matrix = &entity.m_model_matrix;
+            split_near = split_far;
+
+            // casters of the cascade, the signature tells whether they are still the ones in a cached tile, skinned
+            // casters are taken as changing every frame
+            ClusterFrustum frustum =
+                CreateClusterFrustumFromMatrix(cascade.light_proj_view, -1.0, 1.0, -1.0, 1.0, 0.0, 1.0);
+
+            m_directional_light_casters.clear();
+            size_t caster_signature   = 0;
+            bool   has_skinned_caster = false;
+            for (const RenderEntity& entity : m_render_entities)
+            {
+                BoundingBox world_bounding_box {entity.m_world_bounding_box.getMinCorner(),
+                                                entity.m_world_bounding_box.getMaxCorner()};
 
-                assert(entity.m_joint_matrices.size() <= s_mesh_vertex_blending_max_joint_count);
-                if (!entity.m_joint_matrices.empty())
+                if (TiledFrustumIntersectBox(frustum, world_bounding_box))
                 {
-                    temp_node.joint_count    = static_cast<uint32_t>(entity.m_joint_matrices.size());
-                    temp_node.joint_matrices = entity.m_joint_matrices.data();
+                    m_directional_light_casters.push_back(&entity);
+
+                    if (is_cacheable)
+                    {
+                        hash_combine(caster_signature, entity.m_instance_id);
+                        hash_combine(caster_signature, entity.m_mesh_asset_id);
+                        for (size_t row = 0; row < 4; ++row)
+                        {
+                            for (size_t column = 0; column < 4; ++column)
+                            {
+                                hash_combine(caster_signature, entity.m_model_matrix[row][column]);
+                            }
+                        }
+                        has_skinned_caster |= !entity.m_joint_matrices.empty();
+                    }
                 }
-                temp_node.node_id = entity.m_instance_id;
+            }
 
-                VulkanMesh& mesh_asset           = render_resource->getEntityMesh(entity);
+            cascade.is_cached = is_cacheable && cache.has_tile && !has_skinned_caster &&
+                                cache.light_proj_view == cascade.light_proj_view &&
+                                cache.caster_signature == caster_signature;
+            cache.has_tile         = is_cacheable;
+            cache.light_proj_view  = cascade.light_proj_view;
+            cache.caster_signature = caster_signature;
+
+            // the nodes are kept for a cached cascade as well, the pass still draws it when its tile is gone
+            cascade.visible_mesh_nodes.clear();
+            for (const RenderEntity* entity : m_directional_light_casters)
+            {
+                cascade.visible_mesh_nodes.emplace_back();
+                RenderMeshNode& temp_node = cascade.visible_mesh_nodes.back();
+
+                temp_node.model_matrix = &entity->m_model_matrix;
+
+                temp_node.joint_palette_offset  = entity->m_joint_palette_offset;
+                temp_node.joint_count           = entity->m_is_pre_skinned ? 0 : entity->m_joint_palette_count;
+                temp_node.is_pre_skinned        = entity->m_is_pre_skinned;
+                temp_node.skinned_vertex_offset = entity->m_skinned_vertex_offset;
+                temp_node.node_id = entity->m_instance_id;
+
+                VulkanMesh& mesh_asset           = render_resource->getEntityMesh(*entity);
                 temp_node.ref_mesh               = &mesh_asset;
-                temp_node.enable_vertex_blending = entity.m_enable_vertex_blending;
+                temp_node.enable_vertex_blending = entity->m_enable_vertex_blending;
 
-                VulkanPBRMaterial& material_asset = render_resource->getEntityMaterial(entity);
+                VulkanPBRMaterial& material_asset = render_resource->getEntityMaterial(*entity);
                 temp_node.ref_material            = &material_asset;
             }
         }
@@ -131,46 +562,58 @@ namespace Piccolo
 
     void RenderScene::updateVisibleObjectsPointLight(std::shared_ptr<RenderResource> render_resource)
     {
-        m_point_lights_visible_mesh_nodes.clear();
+        // only the lights with a shadow map need casters, the node lists keep their capacity between frames
+        uint32_t point_light_num =
+            std::min(static_cast<uint32_t>(m_point_light_list.m_lights.size()), s_max_point_light_count);
+        m_point_light_shadows.resize(point_light_num);
+        for (uint32_t i = point_light_num; i < s_max_point_light_count; i++)
+        {
+            m_point_light_shadow_caches[i].has_layers = false;
+        }
 
-        std::vector<BoundingSphere> point_lights_bounding_spheres;
-        uint32_t                    point_light_num = static_cast<uint32_t>(m_point_light_list.m_lights.size());
-        point_lights_bounding_spheres.resize(point_light_num);
-        for (size_t i = 0; i < point_light_num; i++)
+        BoundingSphere point_lights_bounding_spheres[s_max_point_light_count];
+        size_t         caster_signatures[s_max_point_light_count]  = {};
+        bool           has_skinned_casters[s_max_point_light_count] = {};
+        for (uint32_t i = 0; i < point_light_num; i++)
         {
+            m_point_light_shadows[i].visible_mesh_nodes.clear();
             point_lights_bounding_spheres[i].m_center = m_point_light_list.m_lights[i].m_position;
             point_lights_bounding_spheres[i].m_radius = m_point_light_list.m_lights[i].calculateRadius();
         }
 
         for (const RenderEntity& entity : m_render_entities)
         {
-            BoundingBox mesh_asset_bounding_box {entity.m_bounding_box.getMinCorner(),
-                                                 entity.m_bounding_box.getMaxCorner()};
+            BoundingBox world_bounding_box {entity.m_world_bounding_box.getMinCorner(),
+                                            entity.m_world_bounding_box.getMaxCorner()};
 
-            bool intersect_with_point_lights = true;
-            for (size_t i = 0; i < point_light_num; i++)
+            // an entity is drawn into the shadow map of every light it can reach
+            for (uint32_t i = 0; i < point_light_num; i++)
             {
-                if (!BoxIntersectsWithSphere(BoundingBoxTransform(mesh_asset_bounding_box, entity.m_model_matrix),
-                                             point_lights_bounding_spheres[i]))
+                if (!BoxIntersectsWithSphere(world_bounding_box, point_lights_bounding_spheres[i]))
                 {
-                    intersect_with_point_lights = false;
-                    break;
+                    continue;
                 }
-            }
 
-            if (intersect_with_point_lights)
-            {
-                m_point_lights_visible_mesh_nodes.emplace_back();
-                RenderMeshNode& temp_node = m_point_lights_visible_mesh_nodes.back();
+                hash_combine(caster_signatures[i], entity.m_instance_id);
+                hash_combine(caster_signatures[i], entity.m_mesh_asset_id);
+                for (size_t row = 0; row < 4; ++row)
+                {
+                    for (size_t column = 0; column < 4; ++column)
+                    {
+                        hash_combine(caster_signatures[i], entity.m_model_matrix[row][column]);
+                    }
+                }
+                has_skinned_casters[i] |= !entity.m_joint_matrices.empty();
+
+                m_point_light_shadows[i].visible_mesh_nodes.emplace_back();
+                RenderMeshNode& temp_node = m_point_light_shadows[i].visible_mesh_nodes.back();
 
                 temp_node.model_matrix = &entity.m_model_matrix;
 
-                assert(entity.m_joint_matrices.size() <= s_mesh_vertex_blending_max_joint_count);
-                if (!entity.m_joint_matrices.empty())
-                {
-                    temp_node.joint_count    = static_cast<uint32_t>(entity.m_joint_matrices.size());
-                    temp_node.joint_matrices = entity.m_joint_matrices.data();
-                }
+                temp_node.joint_palette_offset  = entity.m_joint_palette_offset;
+                temp_node.joint_count           = entity.m_is_pre_skinned ? 0 : entity.m_joint_palette_count;
+                temp_node.is_pre_skinned        = entity.m_is_pre_skinned;
+                temp_node.skinned_vertex_offset = entity.m_skinned_vertex_offset;
                 temp_node.node_id = entity.m_instance_id;
 
                 VulkanMesh& mesh_asset           = render_resource->getEntityMesh(entity);
@@ -181,6 +624,54 @@ namespace Piccolo
                 temp_node.ref_material            = &material_asset;
             }
         }
+
+        // only a light without layers is drawn right away, a light which moved or whose casters changed, skinned
+        // casters change every frame, waits for its turn in the budget and keeps the old layers until then
+        uint32_t budgeted_lights[s_max_point_light_count];
+        uint32_t budgeted_light_count = 0;
+        for (uint32_t i = 0; i < point_light_num; i++)
+        {
+            PointLightShadowCache& cache = m_point_light_shadow_caches[i];
+            if (!cache.has_layers)
+            {
+                m_point_light_shadows[i].is_cached = false;
+                continue;
+            }
+
+            m_point_light_shadows[i].is_cached = true;
+            if (cache.position != point_lights_bounding_spheres[i].m_center ||
+                cache.radius != point_lights_bounding_spheres[i].m_radius || has_skinned_casters[i] ||
+                cache.caster_signature != caster_signatures[i])
+            {
+                budgeted_lights[budgeted_light_count++] = i;
+            }
+        }
+
+        // the oldest layers first, so that every waiting light gets its turn
+        std::stable_sort(budgeted_lights, budgeted_lights + budgeted_light_count, [this](uint32_t lhs, uint32_t rhs) {
+            return m_point_light_shadow_caches[lhs].layers_age > m_point_light_shadow_caches[rhs].layers_age;
+        });
+        uint32_t const update_count = std::min(budgeted_light_count, s_point_light_shadow_update_budget);
+        for (uint32_t i = 0; i < update_count; i++)
+        {
+            m_point_light_shadows[budgeted_lights[i]].is_cached = false;
+        }
+
+        for (uint32_t i = 0; i < point_light_num; i++)
+        {
+            PointLightShadowCache& cache = m_point_light_shadow_caches[i];
+            if (m_point_light_shadows[i].is_cached)
+            {
+                ++cache.layers_age;
+                continue;
+            }
+
+            cache.position         = point_lights_bounding_spheres[i].m_center;
+            cache.radius           = point_lights_bounding_spheres[i].m_radius;
+            cache.caster_signature = caster_signatures[i];
+            cache.layers_age       = 0;
+            cache.has_layers       = true;
+        }
     }
 
     void RenderScene::updateVisibleObjectsMainCamera(std::shared_ptr<RenderResource> render_resource,
@@ -196,21 +687,19 @@ namespace Piccolo
 
         for (const RenderEntity& entity : m_render_entities)
         {
-            BoundingBox mesh_asset_bounding_box {entity.m_bounding_box.getMinCorner(),
-                                                 entity.m_bounding_box.getMaxCorner()};
+            BoundingBox world_bounding_box {entity.m_world_bounding_box.getMinCorner(),
+                                            entity.m_world_bounding_box.getMaxCorner()};
 
-            if (TiledFrustumIntersectBox(f, BoundingBoxTransform(mesh_asset_bounding_box, entity.m_model_matrix)))
+            if (TiledFrustumIntersectBox(f, world_bounding_box))
             {
                 m_main_camera_visible_mesh_nodes.emplace_back();
                 RenderMeshNode& temp_node = m_main_camera_visible_mesh_nodes.back();
                 temp_node.model_matrix    = &entity.m_model_matrix;
 
-                assert(entity.m_joint_matrices.size() <= s_mesh_vertex_blending_max_joint_count);
-                if (!entity.m_joint_matrices.empty())
-                {
-                    temp_node.joint_count    = static_cast<uint32_t>(entity.m_joint_matrices.size());
-                    temp_node.joint_matrices = entity.m_joint_matrices.data();
-                }
+                temp_node.joint_palette_offset  = entity.m_joint_palette_offset;
+                temp_node.joint_count           = entity.m_is_pre_skinned ? 0 : entity.m_joint_palette_count;
+                temp_node.is_pre_skinned        = entity.m_is_pre_skinned;
+                temp_node.skinned_vertex_offset = entity.m_skinned_vertex_offset;
                 temp_node.node_id = entity.m_instance_id;
 
                 VulkanMesh& mesh_asset           = render_resource->getEntityMesh(entity);
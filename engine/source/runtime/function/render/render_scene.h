@@ -6,8 +6,11 @@
 #include "runtime/function/render/render_common.h"
 #include "runtime/function/render/render_entity.h"
 #include "runtime/function/render/render_guid_allocator.h"
+#include "runtime/function/render/render_mesh.h"
 #include "runtime/function/render/render_object.h"
 
+#include "runtime/core/math/vector2.h"
+
 #include <optional>
 #include <vector>
 
@@ -30,11 +33,21 @@ namespace Piccolo
         // axis, for editor
         std::optional<RenderEntity> m_render_axis;
 
+        // directional light shadow cascades, set up from DirectionalLightShadowConfig
+        uint32_t           m_directional_light_cascade_count {1};
+        std::vector<float> m_directional_light_cascade_splits;
+        float              m_directional_light_split_lambda {0.9f};
+        uint32_t           m_directional_light_cached_cascade_count {0};
+
+        // skinned entities are blended once per frame by the skinning pass and then drawn as static geometry
+        bool m_enable_pre_skinning {false};
+
         // visible objects (updated per frame)
-        std::vector<RenderMeshNode> m_directional_light_visible_mesh_nodes;
-        std::vector<RenderMeshNode> m_point_lights_visible_mesh_nodes;
-        std::vector<RenderMeshNode> m_main_camera_visible_mesh_nodes;
-        RenderAxisNode              m_axis_node;
+        std::vector<RenderDirectionalLightCascade> m_directional_light_cascades;
+        // one for each point light with a shadow map, indexed like the lights
+        std::vector<RenderPointLightShadow>        m_point_light_shadows;
+        std::vector<RenderMeshNode>                m_main_camera_visible_mesh_nodes;
+        RenderAxisNode                             m_axis_node;
 
         // clear
         void clear();
@@ -54,15 +67,72 @@ namespace Piccolo
         GObjectID getGObjectIDByMeshID(uint32_t mesh_id) const;
         void      deleteEntityByGObjectID(GObjectID go_id);
 
+        // casts the ray through picked_uv of the viewport against the world bounding boxes of the entities and then
+        // against the triangles of the closest ones, skinned with the joint palette of the frame, picked_mesh_id is 0
+        // when nothing is hit, false when a hit entity has no mesh data on the host to test
+        bool pickMesh(std::shared_ptr<RenderResource> render_resource,
+                      const Matrix4x4&                proj_view_matrix,
+                      const Vector2&                  picked_uv,
+                      uint32_t&                       picked_mesh_id);
+
         void clearForLevelReloading();
 
+        // the entities are added and updated through these, so that the world space bounding box of an entity is only
+        // computed again when its model matrix or its mesh bounding box changed
+        void addRenderEntity(const RenderEntity& render_entity);
+        void updateRenderEntity(const RenderEntity& render_entity);
+        void updateMeshBoundingBox(size_t mesh_asset_id, const AxisAlignedBox& bounding_box);
+
+        // bounds of all the entities in world space, grown as the entities are added and only merged from the cached
+        // entity boxes again after a box on its boundary moved or went away
+        const AxisAlignedBox& getSceneBoundingBox();
+
     private:
+        void updateWorldBoundingBox(RenderEntity& entity, bool is_new_entity);
         GuidAllocator<GameObjectPartId>   m_instance_id_allocator;
         GuidAllocator<MeshSourceDesc>     m_mesh_asset_id_allocator;
         GuidAllocator<MaterialSourceDesc> m_material_asset_id_allocator;
 
         std::unordered_map<uint32_t, GObjectID> m_mesh_object_id_map;
 
+        // scratch of pickMesh
+        struct PickCandidate
+        {
+            const RenderEntity* entity {nullptr};
+            float               entry_distance {0.0f};
+        };
+        std::vector<PickCandidate>                         m_pick_candidates;
+        std::vector<MeshVertex::VulkanMeshVertexPostition> m_pick_skinned_positions;
+
+        AxisAlignedBox m_scene_bounding_box;
+        bool           m_is_scene_bounding_box_dirty {false};
+
+        // what the tile of a cached cascade was last drawn with
+        struct DirectionalLightCascadeCache
+        {
+            Vector3   center;
+            float     radius {0.0f};
+            Matrix4x4 light_proj_view;
+            size_t    caster_signature {0};
+            bool      has_tile {false};
+        };
+        DirectionalLightCascadeCache     m_directional_light_cascade_caches[s_max_directional_light_cascade_count];
+        std::vector<const RenderEntity*> m_directional_light_casters;
+
+        // what the layers of a point light were last drawn with
+        struct PointLightShadowCache
+        {
+            Vector3  position;
+            float    radius {0.0f};
+            size_t   caster_signature {0};
+            uint32_t layers_age {0}; // frames since the layers were drawn
+            bool     has_layers {false};
+        };
+        PointLightShadowCache m_point_light_shadow_caches[s_max_point_light_count];
+
+        // packs the joints of every skinned entity into the palette shared by all the passes of the frame, and
+        // places the vertices of the pre-skinned ones
+        void updateJointPalette(std::shared_ptr<RenderResource> render_resource);
         void updateVisibleObjectsDirectionalLight(std::shared_ptr<RenderResource> render_resource,
                                                   std::shared_ptr<RenderCamera>   camera);
         void updateVisibleObjectsPointLight(std::shared_ptr<RenderResource> render_resource);
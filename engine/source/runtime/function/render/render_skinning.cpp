@@ -0,0 +1,156 @@
+#include "runtime/function/render/render_skinning.h"
+
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define PICCOLO_SKINNING_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace Piccolo
+{
+    namespace
+    {
+#ifdef PICCOLO_SKINNING_SSE
+        // the blended matrix is kept by columns, so that a vertex is transformed with multiply adds only
+        struct BlendedJointMatrix
+        {
+            __m128 columns[4];
+        };
+
+        BlendedJointMatrix blendJoints(const MeshVertex::VulkanMeshVertexJointBinding& joint_binding,
+                                       const VulkanJointMatrix*                        joints,
+                                       uint32_t                                        joint_count)
+        {
+            __m128 rows[4] = {_mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps()};
+
+            const float* weights = &joint_binding.weights.x;
+            for (uint32_t influence = 0; influence < 4; ++influence)
+            {
+                int joint_index = joint_binding.indices[influence];
+                if (!(weights[influence] > 0.0f) || joint_index <= 0 ||
+                    static_cast<uint32_t>(joint_index) >= joint_count)
+                {
+                    continue;
+                }
+
+                const VulkanJointMatrix& joint  = joints[joint_index];
+                __m128                   weight = _mm_set1_ps(weights[influence]);
+                for (uint32_t row = 0; row < 3; ++row)
+                {
+                    rows[row] = _mm_add_ps(rows[row], _mm_mul_ps(_mm_loadu_ps(&joint.rows[row].x), weight));
+                }
+            }
+
+            _MM_TRANSPOSE4_PS(rows[0], rows[1], rows[2], rows[3]);
+
+            BlendedJointMatrix matrix;
+            for (uint32_t column = 0; column < 4; ++column)
+            {
+                matrix.columns[column] = rows[column];
+            }
+            return matrix;
+        }
+
+        Vector3 transformDirection(const BlendedJointMatrix& matrix, const Vector3& direction)
+        {
+            __m128 result = _mm_add_ps(_mm_add_ps(_mm_mul_ps(matrix.columns[0], _mm_set1_ps(direction.x)),
+                                                  _mm_mul_ps(matrix.columns[1], _mm_set1_ps(direction.y))),
+                                       _mm_mul_ps(matrix.columns[2], _mm_set1_ps(direction.z)));
+
+            alignas(16) float components[4];
+            _mm_store_ps(components, result);
+            return Vector3(components[0], components[1], components[2]);
+        }
+
+        Vector3 transformPosition(const BlendedJointMatrix& matrix, const Vector3& position)
+        {
+            __m128 result = _mm_add_ps(_mm_add_ps(_mm_mul_ps(matrix.columns[0], _mm_set1_ps(position.x)),
+                                                  _mm_mul_ps(matrix.columns[1], _mm_set1_ps(position.y))),
+                                       _mm_add_ps(_mm_mul_ps(matrix.columns[2], _mm_set1_ps(position.z)),
+                                                  matrix.columns[3]));
+
+            alignas(16) float components[4];
+            _mm_store_ps(components, result);
+            return Vector3(components[0], components[1], components[2]);
+        }
+#else
+        struct BlendedJointMatrix
+        {
+            float rows[3][4];
+        };
+
+        BlendedJointMatrix blendJoints(const MeshVertex::VulkanMeshVertexJointBinding& joint_binding,
+                                       const VulkanJointMatrix*                        joints,
+                                       uint32_t                                        joint_count)
+        {
+            BlendedJointMatrix matrix = {};
+
+            const float* weights = &joint_binding.weights.x;
+            for (uint32_t influence = 0; influence < 4; ++influence)
+            {
+                int joint_index = joint_binding.indices[influence];
+                if (!(weights[influence] > 0.0f) || joint_index <= 0 ||
+                    static_cast<uint32_t>(joint_index) >= joint_count)
+                {
+                    continue;
+                }
+
+                const VulkanJointMatrix& joint = joints[joint_index];
+                for (uint32_t row = 0; row < 3; ++row)
+                {
+                    const float* joint_row = &joint.rows[row].x;
+                    for (uint32_t column = 0; column < 4; ++column)
+                    {
+                        matrix.rows[row][column] += joint_row[column] * weights[influence];
+                    }
+                }
+            }
+            return matrix;
+        }
+
+        Vector3 transformDirection(const BlendedJointMatrix& matrix, const Vector3& direction)
+        {
+            float components[3];
+            for (uint32_t row = 0; row < 3; ++row)
+            {
+                components[row] = matrix.rows[row][0] * direction.x + matrix.rows[row][1] * direction.y +
+                                  matrix.rows[row][2] * direction.z;
+            }
+            return Vector3(components[0], components[1], components[2]);
+        }
+
+        Vector3 transformPosition(const BlendedJointMatrix& matrix, const Vector3& position)
+        {
+            Vector3 result = transformDirection(matrix, position);
+            return Vector3(result.x + matrix.rows[0][3], result.y + matrix.rows[1][3], result.z + matrix.rows[2][3]);
+        }
+#endif
+    } // namespace
+
+    void skinMeshVertices(uint32_t                                                 vertex_count,
+                          const MeshVertex::VulkanMeshVertexPostition*             positions,
+                          const MeshVertex::VulkanMeshVertexVaryingEnableBlending* varyings,
+                          const MeshVertex::VulkanMeshVertexJointBinding*          joint_bindings,
+                          const VulkanJointMatrix*                                 joints,
+                          uint32_t                                                 joint_count,
+                          MeshVertex::VulkanMeshVertexPostition*                   skinned_positions,
+                          MeshVertex::VulkanMeshVertexVaryingEnableBlending*       skinned_varyings)
+    {
+        for (uint32_t vertex_index = 0; vertex_index < vertex_count; ++vertex_index)
+        {
+            BlendedJointMatrix matrix = blendJoints(joint_bindings[vertex_index], joints, joint_count);
+
+            skinned_positions[vertex_index].position = transformPosition(matrix, positions[vertex_index].position);
+
+            if (skinned_varyings)
+            {
+                Vector3 normal  = transformDirection(matrix, varyings[vertex_index].normal);
+                Vector3 tangent = transformDirection(matrix, varyings[vertex_index].tangent);
+                normal.normalise();
+                tangent.normalise();
+
+                skinned_varyings[vertex_index].normal  = normal;
+                skinned_varyings[vertex_index].tangent = tangent;
+            }
+        }
+    }
+} // namespace Piccolo
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "runtime/function/render/render_common.h"
+#include "runtime/function/render/render_mesh.h"
+
+#include <cstdint>
+
+namespace Piccolo
+{
+    // the cpu side of mesh_skinning.comp, for the code which needs the skinned vertices on the host, joints points
+    // to the first joint of the entity in the palette, joint index 0 and the zero weights are skipped like on the gpu,
+    // skinned_varyings may be null when only the positions are needed
+    void skinMeshVertices(uint32_t                                                 vertex_count,
+                          const MeshVertex::VulkanMeshVertexPostition*             positions,
+                          const MeshVertex::VulkanMeshVertexVaryingEnableBlending* varyings,
+                          const MeshVertex::VulkanMeshVertexJointBinding*          joint_bindings,
+                          const VulkanJointMatrix*                                 joints,
+                          uint32_t                                                 joint_count,
+                          MeshVertex::VulkanMeshVertexPostition*                   skinned_positions,
+                          MeshVertex::VulkanMeshVertexVaryingEnableBlending*       skinned_varyings);
+} // namespace Piccolo
@@ -16,10 +16,16 @@
 #include "runtime/function/render/debugdraw/debug_draw_manager.h"
 
 #include "runtime/function/render/passes/main_camera_pass.h"
+#include "runtime/function/render/passes/mesh_skinning_pass.h"
 #include "runtime/function/render/passes/particle_pass.h"
 
 #include "runtime/function/render/interface/vulkan/vulkan_rhi.h"
 
+#include <algorithm>
+#include <chrono>
+#include <set>
+#include <unordered_map>
+
 namespace Piccolo
 {
     RenderSystem::~RenderSystem()
@@ -36,7 +42,8 @@ namespace Piccolo
 
         // render context initialize
         RHIInitInfo rhi_init_info;
-        rhi_init_info.window_system = init_info.window_system;
+        rhi_init_info.window_system       = init_info.window_system;
+        rhi_init_info.pipeline_cache_path = config_manager->getPipelineCachePath();
 
         m_rhi = std::make_shared<VulkanRHI>();
         m_rhi->initialize(rhi_init_info);
@@ -72,17 +79,44 @@ namespace Piccolo
         m_render_scene->m_directional_light.m_direction =
             global_rendering_res.m_directional_light.m_direction.normalisedCopy();
         m_render_scene->m_directional_light.m_color = global_rendering_res.m_directional_light.m_color.toVector3();
+
+        const DirectionalLightShadowConfig& shadow_config = global_rendering_res.m_directional_light_shadow;
+        if (shadow_config.m_cascade_count < 1 ||
+            shadow_config.m_cascade_count > static_cast<int>(s_max_directional_light_cascade_count))
+        {
+            LOG_WARN("directional light cascade count {} clamped to [1, {}]",
+                     shadow_config.m_cascade_count,
+                     s_max_directional_light_cascade_count);
+        }
+        m_render_scene->m_directional_light_cascade_count =
+            static_cast<uint32_t>(std::clamp(shadow_config.m_cascade_count,
+                                             1,
+                                             static_cast<int>(s_max_directional_light_cascade_count)));
+        m_render_scene->m_directional_light_cascade_splits = shadow_config.m_cascade_splits;
+        m_render_scene->m_directional_light_split_lambda   = shadow_config.m_split_lambda;
+        m_render_scene->m_directional_light_cached_cascade_count =
+            static_cast<uint32_t>(std::max(shadow_config.m_cached_cascade_count, 0));
+        m_render_scene->m_enable_pre_skinning = global_rendering_res.m_enable_pre_skinning;
         m_render_scene->setVisibleNodesReference();
 
         // initialize render pipeline
         RenderPipelineInitInfo pipeline_init_info;
-        pipeline_init_info.enable_fxaa     = global_rendering_res.m_enable_fxaa;
-        pipeline_init_info.render_resource = m_render_resource;
+        pipeline_init_info.enable_fxaa                 = global_rendering_res.m_enable_fxaa;
+        pipeline_init_info.enable_gpu_driven_rendering = global_rendering_res.m_enable_gpu_driven_rendering;
+        pipeline_init_info.enable_pre_skinning         = global_rendering_res.m_enable_pre_skinning;
+        pipeline_init_info.render_resource             = m_render_resource;
+
+        auto pipeline_start_time = std::chrono::steady_clock::now();
 
         m_render_pipeline        = std::make_shared<RenderPipeline>();
         m_render_pipeline->m_rhi = m_rhi;
         m_render_pipeline->initialize(pipeline_init_info);
 
+        // mostly pipeline compilation, which the persistent pipeline cache shortens on later runs
+        auto pipeline_init_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - pipeline_start_time);
+        LOG_INFO("render pipeline initialized in {} ms", pipeline_init_time.count());
+
         // descriptor set layout in main camera pass will be used when uploading resource
         std::static_pointer_cast<RenderResource>(m_render_resource)->m_mesh_descriptor_set_layout =
             &static_cast<RenderPass*>(m_render_pipeline->m_main_camera_pass.get())
@@ -92,6 +126,13 @@ namespace Piccolo
             &static_cast<RenderPass*>(m_render_pipeline->m_main_camera_pass.get())
                  ->m_descriptor_infos[MainCameraPass::LayoutType::_mesh_per_material]
                  .layout;
+        if (m_render_pipeline->m_mesh_skinning_pass)
+        {
+            std::static_pointer_cast<RenderResource>(m_render_resource)->m_mesh_skinning_descriptor_set_layout =
+                &static_cast<RenderPass*>(m_render_pipeline->m_mesh_skinning_pass.get())
+                     ->m_descriptor_infos[MeshSkinningPass::LayoutType::_per_mesh]
+                     .layout;
+        }
     }
 
     void RenderSystem::tick(float delta_time)
@@ -187,6 +228,17 @@ namespace Piccolo
 
     uint32_t RenderSystem::getGuidOfPickedMesh(const Vector2& picked_uv)
     {
+        // picked on the cpu with the camera of the last frame, which the pick pass drew with as well, the pick pass
+        // is only rendered for a scene which has entities without mesh data on the host
+        std::shared_ptr<RenderResource> render_resource = std::static_pointer_cast<RenderResource>(m_render_resource);
+        const Matrix4x4&                proj_view_matrix =
+            render_resource->m_mesh_inefficient_pick_perframe_storage_buffer_object.proj_view_matrix;
+
+        uint32_t picked_mesh_id = 0;
+        if (m_render_scene->pickMesh(render_resource, proj_view_matrix, picked_uv, picked_mesh_id))
+        {
+            return picked_mesh_id;
+        }
         return m_render_pipeline->getGuidOfPickedMesh(picked_uv);
     }
 
@@ -237,6 +289,102 @@ namespace Piccolo
         m_render_scene->clearForLevelReloading();
     }
 
+    void RenderSystem::reloadAssets(const std::vector<std::string>& asset_urls)
+    {
+        std::shared_ptr<AssetManager> asset_manager = g_runtime_global_context.m_asset_manager;
+        ASSERT(asset_manager);
+
+        // reverse dependencies, from the files to the cached assets loaded from them
+        std::unordered_map<std::string, std::vector<size_t>> mesh_dependents;
+        std::unordered_map<std::string, std::vector<size_t>> material_dependents;
+        for (const auto& [guid, mesh_source] : m_render_scene->getMeshAssetIdAllocator().getGuidElements())
+        {
+            mesh_dependents[asset_manager->getAssetUrl(mesh_source.m_mesh_file)].push_back(guid);
+        }
+        for (const auto& [guid, material_source] : m_render_scene->getMaterialAssetdAllocator().getGuidElements())
+        {
+            for (const std::string* texture_file : {&material_source.m_base_color_file,
+                                                    &material_source.m_metallic_roughness_file,
+                                                    &material_source.m_normal_file,
+                                                    &material_source.m_occlusion_file,
+                                                    &material_source.m_emissive_file})
+            {
+                if (!texture_file->empty())
+                {
+                    material_dependents[asset_manager->getAssetUrl(*texture_file)].push_back(guid);
+                }
+            }
+        }
+
+        std::set<size_t> mesh_guids;
+        std::set<size_t> material_guids;
+        for (const std::string& asset_url : asset_urls)
+        {
+            auto mesh_iter = mesh_dependents.find(asset_url);
+            if (mesh_iter != mesh_dependents.end())
+            {
+                mesh_guids.insert(mesh_iter->second.begin(), mesh_iter->second.end());
+            }
+            auto material_iter = material_dependents.find(asset_url);
+            if (material_iter != material_dependents.end())
+            {
+                material_guids.insert(material_iter->second.begin(), material_iter->second.end());
+            }
+        }
+        if (mesh_guids.empty() && material_guids.empty())
+        {
+            return;
+        }
+
+        // the frames in flight still read the old buffers and images
+        m_rhi->flushUploadCommands();
+        m_rhi->queueWaitIdle(m_rhi->getGraphicsQueue());
+
+        for (size_t mesh_guid : mesh_guids)
+        {
+            MeshSourceDesc mesh_source;
+            m_render_scene->getMeshAssetIdAllocator().getGuidRelatedElement(mesh_guid, mesh_source);
+
+            AxisAlignedBox bounding_box;
+            RenderMeshData mesh_data = m_render_resource->loadMeshData(mesh_source, bounding_box);
+            if (!mesh_data.m_static_mesh_data.m_vertex_buffer || !mesh_data.m_static_mesh_data.m_index_buffer ||
+                mesh_data.m_static_mesh_data.m_vertex_buffer->m_size == 0)
+            {
+                LOG_WARN("reload mesh {} failed, keeping the loaded one", mesh_source.m_mesh_file);
+                continue;
+            }
+
+            RenderEntity render_entity;
+            render_entity.m_mesh_asset_id = mesh_guid;
+            m_render_resource->reloadGameObjectRenderResource(m_rhi, render_entity, mesh_data);
+
+            m_render_scene->updateMeshBoundingBox(mesh_guid, bounding_box);
+        }
+
+        for (size_t material_guid : material_guids)
+        {
+            MaterialSourceDesc material_source;
+            m_render_scene->getMaterialAssetdAllocator().getGuidRelatedElement(material_guid, material_source);
+
+            // the factors of the material uniform buffer come from the entities
+            RenderEntity render_entity;
+            for (const RenderEntity& entity : m_render_scene->m_render_entities)
+            {
+                if (entity.m_material_asset_id == material_guid)
+                {
+                    render_entity = entity;
+                    break;
+                }
+            }
+            render_entity.m_material_asset_id = material_guid;
+
+            RenderMaterialData material_data = m_render_resource->loadMaterialData(material_source);
+            m_render_resource->reloadGameObjectRenderResource(m_rhi, render_entity, material_data);
+        }
+
+        LOG_INFO("reloaded {} meshes and {} materials", mesh_guids.size(), material_guids.size());
+    }
+
     void RenderSystem::setRenderPipelineType(RENDER_PIPELINE_TYPE pipeline_type)
     {
         m_render_pipeline_type = pipeline_type;
@@ -354,18 +502,11 @@ namespace Piccolo
                     // add object to render scene if needed
                     if (!is_entity_in_scene)
                     {
-                        m_render_scene->m_render_entities.push_back(render_entity);
+                        m_render_scene->addRenderEntity(render_entity);
                     }
                     else
                     {
-                        for (auto& entity : m_render_scene->m_render_entities)
-                        {
-                            if (entity.m_instance_id == render_entity.m_instance_id)
-                            {
-                                entity = render_entity;
-                                break;
-                            }
-                        }
+                        m_render_scene->updateRenderEntity(render_entity);
                     }
                 }
                 // after finished processing, pop this game object
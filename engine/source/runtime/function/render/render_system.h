@@ -8,6 +8,8 @@
 #include <array>
 #include <memory>
 #include <optional>
+#include <string>
+#include <vector>
 
 namespace Piccolo
 {
@@ -65,6 +67,10 @@ namespace Piccolo
 
         void clearForLevelReloading();
 
+        // rebuilds the cached meshes and materials loaded from the changed assets in place, asset_urls are relative
+        // to the root folder, the level and the entities using them are left untouched
+        void reloadAssets(const std::vector<std::string>& asset_urls);
+
     private:
         RENDER_PIPELINE_TYPE m_render_pipeline_type {RENDER_PIPELINE_TYPE::DEFERRED_PIPELINE};
 
@@ -1,5 +1,17 @@
 #include "runtime/platform/file_service/file_service.h"
 
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 using namespace std;
 
 namespace Piccolo
@@ -16,4 +28,125 @@ namespace Piccolo
         }
         return files;
     }
-} // namespace Piccolo
\ No newline at end of file
+
+    MappedFile::~MappedFile() { close(); }
+
+#if defined(_WIN32)
+    bool MappedFile::open(const filesystem::path& path)
+    {
+        close();
+
+        HANDLE file = CreateFileW(path.c_str(),
+                                  GENERIC_READ,
+                                  FILE_SHARE_READ,
+                                  nullptr,
+                                  OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                                  nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file, &file_size))
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        m_file_handle = file;
+        m_size        = static_cast<size_t>(file_size.QuadPart);
+        m_is_open     = true;
+        if (m_size == 0)
+        {
+            return true;
+        }
+
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr)
+        {
+            close();
+            return false;
+        }
+        m_mapping_handle = mapping;
+
+        m_data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if (m_data == nullptr)
+        {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void MappedFile::close()
+    {
+        if (m_data)
+        {
+            UnmapViewOfFile(m_data);
+        }
+        if (m_mapping_handle)
+        {
+            CloseHandle(m_mapping_handle);
+        }
+        if (m_file_handle)
+        {
+            CloseHandle(m_file_handle);
+        }
+        m_file_handle    = nullptr;
+        m_mapping_handle = nullptr;
+        m_data           = nullptr;
+        m_size           = 0;
+        m_is_open        = false;
+    }
+#else
+    bool MappedFile::open(const filesystem::path& path)
+    {
+        close();
+
+        int file = ::open(path.c_str(), O_RDONLY);
+        if (file < 0)
+        {
+            return false;
+        }
+
+        struct stat file_status;
+        if (fstat(file, &file_status) != 0)
+        {
+            ::close(file);
+            return false;
+        }
+
+        m_size    = static_cast<size_t>(file_status.st_size);
+        m_is_open = true;
+        if (m_size != 0)
+        {
+            void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+            if (data == MAP_FAILED)
+            {
+                ::close(file);
+                close();
+                return false;
+            }
+            madvise(data, m_size, MADV_SEQUENTIAL);
+            m_data = static_cast<const char*>(data);
+        }
+
+        // the mapping stays valid after the descriptor is closed
+        ::close(file);
+        return true;
+    }
+
+    void MappedFile::close()
+    {
+        if (m_data)
+        {
+            munmap(const_cast<char*>(m_data), m_size);
+        }
+        m_data    = nullptr;
+        m_size    = 0;
+        m_is_open = false;
+    }
+#endif
+} // namespace Piccolo
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <filesystem>
 #include <vector>
 
@@ -10,4 +11,32 @@ namespace Piccolo
     public:
         std::vector<std::filesystem::path> getFiles(const std::filesystem::path& directory);
     };
-} // namespace Piccolo
\ No newline at end of file
+
+    // read only view of a whole file mapped into memory, empty files are opened without a mapping
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool open(const std::filesystem::path& path);
+        void close();
+
+        bool        isOpen() const { return m_is_open; }
+        const char* data() const { return m_data; }
+        size_t      size() const { return m_size; }
+
+    private:
+        bool        m_is_open {false};
+        const char* m_data {nullptr};
+        size_t      m_size {0};
+
+#if defined(_WIN32)
+        void* m_file_handle {nullptr};
+        void* m_mapping_handle {nullptr};
+#endif
+    };
+} // namespace Piccolo
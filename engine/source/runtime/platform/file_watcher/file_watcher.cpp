@@ -0,0 +1,386 @@
+#include "runtime/platform/file_watcher/file_watcher.h"
+
+#include "runtime/core/base/macro.h"
+
+#if defined(__linux__)
+#include <cerrno>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace Piccolo
+{
+    namespace
+    {
+        FileChangeType combineChanges(FileChangeType earlier, FileChangeType later)
+        {
+            if (later == FileChangeType::removed || later == FileChangeType::rescan)
+            {
+                return later;
+            }
+            if (earlier == FileChangeType::added)
+            {
+                return FileChangeType::added;
+            }
+            // a file removed and created again within a tick has been replaced
+            return FileChangeType::modified;
+        }
+
+        std::vector<FileChangeEvent> coalesceEvents(const std::vector<FileChangeEvent>& events)
+        {
+            std::vector<FileChangeEvent>            coalesced_events;
+            std::unordered_map<std::string, size_t> event_indices;
+            for (const FileChangeEvent& event : events)
+            {
+                auto iter = event_indices.find(event.path.generic_string());
+                if (iter == event_indices.end())
+                {
+                    event_indices.emplace(event.path.generic_string(), coalesced_events.size());
+                    coalesced_events.push_back(event);
+                }
+                else
+                {
+                    FileChangeEvent& coalesced_event = coalesced_events[iter->second];
+                    coalesced_event.type             = combineChanges(coalesced_event.type, event.type);
+                    coalesced_event.is_directory     = event.is_directory;
+                }
+            }
+            return coalesced_events;
+        }
+    } // namespace
+
+    FileWatcher::~FileWatcher() { clear(); }
+
+    bool FileWatcher::initialize(const FileWatcherInitInfo& init_info)
+    {
+        clear();
+
+        std::error_code error;
+        if (!std::filesystem::is_directory(init_info.directory, error))
+        {
+            LOG_ERROR("can not watch {}, it is not a directory", init_info.directory.generic_string());
+            return false;
+        }
+
+        m_directory     = std::filesystem::absolute(init_info.directory).lexically_normal();
+        m_poll_interval = init_info.poll_interval;
+
+        if (!init_info.force_polling && initializeInotify())
+        {
+            LOG_INFO("watching {} with inotify", m_directory.generic_string());
+            return true;
+        }
+
+        m_stop_polling = false;
+        m_poll_thread  = std::thread(&FileWatcher::pollLoop, this, takeSnapshot(m_directory));
+        LOG_INFO("watching {} by polling every {}ms", m_directory.generic_string(), m_poll_interval.count());
+        return true;
+    }
+
+    void FileWatcher::clear()
+    {
+        if (m_poll_thread.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_poll_mutex);
+                m_stop_polling = true;
+            }
+            m_poll_condition.notify_all();
+            m_poll_thread.join();
+        }
+
+        clearInotify();
+
+        std::lock_guard<std::mutex> lock(m_event_mutex);
+        m_pending_events.clear();
+    }
+
+    void FileWatcher::tick()
+    {
+        if (isUsingInotify())
+        {
+            readInotifyEvents();
+        }
+
+        std::vector<FileChangeEvent> events;
+        {
+            std::lock_guard<std::mutex> lock(m_event_mutex);
+            events.swap(m_pending_events);
+        }
+        if (events.empty())
+        {
+            return;
+        }
+
+        events = coalesceEvents(events);
+
+        // a listener may add or remove listeners while it is called
+        std::vector<FileChangeListener> listeners;
+        for (auto& listener : m_listeners)
+        {
+            listeners.push_back(listener.second);
+        }
+        for (FileChangeListener& listener : listeners)
+        {
+            listener(events);
+        }
+    }
+
+    uint32_t FileWatcher::addListener(FileChangeListener listener)
+    {
+        uint32_t listener_id = m_next_listener_id++;
+        m_listeners.emplace(listener_id, std::move(listener));
+        return listener_id;
+    }
+
+    void FileWatcher::removeListener(uint32_t listener_id) { m_listeners.erase(listener_id); }
+
+    void FileWatcher::pushEvent(FileChangeType type, const std::filesystem::path& path, bool is_directory)
+    {
+        FileChangeEvent event;
+        event.type         = type;
+        event.path         = path;
+        event.is_directory = is_directory;
+
+        std::lock_guard<std::mutex> lock(m_event_mutex);
+        m_pending_events.push_back(std::move(event));
+    }
+
+#if defined(__linux__)
+    namespace
+    {
+        constexpr uint32_t k_inotify_mask =
+            IN_CREATE | IN_CLOSE_WRITE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR | IN_EXCL_UNLINK;
+    } // namespace
+
+    bool FileWatcher::initializeInotify()
+    {
+        m_inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (m_inotify_fd < 0)
+        {
+            LOG_WARN("inotify is not available, falling back to polling");
+            return false;
+        }
+
+        if (!addInotifyWatch(m_directory, false))
+        {
+            // usually fs.inotify.max_user_watches is too low for the tree
+            LOG_WARN("can not watch every directory of {} with inotify, falling back to polling",
+                     m_directory.generic_string());
+            clearInotify();
+            return false;
+        }
+        return true;
+    }
+
+    bool FileWatcher::addInotifyWatch(const std::filesystem::path& directory, bool report_files)
+    {
+        int watch = inotify_add_watch(m_inotify_fd, directory.c_str(), k_inotify_mask);
+        if (watch < 0)
+        {
+            // the directory may be gone already, its removal is reported anyway
+            return errno == ENOENT || errno == ENOTDIR;
+        }
+        m_watch_directories[watch] = directory;
+
+        std::error_code error;
+        for (std::filesystem::directory_iterator iter(directory, error), end; !error && iter != end;
+             iter.increment(error))
+        {
+            if (iter->is_directory(error))
+            {
+                if (report_files)
+                {
+                    pushEvent(FileChangeType::added, iter->path(), true);
+                }
+                if (!addInotifyWatch(iter->path(), report_files))
+                {
+                    return false;
+                }
+            }
+            else if (report_files && iter->is_regular_file(error))
+            {
+                // created before the watch was in place, no event of its own arrives
+                pushEvent(FileChangeType::added, iter->path(), false);
+            }
+        }
+        return true;
+    }
+
+    void FileWatcher::removeInotifyWatches(const std::filesystem::path& directory)
+    {
+        std::string prefix = directory.generic_string() + "/";
+        for (auto iter = m_watch_directories.begin(); iter != m_watch_directories.end();)
+        {
+            std::string watch_directory = iter->second.generic_string();
+            if (watch_directory == directory.generic_string() || watch_directory.rfind(prefix, 0) == 0)
+            {
+                inotify_rm_watch(m_inotify_fd, iter->first);
+                iter = m_watch_directories.erase(iter);
+            }
+            else
+            {
+                ++iter;
+            }
+        }
+    }
+
+    void FileWatcher::readInotifyEvents()
+    {
+        alignas(inotify_event) char buffer[16 * 1024];
+        while (true)
+        {
+            ssize_t length = read(m_inotify_fd, buffer, sizeof(buffer));
+            if (length <= 0)
+            {
+                // EAGAIN, nothing left to read
+                return;
+            }
+
+            for (char* cursor = buffer; cursor < buffer + length;)
+            {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(cursor);
+                cursor += sizeof(inotify_event) + event->len;
+
+                if (event->mask & IN_Q_OVERFLOW)
+                {
+                    pushEvent(FileChangeType::rescan, m_directory, true);
+                    continue;
+                }
+
+                auto directory_iter = m_watch_directories.find(event->wd);
+                if (directory_iter == m_watch_directories.end())
+                {
+                    continue;
+                }
+                if (event->mask & IN_IGNORED)
+                {
+                    m_watch_directories.erase(directory_iter);
+                    continue;
+                }
+                if (event->len == 0)
+                {
+                    continue;
+                }
+
+                std::filesystem::path path         = directory_iter->second / event->name;
+                bool                  is_directory = (event->mask & IN_ISDIR) != 0;
+                if (event->mask & (IN_CREATE | IN_MOVED_TO))
+                {
+                    pushEvent(FileChangeType::added, path, is_directory);
+                    if (is_directory && !addInotifyWatch(path, true))
+                    {
+                        LOG_WARN("can not watch {} with inotify, its changes are missed", path.generic_string());
+                    }
+                }
+                else if (event->mask & (IN_DELETE | IN_MOVED_FROM))
+                {
+                    pushEvent(FileChangeType::removed, path, is_directory);
+                    if (is_directory)
+                    {
+                        removeInotifyWatches(path);
+                    }
+                }
+                else if (event->mask & IN_CLOSE_WRITE)
+                {
+                    pushEvent(FileChangeType::modified, path, false);
+                }
+            }
+        }
+    }
+
+    void FileWatcher::clearInotify()
+    {
+        if (m_inotify_fd >= 0)
+        {
+            close(m_inotify_fd);
+            m_inotify_fd = -1;
+        }
+        m_watch_directories.clear();
+    }
+#else
+    bool FileWatcher::initializeInotify() { return false; }
+
+    bool FileWatcher::addInotifyWatch(const std::filesystem::path&, bool) { return false; }
+
+    void FileWatcher::removeInotifyWatches(const std::filesystem::path&) {}
+
+    void FileWatcher::readInotifyEvents() {}
+
+    void FileWatcher::clearInotify() {}
+#endif
+
+    FileWatcher::FileSnapshot FileWatcher::takeSnapshot(const std::filesystem::path& directory)
+    {
+        FileSnapshot snapshot;
+
+        // files may vanish while the tree is walked, they are simply missing from the snapshot
+        std::error_code error;
+        for (std::filesystem::recursive_directory_iterator
+                 iter(directory, std::filesystem::directory_options::skip_permission_denied, error),
+             end;
+             !error && iter != end;
+             iter.increment(error))
+        {
+            std::error_code file_error;
+            if (!iter->is_regular_file(file_error))
+            {
+                continue;
+            }
+
+            FileStamp stamp;
+            stamp.write_time = iter->last_write_time(file_error);
+            stamp.size       = iter->file_size(file_error);
+            if (!file_error)
+            {
+                snapshot.emplace(iter->path(), stamp);
+            }
+        }
+        return snapshot;
+    }
+
+    void FileWatcher::pollLoop(FileSnapshot snapshot)
+    {
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_poll_mutex);
+                if (m_poll_condition.wait_for(lock, m_poll_interval, [this]() { return m_stop_polling; }))
+                {
+                    return;
+                }
+            }
+
+            FileSnapshot new_snapshot = takeSnapshot(m_directory);
+
+            // both snapshots are sorted by path, one pass finds every difference
+            auto old_iter = snapshot.begin();
+            auto new_iter = new_snapshot.begin();
+            while (old_iter != snapshot.end() || new_iter != new_snapshot.end())
+            {
+                if (new_iter == new_snapshot.end() || (old_iter != snapshot.end() && old_iter->first < new_iter->first))
+                {
+                    pushEvent(FileChangeType::removed, old_iter->first, false);
+                    ++old_iter;
+                }
+                else if (old_iter == snapshot.end() || new_iter->first < old_iter->first)
+                {
+                    pushEvent(FileChangeType::added, new_iter->first, false);
+                    ++new_iter;
+                }
+                else
+                {
+                    if (old_iter->second.write_time != new_iter->second.write_time ||
+                        old_iter->second.size != new_iter->second.size)
+                    {
+                        pushEvent(FileChangeType::modified, new_iter->first, false);
+                    }
+                    ++old_iter;
+                    ++new_iter;
+                }
+            }
+
+            snapshot = std::move(new_snapshot);
+        }
+    }
+} // namespace Piccolo
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace Piccolo
+{
+    enum class FileChangeType : uint8_t
+    {
+        added,
+        modified,
+        removed,
+        // events were lost, everything below the path may have changed
+        rescan
+    };
+
+    struct FileChangeEvent
+    {
+        FileChangeType        type {FileChangeType::modified};
+        std::filesystem::path path;
+        bool                  is_directory {false};
+    };
+
+    using FileChangeListener = std::function<void(const std::vector<FileChangeEvent>&)>;
+
+    struct FileWatcherInitInfo
+    {
+        std::filesystem::path     directory;
+        std::chrono::milliseconds poll_interval {500};
+        // skips inotify, mostly to try the polling path on linux
+        bool force_polling {false};
+    };
+
+    // watches a directory tree and hands the changes to its listeners on the thread calling tick
+    // inotify is used on linux, other platforms and a failing inotify fall back to comparing snapshots of the tree
+    // on a background thread, so that a large tree never stalls the caller of tick
+    class FileWatcher
+    {
+    public:
+        ~FileWatcher();
+
+        bool initialize(const FileWatcherInitInfo& init_info);
+        void clear();
+
+        // the events of a tick are coalesced per path, a file written several times is reported once
+        void tick();
+
+        uint32_t addListener(FileChangeListener listener);
+        void     removeListener(uint32_t listener_id);
+
+        bool isUsingInotify() const { return m_inotify_fd >= 0; }
+
+    private:
+        struct FileStamp
+        {
+            std::filesystem::file_time_type write_time;
+            uintmax_t                       size {0};
+        };
+        using FileSnapshot = std::map<std::filesystem::path, FileStamp>;
+
+        void pushEvent(FileChangeType type, const std::filesystem::path& path, bool is_directory);
+
+        bool initializeInotify();
+        // watches the directory and everything below it, report_files is set for a directory which appeared later
+        bool addInotifyWatch(const std::filesystem::path& directory, bool report_files);
+        void removeInotifyWatches(const std::filesystem::path& directory);
+        void readInotifyEvents();
+        void clearInotify();
+
+        static FileSnapshot takeSnapshot(const std::filesystem::path& directory);
+        void                pollLoop(FileSnapshot snapshot);
+
+    private:
+        std::filesystem::path     m_directory;
+        std::chrono::milliseconds m_poll_interval {500};
+
+        std::mutex                   m_event_mutex;
+        std::vector<FileChangeEvent> m_pending_events;
+
+        std::map<uint32_t, FileChangeListener> m_listeners;
+        uint32_t                               m_next_listener_id {1};
+
+        // inotify watch descriptor to the directory it watches
+        int                                            m_inotify_fd {-1};
+        std::unordered_map<int, std::filesystem::path> m_watch_directories;
+
+        std::thread             m_poll_thread;
+        std::mutex              m_poll_mutex;
+        std::condition_variable m_poll_condition;
+        bool                    m_stop_polling {false};
+    };
+} // namespace Piccolo
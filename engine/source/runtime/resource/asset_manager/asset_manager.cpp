@@ -1,15 +1,168 @@
 #include "runtime/resource/asset_manager/asset_manager.h"
 
 #include "runtime/resource/config_manager/config_manager.h"
+#include "runtime/resource/res_type/common/cooked_manifest.h"
 
 #include "runtime/function/global/global_context.h"
 
+#include <algorithm>
+#include <cstring>
 #include <filesystem>
 
 namespace Piccolo
 {
+    void AssetManager::initialize() { loadCookedManifest(); }
+
+    void AssetManager::onFilesChanged(const std::vector<FileChangeEvent>& events)
+    {
+        const std::string& manifest_url = g_runtime_global_context.m_config_manager->getCookedManifestUrl();
+        if (manifest_url.empty())
+        {
+            return;
+        }
+
+        std::filesystem::path manifest_path = getFullPath(manifest_url).lexically_normal();
+        for (const FileChangeEvent& event : events)
+        {
+            if (event.type == FileChangeType::rescan || event.path.lexically_normal() == manifest_path)
+            {
+                loadCookedManifest();
+                return;
+            }
+        }
+    }
+
+    std::vector<std::string> AssetManager::getChangedAssetUrls(const std::vector<FileChangeEvent>& events) const
+    {
+        std::vector<std::string> asset_urls;
+        for (const FileChangeEvent& event : events)
+        {
+            // a removed asset is still referenced by whatever uses it, nothing can be reloaded from it
+            if (event.is_directory || event.type == FileChangeType::removed || event.type == FileChangeType::rescan)
+            {
+                continue;
+            }
+
+            std::string asset_url = getAssetUrl(event.path);
+            if (event.path.extension() == ".bin")
+            {
+                if (m_has_cooked_manifest)
+                {
+                    auto iter = m_cooked_source_urls.find(asset_url);
+                    if (iter == m_cooked_source_urls.end())
+                    {
+                        continue;
+                    }
+                    asset_url = iter->second;
+                }
+                else
+                {
+                    // the reverse of getCookedPath, foo.png.bin to foo.png and foo.mesh.bin to foo.mesh.json
+                    asset_url.erase(asset_url.size() - std::strlen(".bin"));
+                    if (!std::filesystem::exists(getFullPath(asset_url)))
+                    {
+                        asset_url += ".json";
+                    }
+                }
+            }
+            asset_urls.push_back(std::move(asset_url));
+        }
+
+        // a cooked file is usually written together with its source file
+        std::sort(asset_urls.begin(), asset_urls.end());
+        asset_urls.erase(std::unique(asset_urls.begin(), asset_urls.end()), asset_urls.end());
+        return asset_urls;
+    }
+
+    void AssetManager::loadCookedManifest()
+    {
+        m_cooked_asset_urls.clear();
+        m_cooked_source_urls.clear();
+        m_has_cooked_manifest = false;
+
+        const std::string& manifest_url = g_runtime_global_context.m_config_manager->getCookedManifestUrl();
+        if (manifest_url.empty() || !std::filesystem::exists(getFullPath(manifest_url)))
+        {
+            return;
+        }
+
+        CookedManifestRes manifest;
+        if (!loadAsset(manifest_url, manifest))
+        {
+            return;
+        }
+
+        for (const CookedAssetRes& cooked_asset : manifest.m_assets)
+        {
+            m_cooked_asset_urls[cooked_asset.m_source_url]  = cooked_asset.m_cooked_url;
+            m_cooked_source_urls[cooked_asset.m_cooked_url] = cooked_asset.m_source_url;
+        }
+        m_has_cooked_manifest = true;
+
+        LOG_INFO("{} cooked assets in {}", m_cooked_asset_urls.size(), manifest_url);
+    }
+
     std::filesystem::path AssetManager::getFullPath(const std::string& relative_path) const
     {
         return std::filesystem::absolute(g_runtime_global_context.m_config_manager->getRootFolder() / relative_path);
     }
-} // namespace Piccolo
\ No newline at end of file
+
+    std::string AssetManager::getAssetUrl(const std::filesystem::path& path) const
+    {
+        // getFullPath keeps a path which is already absolute
+        return getFullPath(path.generic_string())
+            .lexically_normal()
+            .lexically_relative(getFullPath(std::string()).lexically_normal())
+            .generic_string();
+    }
+
+    std::filesystem::path AssetManager::getCookedPath(const std::string& asset_url) const
+    {
+        std::filesystem::path cooked_path = getFullPath(asset_url);
+        if (cooked_path.extension() == ".json")
+        {
+            return cooked_path.replace_extension(".bin");
+        }
+        return cooked_path += ".bin";
+    }
+
+    std::filesystem::path AssetManager::findCookedPath(const std::string& asset_url) const
+    {
+        if (asset_url.empty())
+        {
+            return {};
+        }
+
+        std::filesystem::path source_path = getFullPath(asset_url);
+        std::filesystem::path cooked_path;
+        if (m_has_cooked_manifest)
+        {
+            // the render system passes full paths, the manifest is keyed by urls relative to the root folder
+            auto iter = m_cooked_asset_urls.find(getAssetUrl(source_path));
+            if (iter == m_cooked_asset_urls.end())
+            {
+                return {};
+            }
+            cooked_path = getFullPath(iter->second);
+        }
+        else
+        {
+            cooked_path = getCookedPath(asset_url);
+        }
+
+        std::error_code error;
+        auto            cooked_time = std::filesystem::last_write_time(cooked_path, error);
+        if (error)
+        {
+            return {};
+        }
+
+        // a cooked file without its source file is still fine, it may be shipped alone
+        auto source_time = std::filesystem::last_write_time(source_path, error);
+        if (!error && source_time > cooked_time)
+        {
+            return {};
+        }
+        return cooked_path;
+    }
+} // namespace Piccolo
@@ -2,23 +2,68 @@
 
 #include "runtime/core/base/macro.h"
 #include "runtime/core/meta/serializer/serializer.h"
+#include "runtime/platform/file_service/file_service.h"
+#include "runtime/platform/file_watcher/file_watcher.h"
 
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <functional>
 #include <sstream>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "_generated/serializer/all_serializer.h"
 
 namespace Piccolo
 {
+    enum class AssetLoadMode : uint8_t
+    {
+        // deserialize straight from the mapped file, no json dom is built
+        streaming,
+        // parse the whole file into a json11 dom first, the asset is left untouched when the file is malformed
+        json_dom
+    };
+
+    // leads the binary form of an asset in its cooked sibling file
+    struct CookedAssetHeader
+    {
+        uint32_t magic {0};
+        uint32_t version {0};
+        uint64_t schema_hash {0};
+    };
+
     class AssetManager
     {
     public:
+        static constexpr uint32_t s_cooked_asset_magic   = 0x4B4F4F43; // "COOK"
+        static constexpr uint32_t s_cooked_asset_version = 1;
+
+        // reads the manifest written by the asset cooker, without one cooked siblings are looked up on disk
+        void initialize();
+
+        // called with the changes the file watcher reports, a cooker run while the engine is up is picked up here
+        void onFilesChanged(const std::vector<FileChangeEvent>& events);
+
+        // the urls of the assets touched by the changes, a rewritten cooked file is reported as its source asset
+        std::vector<std::string> getChangedAssetUrls(const std::vector<FileChangeEvent>& events) const;
+
+        // a cooked sibling newer than the json file is loaded instead of it, unless the json dom is asked for
         template<typename AssetType>
-        bool loadAsset(const std::string& asset_url, AssetType& out_asset) const
+        bool loadAsset(const std::string& asset_url,
+                       AssetType&         out_asset,
+                       AssetLoadMode      load_mode = AssetLoadMode::streaming) const
         {
+            if (load_mode == AssetLoadMode::streaming)
+            {
+                if (loadCookedAsset(asset_url, out_asset))
+                {
+                    return true;
+                }
+                return loadAssetStreaming(asset_url, out_asset);
+            }
+
             // read json file to string
             std::filesystem::path asset_path = getFullPath(asset_url);
             std::ifstream asset_json_file(asset_path);
@@ -65,10 +110,133 @@ namespace Piccolo
             asset_json_file << asset_json_text;
             asset_json_file.flush();
 
+            // keep an existing cooked sibling in sync, it would be ignored as stale otherwise
+            if (std::filesystem::exists(getCookedPath(asset_url)))
+            {
+                saveCookedAsset(out_asset, asset_url);
+            }
+
             return true;
         }
 
+        // writes the binary form next to the json file of asset_url
+        template<typename AssetType>
+        bool saveCookedAsset(const AssetType& asset, const std::string& asset_url) const
+        {
+            std::filesystem::path cooked_path = getCookedPath(asset_url);
+            std::ofstream         cooked_file(cooked_path, std::ios::binary | std::ios::trunc);
+            if (!cooked_file)
+            {
+                LOG_ERROR("open file {} failed!", cooked_path.generic_string());
+                return false;
+            }
+
+            CookedAssetHeader header;
+            header.magic       = s_cooked_asset_magic;
+            header.version     = s_cooked_asset_version;
+            header.schema_hash = Serializer::getBinarySchemaHash<AssetType>();
+
+            BinaryWriter writer;
+            Serializer::write(writer, asset);
+
+            cooked_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            cooked_file.write(writer.getBuffer().data(), writer.getBuffer().size());
+            cooked_file.flush();
+
+            return static_cast<bool>(cooked_file);
+        }
+
         std::filesystem::path getFullPath(const std::string& relative_path) const;
+        // the url relative to the root folder of a full path or url, so that differently spelled paths compare equal
+        std::string getAssetUrl(const std::filesystem::path& path) const;
+        // where the cooker writes the binary form of asset_url, foo.mesh.json to foo.mesh.bin, foo.png to foo.png.bin
+        std::filesystem::path getCookedPath(const std::string& asset_url) const;
+        // the cooked file to load instead of asset_url, empty when there is none or the source file is newer
+        std::filesystem::path findCookedPath(const std::string& asset_url) const;
+
+    private:
+        void loadCookedManifest();
+
+        // false when there is no usable cooked file, the json file is loaded then
+        template<typename AssetType>
+        bool loadCookedAsset(const std::string& asset_url, AssetType& out_asset) const
+        {
+            std::filesystem::path cooked_path = findCookedPath(asset_url);
+            if (cooked_path.empty())
+            {
+                return false;
+            }
+
+            MappedFile cooked_file;
+            if (!cooked_file.open(cooked_path))
+            {
+                LOG_WARN("open file: {} failed, loading the json file instead", cooked_path.generic_string());
+                return false;
+            }
+
+            CookedAssetHeader header;
+            if (cooked_file.size() < sizeof(header))
+            {
+                LOG_WARN("cooked file {} is truncated, loading the json file instead", cooked_path.generic_string());
+                return false;
+            }
+            std::memcpy(&header, cooked_file.data(), sizeof(header));
+            if (header.magic != s_cooked_asset_magic || header.version != s_cooked_asset_version ||
+                header.schema_hash != Serializer::getBinarySchemaHash<AssetType>())
+            {
+                LOG_WARN("cooked file {} was written for another layout of the asset, loading the json file instead",
+                         cooked_path.generic_string());
+                return false;
+            }
+
+            // read into a fresh asset, so that a failure does not leave a half read one for the json fallback
+            AssetType    cooked_asset;
+            BinaryReader reader(cooked_file.data() + sizeof(header), cooked_file.data() + cooked_file.size());
+            Serializer::read(reader, cooked_asset);
+            if (reader.hasError())
+            {
+                LOG_WARN("read cooked file {} failed at offset {}: {}, loading the json file instead",
+                         cooked_path.generic_string(),
+                         sizeof(header) + reader.getErrorOffset(),
+                         reader.getError());
+                return false;
+            }
+
+            out_asset = std::move(cooked_asset);
+            return true;
+        }
+
+        template<typename AssetType>
+        bool loadAssetStreaming(const std::string& asset_url, AssetType& out_asset) const
+        {
+            std::filesystem::path asset_path = getFullPath(asset_url);
+            MappedFile            asset_json_file;
+            if (!asset_json_file.open(asset_path))
+            {
+                LOG_ERROR("open file: {} failed!", asset_path.generic_string());
+                return false;
+            }
+
+            // read into a fresh asset, so that a parse error does not leave the caller a half read one
+            AssetType  streamed_asset;
+            JsonReader reader(asset_json_file.data(), asset_json_file.data() + asset_json_file.size());
+            Serializer::read(reader, streamed_asset);
+            if (reader.hasError())
+            {
+                LOG_ERROR("parse json file {} failed at offset {}: {}",
+                          asset_url,
+                          reader.getErrorOffset(),
+                          reader.getError());
+                return false;
+            }
+
+            out_asset = std::move(streamed_asset);
+            return true;
+        }
 
+        // asset url to cooked url and back, from the manifest
+        std::unordered_map<std::string, std::string> m_cooked_asset_urls;
+        std::unordered_map<std::string, std::string> m_cooked_source_urls;
+        bool                                         m_has_cooked_manifest {false};
     };
 } // namespace Piccolo
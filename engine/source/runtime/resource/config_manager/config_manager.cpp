@@ -36,6 +36,10 @@ namespace Piccolo
                 {
                     m_default_world_url = value;
                 }
+                else if (name == "CookedManifest")
+                {
+                    m_cooked_manifest_url = value;
+                }
                 else if (name == "BigIconFile")
                 {
                     m_editor_big_icon_path = m_root_folder / value;
@@ -48,6 +52,22 @@ namespace Piccolo
                 {
                     m_editor_font_path = m_root_folder / value;
                 }
+                else if (name == "PipelineCacheFile")
+                {
+                    m_pipeline_cache_path = m_root_folder / value;
+                }
+                else if (name == "LogFile")
+                {
+                    // an empty value keeps the path empty, which disables the file sink
+                    if (!value.empty())
+                    {
+                        m_log_file_path = m_root_folder / value;
+                    }
+                }
+                else if (name == "LogBackend")
+                {
+                    m_enable_async_log = value != "sync";
+                }
                 else if (name == "GlobalRenderingRes")
                 {
                     m_global_rendering_res_url = value;
@@ -78,10 +98,18 @@ namespace Piccolo
 
     const std::filesystem::path& ConfigManager::getEditorFontPath() const { return m_editor_font_path; }
 
+    const std::filesystem::path& ConfigManager::getPipelineCachePath() const { return m_pipeline_cache_path; }
+
+    const std::filesystem::path& ConfigManager::getLogFilePath() const { return m_log_file_path; }
+
+    bool ConfigManager::isAsyncLogEnabled() const { return m_enable_async_log; }
+
     const std::string& ConfigManager::getDefaultWorldUrl() const { return m_default_world_url; }
 
     const std::string& ConfigManager::getGlobalRenderingResUrl() const { return m_global_rendering_res_url; }
 
+    const std::string& ConfigManager::getCookedManifestUrl() const { return m_cooked_manifest_url; }
+
     const std::string& ConfigManager::getGlobalParticleResUrl() const { return m_global_particle_res_url; }
 
 #ifdef ENABLE_PHYSICS_DEBUG_RENDERER
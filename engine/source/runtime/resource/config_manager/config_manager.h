@@ -17,6 +17,9 @@ namespace Piccolo
         const std::filesystem::path& getEditorBigIconPath() const;
         const std::filesystem::path& getEditorSmallIconPath() const;
         const std::filesystem::path& getEditorFontPath() const;
+        const std::filesystem::path& getPipelineCachePath() const;
+        const std::filesystem::path& getLogFilePath() const;
+        bool                         isAsyncLogEnabled() const;
 
 #ifdef ENABLE_PHYSICS_DEBUG_RENDERER
         const std::filesystem::path& getJoltPhysicsAssetFolder() const;
@@ -25,6 +28,7 @@ namespace Piccolo
         const std::string& getDefaultWorldUrl() const;
         const std::string& getGlobalRenderingResUrl() const;
         const std::string& getGlobalParticleResUrl() const;
+        const std::string& getCookedManifestUrl() const;
 
     private:
         std::filesystem::path m_root_folder;
@@ -33,6 +37,9 @@ namespace Piccolo
         std::filesystem::path m_editor_big_icon_path;
         std::filesystem::path m_editor_small_icon_path;
         std::filesystem::path m_editor_font_path;
+        std::filesystem::path m_pipeline_cache_path;
+        std::filesystem::path m_log_file_path;
+        bool                  m_enable_async_log {true};
 
 #ifdef ENABLE_PHYSICS_DEBUG_RENDERER
         std::filesystem::path m_jolt_physics_asset_folder;
@@ -41,5 +48,6 @@ namespace Piccolo
         std::string m_default_world_url;
         std::string m_global_rendering_res_url;
         std::string m_global_particle_res_url;
+        std::string m_cooked_manifest_url;
     };
 } // namespace Piccolo
@@ -0,0 +1,37 @@
+#pragma once
+#include "runtime/core/meta/reflection/reflection.h"
+#include <string>
+#include <vector>
+namespace Piccolo
+{
+    REFLECTION_TYPE(CookedAssetRes)
+    CLASS(CookedAssetRes, Fields)
+    {
+        REFLECTION_BODY(CookedAssetRes);
+
+    public:
+        std::string m_source_url;
+        std::string m_cooked_url;
+
+        // name of the cooker and identity of the format it wrote, a change of either cooks the asset again
+        std::string m_cooker;
+        std::string m_format_hash;
+
+        // hash of the source file when it was cooked
+        std::string m_content_hash;
+
+        // asset urls referenced by the source file
+        std::vector<std::string> m_dependencies;
+    };
+
+    REFLECTION_TYPE(CookedManifestRes)
+    CLASS(CookedManifestRes, Fields)
+    {
+        REFLECTION_BODY(CookedManifestRes);
+
+    public:
+        int m_cooker_version {0};
+
+        std::vector<CookedAssetRes> m_assets;
+    };
+} // namespace Piccolo
@@ -21,5 +21,13 @@ namespace Piccolo
         Vector3     m_gravity;
         std::string m_particle_billboard_texture_path;
         std::string m_piccolo_logo_texture_path;
+        // simulates the emitters on the cpu job system and uploads the particles instead of running the compute passes
+        bool m_enable_cpu_simulation {false};
+        // draws the particles of all the emitters in one call, sorted from far to near by a gpu radix sort
+        bool m_enable_depth_sort {false};
+        // with the depth sort, only the nearest particles of every 32x32 pixel tile are drawn, 0 for no limit
+        int m_max_particles_per_tile {0};
+        // with the depth sort, blends the particles at half resolution and composites them over the scene
+        bool m_enable_half_resolution {false};
     };
 } // namespace Piccolo
\ No newline at end of file
@@ -6,6 +6,8 @@
 
 #include "runtime/resource/res_type/data/camera_config.h"
 
+#include <vector>
+
 namespace Piccolo
 {
     REFLECTION_TYPE(SkyBoxIrradianceMap)
@@ -46,6 +48,22 @@ namespace Piccolo
         Color   m_color;
     };
 
+    REFLECTION_TYPE(DirectionalLightShadowConfig)
+    CLASS(DirectionalLightShadowConfig, Fields)
+    {
+        REFLECTION_BODY(DirectionalLightShadowConfig);
+
+    public:
+        // at most 4, the cascades share the tiles of one shadow map
+        int m_cascade_count {1};
+        // view distances at which the cascades end, the last cascade always ends at the far plane of the camera
+        // without them the splits are blended from uniform to logarithmic by m_split_lambda
+        std::vector<float> m_cascade_splits;
+        float              m_split_lambda {0.9f};
+        // the farthest cascades keep their tile while the light and their shadow casters stay the same
+        int m_cached_cascade_count {0};
+    };
+
     REFLECTION_TYPE(GlobalRenderingRes)
     CLASS(GlobalRenderingRes, Fields)
     {
@@ -53,6 +71,8 @@ namespace Piccolo
 
     public:
         bool                m_enable_fxaa {false};
+        bool                m_enable_gpu_driven_rendering {false};
+        bool                m_enable_pre_skinning {false};
         SkyBoxIrradianceMap m_skybox_irradiance_map;
         SkyBoxSpecularMap   m_skybox_specular_map;
         std::string         m_brdf_map;
@@ -62,5 +82,7 @@ namespace Piccolo
         Color            m_ambient_light;
         CameraConfig     m_camera_config;
         DirectionalLight m_directional_light;
+
+        DirectionalLightShadowConfig m_directional_light_shadow;
     };
 } // namespace Piccolo
\ No newline at end of file